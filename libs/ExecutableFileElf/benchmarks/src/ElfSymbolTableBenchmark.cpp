@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Mdt/ExecutableFile/Elf/SymbolTable.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionIndexChangeMap.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace Mdt::ExecutableFile::Elf;
+
+/*
+ * Fix-ups done on the symbol tables once the sections have been moved.
+ * Each benchmark is run for tables of growing size,
+ * their time should grow linearly with the count of symbols.
+ */
+
+static constexpr uint16_t sectionCount = 40;
+
+static
+PartialSymbolTable makeSymbolTable(int symbolCount)
+{
+  PartialSymbolTable table;
+
+  for(int i = 0; i < symbolCount; ++i){
+    PartialSymbolTableEntry entry;
+    entry.fileOffset = 24 * static_cast<int64_t>(i);
+    entry.entry.name = static_cast<uint32_t>(i);
+    entry.entry.info = 3;
+    entry.entry.other = 0;
+    entry.entry.shndx = static_cast<uint16_t>( 1 + (i % (sectionCount - 1)) );
+    entry.entry.value = 1000 * static_cast<uint64_t>(entry.entry.shndx);
+    entry.entry.size = 0;
+    table.addEntryFromFile(entry);
+  }
+
+  return table;
+}
+
+static
+SectionHeaderTable makeSectionHeaderTable()
+{
+  SectionHeaderTable table(sectionCount);
+
+  for(uint16_t i = 0; i < sectionCount; ++i){
+    table[i].addr = 2000 * static_cast<uint64_t>(i);
+  }
+
+  return table;
+}
+
+static
+std::string symbolCountName(int symbolCount)
+{
+  return std::to_string(symbolCount) + " symbols";
+}
+
+
+TEST_CASE("updateVirtualAddresses")
+{
+  const int symbolCount = GENERATE(1'000, 100'000, 3'000'000);
+
+  PartialSymbolTable symbolTable = makeSymbolTable(symbolCount);
+  const SectionHeaderTable sectionHeaderTable = makeSectionHeaderTable();
+  const std::vector<uint16_t> movedSectionIndexes{3, 5, 7, 11, 13, 17};
+
+  BENCHMARK( symbolCountName(symbolCount) ){
+    symbolTable.updateVirtualAddresses(movedSectionIndexes, sectionHeaderTable);
+  };
+  REQUIRE( symbolTable.entryAt(2).value == sectionHeaderTable[3].addr );
+}
+
+TEST_CASE("updateVirtualAddresses_threads")
+{
+  const int symbolCount = 3'000'000;
+  const unsigned int threadCount = GENERATE(1u, 2u, 4u, 8u);
+
+  PartialSymbolTable symbolTable = makeSymbolTable(symbolCount);
+  const SectionHeaderTable sectionHeaderTable = makeSectionHeaderTable();
+  const std::vector<uint16_t> movedSectionIndexes{3, 5, 7, 11, 13, 17};
+
+  BENCHMARK( std::to_string(threadCount) + " threads" ){
+    symbolTable.updateVirtualAddresses(movedSectionIndexes, sectionHeaderTable, threadCount);
+  };
+  REQUIRE( symbolTable.entryAt(2).value == sectionHeaderTable[3].addr );
+}
+
+TEST_CASE("updateSectionIndexes")
+{
+  const int symbolCount = GENERATE(1'000, 100'000, 3'000'000);
+
+  PartialSymbolTable symbolTable = makeSymbolTable(symbolCount);
+  SectionIndexChangeMap indexChanges(sectionCount);
+  indexChanges.swapIndexes(3, 5);
+
+  BENCHMARK( symbolCountName(symbolCount) ){
+    symbolTable.updateSectionIndexes(indexChanges);
+  };
+}
@@ -0,0 +1,10 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "ChangedBytesMapWriter.h"
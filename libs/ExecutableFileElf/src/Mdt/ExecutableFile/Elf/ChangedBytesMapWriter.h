@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_CHANGED_BYTES_MAP_WRITER_H
+#define MDT_EXECUTABLE_FILE_ELF_CHANGED_BYTES_MAP_WRITER_H
+
+#include "Mdt/ExecutableFile/Elf/OffsetRange.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Write to a map only the bytes that really change
+   *
+   * The file is mapped shared,
+   * so a page becomes dirty as soon as one of its bytes is written,
+   * even if the written value is the same as the existing one.
+   * Dirty pages are then written back to the disk by the kernel.
+   *
+   * When rewriting a file, most of the structures
+   * (symbol tables, notes, headers, ...) are byte-identical.
+   * This writer first generates a structure to a buffer,
+   * then compares it to the map and only copies the bytes that differ.
+   * Pages that have no change are never touched and stay clean.
+   *
+   * \code
+   * ChangedBytesMapWriter writer(map);
+   *
+   * writer.write(offset, size, [&section, &ident](ByteArraySpan array){
+   *   dynamicSectionToArray(array, section, ident);
+   * });
+   * \endcode
+   */
+  class ChangedBytesMapWriter
+  {
+   public:
+
+    /*! \brief Construct a writer for \a map
+     *
+     * \pre \a map must not be null
+     */
+    explicit ChangedBytesMapWriter(ByteArraySpan map) noexcept
+     : mMap(map)
+    {
+      assert( !mMap.isNull() );
+    }
+
+    /*! \brief Write \a size bytes at \a offset using \a writer
+     *
+     * \a writer is called with a array of \a size bytes,
+     * that initially contains the bytes of the map.
+     *
+     * \pre \a offset must be >= 0 and \a size must be > 0
+     * \pre the map must be big enough to access \a size bytes at \a offset
+     */
+    template<typename Writer>
+    void write(int64_t offset, int64_t size, Writer writer)
+    {
+      assert( offset >= 0 );
+      assert( size > 0 );
+      assert( mMap.size >= offset + size );
+
+      const ByteArraySpan target = mMap.subSpan(offset, size);
+
+      mBuffer.assign( target.cbegin(), target.cend() );
+      ByteArraySpan array;
+      array.data = mBuffer.data();
+      array.size = size;
+
+      writer(array);
+
+      copyChangedBytes(mBuffer.data(), target, offset);
+    }
+
+    /*! \brief Set each byte in \a range to \a c
+     *
+     * \pre the map must be big enough to access \a range
+     */
+    void fill(const OffsetRange & range, unsigned char c)
+    {
+      assert( mMap.size >= range.minimumSizeToAccessRange() );
+
+      if( range.isEmpty() ){
+        return;
+      }
+
+      mBuffer.assign(range.byteCount(), c);
+      const int64_t offset = static_cast<int64_t>( range.begin() );
+      const ByteArraySpan target = mMap.subSpan( offset, static_cast<int64_t>( range.byteCount() ) );
+
+      copyChangedBytes(mBuffer.data(), target, offset);
+    }
+
+    /*! \brief Get the ranges that have been changed in the map
+     *
+     * The returned ranges are sorted by offset,
+     * adjacent or overlapping ranges are merged.
+     */
+    std::vector<OffsetRange> changedRanges() const
+    {
+      std::vector<OffsetRange> ranges = mChangedRanges;
+
+      const auto cmp = [](const OffsetRange & a, const OffsetRange & b){
+        return a.begin() < b.begin();
+      };
+      std::sort(ranges.begin(), ranges.end(), cmp);
+
+      std::vector<OffsetRange> mergedRanges;
+      for(const OffsetRange & range : ranges){
+        if( !mergedRanges.empty() && (range.begin() <= mergedRanges.back().end()) ){
+          const uint64_t end = std::max( range.end(), mergedRanges.back().end() );
+          mergedRanges.back() = OffsetRange::fromBeginAndEndOffsets(mergedRanges.back().begin(), end);
+        }else{
+          mergedRanges.push_back(range);
+        }
+      }
+
+      return mergedRanges;
+    }
+
+    /*! \brief Get the count of bytes that have been changed in the map
+     *
+     * A byte that has been changed several times is counted once.
+     *
+     * \sa changedRanges()
+     */
+    uint64_t changedByteCount() const
+    {
+      uint64_t count = 0;
+
+      for(const OffsetRange & range : changedRanges()){
+        count += range.byteCount();
+      }
+
+      return count;
+    }
+
+   private:
+
+    void copyChangedBytes(const unsigned char *source, ByteArraySpan target, int64_t targetOffset)
+    {
+      assert( source != nullptr );
+      assert( !target.isNull() );
+
+      const unsigned char * const sourceEnd = source + target.size;
+      const unsigned char *first = source;
+      unsigned char *out = target.data;
+
+      while(first != sourceEnd){
+        const auto mismatch = std::mismatch(first, sourceEnd, out);
+        if(mismatch.first == sourceEnd){
+          return;
+        }
+        /*
+         * Find the end of the run of changed bytes.
+         * A few equal bytes inside a run are copied too,
+         * to not split the range for nothing
+         */
+        const unsigned char *last = mismatch.first;
+        unsigned char *lastOut = mismatch.second;
+        int equalCount = 0;
+        while( (last != sourceEnd) && (equalCount < 8) ){
+          if(*last == *lastOut){
+            ++equalCount;
+          }else{
+            equalCount = 0;
+          }
+          ++last;
+          ++lastOut;
+        }
+        last -= equalCount;
+
+        std::copy(mismatch.first, last, mismatch.second);
+
+        const uint64_t begin = static_cast<uint64_t>( targetOffset + (mismatch.first - source) );
+        const uint64_t end = static_cast<uint64_t>( targetOffset + (last - source) );
+        mChangedRanges.push_back( OffsetRange::fromBeginAndEndOffsets(begin, end) );
+
+        first = last;
+        out = target.data + (last - source);
+      }
+    }
+
+    ByteArraySpan mMap;
+    std::vector<unsigned char> mBuffer;
+    std::vector<OffsetRange> mChangedRanges;
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_CHANGED_BYTES_MAP_WRITER_H
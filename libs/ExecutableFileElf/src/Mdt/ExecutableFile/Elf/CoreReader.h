@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_CORE_READER_H
+#define MDT_EXECUTABLE_FILE_ELF_CORE_READER_H
+
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/DynamicSection.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderReader.h"
+#include "Mdt/ExecutableFile/ReadResult.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/NotNullTerminatedStringError.h"
+#include "Mdt/ExecutableFile/StringTableError.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
+#include <QCoreApplication>
+#include <QString>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Error code returned by the core reader functions
+   *
+   * \sa readErrorMessage()
+   */
+  enum class ReadError
+  {
+    NoError,                              /*!< No error */
+    FileTooSmallToReadFileHeader,         /*!< The file is to small to read the file header */
+    InvalidFileHeader,                    /*!< The file does not start with a valid ELF file header */
+    FileTooSmallToReadSectionHeaders,     /*!< The file is to small to read the section header table */
+    FileTooSmallToReadProgramHeaderTable, /*!< The file is to small to read the program header table */
+    NoSectionNamesStringTable,            /*!< The section names string table section header does not exist */
+    SectionNamesStringTableOutOfRange,    /*!< The section names string table is not in the range of the file */
+    InvalidSectionName,                   /*!< A section name is not null terminated */
+    NoDynamicSection,                     /*!< The .dynamic section does not exist */
+    InvalidDynamicSection,                /*!< The .dynamic section or its string table is corrupted */
+    ReadLimitExceeded                     /*!< A limit defined by ReadLimits would be exceeded */
+  };
+
+  /*! \internal Result of a core reader function
+   */
+  template<typename T>
+  using CoreReadResult = ReadResult<T, ReadError>;
+
+  /*! \internal Get a human readable message for \a error
+   *
+   * This is the only core function that allocates a (translated) message,
+   * so it should only be called when the message is really required.
+   *
+   * \pre \a error must not be NoError
+   */
+  inline
+  QString readErrorMessage(ReadError error, const QString & fileName)
+  {
+    assert( error != ReadError::NoError );
+
+    const char *context = "Mdt::ExecutableFile::Elf::FileIoEngine";
+
+    switch(error){
+      case ReadError::NoError:
+        break;
+      case ReadError::FileTooSmallToReadFileHeader:
+        return QCoreApplication::translate(context, "file '%1' is to small to read the file header").arg(fileName);
+      case ReadError::InvalidFileHeader:
+        return QCoreApplication::translate(context, "file '%1' does not contain a valid file header").arg(fileName);
+      case ReadError::FileTooSmallToReadSectionHeaders:
+        return QCoreApplication::translate(context, "file '%1' is to small to read section headers").arg(fileName);
+      case ReadError::FileTooSmallToReadProgramHeaderTable:
+        return QCoreApplication::translate(context, "file '%1' is to small to read the program header table").arg(fileName);
+      case ReadError::NoSectionNamesStringTable:
+        return QCoreApplication::translate(context, "file '%1' does not contain the section names string table section header").arg(fileName);
+      case ReadError::SectionNamesStringTableOutOfRange:
+        return QCoreApplication::translate(context, "file '%1': the section names string table is out of the file range").arg(fileName);
+      case ReadError::InvalidSectionName:
+        return QCoreApplication::translate(context, "file '%1' contains a section name that is not null terminated").arg(fileName);
+      case ReadError::NoDynamicSection:
+        return QCoreApplication::translate(context, "file '%1' does not contain the .dynamic section").arg(fileName);
+      case ReadError::InvalidDynamicSection:
+        return QCoreApplication::translate(context, "file '%1' contains a invalid .dynamic section").arg(fileName);
+      case ReadError::ReadLimitExceeded:
+        return QCoreApplication::translate(context, "file '%1' exceeds a read limit").arg(fileName);
+    }
+
+    return QString();
+  }
+
+  /*! \internal Get minimum size to read the file header without knowing the Ident
+   *
+   * It can be either 52 or 64 bytes, so we return 64.
+   *
+   * \sa minimumSizeToReadFileHeader(const Ident &)
+   */
+  constexpr
+  int64_t minimumSizeToReadAnyFileHeader() noexcept
+  {
+    return 64;
+  }
+
+  /*! \internal Read the file header
+   *
+   * \pre \a map must not be null
+   */
+  inline
+  CoreReadResult<FileHeader> readFileHeader(const ByteArraySpan & map) noexcept
+  {
+    assert( !map.isNull() );
+
+    if( map.size < minimumSizeToReadAnyFileHeader() ){
+      return CoreReadResult<FileHeader>::fromError(ReadError::FileTooSmallToReadFileHeader);
+    }
+
+    FileHeader fileHeader = extractFileHeader(map);
+    if( !fileHeader.seemsValid() ){
+      return CoreReadResult<FileHeader>::fromError(ReadError::InvalidFileHeader);
+    }
+
+    return fileHeader;
+  }
+
+  /*! \internal Check that \a map is big enough to read all section headers
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   */
+  inline
+  ReadError checkSizeToReadSectionHeaders(const ByteArraySpan & map, const FileHeader & fileHeader) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    if( map.size < fileHeader.minimumSizeToReadAllSectionHeaders() ){
+      return ReadError::FileTooSmallToReadSectionHeaders;
+    }
+
+    return ReadError::NoError;
+  }
+
+  /*! \internal Check that \a map is big enough to read the program header table
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   */
+  inline
+  ReadError checkSizeToReadProgramHeaderTable(const ByteArraySpan & map, const FileHeader & fileHeader) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    if( map.size < fileHeader.minimumSizeToReadAllProgramHeaders() ){
+      return ReadError::FileTooSmallToReadProgramHeaderTable;
+    }
+
+    return ReadError::NoError;
+  }
+
+  /*! \internal Read the section names string table section header
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   */
+  inline
+  CoreReadResult<SectionHeader> readSectionNameStringTableHeader(const ByteArraySpan & map, const FileHeader & fileHeader) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    const ReadError sizeError = checkSizeToReadSectionHeaders(map, fileHeader);
+    if(sizeError != ReadError::NoError){
+      return CoreReadResult<SectionHeader>::fromError(sizeError);
+    }
+    if(fileHeader.shstrndx >= fileHeader.shnum){
+      return CoreReadResult<SectionHeader>::fromError(ReadError::NoSectionNamesStringTable);
+    }
+
+    SectionHeader header = extractSectionNameStringTableHeader(map, fileHeader);
+    if( header.sectionType() == SectionType::Null ){
+      return CoreReadResult<SectionHeader>::fromError(ReadError::NoSectionNamesStringTable);
+    }
+    if( map.size < header.minimumSizeToReadSection() ){
+      return CoreReadResult<SectionHeader>::fromError(ReadError::SectionNamesStringTableOutOfRange);
+    }
+
+    return header;
+  }
+
+  /*! \internal Read the section header table, including the section names
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   */
+  inline
+  CoreReadResult<SectionHeaderTable> readSectionHeaderTable(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                                            const ReadLimits & limits = ReadLimits()) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    const auto stringTableHeader = readSectionNameStringTableHeader(map, fileHeader);
+    if( !stringTableHeader ){
+      return CoreReadResult<SectionHeaderTable>::fromError( stringTableHeader.error() );
+    }
+
+    /*
+     * Names are checked while they are extracted,
+     * so we only pay for a exception for corrupted files
+     */
+    ReadBudget budget(limits);
+    try{
+      return extractAllSectionHeaders(map, fileHeader, budget);
+    }catch(const NotNullTerminatedStringError &){
+      return CoreReadResult<SectionHeaderTable>::fromError(ReadError::InvalidSectionName);
+    }catch(const ReadLimitExceededError &){
+      return CoreReadResult<SectionHeaderTable>::fromError(ReadError::ReadLimitExceeded);
+    }
+  }
+
+  /*! \internal Read the program header table
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   */
+  inline
+  CoreReadResult<ProgramHeaderTable> readProgramHeaderTable(const ByteArraySpan & map, const FileHeader & fileHeader) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    const ReadError sizeError = checkSizeToReadProgramHeaderTable(map, fileHeader);
+    if(sizeError != ReadError::NoError){
+      return CoreReadResult<ProgramHeaderTable>::fromError(sizeError);
+    }
+
+    return extractAllProgramHeaders(map, fileHeader);
+  }
+
+  /*! \internal Read the dynamic section
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   * \pre \a sectionNamesStringTableSectionHeader must be the section names string table header
+   * \sa readSectionNameStringTableHeader()
+   */
+  inline
+  CoreReadResult<DynamicSection> readDynamicSection(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                                    const SectionHeader & sectionNamesStringTableSectionHeader,
+                                                    const ReadLimits & limits = ReadLimits()) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( headerIsStringTableSection(sectionNamesStringTableSectionHeader) );
+
+    const ReadError sizeError = checkSizeToReadSectionHeaders(map, fileHeader);
+    if(sizeError != ReadError::NoError){
+      return CoreReadResult<DynamicSection>::fromError(sizeError);
+    }
+
+    DynamicSection dynamicSection;
+    ReadBudget budget(limits);
+    try{
+      dynamicSection = extractDynamicSection(map, fileHeader, sectionNamesStringTableSectionHeader, budget);
+    }catch(const ReadLimitExceededError &){
+      return CoreReadResult<DynamicSection>::fromError(ReadError::ReadLimitExceeded);
+    }catch(const DynamicSectionReadError &){
+      return CoreReadResult<DynamicSection>::fromError(ReadError::InvalidDynamicSection);
+    }catch(const StringTableError &){
+      return CoreReadResult<DynamicSection>::fromError(ReadError::InvalidDynamicSection);
+    }catch(const NotNullTerminatedStringError &){
+      return CoreReadResult<DynamicSection>::fromError(ReadError::InvalidDynamicSection);
+    }
+
+    if( dynamicSection.isNull() ){
+      return CoreReadResult<DynamicSection>::fromError(ReadError::NoDynamicSection);
+    }
+
+    return dynamicSection;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_CORE_READER_H
@@ -256,6 +256,10 @@ QString toDebugString(SectionType type)
       return QLatin1String("array of constructors");
     case SectionType::FiniArray:
       return QLatin1String("array of destructors");
+    case SectionType::Group:
+      return QLatin1String("section group");
+    case SectionType::Relr:
+      return QLatin1String("SHT_RELR: packed relative relocation entries");
     case SectionType::OsSpecific:
       return QLatin1String("OS specific");
     case SectionType::GnuHash:
@@ -350,6 +354,8 @@ QString toDebugString(DynamicSectionTagType type)
       return QLatin1String("end of the _DYNAMIC array");
     case DynamicSectionTagType::Needed:
       return QLatin1String("string table offset to get the needed library name");
+    case DynamicSectionTagType::PltRelocationTableSize:
+      return QLatin1String("DT_PLTRELSZ: total size [bytes] of the relocations associated with the PLT");
     case DynamicSectionTagType::PltGot:
       return QLatin1String("DT_PLTGOT");
     case DynamicSectionTagType::Hash:
@@ -378,12 +384,50 @@ QString toDebugString(DynamicSectionTagType type)
       return QLatin1String("string table offset to get the search path");
     case DynamicSectionTagType::Symbolic:
       return QLatin1String("DT_SYMBOLIC");
+    case DynamicSectionTagType::RelTable:
+      return QLatin1String("DT_REL: address of the relocation table without addends");
+    case DynamicSectionTagType::RelTableSize:
+      return QLatin1String("DT_RELSZ: total size [bytes] of the DT_REL relocation table");
+    case DynamicSectionTagType::RelEntrySize:
+      return QLatin1String("DT_RELENT: size [bytes] of a DT_REL relocation entry");
     case DynamicSectionTagType::Debug:
       return QLatin1String("DT_DEBUG: used for debugging");
+    case DynamicSectionTagType::JmpRel:
+      return QLatin1String("DT_JMPREL: address of the relocations associated with the PLT");
     case DynamicSectionTagType::Runpath:
       return QLatin1String("string table offset to get the search path");
+    case DynamicSectionTagType::Flags:
+      return QLatin1String("DT_FLAGS: flags for the object being loaded");
+    case DynamicSectionTagType::RelrTableSize:
+      return QLatin1String("DT_RELRSZ: total size [bytes] of the packed relative relocation table");
+    case DynamicSectionTagType::RelrTable:
+      return QLatin1String("DT_RELR: address of the packed relative relocation table");
+    case DynamicSectionTagType::RelrEntrySize:
+      return QLatin1String("DT_RELRENT: size [bytes] of a packed relative relocation entry");
     case DynamicSectionTagType::GnuHash:
       return QLatin1String("DT_GNU_HASH");
+    case DynamicSectionTagType::Config:
+      return QLatin1String("DT_CONFIG: string table offset to get the configuration file name");
+    case DynamicSectionTagType::DepAudit:
+      return QLatin1String("DT_DEPAUDIT: string table offset to get the dependency audit library");
+    case DynamicSectionTagType::Audit:
+      return QLatin1String("DT_AUDIT: string table offset to get the audit library");
+    case DynamicSectionTagType::RelaCount:
+      return QLatin1String("DT_RELACOUNT: count of relative relocations at the start of the DT_RELA table");
+    case DynamicSectionTagType::RelCount:
+      return QLatin1String("DT_RELCOUNT: count of relative relocations at the start of the DT_REL table");
+    case DynamicSectionTagType::Flags1:
+      return QLatin1String("DT_FLAGS_1: GNU extension flags");
+    case DynamicSectionTagType::VersionDefinitionCount:
+      return QLatin1String("DT_VERDEFNUM: count of entries in the .gnu.version_d section");
+    case DynamicSectionTagType::VersionNeed:
+      return QLatin1String("DT_VERNEED: address of the .gnu.version_r section");
+    case DynamicSectionTagType::VersionNeedCount:
+      return QLatin1String("DT_VERNEEDNUM: count of entries in the .gnu.version_r section");
+    case DynamicSectionTagType::Auxiliary:
+      return QLatin1String("DT_AUXILIARY: string table offset to get the name of a auxiliary filtee");
+    case DynamicSectionTagType::Filter:
+      return QLatin1String("DT_FILTER: string table offset to get the name of a filtee");
     case DynamicSectionTagType::Unknown:
       return QLatin1String("unknown");
   }
@@ -414,7 +458,24 @@ QString dynamicStructValOrPtrToDebugString(const DynamicStruct & entry)
     case DynamicSectionTagType::StringTable:
     case DynamicSectionTagType::SymbolTable:
     case DynamicSectionTagType::RelocationTable:
+    case DynamicSectionTagType::RelTable:
+    case DynamicSectionTagType::JmpRel:
+    case DynamicSectionTagType::RelrTable:
+    case DynamicSectionTagType::VersionNeed:
       return dynamicStructPtrToDebugString(entry);
+    case DynamicSectionTagType::PltRelocationTableSize:
+    case DynamicSectionTagType::RelTableSize:
+    case DynamicSectionTagType::RelEntrySize:
+    case DynamicSectionTagType::RelrTableSize:
+    case DynamicSectionTagType::RelrEntrySize:
+    case DynamicSectionTagType::RelaCount:
+    case DynamicSectionTagType::RelCount:
+    case DynamicSectionTagType::VersionDefinitionCount:
+    case DynamicSectionTagType::VersionNeedCount:
+      return dynamicStructValToDebugString(entry);
+    case DynamicSectionTagType::Flags:
+    case DynamicSectionTagType::Flags1:
+      return QLatin1String("val: 0x") + QString::number(entry.val_or_ptr, 16);
     case DynamicSectionTagType::SoName:
     case DynamicSectionTagType::RelocationTableSize:
     case DynamicSectionTagType::RelocationEntrySize:
@@ -425,6 +486,11 @@ QString dynamicStructValOrPtrToDebugString(const DynamicStruct & entry)
       return dynamicStructPtrToDebugString(entry);
     case DynamicSectionTagType::Runpath:
     case DynamicSectionTagType::RPath:
+    case DynamicSectionTagType::Config:
+    case DynamicSectionTagType::DepAudit:
+    case DynamicSectionTagType::Audit:
+    case DynamicSectionTagType::Auxiliary:
+    case DynamicSectionTagType::Filter:
     case DynamicSectionTagType::StringTableSize:
       return dynamicStructValToDebugString(entry);
     case DynamicSectionTagType::Symbolic:
@@ -0,0 +1,283 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_DEPLOY_STAMP_NOTE_H
+#define MDT_EXECUTABLE_FILE_ELF_DEPLOY_STAMP_NOTE_H
+
+#include "Mdt/ExecutableFile/DeployStamp.h"
+#include "Mdt/ExecutableFile/RPathElf.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include "Mdt/ExecutableFile/Elf/NoteSection.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/Elf/FileWriterUtils.h"
+#include "Mdt/ExecutableFile/Elf/Algorithm.h"
+#include "Mdt/ExecutableFile/Elf/Exceptions.h"
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Encode and decode the deployment stamp note
+   *
+   * The note is named "Mdt", has the type 1,
+   * and lives in the .note.mdt.deploy-stamp section.
+   * Its description is:
+   * - format version (4 bytes)
+   * - tool version size (4 bytes)
+   * - run path size (4 bytes)
+   * - input fingerprint size (4 bytes)
+   * - tool version (UTF-8), run path (UTF-8, in the DT_RUNPATH form) and input fingerprint,
+   *   padded to 4 bytes
+   *
+   * The section is not loaded, but it is covered by its own PT_NOTE
+   * (p_memsz is 0), so it can be found from the program headers,
+   * that are at the beginning of the file.
+   */
+  class DeployStampNote : public QObject
+  {
+    Q_OBJECT
+
+   public:
+
+    /*! \brief Get the name of the deployment stamp note section
+     */
+    static
+    std::string sectionName() noexcept
+    {
+      return ".note.mdt.deploy-stamp";
+    }
+
+    /*! \brief Get the name of the deployment stamp note
+     */
+    static
+    std::string noteName() noexcept
+    {
+      return "Mdt";
+    }
+
+    /*! \brief Get the type of the deployment stamp note
+     */
+    static constexpr
+    uint32_t noteType() noexcept
+    {
+      return 1;
+    }
+
+    /*! \brief Get the version of the description format
+     */
+    static constexpr
+    uint32_t formatVersion() noexcept
+    {
+      return 1;
+    }
+
+    /*! \brief Get a note section for \a stamp
+     *
+     * The description words are stored so that,
+     * once written with \a dataFormat, the bytes are in the order described above.
+     *
+     * \pre \a stamp must not be null
+     * \pre \a dataFormat must be valid
+     */
+    static
+    NoteSection noteSectionFromStamp(const DeployStamp & stamp, DataFormat dataFormat)
+    {
+      assert( !stamp.isNull() );
+      assert( dataFormat != DataFormat::DataNone );
+
+      const QByteArray toolVersion = stamp.toolVersion().toUtf8();
+      const QByteArray runPath = RPathElf::rPathToString( stamp.runPath() ).toUtf8();
+      const QByteArray & fingerprint = stamp.inputFingerprint();
+
+      const uint32_t bytesSize = static_cast<uint32_t>( toolVersion.size() + runPath.size() + fingerprint.size() );
+
+      NoteSection section;
+      section.name = noteName();
+      section.type = noteType();
+      section.descriptionSize = 16 + bytesSize;
+      section.description.push_back( formatVersion() );
+      section.description.push_back( static_cast<uint32_t>( toolVersion.size() ) );
+      section.description.push_back( static_cast<uint32_t>( runPath.size() ) );
+      section.description.push_back( static_cast<uint32_t>( fingerprint.size() ) );
+
+      std::vector<unsigned char> bytes;
+      bytes.reserve( findAlignedSize(bytesSize, 4) );
+      bytes.insert( bytes.end(), toolVersion.cbegin(), toolVersion.cend() );
+      bytes.insert( bytes.end(), runPath.cbegin(), runPath.cend() );
+      bytes.insert( bytes.end(), fingerprint.cbegin(), fingerprint.cend() );
+      bytes.resize( findAlignedSize(bytesSize, 4), 0 );
+
+      for(size_t i = 0; i < bytes.size(); i += 4){
+        section.description.push_back( getWord(bytes.data() + i, dataFormat) );
+      }
+
+      return section;
+    }
+
+    /*! \brief Get the stamp out from \a section
+     *
+     * \pre \a section must be a deployment stamp note
+     * \pre \a dataFormat must be valid
+     * \exception NoteSectionReadError
+     * \exception RPathFormatError
+     */
+    static
+    DeployStamp stampFromNoteSection(const NoteSection & section, DataFormat dataFormat)
+    {
+      assert( isDeployStampNote(section) );
+      assert( dataFormat != DataFormat::DataNone );
+
+      if( (section.descriptionSize < 16) || (section.description.size() < 4) ){
+        const QString msg = tr("deployment stamp note description is to small");
+        throw NoteSectionReadError(msg);
+      }
+      if(section.description[0] != formatVersion()){
+        const QString msg = tr("deployment stamp note has the unsupported format version %1")
+                            .arg(section.description[0]);
+        throw NoteSectionReadError(msg);
+      }
+
+      const uint64_t toolVersionSize = section.description[1];
+      const uint64_t runPathSize = section.description[2];
+      const uint64_t fingerprintSize = section.description[3];
+      const uint64_t bytesSize = toolVersionSize + runPathSize + fingerprintSize;
+      if( (toolVersionSize == 0) || ( (16 + bytesSize) != section.descriptionSize )
+       || ( (section.description.size() - 4) * 4 < bytesSize ) ){
+        const QString msg = tr("deployment stamp note has inconsistent sizes");
+        throw NoteSectionReadError(msg);
+      }
+
+      std::vector<unsigned char> bytes( (section.description.size() - 4) * 4 );
+      for(size_t i = 4; i < section.description.size(); ++i){
+        ByteArraySpan word;
+        word.data = bytes.data() + (i - 4) * 4;
+        word.size = 4;
+        set32BitWord(word, section.description[i], dataFormat);
+      }
+
+      const char *first = reinterpret_cast<const char*>( bytes.data() );
+      const QString toolVersion = QString::fromUtf8( first, static_cast<int>(toolVersionSize) );
+      first += toolVersionSize;
+      const QString runPath = QString::fromUtf8( first, static_cast<int>(runPathSize) );
+      first += runPathSize;
+      const QByteArray fingerprint( first, static_cast<int>(fingerprintSize) );
+
+      return DeployStamp( toolVersion, RPathElf::rPathFromString(runPath), fingerprint );
+    }
+
+    /*! \brief Check if \a section is a deployment stamp note
+     */
+    static
+    bool isDeployStampNote(const NoteSection & section) noexcept
+    {
+      return (section.name == noteName()) && (section.type == noteType());
+    }
+
+    /*! \brief Get the stamp out from the PT_NOTE segments of \a map
+     *
+     * Only the program headers and the notes they cover are read.
+     * Returns a null stamp if the file has none.
+     *
+     * A unrelated note that is malformed ends the walk of its segment,
+     * but a corrupted deployment stamp note is a error.
+     *
+     * \pre \a map must not be null
+     * \pre \a fileHeader must be valid
+     * \exception NoteSectionReadError
+     * \exception RPathFormatError
+     */
+    static
+    DeployStamp extractStamp(const ByteArraySpan & map, const FileHeader & fileHeader,
+                             const ProgramHeaderTable & programHeaderTable)
+    {
+      assert( !map.isNull() );
+      assert( fileHeader.seemsValid() );
+
+      const DataFormat dataFormat = fileHeader.ident.dataFormat;
+
+      for(const ProgramHeader & header : programHeaderTable){
+        if( (header.segmentType() != SegmentType::Note) || (header.filesz == 0) ){
+          continue;
+        }
+        if( ( header.offset > static_cast<uint64_t>(map.size) ) || ( header.filesz > static_cast<uint64_t>(map.size) - header.offset ) ){
+          continue;
+        }
+        const uint64_t alignment = (header.align == 8) ? 8 : 4;
+        const ByteArraySpan segment = map.subSpan( static_cast<int64_t>(header.offset), static_cast<int64_t>(header.filesz) );
+
+        uint64_t offset = 0;
+        while( (offset + 12) <= static_cast<uint64_t>(segment.size) ){
+          const uint64_t nameSize = getWord(segment.data + offset, dataFormat);
+          const uint64_t descriptionSize = getWord(segment.data + offset + 4, dataFormat);
+          const uint32_t type = getWord(segment.data + offset + 8, dataFormat);
+          const uint64_t nameOffset = offset + 12;
+          const uint64_t descriptionOffset = nameOffset + findAlignedSize(nameSize, alignment);
+          const uint64_t descriptionEnd = descriptionOffset + descriptionSize;
+          if( descriptionEnd > static_cast<uint64_t>(segment.size) ){
+            break;
+          }
+          if( isDeployStampNote(nameSize, type, segment, nameOffset) ){
+            return stampFromDescription( segment, descriptionOffset, descriptionSize, dataFormat );
+          }
+          offset = findAlignedSize(descriptionEnd, alignment);
+        }
+      }
+
+      return DeployStamp();
+    }
+
+   private:
+
+    static
+    bool isDeployStampNote(uint64_t nameSize, uint32_t type, const ByteArraySpan & segment, uint64_t nameOffset) noexcept
+    {
+      if( (type != noteType()) || (nameSize != noteName().size() + 1) ){
+        return false;
+      }
+
+      return stringFromBoundedUnsignedCharArray( segment.subSpan(static_cast<int64_t>(nameOffset), static_cast<int64_t>(nameSize)) ) == noteName();
+    }
+
+    static
+    DeployStamp stampFromDescription(const ByteArraySpan & segment, uint64_t descriptionOffset,
+                                     uint64_t descriptionSize, DataFormat dataFormat)
+    {
+      NoteSection section;
+      section.name = noteName();
+      section.type = noteType();
+      section.descriptionSize = static_cast<uint32_t>(descriptionSize);
+      // The words must not be read past the end of the segment
+      for(uint64_t offset = 0; offset + 4 <= descriptionSize; offset += 4){
+        section.description.push_back( getWord(segment.data + descriptionOffset + offset, dataFormat) );
+      }
+      if( (descriptionSize % 4) != 0 ){
+        unsigned char lastWord[4] = {0, 0, 0, 0};
+        const uint64_t first = descriptionSize - (descriptionSize % 4);
+        for(uint64_t i = first; i < descriptionSize; ++i){
+          lastWord[i - first] = segment.data[descriptionOffset + i];
+        }
+        section.description.push_back( getWord(lastWord, dataFormat) );
+      }
+
+      return stampFromNoteSection(section, dataFormat);
+    }
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_DEPLOY_STAMP_NOTE_H
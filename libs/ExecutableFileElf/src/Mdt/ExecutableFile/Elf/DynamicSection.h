@@ -12,11 +12,15 @@
 
 #include "Mdt/ExecutableFile/ExecutableFileReadError.h"
 #include "Mdt/ExecutableFile/Elf/StringTable.h"
+#include "Mdt/ExecutableFile/Elf/StringTableBuilder.h"
+#include "Mdt/ExecutableFile/Elf/StringTableEditor.h"
 #include "Mdt/ExecutableFile/Elf/Ident.h"
 #include <QString>
 #include <QStringList>
 #include <QObject>
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <limits>
 #include <cstdlib>
 #include <cmath>
@@ -36,6 +40,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
   {
     Null = 0,                 /*!< Marks the end of the _DYNAMIC array */
     Needed = 1,               /*!< This element holds the string table offset to get the needed library name */
+    PltRelocationTableSize = 2, /*!< DT_PLTRELSZ: total size [bytes] of the relocations associated with the PLT */
     PltGot = 3,               /*!< DT_PLTGOT */
     Hash = 4,                 /*!< DT_HASH */
     StringTable = 5,          /*!< DT_STRTAB: this element holds the address to the string table */
@@ -50,12 +55,31 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     SoName = 14,              /*!< This element holds the string table offset to get the sahred object name */
     RPath = 15,               /*!< This element holds the string table offset to get the search path (deprecated) */
     Symbolic = 16,            /*!< DT_SYMBOLIC */
+    RelTable = 17,            /*!< DT_REL: address of the relocation table without addends */
+    RelTableSize = 18,        /*!< DT_RELSZ: total size [bytes] of the DT_REL relocation table */
+    RelEntrySize = 19,        /*!< DT_RELENT: size [bytes] of a DT_REL relocation entry */
     Debug = 21,               /*!< DT_DEBUG: used for debugging */
+    JmpRel = 23,              /*!< DT_JMPREL: address of the relocations associated with the PLT */
     Runpath = 29,             /*!< This element holds the string table offset to get the search path */
+    Flags = 30,               /*!< DT_FLAGS: flags for the object being loaded (DF_BIND_NOW, ...) */
+    RelrTableSize = 35,       /*!< DT_RELRSZ: total size [bytes] of the packed relative relocation table */
+    RelrTable = 36,           /*!< DT_RELR: address of the packed relative relocation table */
+    RelrEntrySize = 37,       /*!< DT_RELRENT: size [bytes] of a packed relative relocation entry */
     Unknown = 100,            /*!< Unknown element (not from the standard) */
     GnuHash = 0x6ffffef5      /*!< DT_GNU_HASH
                                   (see source code, for example:
-                                  https://sourceware.org/git/?p=binutils-gdb.git;a=blob;f=include/elf/common.h;h=efb7ff0de05155604c162e5af4e59222ab7f9061;hb=refs/heads/master) */
+                                  https://sourceware.org/git/?p=binutils-gdb.git;a=blob;f=include/elf/common.h;h=efb7ff0de05155604c162e5af4e59222ab7f9061;hb=refs/heads/master) */,
+    Config = 0x6ffffefa,      /*!< DT_CONFIG: string table offset to get the configuration file name */
+    DepAudit = 0x6ffffefb,    /*!< DT_DEPAUDIT: string table offset to get the dependency audit library */
+    Audit = 0x6ffffefc,       /*!< DT_AUDIT: string table offset to get the audit library */
+    RelaCount = 0x6ffffff9,   /*!< DT_RELACOUNT: count of relative relocations at the start of the DT_RELA table */
+    RelCount = 0x6ffffffa,    /*!< DT_RELCOUNT: count of relative relocations at the start of the DT_REL table */
+    Flags1 = 0x6ffffffb,      /*!< DT_FLAGS_1: GNU extension flags (DF_1_NOW, ...) */
+    VersionDefinitionCount = 0x6ffffffd, /*!< DT_VERDEFNUM: count of entries in the .gnu.version_d section */
+    VersionNeed = 0x6ffffffe, /*!< DT_VERNEED: address of the .gnu.version_r section */
+    VersionNeedCount = 0x6fffffff, /*!< DT_VERNEEDNUM: count of entries in the .gnu.version_r section */
+    Auxiliary = 0x7ffffffd,   /*!< DT_AUXILIARY: string table offset to get the name of a auxiliary filtee */
+    Filter = 0x7fffffff       /*!< DT_FILTER: string table offset to get the name of a filtee */
   };
 
   /*! \internal
@@ -168,6 +192,8 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
           return DynamicSectionTagType::Null;
         case 1:
           return DynamicSectionTagType::Needed;
+        case 2:
+          return DynamicSectionTagType::PltRelocationTableSize;
         case 3:
           return DynamicSectionTagType::PltGot;
         case 4:
@@ -196,12 +222,50 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
           return DynamicSectionTagType::RPath;
         case 16:
           return DynamicSectionTagType::Symbolic;
+        case 17:
+          return DynamicSectionTagType::RelTable;
+        case 18:
+          return DynamicSectionTagType::RelTableSize;
+        case 19:
+          return DynamicSectionTagType::RelEntrySize;
         case 21:
           return DynamicSectionTagType::Debug;
+        case 23:
+          return DynamicSectionTagType::JmpRel;
         case 29:
           return DynamicSectionTagType::Runpath;
+        case 30:
+          return DynamicSectionTagType::Flags;
+        case 35:
+          return DynamicSectionTagType::RelrTableSize;
+        case 36:
+          return DynamicSectionTagType::RelrTable;
+        case 37:
+          return DynamicSectionTagType::RelrEntrySize;
         case 0x6ffffef5:
           return DynamicSectionTagType::GnuHash;
+        case 0x6ffffefa:
+          return DynamicSectionTagType::Config;
+        case 0x6ffffefb:
+          return DynamicSectionTagType::DepAudit;
+        case 0x6ffffefc:
+          return DynamicSectionTagType::Audit;
+        case 0x6ffffff9:
+          return DynamicSectionTagType::RelaCount;
+        case 0x6ffffffa:
+          return DynamicSectionTagType::RelCount;
+        case 0x6ffffffb:
+          return DynamicSectionTagType::Flags1;
+        case 0x6ffffffd:
+          return DynamicSectionTagType::VersionDefinitionCount;
+        case 0x6ffffffe:
+          return DynamicSectionTagType::VersionNeed;
+        case 0x6fffffff:
+          return DynamicSectionTagType::VersionNeedCount;
+        case 0x7ffffffd:
+          return DynamicSectionTagType::Auxiliary;
+        case 0x7fffffff:
+          return DynamicSectionTagType::Filter;
       }
 
       return DynamicSectionTagType::Unknown;
@@ -221,6 +285,11 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         case DynamicSectionTagType::SoName:
         case DynamicSectionTagType::RPath:
         case DynamicSectionTagType::Runpath:
+        case DynamicSectionTagType::Config:
+        case DynamicSectionTagType::DepAudit:
+        case DynamicSectionTagType::Audit:
+        case DynamicSectionTagType::Auxiliary:
+        case DynamicSectionTagType::Filter:
           return true;
         default:
           break;
@@ -336,6 +405,46 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       updateStringTableSizeEntry();
     }
 
+    /*! \brief Get the index to the string table of each entry that refers to it
+     *
+     * \sa DynamicStruct::isIndexToStrTab()
+     */
+    std::vector<uint64_t> stringTableIndexes() const
+    {
+      std::vector<uint64_t> indexes;
+
+      for(const DynamicStruct & s : mSection){
+        if( s.isIndexToStrTab() ){
+          indexes.push_back(s.val_or_ptr);
+        }
+      }
+
+      return indexes;
+    }
+
+    /*! \brief Replace the string table of this section
+     *
+     * Each entry that refers to the string table
+     * gets the index \a indexMap gives for its current index.
+     *
+     * \pre \a stringTable must not be empty
+     * \pre \a indexMap must contain the index of each entry that refers to the string table
+     * \pre this section must have the DT_STRSZ entry
+     * \sa stringTableIndexes()
+     */
+    void setStringTable(const StringTable & stringTable, const StringTableIndexMap & indexMap) noexcept
+    {
+      assert( !stringTable.isEmpty() );
+
+      for(DynamicStruct & s : mSection){
+        if( s.isIndexToStrTab() ){
+          s.val_or_ptr = indexMap.newIndexForOldIndex(s.val_or_ptr);
+        }
+      }
+
+      setStringTable(stringTable);
+    }
+
     /*! \brief Access the string table of this section
      *
      * Accessing the string table directly is not recommanded.
@@ -397,6 +506,23 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return it->val_or_ptr;
     }
 
+    /*! \brief Check if \a index is the start of a string in the string table
+     *
+     * Linkers can merge a string that is the tail of a other one,
+     * in which case \a index points to the middle of that other string.
+     * Such a string can not be edited in place.
+     *
+     * Returns false for the index 0 (the empty string) and for a invalid index.
+     */
+    bool isStartOfString(uint64_t index) const noexcept
+    {
+      if( (index == 0) || !mStringTable.indexIsValid(index) ){
+        return false;
+      }
+
+      return *(mStringTable.cbegin() + static_cast<int64_t>(index) - 1) == '\0';
+    }
+
     /*! \brief Get the SO name (DT_SONAME)
      *
      * Returns a empty string if this section
@@ -421,6 +547,60 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mStringTable.unicodeStringAtIndex(it->val_or_ptr);
     }
 
+    /*! \brief Get a view to the SO name (DT_SONAME)
+     *
+     * Same as getSoName(), but returns the UTF-8 string
+     * directly from the string table, without any conversion.
+     * The returned view is invalidated when this section is modified or destroyed.
+     *
+     * \pre this section must not be null
+     * \exception ExecutableFileReadError
+     */
+    std::string_view soNameView() const
+    {
+      assert( !isNull() );
+
+      const auto it = findEntryForTag(DynamicSectionTagType::SoName);
+      if( it == mSection.cend() ){
+        return std::string_view();
+      }
+      assert( it->tagType() == DynamicSectionTagType::SoName );
+
+      DynamicSectionValidator::validateStringTableIndex(*it, mStringTable);
+
+      return mStringTable.stringViewAtIndex(it->val_or_ptr);
+    }
+
+    /*! \brief Call \a visitor for each needed shared library (DT_NEEDED)
+     *
+     * \a visitor is called with a std::string_view
+     * that refers to the UTF-8 string in the string table,
+     * in the order of the DT_NEEDED entries.
+     * Unlike getNeededSharedLibraries(), no string or list is allocated.
+     *
+     * Example:
+     * \code
+     * section.forEachNeeded([](std::string_view library){
+     *   crawler.visit(library);
+     * });
+     * \endcode
+     *
+     * \pre this section must not be null
+     * \exception ExecutableFileReadError
+     */
+    template<typename Visitor>
+    void forEachNeeded(Visitor visitor) const
+    {
+      assert( !isNull() );
+
+      for(const DynamicStruct & s : mSection){
+        if(s.tagType() == DynamicSectionTagType::Needed){
+          DynamicSectionValidator::validateStringTableIndex(s, mStringTable);
+          visitor( mStringTable.stringViewAtIndex(s.val_or_ptr) );
+        }
+      }
+    }
+
     /*! \brief Get the needed shared libraries (DT_NEEDED)
      *
      * Returns a empty list if this section
@@ -478,6 +658,59 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mStringTable.unicodeStringAtIndex(it->val_or_ptr);
     }
 
+    /*! \brief Get a view to the run path (DT_RUNPATH)
+     *
+     * Same as getRunPath(), but returns the UTF-8 string
+     * directly from the string table, without any conversion.
+     * The returned view is invalidated when this section is modified or destroyed.
+     *
+     * \pre this section must not be null
+     * \exception ExecutableFileReadError
+     */
+    std::string_view runPathView() const
+    {
+      assert( !isNull() );
+
+      const auto it = findRunPathEntry();
+      if( it == mSection.cend() ){
+        return std::string_view();
+      }
+      assert( it->tagType() == DynamicSectionTagType::Runpath );
+
+      DynamicSectionValidator::validateStringTableIndex(*it, mStringTable);
+
+      return mStringTable.stringViewAtIndex(it->val_or_ptr);
+    }
+
+    /*! \brief Call \a visitor for each entry of the run path (DT_RUNPATH)
+     *
+     * The run path is split on ':' and \a visitor is called
+     * with a std::string_view for each non empty entry, as is
+     * (for example, $ORIGIN is not expanded).
+     *
+     * \pre this section must not be null
+     * \exception ExecutableFileReadError
+     * \sa RPathElf::rPathFromString()
+     */
+    template<typename Visitor>
+    void forEachRunPathEntry(Visitor visitor) const
+    {
+      assert( !isNull() );
+
+      std::string_view runPath = runPathView();
+      while( !runPath.empty() ){
+        const auto separatorPos = runPath.find(':');
+        const std::string_view entry = runPath.substr(0, separatorPos);
+        if( !entry.empty() ){
+          visitor(entry);
+        }
+        if(separatorPos == std::string_view::npos){
+          break;
+        }
+        runPath.remove_prefix(separatorPos + 1);
+      }
+    }
+
     /*! \brief Add the run path entry to this table (DT_RUNPATH)
      *
      * The new entry will be added before the null entries
@@ -500,6 +733,12 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
      * If \a runPath is a empty string,
      * the run path entry will be removed.
      *
+     * The current run path string is replaced in the string table,
+     * and the other entries are updated in a single pass (see StringTableEditor).
+     * If this string is shared with a other entry
+     * (or is the tail of a other string),
+     * the new run path is appended to the string table instead.
+     *
      * \pre this section must not be null
      * \sa removeRunPath()
      * \pre this section must have the DT_STRSZ entry
@@ -513,11 +752,14 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         return;
       }
 
-      const auto it = findRunPathEntry();
+      const auto it = findMutableRunPathEntry();
 
-      if( it != mSection.cend() ){
-        const int64_t offset = mStringTable.setUnicodeStringAtIndex(it->val_or_ptr, runPath);
-        shiftEntriesIndexingStrTabAfter(*it, offset);
+      if( (it != mSection.end()) && isStartOfString(it->val_or_ptr) && (countOfEntriesReferencingStringAt(it->val_or_ptr) == 1) ){
+        StringTableEditor editor(mStringTable);
+        editor.setStringAtIndex( it->val_or_ptr, runPath.toStdString() );
+        commitStringTableEdits(editor);
+      }else if( it != mSection.end() ){
+        it->val_or_ptr = mStringTable.appendUnicodeString(runPath);
       }else{
         DynamicStruct runPathEntry(DynamicSectionTagType::Runpath);
         runPathEntry.val_or_ptr = mStringTable.appendUnicodeString(runPath);
@@ -528,6 +770,9 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
 
     /*! \brief Remove the run path (DT_RUNPATH) entry
+     *
+     * The run path string is also removed from the string table,
+     * unless it is used by a other entry.
      *
      * \pre this section must not be null
      * \pre this section must have the DT_STRSZ entry
@@ -542,13 +787,215 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         return;
       }
 
-      const int64_t offset = mStringTable.removeStringAtIndex(it->val_or_ptr);
-      shiftEntriesIndexingStrTabAfter(*it, offset);
+      const DynamicStruct runPathEntry = *it;
+      mSection.erase(it);
+      indexKnownEnties();
+
+      if( isStartOfString(runPathEntry.val_or_ptr) && (countOfEntriesReferencingStringAt(runPathEntry.val_or_ptr) == 0) ){
+        StringTableEditor editor(mStringTable);
+        editor.removeStringAtIndex(runPathEntry.val_or_ptr);
+        commitStringTableEdits(editor);
+      }
+
+      updateStringTableSizeEntry();
+    }
+
+    /*! \brief Set the SO name (DT_SONAME)
+     *
+     * If \a soName is a empty string,
+     * the DT_SONAME entry will be removed.
+     *
+     * The new name is appended to the string table,
+     * the old one is left in place.
+     * This way, no other index to the string table
+     * (for example from the dynamic symbol table) is changed.
+     *
+     * \pre this section must not be null
+     * \pre this section must have the DT_STRSZ entry
+     */
+    void setSoName(const QString & soName)
+    {
+      assert( !isNull() );
+
+      const auto it = findMutableEntryForTag(DynamicSectionTagType::SoName);
+
+      if( soName.trimmed().isEmpty() ){
+        if( it != mSection.end() ){
+          mSection.erase(it);
+          indexKnownEnties();
+        }
+        return;
+      }
+
+      if( it != mSection.end() ){
+        if( mStringTable.indexIsValid(it->val_or_ptr) && (mStringTable.unicodeStringAtIndex(it->val_or_ptr) == soName) ){
+          return;
+        }
+        it->val_or_ptr = mStringTable.appendUnicodeString(soName);
+      }else{
+        DynamicStruct soNameEntry(DynamicSectionTagType::SoName);
+        soNameEntry.val_or_ptr = mStringTable.appendUnicodeString(soName);
+        insertEntryBeforeNull(soNameEntry);
+      }
+
+      updateStringTableSizeEntry();
+    }
+
+    /*! \brief Check if this section contains a DT_NEEDED entry for \a library
+     */
+    bool containsNeededSharedLibrary(const QString & library) const
+    {
+      return findNeededEntry(library) != mSection.cend();
+    }
+
+    /*! \brief Add a needed shared library (DT_NEEDED)
+     *
+     * The new entry is added after the last DT_NEEDED entry,
+     * so that the search order of the existing libraries is preserved.
+     * Does nothing if \a library is already needed.
+     *
+     * \pre this section must not be null
+     * \pre \a library must not be empty
+     * \pre this section must have the DT_STRSZ entry
+     */
+    void addNeededSharedLibrary(const QString & library)
+    {
+      assert( !isNull() );
+      assert( !library.trimmed().isEmpty() );
+
+      if( containsNeededSharedLibrary(library) ){
+        return;
+      }
+
+      DynamicStruct neededEntry(DynamicSectionTagType::Needed);
+      neededEntry.val_or_ptr = mStringTable.appendUnicodeString(library);
+
+      const auto isNeeded = [](DynamicStruct s){
+        return s.tagType() == DynamicSectionTagType::Needed;
+      };
+      const auto lastNeeded = std::find_if(mSection.crbegin(), mSection.crend(), isNeeded);
+      if( lastNeeded != mSection.crend() ){
+        mSection.insert(lastNeeded.base(), neededEntry);
+        indexKnownEnties();
+      }else{
+        insertEntryBeforeNull(neededEntry);
+      }
+
+      updateStringTableSizeEntry();
+    }
+
+    /*! \brief Remove the needed shared library \a library (DT_NEEDED)
+     *
+     * Does nothing if \a library is not needed.
+     * Its name is left in the string table.
+     *
+     * \pre this section must not be null
+     */
+    void removeNeededSharedLibrary(const QString & library)
+    {
+      assert( !isNull() );
+
+      const auto it = findNeededEntry(library);
+      if( it == mSection.cend() ){
+        return;
+      }
 
       mSection.erase(it);
       indexKnownEnties();
+    }
+
+    /*! \brief Replace the needed shared library \a library with \a newLibrary (DT_NEEDED)
+     *
+     * The position of the DT_NEEDED entry is preserved.
+     * Does nothing if \a library is not needed.
+     *
+     * \pre this section must not be null
+     * \pre \a newLibrary must not be empty
+     * \pre this section must have the DT_STRSZ entry
+     */
+    void replaceNeededSharedLibrary(const QString & library, const QString & newLibrary)
+    {
+      assert( !isNull() );
+      assert( !newLibrary.trimmed().isEmpty() );
+
+      const auto it = findNeededEntry(library);
+      if( it == mSection.cend() ){
+        return;
+      }
+      if(newLibrary == library){
+        return;
+      }
+      if( containsNeededSharedLibrary(newLibrary) ){
+        removeNeededSharedLibrary(library);
+        return;
+      }
+
+      const auto index = it - mSection.cbegin();
+      mSection[static_cast<size_t>(index)].val_or_ptr = mStringTable.appendUnicodeString(newLibrary);
+
+      updateStringTableSizeEntry();
+    }
 
+    /*! \brief Add \a str to the end of the string table (.dynstr)
+     *
+     * This is used for strings referenced outside this section,
+     * like the version names of the .gnu.version_r section.
+     * Returns the index of \a str in the string table.
+     *
+     * \pre this section must not be null
+     * \pre \a str must not be empty
+     * \pre this section must have the DT_STRSZ entry
+     */
+    uint64_t addStringToStringTable(const std::string & str)
+    {
+      assert( !isNull() );
+      assert( !str.empty() );
+
+      const uint64_t index = mStringTable.appendString(str);
       updateStringTableSizeEntry();
+
+      return index;
+    }
+
+    /*! \brief Set the value of the \a tag entry
+     *
+     * This is used for entries that holds flags,
+     * like DT_FLAGS or DT_FLAGS_1 .
+     * If the entry does not exist, it is added.
+     *
+     * \pre \a tag must not be a index to the string table
+     * \pre this section must not be null
+     */
+    void setValueForTag(DynamicSectionTagType tag, uint64_t value)
+    {
+      assert( !isNull() );
+      assert( !DynamicStruct(tag).isIndexToStrTab() );
+      assert( tag != DynamicSectionTagType::Null );
+      assert( tag != DynamicSectionTagType::Unknown );
+
+      const auto it = findMutableEntryForTag(tag);
+      if( it != mSection.end() ){
+        it->val_or_ptr = value;
+        return;
+      }
+
+      DynamicStruct entry(tag);
+      entry.val_or_ptr = value;
+      insertEntryBeforeNull(entry);
+    }
+
+    /*! \brief Get the value of the \a tag entry
+     *
+     * Returns 0 if this section does not contain the \a tag entry
+     */
+    uint64_t valueForTag(DynamicSectionTagType tag) const noexcept
+    {
+      const auto it = findEntryForTag(tag);
+      if( it == mSection.cend() ){
+        return 0;
+      }
+
+      return it->val_or_ptr;
     }
 
     /*! \brief Check if this dynamic section contains the address to the GNU hash table (DT_GNU_HASH)
@@ -648,8 +1095,49 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return std::find_if(mSection.cbegin(), mSection.cend(), isRunPathEntry);
     }
 
+    iterator findMutableRunPathEntry() noexcept
+    {
+      return std::find_if(mSection.begin(), mSection.end(), isRunPathEntry);
+    }
+
+    const_iterator findNeededEntry(const QString & library) const
+    {
+      const auto pred = [this,&library](DynamicStruct s){
+        if( s.tagType() != DynamicSectionTagType::Needed ){
+          return false;
+        }
+        if( !mStringTable.indexIsValid(s.val_or_ptr) ){
+          return false;
+        }
+        return mStringTable.unicodeStringAtIndex(s.val_or_ptr) == library;
+      };
+
+      return std::find_if(mSection.cbegin(), mSection.cend(), pred);
+    }
+
+    void insertEntryBeforeNull(DynamicStruct entry)
+    {
+      const auto it = findEntryForTag(DynamicSectionTagType::Null);
+      mSection.insert(it, entry);
+      indexKnownEnties();
+    }
+
+    /*
+     * Count the entries that refer to the string at index,
+     * or to the middle of it
+     */
+    int countOfEntriesReferencingStringAt(uint64_t index) const noexcept
+    {
+      assert( mStringTable.indexIsValid(index) );
+
+      const uint64_t end = index + mStringTable.stringViewAtIndex(index).size();
+      const auto pred = [index,end](DynamicStruct s){
+        return s.isIndexToStrTab() && (s.val_or_ptr >= index) && (s.val_or_ptr <= end);
+      };
+
+      return static_cast<int>( std::count_if(mSection.cbegin(), mSection.cend(), pred) );
+    }
 
-    /// \todo use OffsetChange
     /*
      * Initial:
      * string table: \0/tmp\0libA.so\0
@@ -658,32 +1146,21 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
      * After:
      * string table: \0/path1\0libA.so\0
      * indexes: 1,8
+     *
+     * Each entry that refers to a removed string
+     * must have been removed before.
      */
-    void shiftEntriesIndexingStrTabAfter(DynamicStruct ref, int64_t offset) noexcept
+    void commitStringTableEdits(StringTableEditor & editor)
     {
-      assert( ref.isIndexToStrTab() );
+      StringTable stringTable = editor.commit();
 
-      const uint64_t absOffset = static_cast<uint64_t>( std::abs(offset) );
-
-      if(offset < 0){
-        for(auto & s : mSection){
-          if(s.isIndexToStrTab() && s.val_or_ptr > ref.val_or_ptr){
-            s.val_or_ptr -= absOffset;
-          }
-        }
-      }else{
-        for(auto & s : mSection){
-          if(s.isIndexToStrTab() && s.val_or_ptr > ref.val_or_ptr){
-            s.val_or_ptr += absOffset;
-          }
+      for(DynamicStruct & s : mSection){
+        if( s.isIndexToStrTab() && mStringTable.indexIsValid(s.val_or_ptr) ){
+          s.val_or_ptr = editor.newIndexForOldIndex(s.val_or_ptr);
         }
       }
 
-//       for(auto & s : mSection){
-//         if(s.isIndexToStrTab() && s.val_or_ptr > ref.val_or_ptr){
-//           s.val_or_ptr += offset;
-//         }
-//       }
+      mStringTable = std::move(stringTable);
     }
 
     void updateStringTableSizeEntry() noexcept
@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_DYNAMIC_STRING_TABLE_REFERENCES_H
+#define MDT_EXECUTABLE_FILE_ELF_DYNAMIC_STRING_TABLE_REFERENCES_H
+
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <QString>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal A index to the dynamic string table (.dynstr) stored outside the dynamic section
+   *
+   * \a offsetInSection is the offset, from the start of the section of type \a sectionType ,
+   * of the 32-bit word that holds \a index
+   * (like the st_name of a .dynsym entry).
+   */
+  struct DynamicStringTableReference
+  {
+    SectionType sectionType = SectionType::Null;
+    uint64_t offsetInSection = 0;
+    uint64_t index = 0;
+  };
+
+  /*! \internal Add the location of the name of each entry of \a symbolTableHeader
+   *
+   * \pre \a symbolTableHeader must be a dynamic symbol table
+   * \exception ExecutableFileReadError
+   */
+  inline
+  void addDynamicSymbolNameReferenceLocations(std::vector<DynamicStringTableReference> & references, const ByteArraySpan & map,
+                                              const FileHeader & fileHeader, const SectionHeader & symbolTableHeader)
+  {
+    assert( symbolTableHeader.sectionType() == SectionType::DynSym );
+
+    const uint64_t entrySize = fileHeader.ident._class == Class::Class32 ? 16 : 24;
+    if( map.size < symbolTableHeader.minimumSizeToReadSection() ){
+      const QString msg = tr("file is to small to read the .dynsym section");
+      throw ExecutableFileReadError(msg);
+    }
+
+    const uint64_t count = symbolTableHeader.size / entrySize;
+    references.reserve( references.size() + static_cast<std::size_t>(count) );
+    for(uint64_t i = 0; i < count; ++i){
+      // st_name is the first member for both 32 and 64-bit files
+      DynamicStringTableReference reference;
+      reference.sectionType = SectionType::DynSym;
+      reference.offsetInSection = i * entrySize;
+      reference.index = getWord(map.data + symbolTableHeader.offset + reference.offsetInSection, fileHeader.ident.dataFormat);
+      references.push_back(reference);
+    }
+  }
+
+  /*! \internal Add the location of each name referenced from a symbol version section
+   *
+   * Walks the Elf_Verdef/Elf_Verdaux or the Elf_Verneed/Elf_Vernaux chains.
+   * Their layout is the same for 32 and 64-bit files.
+   *
+   * \pre \a header must be a GnuVersionDef or a GnuVersionNeed section header
+   * \exception ExecutableFileReadError
+   */
+  inline
+  void addSymbolVersionNameReferenceLocations(std::vector<DynamicStringTableReference> & references, const ByteArraySpan & map,
+                                              const FileHeader & fileHeader, const SectionHeader & header)
+  {
+    assert( (header.sectionType() == SectionType::GnuVersionDef) || (header.sectionType() == SectionType::GnuVersionNeed) );
+
+    const DataFormat dataFormat = fileHeader.ident.dataFormat;
+    const SectionType sectionType = header.sectionType();
+    const bool isVerdef = sectionType == SectionType::GnuVersionDef;
+
+    if( map.size < header.minimumSizeToReadSection() ){
+      const QString msg = tr("file is to small to read a symbol version section");
+      throw ExecutableFileReadError(msg);
+    }
+
+    const auto throwCorrupted = [](){
+      const QString msg = tr("a symbol version section is corrupted");
+      throw ExecutableFileReadError(msg);
+    };
+
+    const auto addReference = [&references,&map,&header,dataFormat,sectionType](uint64_t offsetInSection){
+      DynamicStringTableReference reference;
+      reference.sectionType = sectionType;
+      reference.offsetInSection = offsetInSection;
+      reference.index = getWord(map.data + header.offset + offsetInSection, dataFormat);
+      references.push_back(reference);
+    };
+
+    // sizeof(Elf_Verdef) is 20, sizeof(Elf_Verneed) is 16
+    const uint64_t entrySize = isVerdef ? 20 : 16;
+    const uint64_t sectionEnd = header.size;
+    uint64_t offset = 0;
+    // sh_info holds the count of entries
+    for(uint64_t i = 0; i < header.info; ++i){
+      if( (offset + entrySize) > sectionEnd ){
+        throwCorrupted();
+      }
+      const unsigned char *entry = map.data + header.offset + offset;
+      const uint16_t auxCount = getHalfWord(entry + (isVerdef ? 6 : 2), dataFormat);
+      if(!isVerdef){
+        addReference(offset + 4); // vn_file
+      }
+
+      uint64_t auxOffset = offset + (isVerdef ? getWord(entry + 12, dataFormat) : getWord(entry + 8, dataFormat));
+      for(uint16_t j = 0; j < auxCount; ++j){
+        const uint64_t auxSize = isVerdef ? 8 : 16;
+        if( (auxOffset + auxSize) > sectionEnd ){
+          throwCorrupted();
+        }
+        const unsigned char *aux = map.data + header.offset + auxOffset;
+        addReference( auxOffset + (isVerdef ? 0 : 8) ); // vda_name or vna_name
+        const uint32_t next = getWord(aux + (isVerdef ? 4 : 12), dataFormat);
+        if(next == 0){
+          break;
+        }
+        auxOffset += next;
+      }
+
+      const uint32_t next = getWord(entry + (isVerdef ? 16 : 12), dataFormat);
+      if(next == 0){
+        break;
+      }
+      offset += next;
+    }
+  }
+
+  /*! \internal Get the location of each string referenced in the dynamic string table, outside the dynamic section
+   *
+   * Collects the names of the dynamic symbols
+   * and the names used by the symbol versioning sections
+   * that are linked to the section at \a dynamicStringTableSectionIndex .
+   * The references are in the order of the sections, then of their entries.
+   *
+   * \exception ExecutableFileReadError
+   */
+  inline
+  std::vector<DynamicStringTableReference>
+  extractDynamicStringTableReferenceLocations(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                              const std::vector<SectionHeader> & sectionHeaderTable,
+                                              uint16_t dynamicStringTableSectionIndex)
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    std::vector<DynamicStringTableReference> references;
+
+    for(const SectionHeader & header : sectionHeaderTable){
+      if(header.link != dynamicStringTableSectionIndex){
+        continue;
+      }
+      switch( header.sectionType() ){
+        case SectionType::DynSym:
+          addDynamicSymbolNameReferenceLocations(references, map, fileHeader, header);
+          break;
+        case SectionType::GnuVersionDef:
+        case SectionType::GnuVersionNeed:
+          addSymbolVersionNameReferenceLocations(references, map, fileHeader, header);
+          break;
+        default:
+          break;
+      }
+    }
+
+    return references;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_DYNAMIC_STRING_TABLE_REFERENCES_H
@@ -72,6 +72,34 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
   };
 
+  /*! \internal
+   */
+  class /*MDT_DEPLOYUTILSCORE_EXPORT*/ RelocatableObjectReadError : public QRuntimeError
+  {
+   public:
+
+    /*! \brief Constructor
+     */
+    explicit RelocatableObjectReadError(const QString & what)
+      : QRuntimeError(what)
+    {
+    }
+  };
+
+  /*! \internal
+   */
+  class /*MDT_DEPLOYUTILSCORE_EXPORT*/ GnuVersionNeedTableReadError : public QRuntimeError
+  {
+   public:
+
+    /*! \brief Constructor
+     */
+    explicit GnuVersionNeedTableReadError(const QString & what)
+      : QRuntimeError(what)
+    {
+    }
+  };
+
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
 
 #endif // #ifndef MDT_EXECUTABLE_FILE_ELF_EXCEPTIONS_H
@@ -17,8 +17,10 @@
 #include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
 #include "Mdt/ExecutableFile/Elf/SectionIndexChangeMap.h"
 #include "Mdt/ExecutableFile/Elf/OffsetRange.h"
+#include "Mdt/ExecutableFile/Elf/StringTable.h"
 #include "Mdt/ExecutableFile/Elf/Algorithm.h"
 #include <vector>
+#include <string>
 #include <cstdint>
 #include <limits>
 #include <iterator>
@@ -171,15 +173,82 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     SectionIndexChangeMap sortSectionHeaderTableByFileOffset() noexcept
     {
       const uint64_t shtStringTableOffset = mSectionHeaderTable[mFileHeader.shstrndx].offset;
+      const std::string shtStringTableName = mSectionHeaderTable[mFileHeader.shstrndx].name;
 
       const SectionIndexChangeMap map = sortSectionHeadersByFileOffset(mSectionHeaderTable);
       indexKnownSectionHeaders();
 
-      mFileHeader.shstrndx = findIndexOfSectionHeaderAtOffset(mSectionHeaderTable, shtStringTableOffset);
+      /*
+       * A empty section, or a SHT_NOBITS one like .bss,
+       * can have the same offset than the section name string table
+       */
+      const auto isShtStringTable = [shtStringTableOffset, &shtStringTableName](const SectionHeader & header){
+        return (header.offset == shtStringTableOffset) && (header.name == shtStringTableName);
+      };
+      const auto it = std::find_if(mSectionHeaderTable.cbegin(), mSectionHeaderTable.cend(), isShtStringTable);
+      if( it == mSectionHeaderTable.cend() ){
+        mFileHeader.shstrndx = findIndexOfSectionHeaderAtOffset(mSectionHeaderTable, shtStringTableOffset);
+      }else{
+        mFileHeader.shstrndx = static_cast<uint16_t>( std::distance(mSectionHeaderTable.cbegin(), it) );
+      }
 
       return map;
     }
 
+    /*! \brief Find the index of the section header of \a type that starts at \a virtualAddress
+     *
+     * Returns sectionHeaderTable().size() if no such section header exists.
+     */
+    uint16_t findIndexOfSectionHeaderAtAddress(SectionType type, uint64_t virtualAddress) const noexcept
+    {
+      for(size_t i = 1; i < mSectionHeaderTable.size(); ++i){
+        const SectionHeader & header = mSectionHeaderTable[i];
+        if( (header.sectionType() == type) && (header.addr == virtualAddress) && header.allocatesMemory() ){
+          return static_cast<uint16_t>(i);
+        }
+      }
+
+      return static_cast<uint16_t>( mSectionHeaderTable.size() );
+    }
+
+    /*! \brief Add \a header to the end of the section header table
+     *
+     * The name of \a header is not added to the section name string table.
+     *
+     * \sa rebuildSectionNameStringTable()
+     * \sa moveSectionNameStringTableAndSectionHeaderTableToEnd()
+     */
+    void addSectionHeader(const SectionHeader & header) noexcept
+    {
+      assert( mSectionHeaderTable.size() < std::numeric_limits<uint16_t>::max() );
+
+      mSectionHeaderTable.push_back(header);
+      mFileHeader.shnum = static_cast<uint16_t>( mSectionHeaderTable.size() );
+    }
+
+    /*! \brief Set the size of the section at \a index
+     *
+     * \pre \a index must be valid
+     */
+    void setSectionSizeAt(uint16_t index, uint64_t size) noexcept
+    {
+      assert( index < mSectionHeaderTable.size() );
+
+      mSectionHeaderTable[index].size = size;
+    }
+
+    /*! \brief Move the section at \a index to \a fileOffset and \a virtualAddress
+     *
+     * \pre \a index must be valid
+     */
+    void moveSectionAt(uint16_t index, uint64_t fileOffset, uint64_t virtualAddress) noexcept
+    {
+      assert( index < mSectionHeaderTable.size() );
+
+      mSectionHeaderTable[index].addr = virtualAddress;
+      mSectionHeaderTable[index].offset = fileOffset;
+    }
+
     /*! \brief Check if the .got section header exists
      */
     bool containsGotSectionHeader() const noexcept
@@ -244,6 +313,18 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mIndexOfProgramInterpreterSectionHeader < mSectionHeaderTable.size();
     }
 
+    /*! \brief Get the index of the .interp section header
+     *
+     * \pre the .interp section header must exist
+     * \sa containsProgramInterpreterSectionHeader()
+     */
+    uint16_t programInterpreterSectionHeaderIndex() const noexcept
+    {
+      assert( containsProgramInterpreterSectionHeader() );
+
+      return static_cast<uint16_t>(mIndexOfProgramInterpreterSectionHeader);
+    }
+
     /*! \brief Get the .interp section header
      *
      * \pre the .interp interp header must exist
@@ -270,6 +351,18 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mIndexOfGnuHashTableSectionHeader < mSectionHeaderTable.size();
     }
 
+    /*! \brief Get the index of the .gnu.hash section header
+     *
+     * \pre the .gnu.hash section header must exist
+     * \sa containsGnuHashTableSectionHeader()
+     */
+    uint16_t gnuHashTableSectionHeaderIndex() const noexcept
+    {
+      assert( containsGnuHashTableSectionHeader() );
+
+      return static_cast<uint16_t>(mIndexOfGnuHashTableSectionHeader);
+    }
+
     /*! \brief Get the .gnu.hash section header
      *
      * \pre the .gnu.hash section header must exist
@@ -282,6 +375,31 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mSectionHeaderTable[mIndexOfGnuHashTableSectionHeader];
     }
 
+    /*! \brief Set the size of the .gnu.hash section
+     *
+     * \pre the .gnu.hash section header must exist
+     * \sa containsGnuHashTableSectionHeader()
+     */
+    void setGnuHashTableSize(uint64_t size) noexcept
+    {
+      assert( containsGnuHashTableSectionHeader() );
+
+      mSectionHeaderTable[mIndexOfGnuHashTableSectionHeader].size = size;
+    }
+
+    /*! \brief Move the .gnu.hash section to \a fileOffset and \a virtualAddress
+     *
+     * \pre the .gnu.hash section header must exist
+     * \sa containsGnuHashTableSectionHeader()
+     */
+    void moveGnuHashTableTo(uint64_t fileOffset, uint64_t virtualAddress) noexcept
+    {
+      assert( containsGnuHashTableSectionHeader() );
+
+      mSectionHeaderTable[mIndexOfGnuHashTableSectionHeader].addr = virtualAddress;
+      mSectionHeaderTable[mIndexOfGnuHashTableSectionHeader].offset = fileOffset;
+    }
+
     /*! \brief Get the PT_NOTE program header
      *
      * \pre the PT_NOTE program header must exist
@@ -295,13 +413,16 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
 
     /*! \brief Get the note section headers
+     *
+     * The deployment stamp note is not part of them,
+     * because it is not covered by the PT_NOTE program header.
      */
     std::vector<SectionHeader> getNoteSectionHeaders() const noexcept
     {
       std::vector<SectionHeader> noteSectionHeaders;
 
       for(const SectionHeader & header : mSectionHeaderTable){
-        if(header.sectionType() == SectionType::Note){
+        if( (header.sectionType() == SectionType::Note) && !header.isDeployStampNoteSectionHeader() ){
           noteSectionHeaders.push_back(header);
         }
       }
@@ -309,6 +430,102 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return noteSectionHeaders;
     }
 
+    /*! \brief Find the index of the deployment stamp note section header
+     *
+     * Returns the count of section headers if it does not exist.
+     */
+    uint16_t findIndexOfDeployStampNoteSectionHeader() const noexcept
+    {
+      const auto it = std::find_if(mSectionHeaderTable.cbegin(), mSectionHeaderTable.cend(), [](const SectionHeader & header){
+        return header.isDeployStampNoteSectionHeader();
+      });
+
+      return static_cast<uint16_t>( std::distance(mSectionHeaderTable.cbegin(), it) );
+    }
+
+    /*! \brief Check if the deployment stamp note section header exists
+     */
+    bool containsDeployStampNoteSectionHeader() const noexcept
+    {
+      return findIndexOfDeployStampNoteSectionHeader() < mSectionHeaderTable.size();
+    }
+
+    /*! \brief Find the index of the PT_NOTE program header that covers the deployment stamp note
+     *
+     * Returns the count of program headers if it does not exist.
+     *
+     * \sa ProgramHeader::isNoteOnlyInFile()
+     */
+    size_t findIndexOfDeployStampNoteProgramHeader() const noexcept
+    {
+      const uint16_t sectionIndex = findIndexOfDeployStampNoteSectionHeader();
+      if( sectionIndex >= mSectionHeaderTable.size() ){
+        return mProgramHeaderTable.headerCount();
+      }
+      const uint64_t offset = mSectionHeaderTable[sectionIndex].offset;
+
+      for(size_t i = 0; i < mProgramHeaderTable.headerCount(); ++i){
+        const ProgramHeader & header = mProgramHeaderTable.headerAt(i);
+        if( header.isNoteOnlyInFile() && (header.offset == offset) ){
+          return i;
+        }
+      }
+
+      return mProgramHeaderTable.headerCount();
+    }
+
+    /*! \brief Find the index of the .gnu_debuglink section header
+     *
+     * Returns the count of section headers if it does not exist.
+     */
+    uint16_t findIndexOfGnuDebugLinkSectionHeader() const noexcept
+    {
+      const auto it = std::find_if(mSectionHeaderTable.cbegin(), mSectionHeaderTable.cend(), [](const SectionHeader & header){
+        return header.isGnuDebugLinkSectionHeader();
+      });
+
+      return static_cast<uint16_t>( std::distance(mSectionHeaderTable.cbegin(), it) );
+    }
+
+    /*! \brief Check if the .gnu_debuglink section header exists
+     */
+    bool containsGnuDebugLinkSectionHeader() const noexcept
+    {
+      return findIndexOfGnuDebugLinkSectionHeader() < mSectionHeaderTable.size();
+    }
+
+    /*! \brief Get the .gnu_debuglink section header
+     *
+     * \pre the .gnu_debuglink section header must exist
+     * \sa containsGnuDebugLinkSectionHeader()
+     */
+    const SectionHeader & gnuDebugLinkSectionHeader() const noexcept
+    {
+      assert( containsGnuDebugLinkSectionHeader() );
+
+      return mSectionHeaderTable[findIndexOfGnuDebugLinkSectionHeader()];
+    }
+
+    /*! \brief Set the size of the deployment stamp note
+     *
+     * The PT_NOTE program header that covers it, if any, is also updated.
+     *
+     * \pre the deployment stamp note section header must exist
+     * \sa containsDeployStampNoteSectionHeader()
+     * \pre \a size must be > 0
+     */
+    void setDeployStampNoteSize(uint64_t size) noexcept
+    {
+      assert( containsDeployStampNoteSectionHeader() );
+      assert( size > 0 );
+
+      const size_t programHeaderIndex = findIndexOfDeployStampNoteProgramHeader();
+      mSectionHeaderTable[findIndexOfDeployStampNoteSectionHeader()].size = size;
+      if( programHeaderIndex < mProgramHeaderTable.headerCount() ){
+        mProgramHeaderTable.setFileOffsetAndFileSizeAt(programHeaderIndex, mProgramHeaderTable.headerAt(programHeaderIndex).offset, size);
+      }
+    }
+
     /*! \brief Check if the PT_GNU_RELRO program header exists
      */
     bool containsGnuRelRoProgramHeader() const noexcept
@@ -556,14 +773,51 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mSectionHeaderTable[mIndexOfDynamicStringTableSectionHeader].offset = fileOffset;
     }
 
+    /*! \brief Move the dynamic section to \a fileOffset and \a virtualAddress
+     *
+     * The PT_DYNAMIC segment is also updated.
+     *
+     * \pre the dynamic program header must exist
+     * \sa containsDynamicProgramHeader()
+     * \pre the dynamic section header must exist
+     * \sa containsDynamicSectionHeader()
+     */
+    void moveDynamicSectionTo(uint64_t fileOffset, uint64_t virtualAddress) noexcept
+    {
+      assert( containsDynamicProgramHeader() );
+      assert( containsDynamicSectionHeader() );
+
+      mProgramHeaderTable.setDynamicSectionVirtualAddressAndFileOffset(virtualAddress, fileOffset);
+      mSectionHeaderTable[mIndexOfDynamicSectionHeader].addr = virtualAddress;
+      mSectionHeaderTable[mIndexOfDynamicSectionHeader].offset = fileOffset;
+    }
+
+    /*! \brief Move the dynamic string table to \a fileOffset and \a virtualAddress
+     *
+     * \pre the dynamic string table section header must exist
+     * \sa containsDynamicStringTableSectionHeader()
+     */
+    void moveDynamicStringTableTo(uint64_t fileOffset, uint64_t virtualAddress) noexcept
+    {
+      assert( containsDynamicStringTableSectionHeader() );
+
+      mSectionHeaderTable[mIndexOfDynamicStringTableSectionHeader].addr = virtualAddress;
+      mSectionHeaderTable[mIndexOfDynamicStringTableSectionHeader].offset = fileOffset;
+    }
+
     /*! \brief Move the program header table to the end
      *
      * The virtual address of the program header table
      * will be aligned to the next page past the end.
      * Its file offset will also be updated.
      *
+     * If the program header table program header (PT_PHDR) exists,
+     * it is also updated.
+     * A shared library often has none:
+     * the dynamic linker then finds the table in the PT_LOAD segment that covers it.
+     *
      * \pre the file header must be valid
-     * \pre the program header table, and also its related segment, must exist
+     * \pre the program header table must exist
      * \sa containsProgramHeaderTable()
      * \sa containsProgramHeaderTableProgramHeader()
      */
@@ -571,7 +825,6 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     {
       assert( fileHeaderSeemsValid() );
       assert( containsProgramHeaderTable() );
-      assert( containsProgramHeaderTableProgramHeader() );
 
       /// \todo check if this should be as the other PT_LOAD ? f.ex. 0x200000 maybe a argument ??
 //       const uint64_t pageSize = 0x200000;
@@ -595,10 +848,28 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
        */
       const uint64_t fileOffset = virtualAddess;
 
-      mProgramHeaderTable.setProgramHeaderTableHeaderVirtualAddressAndFileOffset(virtualAddess, fileOffset);
+      if( containsProgramHeaderTableProgramHeader() ){
+        mProgramHeaderTable.setProgramHeaderTableHeaderVirtualAddressAndFileOffset(virtualAddess, fileOffset);
+      }
       mFileHeader.phoff = fileOffset;
     }
 
+    /*! \brief Set the size of the program interpreter section
+     *
+     * Both the .interp section header and the PT_INTERP program header are updated.
+     *
+     * \pre the .interp section header must exist
+     * \pre the PT_INTERP programe header must exist
+     */
+    void setProgramInterpreterSectionSize(uint64_t size) noexcept
+    {
+      assert( containsProgramInterpreterSectionHeader() );
+      assert( containsProgramInterpreterProgramHeader() );
+
+      mProgramHeaderTable.setProgramInterpreterSize(size);
+      mSectionHeaderTable[mIndexOfProgramInterpreterSectionHeader].size = size;
+    }
+
     /*! \brief Move the program interpreter section to the end
      *
      * \pre the file header must be valid
@@ -625,6 +896,234 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mProgramHeaderTable.setProgramInterpreterHeaderVirtualAddressAndFileOffset(virtualAddess, fileOffset);
     }
 
+    /*! \brief Move the program interpreter section to \a fileOffset and \a virtualAddress
+     *
+     * The PT_INTERP segment is also updated.
+     *
+     * \pre the program interpreter section header and program header must exist
+     */
+    void moveProgramInterpreterSectionTo(uint64_t fileOffset, uint64_t virtualAddress) noexcept
+    {
+      assert( containsProgramInterpreterSectionHeader() );
+      assert( containsProgramInterpreterProgramHeader() );
+
+      mSectionHeaderTable[mIndexOfProgramInterpreterSectionHeader].addr = virtualAddress;
+      mSectionHeaderTable[mIndexOfProgramInterpreterSectionHeader].offset = fileOffset;
+
+      mProgramHeaderTable.setProgramInterpreterHeaderVirtualAddressAndFileOffset(virtualAddress, fileOffset);
+    }
+
+    /*! \brief Find the PT_LOAD segment that can be extended to cover sections moved to the end
+     *
+     * This is the PT_LOAD segment with the highest virtual address, if:
+     * - nothing is mapped after it
+     * - it is entirely backed by the file (no .bss like part)
+     * - it grants \a permissions , and at most also write permission
+     *   (a segment added by a previous edit is writable if it covers the dynamic section,
+     *   and can also hold read only sections)
+     * - less than a page of unrelated data lies between its end and the end of the file
+     *   (this data would also be mapped)
+     *
+     * Returns the index in the program header table,
+     * or the count of program headers if no such segment exists.
+     *
+     * \pre the file header must be valid
+     */
+    size_t findIndexOfExtensibleLastLoadProgramHeader(SegmentPermissions permissions) const noexcept
+    {
+      assert( fileHeaderSeemsValid() );
+
+      const size_t count = mProgramHeaderTable.headerCount();
+      const uint64_t pageSize = mFileHeader.pageSize();
+      if(pageSize == 0){
+        return count;
+      }
+
+      size_t index = count;
+      for(size_t i = 0; i < count; ++i){
+        const ProgramHeader & header = mProgramHeaderTable.headerAt(i);
+        if( header.segmentType() != SegmentType::Load ){
+          continue;
+        }
+        if( (index == count) || (header.vaddr > mProgramHeaderTable.headerAt(index).vaddr) ){
+          index = i;
+        }
+      }
+      if(index == count){
+        return count;
+      }
+
+      const ProgramHeader & header = mProgramHeaderTable.headerAt(index);
+      constexpr uint32_t permissionsMask = 0x07;
+      const uint32_t requiredFlags = permissions.toRawFlags();
+      const uint32_t allowedFlags = requiredFlags | SegmentPermissions(SegmentPermission::Write).toRawFlags();
+      const uint32_t flags = header.flags & permissionsMask;
+      if( ( (flags & requiredFlags) != requiredFlags ) || ( (flags & ~allowedFlags) != 0 ) ){
+        return count;
+      }
+      if(header.memsz != header.filesz){
+        return count;
+      }
+      /*
+       * The allocated sections are covered by segments.
+       * Their sizes could already be the new ones (for the sections that will be moved),
+       * so only the segments and the non allocated sections are considered here.
+       */
+      if( header.segmentVirtualAddressEnd() < mProgramHeaderTable.findLastSegmentVirtualAddressEnd() ){
+        return count;
+      }
+      uint64_t fileEnd = std::max( mProgramHeaderTable.findLastSegmentFileOffsetEnd(), static_cast<uint64_t>( minimumSizeToAccessAllHeaders() ) );
+      for(const SectionHeader & sectionHeader : mSectionHeaderTable){
+        if( !sectionHeader.allocatesMemory() && (sectionHeader.sectionType() != SectionType::NoBits) ){
+          fileEnd = std::max( fileEnd, sectionHeader.fileOffsetEnd() );
+        }
+      }
+      if( (header.fileOffsetEnd() > fileEnd) || ( (fileEnd - header.fileOffsetEnd()) >= pageSize ) ){
+        return count;
+      }
+
+      return index;
+    }
+
+    /*! \brief Find the next virtual address to put a section past the end of the PT_LOAD segment at \a index
+     *
+     * The returned address is aligned to \a alignment ,
+     * and its file offset in the segment is past the end of the file.
+     *
+     * \pre \a index must be a PT_LOAD segment that can be extended
+     * \sa findIndexOfExtensibleLastLoadProgramHeader()
+     * \sa fileOffsetInLoadSegment()
+     */
+    uint64_t findNextVirtualAddressToExtendLoadSegment(size_t index, uint64_t alignment) const noexcept
+    {
+      assert( index < mProgramHeaderTable.headerCount() );
+
+      const ProgramHeader & header = mProgramHeaderTable.headerAt(index);
+      const uint64_t fileEnd = findGlobalFileOffsetEnd();
+      assert( fileEnd >= header.offset );
+
+      const uint64_t address = std::max( findGlobalVirtualAddressEnd(), header.vaddr + (fileEnd - header.offset) );
+
+      return findNextAlignedAddress(address, alignment);
+    }
+
+    /*! \brief Get the file offset of \a virtualAddress in the PT_LOAD segment at \a index
+     *
+     * \pre \a virtualAddress must not be before the start of the segment
+     */
+    uint64_t fileOffsetInLoadSegment(size_t index, uint64_t virtualAddress) const noexcept
+    {
+      assert( index < mProgramHeaderTable.headerCount() );
+
+      const ProgramHeader & header = mProgramHeaderTable.headerAt(index);
+      assert( virtualAddress >= header.vaddr );
+
+      return header.offset + (virtualAddress - header.vaddr);
+    }
+
+    /*! \brief Extend the PT_LOAD segment at \a index so that it covers \a sectionHeader
+     *
+     * \pre \a sectionHeader must be past the start of the segment
+     */
+    void extendLoadProgramHeaderToCoverSection(size_t index, const SectionHeader & sectionHeader) noexcept
+    {
+      assert( index < mProgramHeaderTable.headerCount() );
+
+      const ProgramHeader & header = mProgramHeaderTable.headerAt(index);
+      assert( sectionHeader.offset >= header.offset );
+
+      const uint64_t size = std::max( header.filesz, sectionHeader.fileOffsetEnd() - header.offset );
+      mProgramHeaderTable.setSegmentSizeAt(index, size);
+    }
+
+    /*! \brief Set the alignment of the segment at \a index
+     *
+     * \pre \a index must be in valid range
+     * \pre \a alignment must be congruent with the virtual address and file offset of the segment
+     */
+    void setSegmentAlignmentAt(size_t index, uint64_t alignment) noexcept
+    {
+      assert( index < mProgramHeaderTable.headerCount() );
+      assert( alignment > 0 );
+      assert( (mProgramHeaderTable.headerAt(index).vaddr % alignment) == (mProgramHeaderTable.headerAt(index).offset % alignment) );
+
+      mProgramHeaderTable.setSegmentAlignmentAt(index, alignment);
+    }
+
+    /*! \brief Check if the file content can be shifted starting from \a offset
+     *
+     * The content is cut at \a offset ,
+     * so the file header, the header tables, the segments and the sections
+     * must all end before \a offset or start from it.
+     *
+     * \pre the file header must be valid
+     * \sa shiftFileContentFrom()
+     */
+    bool fileContentCanBeShiftedFrom(uint64_t offset) const noexcept
+    {
+      assert( fileHeaderSeemsValid() );
+
+      const auto isCut = [offset](uint64_t begin, uint64_t end){
+        return (begin < offset) && (end > offset);
+      };
+
+      if( offset < mFileHeader.ehsize ){
+        return false;
+      }
+      if( isCut( mFileHeader.phoff, static_cast<uint64_t>( mFileHeader.minimumSizeToReadAllProgramHeaders() ) ) ){
+        return false;
+      }
+      if( containsSectionHeaderTable() && isCut( mFileHeader.shoff, static_cast<uint64_t>( mFileHeader.minimumSizeToReadAllSectionHeaders() ) ) ){
+        return false;
+      }
+      for(const ProgramHeader & header : mProgramHeaderTable){
+        if( isCut( header.offset, header.fileOffsetEnd() ) ){
+          return false;
+        }
+      }
+      for(const SectionHeader & header : mSectionHeaderTable){
+        if( (header.sectionType() != SectionType::NoBits) && isCut( header.offset, header.fileOffsetEnd() ) ){
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    /*! \brief Shift the file content starting from \a offset by \a byteCount
+     *
+     * The file offsets of the header tables, the segments and the sections
+     * that start from \a offset are increased by \a byteCount .
+     * The virtual addresses are not changed.
+     *
+     * \pre the content must be shiftable from \a offset
+     * \pre \a byteCount must be a multiple of the page size,
+     *   so that the file offset of each segment stays congruent with its virtual address
+     * \sa fileContentCanBeShiftedFrom()
+     */
+    void shiftFileContentFrom(uint64_t offset, uint64_t byteCount) noexcept
+    {
+      assert( fileContentCanBeShiftedFrom(offset) );
+      assert( (mFileHeader.pageSize() == 0) || ( (byteCount % mFileHeader.pageSize()) == 0 ) );
+
+      if(mFileHeader.phoff >= offset){
+        mFileHeader.phoff += byteCount;
+      }
+      if( containsSectionHeaderTable() && (mFileHeader.shoff >= offset) ){
+        mFileHeader.shoff += byteCount;
+      }
+      for(ProgramHeader & header : mProgramHeaderTable){
+        if(header.offset >= offset){
+          header.offset += byteCount;
+        }
+      }
+      for(SectionHeader & header : mSectionHeaderTable){
+        if( (header.sectionType() != SectionType::Null) && (header.offset >= offset) ){
+          header.offset += byteCount;
+        }
+      }
+    }
+
     /*! \brief Move the note sections to the end
      *
      * \pre the file header must be valid
@@ -644,7 +1143,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       uint64_t fileOffset = firstFileOffset;
 
       for(SectionHeader & header : mSectionHeaderTable){
-        if(header.sectionType() == SectionType::Note){
+        if( (header.sectionType() == SectionType::Note) && !header.isDeployStampNoteSectionHeader() ){
           header.addr = virtualAddess;
           header.offset = fileOffset;
           virtualAddess += header.size;
@@ -675,6 +1174,139 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mSectionHeaderTable[mIndexOfGnuHashTableSectionHeader].offset = fileOffset;
     }
 
+    /*! \brief Remove the sections that do not occupy memory during process execution
+     *
+     * The section name string table and the trailing sections
+     * (see SectionHeader::isTrailingSectionHeader()) are kept.
+     * Returns a map of the section indexes changes,
+     * where a removed section has 0 as new index.
+     *
+     * \note The section name string table still contains the names
+     * of the removed sections.
+     * \sa rebuildSectionNameStringTable()
+     * \sa moveSectionNameStringTableAndSectionHeaderTableAfterAllocatedContent()
+     */
+    SectionIndexChangeMap removeNonAllocatedSections() noexcept
+    {
+      const uint16_t sectionNameStringTableIndex = mFileHeader.shstrndx;
+
+      const auto mustRemove = [sectionNameStringTableIndex](uint16_t index, const SectionHeader & header){
+        if( (sectionNameStringTableIndex > 0) && (index == sectionNameStringTableIndex) ){
+          return false;
+        }
+        if( header.isTrailingSectionHeader() ){
+          return false;
+        }
+        return !header.allocatesMemory();
+      };
+
+      const SectionIndexChangeMap map = removeSectionHeaders(mSectionHeaderTable, mustRemove);
+      if( map.isEmpty() ){
+        return map;
+      }
+
+      mFileHeader.shnum = static_cast<uint16_t>( mSectionHeaderTable.size() );
+      mFileHeader.shstrndx = map.indexForOldIndex(sectionNameStringTableIndex);
+      indexKnownSectionHeaders();
+
+      return map;
+    }
+
+    /*! \brief Make a new section name string table for the current section headers
+     *
+     * The name index of each section header, and the size
+     * of the section name string table header, are updated.
+     *
+     * \pre the section name string table header must exist
+     * \sa containsSectionNameStringTableHeader()
+     */
+    StringTable rebuildSectionNameStringTable()
+    {
+      assert( containsSectionNameStringTableHeader() );
+
+      StringTable stringTable;
+
+      for(SectionHeader & header : mSectionHeaderTable){
+        if( header.name.empty() ){
+          header.nameIndex = 0;
+        }else{
+          header.nameIndex = static_cast<uint32_t>( stringTable.appendString(header.name) );
+        }
+      }
+
+      mSectionHeaderTable[mFileHeader.shstrndx].size = static_cast<uint64_t>( stringTable.byteCount() );
+
+      return stringTable;
+    }
+
+    /*! \brief Move the section name string table and the section header table just after the allocated content
+     *
+     * Once the sections that are not needed at run time have been removed,
+     * this places the section name string table just after the last byte
+     * used by the program header table, the segments and the allocated sections,
+     * directly followed by the section header table.
+     * The .gnu_debuglink section and the deployment stamp note, if any,
+     * are placed just before the section name string table.
+     *
+     * \pre the file header must be valid
+     * \pre the section name string table header must exist
+     * \sa removeNonAllocatedSections()
+     */
+    void moveSectionNameStringTableAndSectionHeaderTableAfterAllocatedContent() noexcept
+    {
+      assert( fileHeaderSeemsValid() );
+      assert( containsSectionNameStringTableHeader() );
+
+      uint64_t allocatedContentEnd = static_cast<uint64_t>( mFileHeader.minimumSizeToReadAllProgramHeaders() );
+      allocatedContentEnd = std::max( allocatedContentEnd, findSegmentsFileOffsetEndWithoutNotesOnlyInFile() );
+      for(const SectionHeader & header : mSectionHeaderTable){
+        if( header.allocatesMemory() && (header.sectionType() != SectionType::NoBits) ){
+          allocatedContentEnd = std::max( allocatedContentEnd, header.fileOffsetEnd() );
+        }
+      }
+
+      SectionHeader & sectionNameStringTableHeader = mSectionHeaderTable[mFileHeader.shstrndx];
+      sectionNameStringTableHeader.offset = moveTrailingSectionsTo(allocatedContentEnd);
+
+      const uint64_t sectionHeaderTableAlignment = mFileHeader.ident._class == Class::Class64 ? 8 : 4;
+      mFileHeader.shoff = findAlignedSize(sectionNameStringTableHeader.fileOffsetEnd(), sectionHeaderTableAlignment);
+    }
+
+    /*! \brief Move the section name string table and the section header table to the end of the file
+     *
+     * This is required once the section header table,
+     * or the section name string table, grows.
+     * The section name string table is placed just after the last byte
+     * used by the program header table, the segments and the other sections,
+     * directly followed by the section header table.
+     * The .gnu_debuglink section and the deployment stamp note, if any,
+     * are placed just before the section name string table.
+     * If they were already at the end of the file, they stay there.
+     *
+     * \pre the file header must be valid
+     * \pre the section name string table header must exist
+     */
+    void moveSectionNameStringTableAndSectionHeaderTableToEnd() noexcept
+    {
+      assert( fileHeaderSeemsValid() );
+      assert( containsSectionNameStringTableHeader() );
+
+      uint64_t contentEnd = static_cast<uint64_t>( mFileHeader.minimumSizeToReadAllProgramHeaders() );
+      contentEnd = std::max( contentEnd, findSegmentsFileOffsetEndWithoutNotesOnlyInFile() );
+      for(size_t i = 1; i < mSectionHeaderTable.size(); ++i){
+        const SectionHeader & header = mSectionHeaderTable[i];
+        if( (i != mFileHeader.shstrndx) && (header.sectionType() != SectionType::NoBits) && !header.isTrailingSectionHeader() ){
+          contentEnd = std::max( contentEnd, header.fileOffsetEnd() );
+        }
+      }
+
+      SectionHeader & sectionNameStringTableHeader = mSectionHeaderTable[mFileHeader.shstrndx];
+      sectionNameStringTableHeader.offset = moveTrailingSectionsTo(contentEnd);
+
+      const uint64_t sectionHeaderTableAlignment = mFileHeader.ident._class == Class::Class64 ? 8 : 4;
+      mFileHeader.shoff = findAlignedSize(sectionNameStringTableHeader.fileOffsetEnd(), sectionHeaderTableAlignment);
+    }
+
     /*! \brief Find the global virtual address end
      */
     uint64_t findGlobalVirtualAddressEnd() const noexcept
@@ -714,16 +1346,15 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         segmentsOffsetEnd = mProgramHeaderTable.findLastSegmentFileOffsetEnd();
       }
 
+      /*
+       * A section of type SHT_NOBITS (like .bss)
+       * has a size, but occupies no space in the file.
+       */
       uint64_t sectionsOffsetEnd = 0;
-      if( !mSectionHeaderTable.empty() ){
-        const auto cmp = [](const SectionHeader & a, const SectionHeader & b){
-          return a.fileOffsetEnd() < b.fileOffsetEnd();
-        };
-
-        const auto it = std::max_element(mSectionHeaderTable.cbegin(), mSectionHeaderTable.cend(), cmp);
-        assert( it != mSectionHeaderTable.cend() );
-
-        sectionsOffsetEnd = it->fileOffsetEnd();
+      for(const SectionHeader & header : mSectionHeaderTable){
+        if( header.sectionType() != SectionType::NoBits ){
+          sectionsOffsetEnd = std::max( sectionsOffsetEnd, header.fileOffsetEnd() );
+        }
       }
 
       const uint64_t lastHeaderEnd = static_cast<uint64_t>( minimumSizeToAccessAllHeaders() );
@@ -858,6 +1489,63 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return header.name == ".dynstr";
     }
 
+    /*
+     * A note that is only in the file (like the deployment stamp)
+     * is moved with the section name string table,
+     * so it does not count as content it must be placed after.
+     */
+    uint64_t findSegmentsFileOffsetEndWithoutNotesOnlyInFile() const noexcept
+    {
+      uint64_t offsetEnd = 0;
+      for(const ProgramHeader & header : mProgramHeaderTable){
+        if( !header.isNoteOnlyInFile() ){
+          offsetEnd = std::max( offsetEnd, header.fileOffsetEnd() );
+        }
+      }
+
+      return offsetEnd;
+    }
+
+    /*
+     * Move the .gnu_debuglink section, then the deployment stamp note,
+     * to the first aligned offsets from offset.
+     * Returns the offset just after them.
+     */
+    uint64_t moveTrailingSectionsTo(uint64_t offset) noexcept
+    {
+      const uint16_t sectionIndex = findIndexOfGnuDebugLinkSectionHeader();
+      if( sectionIndex < mSectionHeaderTable.size() ){
+        SectionHeader & header = mSectionHeaderTable[sectionIndex];
+        header.offset = findAlignedSize( offset, std::max(header.addralign, uint64_t(1)) );
+        offset = header.fileOffsetEnd();
+      }
+
+      return moveDeployStampNoteTo(offset);
+    }
+
+    /*
+     * Move the deployment stamp note, and the PT_NOTE that covers it,
+     * to the first aligned offset from offset.
+     * Returns the offset just after it,
+     * or offset if there is no deployment stamp note.
+     */
+    uint64_t moveDeployStampNoteTo(uint64_t offset) noexcept
+    {
+      const uint16_t sectionIndex = findIndexOfDeployStampNoteSectionHeader();
+      if( sectionIndex >= mSectionHeaderTable.size() ){
+        return offset;
+      }
+      const size_t programHeaderIndex = findIndexOfDeployStampNoteProgramHeader();
+
+      SectionHeader & header = mSectionHeaderTable[sectionIndex];
+      header.offset = findAlignedSize( offset, std::max(header.addralign, uint64_t(1)) );
+      if( programHeaderIndex < mProgramHeaderTable.headerCount() ){
+        mProgramHeaderTable.setFileOffsetAndFileSizeAt(programHeaderIndex, header.offset, header.size);
+      }
+
+      return header.fileOffsetEnd();
+    }
+
     void indexKnownSectionHeaders() noexcept
     {
       for(size_t i=1; i < mSectionHeaderTable.size(); ++i){
@@ -14,6 +14,7 @@
 #include "Mdt/ExecutableFile/ExecutableFileWriteError.h"
 #include "Mdt/ExecutableFile/RPath.h"
 #include "Mdt/ExecutableFile/RPathElf.h"
+#include "Mdt/ExecutableFile/DeployStamp.h"
 #include "Mdt/ExecutableFile/Elf/FileWriter.h"
 #include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
 #include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
@@ -26,8 +27,17 @@
 #include "Mdt/ExecutableFile/Elf/ProgramInterpreterSectionReader.h"
 #include "Mdt/ExecutableFile/Elf/GnuHashTableReader.h"
 #include "Mdt/ExecutableFile/Elf/NoteSectionReader.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLinkReader.h"
+#include "Mdt/ExecutableFile/Elf/DeployStampNote.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTableReader.h"
 #include "Mdt/ExecutableFile/Elf/FileWriterFile.h"
+#include "Mdt/ExecutableFile/Elf/CoreReader.h"
+#include "Mdt/ExecutableFile/Elf/RunPathInPlaceEditor.h"
+#include "Mdt/ExecutableFile/Elf/DynamicStringTableReferences.h"
 #include <QLatin1Char>
+#include <QByteArray>
+#include <string_view>
 
 // #include "Debug.h"
 // #include <iostream>
@@ -49,6 +59,30 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mFileName = name;
     }
 
+    /*! \brief Set the maximum count of threads used to decode the symbol table (.symtab)
+     *
+     * By default, the symbol table is decoded in the calling thread.
+     * For very large unstripped files,
+     * a bigger count can be set to decode it in parallel.
+     * The same count is used to update the symbol tables
+     * when sections are moved.
+     *
+     * \sa extractSymTabPartReferringToSection()
+     */
+    void setSymbolTableDecodeThreadCount(unsigned int count) noexcept
+    {
+      mSymbolTableDecodeThreadCount = count;
+    }
+
+    /*! \brief Set the resource limits applied while reading a file
+     *
+     * \sa ReadLimits
+     */
+    void setReadLimits(const ReadLimits & limits) noexcept
+    {
+      mReadBudget.setLimits(limits);
+    }
+
     /*! \brief Clear
      */
     void clear() noexcept
@@ -57,6 +91,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mSectionNamesStringTableSectionHeader.clear();
       mDynamicSection.clear();
       mFileName.clear();
+      mReadBudget.reset();
     }
 
     /*! \brief Get minimum size to read the file header
@@ -69,7 +104,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
      */
     int64_t minimumSizeToReadFileHeader() const noexcept
     {
-      return 64;
+      return minimumSizeToReadAnyFileHeader();
     }
 
     /*! \brief Get the file header
@@ -115,7 +150,11 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       readFileHeaderIfNull(map);
       checkFileSizeToReadSectionHeaders(map);
 
-      return extractAllSectionHeaders(map, mFileHeader);
+      try{
+        return extractAllSectionHeaders(map, mFileHeader, mReadBudget);
+      }catch(const ReadLimitExceededError & error){
+        throwReadLimitExceeded(error);
+      }
     }
 
     /*! \brief Get the program header table
@@ -152,6 +191,24 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mDynamicSection.getSoName();
     }
 
+    /*! \brief Get the dynamic section
+     *
+     * \pre \a map must not be null
+     * \exception ExecutableFileReadError
+     */
+    DynamicSection getDynamicSection(const ByteArraySpan & map)
+    {
+      assert( !map.isNull() );
+
+      checkFileSizeToReadFileHeader(map);
+      readFileHeaderIfNull(map);
+      checkFileSizeToReadSectionHeaders(map);
+      readSectionNameStringTableHeaderIfNull(map);
+      readDynamicSectionIfNull(map);
+
+      return mDynamicSection;
+    }
+
     /*! \brief
      *
      * \pre \a map must not be null
@@ -187,6 +244,32 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return RPathElf::rPathFromString( mDynamicSection.getRunPath() );
     }
 
+    /*! \brief Get the deployment stamp
+     *
+     * Only the file header, the program header table
+     * and the notes covered by the PT_NOTE segments are read.
+     *
+     * \pre \a map must not be null
+     * \exception ExecutableFileReadError
+     * \exception RPathFormatError
+     */
+    DeployStamp getDeployStamp(const ByteArraySpan & map)
+    {
+      assert( !map.isNull() );
+
+      checkFileSizeToReadFileHeader(map);
+      readFileHeaderIfNull(map);
+      checkFileSizeToReadProgramHeaderTable(map);
+
+      try{
+        return DeployStampNote::extractStamp( map, mFileHeader, extractAllProgramHeaders(map, mFileHeader) );
+      }catch(const NoteSectionReadError & error){
+        const QString msg = tr("file '%1' contains a invalid deployment stamp: %2")
+                            .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(msg);
+      }
+    }
+
     /*! \brief
      *
      * \pre \a map must not be null
@@ -204,11 +287,16 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       FileAllHeaders headers;
       headers.setFileHeader(mFileHeader);
       headers.setProgramHeaderTable( extractAllProgramHeaders(map, mFileHeader) );
-      headers.setSectionHeaderTable( extractAllSectionHeaders(map, mFileHeader) );
+      try{
+        headers.setSectionHeaderTable( extractAllSectionHeaders(map, mFileHeader, mReadBudget) );
+      }catch(const ReadLimitExceededError & error){
+        throwReadLimitExceeded(error);
+      }
 
       file.setHeadersFromFile(headers);
       file.setDynamicSectionFromFile(mDynamicSection);
-      file.setSymTabFromFile( extractSymTabPartReferringToSection( map, headers.fileHeader(), headers.sectionHeaderTable() ) );
+      file.setSymTabFromFile( extractSymTabPartReferringToSection( map, headers.fileHeader(), headers.sectionHeaderTable(), mSymbolTableDecodeThreadCount ) );
+      file.setSymbolTableUpdateThreadCount(mSymbolTableDecodeThreadCount);
       file.setDynSymFromFile( extractDynSymPartReferringToSection( map, headers.fileHeader(), headers.sectionHeaderTable() ) );
       file.setGotSectionFromFile( extractGotSection( map, headers.fileHeader(), headers.sectionHeaderTable() ) );
       file.setGotPltSectionFromFile( extractGotPltSection( map, headers.fileHeader(), headers.sectionHeaderTable() ) );
@@ -221,6 +309,17 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         file.setGnuHashTableSection( GnuHashTableReader::extractHasTable( map, headers.fileHeader(), headers.gnuHashTableSectionHeader() ) );
       }
 
+      // Required to move .gnu_debuglink with the section name string table
+      if( headers.containsGnuDebugLinkSectionHeader() ){
+        const SectionHeader & header = headers.gnuDebugLinkSectionHeader();
+        if( map.size < header.minimumSizeToReadSection() ){
+          const QString msg = tr("file '%1' is to small to read the .gnu_debuglink section. required size: %2 , file size: %3")
+                              .arg( mFileName ).arg( header.minimumSizeToReadSection() ).arg(map.size);
+          throw ExecutableFileReadError(msg);
+        }
+        file.setGnuDebugLinkFromFile( extractGnuDebugLink( map, header, headers.fileHeader().ident.dataFormat ) );
+      }
+
       try{
         file.setNoteSectionTableFromFile( NoteSectionReader::extractNoteSectionTable( map, headers.fileHeader(), headers.sectionHeaderTable() ) );
       }catch(const NoteSectionReadError & error){
@@ -228,19 +327,258 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
                             .arg( mFileName, error.whatQString() );
         throw ExecutableFileReadError(msg);
       }
+
+      // Required to move .shstrtab, when sections are removed
+      if( mSectionNamesStringTableSectionHeader.sectionType() == SectionType::StringTable ){
+        try{
+          file.setSectionNameStringTableFromFile( extractStringTable(map, mSectionNamesStringTableSectionHeader) );
+        }catch(const StringTableError & error){
+          const QString msg = tr("file '%1': error while reading the section name string table: %2")
+                              .arg( mFileName, error.whatQString() );
+          throw ExecutableFileReadError(msg);
+        }
+      }
     }
 
-    /*! \brief
+    /*! \brief Read the GNU hashes of the symbols covered by the .gnu.hash section to \a file
+     *
+     * Those are only required to rebuild the .gnu.hash section,
+     * so they are not read by readToFileWriterFile().
+     * Does nothing if \a file has no .gnu.hash section.
+     *
+     * \pre readToFileWriterFile() must have been called on \a file
+     * \exception ExecutableFileReadError
+     */
+    void readGnuHashedSymbolHashesToFileWriterFile(FileWriterFile & file, const ByteArraySpan & map)
+    {
+      assert( !map.isNull() );
+
+      if( !file.headers().containsGnuHashTableSectionHeader() ){
+        return;
+      }
+
+      try{
+        file.setGnuHashedSymbolHashesFromFile(
+          GnuHashTableReader::extractHashedSymbolHashes( map, file.fileHeader(), file.headers().sectionHeaderTable(),
+                                                         file.gnuHashTableSection().symoffset, mDynamicSection.stringTable() )
+        );
+      }catch(const GnuHashTableReadError & error){
+        const QString msg = tr("file '%1': %2")
+                            .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(msg);
+      }
+    }
+
+    /*! \brief Read the dynamic relocation table and the .gnu.version_r section to \a file
+     *
+     * Those are only required to pack the relative relocations,
+     * so they are not read by readToFileWriterFile().
+     * The relocation table is the section DT_RELA (or DT_REL) refers to.
+     * Does nothing for a table that does not exist.
+     *
+     * \pre readToFileWriterFile() must have been called on \a file
+     * \exception ExecutableFileReadError
+     */
+    void readDynamicRelocationsToFileWriterFile(FileWriterFile & file, const ByteArraySpan & map)
+    {
+      assert( !map.isNull() );
+
+      const FileAllHeaders & headers = file.headers();
+      const size_t sectionCount = headers.sectionHeaderTable().size();
+
+      uint16_t relocationSectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+        SectionType::Rela, mDynamicSection.valueForTag(DynamicSectionTagType::RelocationTable)
+      );
+      if(relocationSectionIndex >= sectionCount){
+        relocationSectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+          SectionType::Rel, mDynamicSection.valueForTag(DynamicSectionTagType::RelTable)
+        );
+      }
+      const uint16_t versionNeedSectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+        SectionType::GnuVersionNeed, mDynamicSection.valueForTag(DynamicSectionTagType::VersionNeed)
+      );
+
+      try{
+        if(relocationSectionIndex < sectionCount){
+          const SectionHeader & header = headers.sectionHeaderTable()[relocationSectionIndex];
+          file.setDynamicRelocationSectionFromFile( extractRelocationSection(map, headers.fileHeader(), header, relocationSectionIndex) );
+        }
+      }catch(const RelocatableObjectReadError & error){
+        const QString msg = tr("file '%1': %2")
+                            .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(msg);
+      }
+
+      try{
+        if(versionNeedSectionIndex < sectionCount){
+          const SectionHeader & header = headers.sectionHeaderTable()[versionNeedSectionIndex];
+          file.setGnuVersionNeedTableFromFile( GnuVersionNeedTableReader::extractTable(map, headers.fileHeader(), header) );
+        }
+      }catch(const GnuVersionNeedTableReadError & error){
+        const QString msg = tr("file '%1': %2")
+                            .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(msg);
+      }
+    }
+
+    /*! \brief Read the references to the dynamic string table and the .gnu.version_r section to \a file
+     *
+     * Those are only required to compact the dynamic string table,
+     * so they are not read by readToFileWriterFile().
+     * The .gnu.version_r section is not read again
+     * if readDynamicRelocationsToFileWriterFile() allready did it.
+     *
+     * \pre readToFileWriterFile() must have been called on \a file
+     * \exception ExecutableFileReadError
+     */
+    void readDynamicStringTableReferencesToFileWriterFile(FileWriterFile & file, const ByteArraySpan & map)
+    {
+      assert( !map.isNull() );
+
+      const FileAllHeaders & headers = file.headers();
+      if( !headers.containsDynamicSectionHeader() ){
+        return;
+      }
+
+      std::vector<DynamicStringTableReference> references;
+      try{
+        references = extractDynamicStringTableReferenceLocations(
+          map, headers.fileHeader(), headers.sectionHeaderTable(), static_cast<uint16_t>(headers.dynamicSectionHeader().link)
+        );
+      }catch(const ExecutableFileReadError & error){
+        const QString msg = tr("file '%1': %2")
+                            .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(msg);
+      }
+      // The names used by .gnu.version_r are taken from the table
+      const auto isVersionNeedReference = [](const DynamicStringTableReference & reference){
+        return reference.sectionType == SectionType::GnuVersionNeed;
+      };
+      references.erase( std::remove_if(references.begin(), references.end(), isVersionNeedReference), references.end() );
+      file.setDynamicStringTableReferencesFromFile(references);
+
+      if( !file.gnuVersionNeedTable().isEmpty() ){
+        return;
+      }
+      const uint16_t versionNeedSectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+        SectionType::GnuVersionNeed, mDynamicSection.valueForTag(DynamicSectionTagType::VersionNeed)
+      );
+      try{
+        if( versionNeedSectionIndex < headers.sectionHeaderTable().size() ){
+          const SectionHeader & header = headers.sectionHeaderTable()[versionNeedSectionIndex];
+          file.setGnuVersionNeedTableFromFile( GnuVersionNeedTableReader::extractTable(map, headers.fileHeader(), header) );
+        }
+      }catch(const GnuVersionNeedTableReadError & error){
+        const QString msg = tr("file '%1': %2")
+                            .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(msg);
+      }
+    }
+
+    /*! \brief Set the run path directly in \a map , if possible
+     *
+     * Only the run path string, the DT_RUNPATH and the DT_STRSZ entries
+     * are written, and nothing at all if the file already has \a runPath .
+     * If RunPathInPlaceEdit::NotPossible is returned,
+     * \a map is untouched and the file must be rewritten
+     * with readToFileWriterFile() and setFileWriterToMap().
+     *
+     * \pre \a map must not be null and be writable
+     * \exception ExecutableFileReadError
+     * \sa planRunPathInPlaceEdit()
+     */
+    RunPathInPlaceEdit setRunPathInPlaceIfPossible(ByteArraySpan map, const QString & runPath)
+    {
+      assert( !map.isNull() );
+
+      readFileHeaderIfNull(map);
+      checkFileSizeToReadSectionHeaders(map);
+      readSectionNameStringTableHeaderIfNull(map);
+      readDynamicSectionIfNull(map);
+
+      SectionHeaderTable sectionHeaderTable;
+      try{
+        sectionHeaderTable = extractAllSectionHeaders(map, mFileHeader, mReadBudget);
+      }catch(const ReadLimitExceededError & error){
+        throwReadLimitExceeded(error);
+      }
+
+      const uint16_t dynamicSectionIndex = findSectionHeaderIndex(map, mFileHeader, mSectionNamesStringTableSectionHeader, SectionType::Dynamic, ".dynamic");
+      assert( dynamicSectionIndex > 0 );
+      assert( dynamicSectionIndex < sectionHeaderTable.size() );
+      const SectionHeader & dynamicSectionHeader = sectionHeaderTable[dynamicSectionIndex];
+      const uint16_t dynamicStringTableIndex = static_cast<uint16_t>(dynamicSectionHeader.link);
+      assert( dynamicStringTableIndex < sectionHeaderTable.size() );
+      const SectionHeader & dynamicStringTableSectionHeader = sectionHeaderTable[dynamicStringTableIndex];
+
+      std::vector<uint64_t> references;
+      try{
+        references = extractDynamicStringTableReferences(map, mFileHeader, sectionHeaderTable, dynamicStringTableIndex);
+      }catch(const ExecutableFileReadError & error){
+        const QString message = tr("file '%1': %2")
+                                .arg( mFileName, error.whatQString() );
+        throw ExecutableFileReadError(message);
+      }
+
+      const QByteArray runPathUtf8 = runPath.toUtf8();
+      const std::string_view runPathView( runPathUtf8.constData(), static_cast<std::size_t>( runPathUtf8.size() ) );
+
+      const RunPathInPlacePlan plan = planRunPathInPlaceEdit(mDynamicSection, dynamicStringTableSectionHeader.size, runPathView, references);
+      if( plan.requiresWrite() ){
+        applyRunPathInPlaceEdit(map, mFileHeader, dynamicSectionHeader, dynamicStringTableSectionHeader, plan, runPathView);
+        // Will be read again on next access
+        mDynamicSection.clear();
+      }
+
+      return plan.edit;
+    }
+
+    /*! \brief Shift the content of \a map as required by \a file
+     *
+     * Must be called before setFileWriterToMap(),
+     * \a originalFileSize being the size of the file before it was resized.
+     * Returns the count of bytes moved.
+     *
+     * \pre \a map must not be null
+     * \pre \a map must be large enough to hold the shifted content
+     * \sa FileWriterFile::fileContentShifts()
+     */
+    uint64_t shiftFileContentInMap(ByteArraySpan map, const FileWriterFile & file, uint64_t originalFileSize) noexcept
+    {
+      assert( !map.isNull() );
+      assert( static_cast<uint64_t>(map.size) >= originalFileSize + file.fileContentShiftByteCount() );
+
+      Elf::shiftFileContentInMap(map, file.fileContentShifts(), originalFileSize);
+
+      uint64_t movedByteCount = 0;
+      for(const FileContentShift & shift : file.fileContentShifts()){
+        assert( originalFileSize >= shift.offset );
+        movedByteCount += originalFileSize - shift.offset + shift.byteCount;
+        originalFileSize += shift.byteCount;
+      }
+
+      return movedByteCount;
+    }
+
+    /*! \brief Write \a file to \a map
+     *
+     * Only the bytes that changed are written.
+     * Returns the count of bytes written.
      *
      * \pre \a map must not be null
      * \exception ExecutableFileWriteError
      */
-    void setFileWriterToMap(ByteArraySpan map, const FileWriterFile & file)
+    uint64_t setFileWriterToMap(ByteArraySpan map, const FileWriterFile & file)
     {
       assert( !map.isNull() );
       assert( map.size >= file.minimumSizeToWriteFile() );
 
-      setFileToMap(map, file);
+      uint64_t writtenByteCount = 0;
+      for( const OffsetRange & range : setFileToMap(map, file) ){
+        writtenByteCount += range.byteCount();
+      }
+
+      return writtenByteCount;
     }
 
    private:
@@ -255,9 +593,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       assert( !map.isNull() );
 
       if( map.size < minimumSizeToReadFileHeader() ){
-        const QString message = tr("file '%1' is to small to read the file header")
-                                .arg(mFileName);
-        throw ExecutableFileReadError(message);
+        throwReadError(ReadError::FileTooSmallToReadFileHeader);
       }
     }
 
@@ -270,12 +606,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         return;
       }
 
-      mFileHeader = extractFileHeader(map);
-      if( !mFileHeader.seemsValid() ){
-        const QString message = tr("file '%1' does not contain a valid file header")
-                                .arg(mFileName);
-        throw ExecutableFileReadError(message);
-      }
+      mFileHeader = valueOrThrow( readFileHeader(map) );
     }
 
     /*! \brief
@@ -287,11 +618,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       assert( !map.isNull() );
       assert( mFileHeader.seemsValid() );
 
-      if( map.size < mFileHeader.minimumSizeToReadAllSectionHeaders() ){
-        const QString message = tr("file '%1' is to small to read section headers")
-                                .arg(mFileName);
-        throw ExecutableFileReadError(message);
-      }
+      throwIfError( checkSizeToReadSectionHeaders(map, mFileHeader) );
     }
 
     /*! \brief Check if given map size is enought to read the program header table
@@ -303,11 +630,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       assert( !map.isNull() );
       assert( mFileHeader.seemsValid() );
 
-      if( map.size < mFileHeader.minimumSizeToReadAllProgramHeaders() ){
-        const QString message = tr("file '%1' is to small to read the program header table")
-                                .arg(mFileName);
-        throw ExecutableFileReadError(message);
-      }
+      throwIfError( checkSizeToReadProgramHeaderTable(map, mFileHeader) );
     }
 
     /*! \brief
@@ -323,12 +646,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
         return;
       }
 
-      mSectionNamesStringTableSectionHeader = extractSectionNameStringTableHeader(map, mFileHeader);
-      if( mSectionNamesStringTableSectionHeader.sectionType() == SectionType::Null ){
-        const QString message = tr("file '%1' does not contain the section names string table section header")
-                                .arg(mFileName);
-        throw ExecutableFileReadError(message);
-      }
+      mSectionNamesStringTableSectionHeader = valueOrThrow( readSectionNameStringTableHeader(map, mFileHeader) );
     }
 
     /*! \brief
@@ -344,7 +662,9 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       }
 
       try{
-        mDynamicSection = extractDynamicSection(map, mFileHeader, mSectionNamesStringTableSectionHeader);
+        mDynamicSection = extractDynamicSection(map, mFileHeader, mSectionNamesStringTableSectionHeader, mReadBudget);
+      }catch(const ReadLimitExceededError & error){
+        throwReadLimitExceeded(error);
       }catch(const DynamicSectionReadError & error){
         const QString message = tr("file '%1': error while reading the .dynamic section: %2")
                                 .arg( mFileName, error.whatQString() );
@@ -362,10 +682,51 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       }
     }
 
+    /*! \brief Throw a ExecutableFileReadError for \a error
+     *
+     * \pre \a error must not be NoError
+     */
+    [[noreturn]]
+    void throwReadError(ReadError error) const
+    {
+      assert( error != ReadError::NoError );
+
+      throw ExecutableFileReadError( readErrorMessage(error, mFileName) );
+    }
+
+    /*! \brief Throw a ReadLimitExceededError with the file name added to \a error
+     */
+    [[noreturn]]
+    void throwReadLimitExceeded(const ReadLimitExceededError & error) const
+    {
+      const QString message = tr("file '%1': %2")
+                              .arg( mFileName, error.whatQString() );
+      throw ReadLimitExceededError(message);
+    }
+
+    void throwIfError(ReadError error) const
+    {
+      if(error != ReadError::NoError){
+        throwReadError(error);
+      }
+    }
+
+    template<typename T>
+    T valueOrThrow(CoreReadResult<T> && result) const
+    {
+      if( !result ){
+        throwReadError( result.error() );
+      }
+
+      return result.takeValue();
+    }
+
     FileHeader mFileHeader;
     SectionHeader mSectionNamesStringTableSectionHeader;
     DynamicSection mDynamicSection;
     QString mFileName;
+    unsigned int mSymbolTableDecodeThreadCount = 1;
+    ReadBudget mReadBudget;
   };
 
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
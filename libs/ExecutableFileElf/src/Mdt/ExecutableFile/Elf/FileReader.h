@@ -20,6 +20,7 @@
 #include "Mdt/ExecutableFile/ExecutableFileReadError.h"
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
 #include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
 #include <QChar>
 #include <QString>
 #include <QStringList>
@@ -641,11 +642,12 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
    * \pre \a map must not be null
    * \pre \a map must be big enough to read all section headers
    * \exception NotNullTerminatedStringError
+   * \exception ReadLimitExceededError
    * \todo define also preconditions to access the string table related to the section headers
    *   (https://gitlab.com/scandyna/mdtexecutablefile/-/issues/19)
    */
   inline
-  std::vector<SectionHeader> extractAllSectionHeaders(const ByteArraySpan & map, const FileHeader & fileHeader)
+  std::vector<SectionHeader> extractAllSectionHeaders(const ByteArraySpan & map, const FileHeader & fileHeader, ReadBudget & budget)
   {
     assert( !map.isNull() );
     assert( fileHeader.seemsValid() );
@@ -654,17 +656,38 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     std::vector<SectionHeader> sectionHeaders;
 
     const uint16_t sectionHeaderCount = fileHeader.shnum;
+    budget.checkSectionCount(sectionHeaderCount);
+    budget.consumeRegion( fileHeader.shoff, static_cast<uint64_t>(sectionHeaderCount) * fileHeader.shentsize );
+    sectionHeaders.reserve(sectionHeaderCount);
 
     for(uint16_t i = 0; i < sectionHeaderCount; ++i){
       sectionHeaders.emplace_back( extractSectionHeaderAt(map, fileHeader, i) );
     }
 
     const SectionHeader stringTableSectionHeader = extractSectionNameStringTableHeader(map, fileHeader);
+    budget.checkStringTableByteCount(stringTableSectionHeader.size);
+    budget.consumeRegion(stringTableSectionHeader.offset, stringTableSectionHeader.size);
     setSectionHeadersName(map, stringTableSectionHeader, sectionHeaders);
 
     return sectionHeaders;
   }
 
+  /*! \internal
+   *
+   * Same as extractAllSectionHeaders(const ByteArraySpan &, const FileHeader &, ReadBudget &)
+   * with the default ReadLimits .
+   *
+   * \exception NotNullTerminatedStringError
+   * \exception ReadLimitExceededError
+   */
+  inline
+  std::vector<SectionHeader> extractAllSectionHeaders(const ByteArraySpan & map, const FileHeader & fileHeader)
+  {
+    ReadBudget budget;
+
+    return extractAllSectionHeaders(map, fileHeader, budget);
+  }
+
   /*! \internal Find the index of the first section of a type and for which its name matches \a namePredicate
    *
    * If the requested section header does not exist,
@@ -833,10 +856,12 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
    * \pre \a sectionNamesStringTableSectionHeader must be the section header names string table
    * \exception DynamicSectionReadError
    * \exception StringTableError
+   * \exception ReadLimitExceededError
    */
   inline
   DynamicSection extractDynamicSection(const ByteArraySpan & map, const FileHeader & fileHeader,
-                                       const SectionHeader & sectionNamesStringTableSectionHeader)
+                                       const SectionHeader & sectionNamesStringTableSectionHeader,
+                                       ReadBudget & budget)
   {
     assert( !map.isNull() );
     assert( fileHeader.seemsValid() );
@@ -880,6 +905,16 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       throw DynamicSectionReadError(msg);
     }
 
+    /*
+     * The entry count and the string table size are declared by the file,
+     * so check them before allocating anything
+     */
+    const uint64_t entrySize = 2 * (fileHeader.ident._class == Class::Class32 ? 4 : 8);
+    budget.checkEntryCount(dynamicSectionHeader.size / entrySize);
+    budget.checkStringTableByteCount(dynamicStringTableSectionHeader.size);
+    budget.consumeRegion(dynamicSectionHeader.offset, dynamicSectionHeader.size);
+    budget.consumeRegion(dynamicStringTableSectionHeader.offset, dynamicStringTableSectionHeader.size);
+
     const unsigned char * first = map.data + dynamicSectionHeader.offset;
     const unsigned char * const last = first + dynamicSectionHeader.size;
 
@@ -906,6 +941,24 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     return dynamicSection;
   }
 
+  /*! \internal Extract the dynamic section
+   *
+   * Same as extractDynamicSection(const ByteArraySpan &, const FileHeader &, const SectionHeader &, ReadBudget &)
+   * with the default ReadLimits .
+   *
+   * \exception DynamicSectionReadError
+   * \exception StringTableError
+   * \exception ReadLimitExceededError
+   */
+  inline
+  DynamicSection extractDynamicSection(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                       const SectionHeader & sectionNamesStringTableSectionHeader)
+  {
+    ReadBudget budget;
+
+    return extractDynamicSection(map, fileHeader, sectionNamesStringTableSectionHeader, budget);
+  }
+
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
 
 #endif // #ifndef MDT_EXECUTABLE_FILE_ELF_FILE_READER_H
@@ -22,8 +22,12 @@
 #include "Mdt/ExecutableFile/Elf/SymbolTableWriter.h"
 #include "Mdt/ExecutableFile/Elf/GlobalOffsetTableWriter.h"
 #include "Mdt/ExecutableFile/Elf/ProgramInterpreterSectionWriter.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLinkWriter.h"
 #include "Mdt/ExecutableFile/Elf/GnuHashTableWriter.h"
 #include "Mdt/ExecutableFile/Elf/NoteSectionWriter.h"
+#include "Mdt/ExecutableFile/Elf/RelocationTableWriter.h"
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTableWriter.h"
+#include "Mdt/ExecutableFile/Elf/ChangedBytesMapWriter.h"
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
 #include <QtEndian>
 #include <cstdint>
@@ -133,6 +137,202 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
   }
 
+  /*! \internal
+   */
+  inline
+  int64_t sectionOffset(const SectionHeader & header) noexcept
+  {
+    return static_cast<int64_t>(header.offset);
+  }
+
+  /*! \internal
+   */
+  inline
+  int64_t sectionSize(const SectionHeader & header) noexcept
+  {
+    return static_cast<int64_t>(header.size);
+  }
+
+  /*! \internal Set \a table to a map, entry by entry, using \a writer
+   */
+  inline
+  void setGlobalOffsetTableToMap(ChangedBytesMapWriter & writer, const SectionHeader & sectionHeader,
+                                 const GlobalOffsetTable & table, const Ident & ident)
+  {
+    assert( isGlobalOffsetTableSection(sectionHeader) );
+
+    const int64_t entrySize = globalOffsetTableEntrySize(ident._class);
+    int64_t offset = sectionOffset(sectionHeader);
+    assert(offset >= 0);
+
+    for(size_t i=0; i < table.entriesCount(); ++i){
+      const GlobalOffsetTableEntry & entry = table.entryAt(i);
+      writer.write(offset, entrySize, [&entry,&ident](ByteArraySpan array){
+        setGlobalOffsetTableEntryToArray(array, entry, ident);
+      });
+      offset += entrySize;
+    }
+  }
+
+  /*! \internal Set \a table to a map, entry by entry, using \a writer
+   */
+  inline
+  void setSymbolTableToMap(ChangedBytesMapWriter & writer, const PartialSymbolTable & table, const Ident & ident)
+  {
+    const int64_t entrySize = symbolTableEntrySize(ident._class);
+
+    for(size_t i=0; i < table.entriesCount(); ++i){
+      const SymbolTableEntry & entry = table.entryAt(i);
+      writer.write(table.fileMapOffsetAt(i), entrySize, [&entry,&ident](ByteArraySpan array){
+        setSymbolTableEntryToArray(array, entry, ident);
+      });
+    }
+  }
+
+  /*! \internal Set the .gnu.version_r section of \a file using \a writer
+   *
+   * \pre \a file must have a .gnu.version_r section
+   *  of the size of its gnuVersionNeedTable()
+   */
+  inline
+  void setGnuVersionNeedTableToMap(ChangedBytesMapWriter & writer, const FileWriterFile & file)
+  {
+    const FileAllHeaders & headers = file.headers();
+    const Ident & ident = file.fileHeader().ident;
+
+    const uint16_t sectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+      SectionType::GnuVersionNeed, file.dynamicSection().valueForTag(DynamicSectionTagType::VersionNeed)
+    );
+    assert( sectionIndex < headers.sectionHeaderTable().size() );
+    const SectionHeader & header = headers.sectionHeaderTable()[sectionIndex];
+    writer.write( sectionOffset(header), sectionSize(header), [&file,&ident](ByteArraySpan array){
+      setGnuVersionNeedTableToArray( array, file.gnuVersionNeedTable(), ident );
+    });
+  }
+
+  /*! \internal Set the references to the compacted dynamic string table of \a file using \a writer
+   *
+   * \pre the dynamic string table of \a file must have been compacted
+   * \sa FileWriterFile::dynamicStringTableReferences()
+   */
+  inline
+  void setDynamicStringTableReferencesToMap(ChangedBytesMapWriter & writer, const FileWriterFile & file)
+  {
+    assert( file.dynamicStringTableIsCompacted() );
+
+    const std::vector<SectionHeader> & sectionHeaderTable = file.headers().sectionHeaderTable();
+    const DataFormat dataFormat = file.fileHeader().ident.dataFormat;
+    const uint32_t dynamicStringTableIndex = file.dynamicSectionHeader().link;
+
+    for(const SectionHeader & header : sectionHeaderTable){
+      if(header.link != dynamicStringTableIndex){
+        continue;
+      }
+      const SectionType sectionType = header.sectionType();
+      if( (sectionType != SectionType::DynSym) && (sectionType != SectionType::GnuVersionDef) ){
+        continue;
+      }
+      for(const DynamicStringTableReference & reference : file.dynamicStringTableReferences()){
+        if(reference.sectionType != sectionType){
+          continue;
+        }
+        const int64_t offset = sectionOffset(header) + static_cast<int64_t>(reference.offsetInSection);
+        writer.write(offset, 4, [&reference,dataFormat](ByteArraySpan array){
+          set32BitWord( array, static_cast<uint32_t>(reference.index), dataFormat );
+        });
+      }
+    }
+  }
+
+  /*! \internal Set the packed relative relocations of \a file using \a writer
+   *
+   * This writes the remaining relocations, the packed relative relocation table,
+   * and the addend of each packed relocation at its offset.
+   * The addends are written last, so that they are not overwritten
+   * by a table (like .got) rewritten from the values read from the file.
+   *
+   * \pre the relative relocations of \a file must have been packed
+   */
+  inline
+  void setPackedRelativeRelocationsToMap(ChangedBytesMapWriter & writer, const FileWriterFile & file)
+  {
+    assert( file.relativeRelocationsArePacked() );
+
+    const FileAllHeaders & headers = file.headers();
+    const DynamicSection & dynamicSection = file.dynamicSection();
+    const Ident & ident = file.fileHeader().ident;
+    const RelocationSection & relocationSection = file.dynamicRelocationSection();
+    const bool hasAddends = relocationSection.hasAddends;
+
+    const uint16_t relocationSectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+      hasAddends ? SectionType::Rela : SectionType::Rel,
+      dynamicSection.valueForTag(hasAddends ? DynamicSectionTagType::RelocationTable : DynamicSectionTagType::RelTable)
+    );
+    assert( relocationSectionIndex < headers.sectionHeaderTable().size() );
+    const SectionHeader & relocationSectionHeader = headers.sectionHeaderTable()[relocationSectionIndex];
+    if(relocationSectionHeader.size > 0){
+      writer.write( sectionOffset(relocationSectionHeader), sectionSize(relocationSectionHeader), [&relocationSection,&ident,hasAddends](ByteArraySpan array){
+        setRelocationTableToArray(array, relocationSection.entries, ident, hasAddends);
+      });
+    }
+
+    const uint16_t relrSectionIndex = headers.findIndexOfSectionHeaderAtAddress(
+      SectionType::Relr, dynamicSection.valueForTag(DynamicSectionTagType::RelrTable)
+    );
+    assert( relrSectionIndex < headers.sectionHeaderTable().size() );
+    const SectionHeader & relrSectionHeader = headers.sectionHeaderTable()[relrSectionIndex];
+    writer.write( sectionOffset(relrSectionHeader), sectionSize(relrSectionHeader), [&file,&ident](ByteArraySpan array){
+      setRelrTableToArray( array, file.relrTable(), ident );
+    });
+
+    /*
+     * A Elf_Rel relocation already has its addend at its offset
+     */
+    if(!hasAddends){
+      return;
+    }
+    const int64_t wordSize = relrEntrySize(ident._class);
+    for(const RelocationEntry & entry : file.packedRelativeRelocations()){
+      const uint64_t offset = headers.programHeaderTable().findFileOffsetOfVirtualAddress( entry.offset, static_cast<uint64_t>(wordSize) );
+      assert( offset > 0 );
+      writer.write(static_cast<int64_t>(offset), wordSize, [&entry,&ident](ByteArraySpan array){
+        setSignedNWord(array, entry.addend, ident);
+      });
+    }
+  }
+
+  /*! \internal Set the file header, the program header table and the section header table using \a writer
+   */
+  inline
+  void setAllHeadersToMap(ChangedBytesMapWriter & writer, const FileAllHeaders & headers)
+  {
+    assert( headers.seemsValid() );
+
+    const FileHeader & fileHeader = headers.fileHeader();
+
+    writer.write(0, fileHeader.ehsize, [&fileHeader](ByteArraySpan array){
+      fileHeaderToArray(array, fileHeader);
+    });
+
+    const int64_t programHeaderSize = fileHeader.phentsize;
+    for(uint16_t i = 0; i < fileHeader.phnum; ++i){
+      const int64_t offset = static_cast<int64_t>(fileHeader.phoff) + i * programHeaderSize;
+      const ProgramHeader & programHeader = headers.programHeaderTable().headerAt(i);
+      writer.write(offset, programHeaderSize, [&programHeader,&fileHeader](ByteArraySpan array){
+        programHeaderToArray(array, programHeader, fileHeader);
+      });
+    }
+
+    const int64_t sectionHeaderSize = fileHeader.shentsize;
+    for(uint16_t i = 0; i < fileHeader.shnum; ++i){
+      const int64_t offset = static_cast<int64_t>(fileHeader.shoff) + i * sectionHeaderSize;
+      const SectionHeader & sectionHeader = headers.sectionHeaderTable()[i];
+      writer.write(offset, sectionHeaderSize, [&sectionHeader,&fileHeader](ByteArraySpan array){
+        sectionHeaderToArray(array, sectionHeader, fileHeader);
+      });
+    }
+  }
+
   /*! \internal
    *
    * Old string table:
@@ -170,48 +370,152 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
   }
 
-  /*! \internal
+  /*! \internal Shift the content of \a map regarding \a shifts
+   *
+   * Each shift moves the content that starts at its offset
+   * (in the content resulting from the previous shifts)
+   * towards the end of \a map , and fills the gap with null bytes.
+   * \a contentSize is the size of the content before the shifts.
+   *
+   * \pre \a map must not be null
+   * \pre \a map must be large enough to hold the shifted content
+   */
+  inline
+  void shiftFileContentInMap(ByteArraySpan map, const std::vector<FileContentShift> & shifts, uint64_t contentSize) noexcept
+  {
+    assert( !map.isNull() );
+
+    for(const FileContentShift & shift : shifts){
+      assert( shift.offset <= contentSize );
+      assert( contentSize + shift.byteCount <= static_cast<uint64_t>(map.size) );
+
+      contentSize += shift.byteCount;
+      ByteArraySpan content = map.subSpan( 0, static_cast<int64_t>(contentSize) );
+      shiftBytesToEnd( content, shift.offset, static_cast<int64_t>(shift.byteCount) );
+      replaceBytes( map, OffsetRange::fromBeginAndEndOffsets(shift.offset, shift.offset + shift.byteCount), '\0' );
+    }
+  }
+
+  /*! \internal Write \a file to \a map
+   *
+   * Each structure is generated and compared to the map,
+   * only the bytes that differ are written
+   * (see ChangedBytesMapWriter).
+   *
+   * Returns the file offset ranges that have been changed in \a map
    */
   inline
-  void setFileToMap(ByteArraySpan map, const FileWriterFile & file) noexcept
+  std::vector<OffsetRange> setFileToMap(ByteArraySpan map, const FileWriterFile & file)
   {
     assert( !map.isNull() );
     assert( file.seemsValid() );
     assert( map.size >= file.minimumSizeToWriteFile() );
 
-    if( file.dynamicStringTableMovesToEnd() ){
-      replaceBytes(map, file.originalDynamicStringTableOffsetRange(), '\0');
+    ChangedBytesMapWriter writer(map);
+    const FileHeader & fileHeader = file.fileHeader();
+    const Ident & ident = fileHeader.ident;
+
+    /*
+     * The sections moved to the end are aligned, which leaves gaps between them.
+     * Those must not depend on what the map contained past the original content,
+     * so that the same edits on the same file always give the same output.
+     */
+    const uint64_t originalContentEnd = file.originalGlobalFileOffsetRange().end();
+    const uint64_t newContentEnd = static_cast<uint64_t>( file.minimumSizeToWriteFile() );
+    if(originalContentEnd < newContentEnd){
+      writer.fill(OffsetRange::fromBeginAndEndOffsets(originalContentEnd, newContentEnd), '\0');
+    }
+
+    if( file.dynamicStringTableMoves() ){
+      writer.fill(file.originalDynamicStringTableOffsetRange(), '\0');
     }else{
-      setBytesAfterOldDynamicStringTableNull(map, file);
+      const uint64_t begin = file.dynamicStringTableOffsetRange().end();
+      const uint64_t end = file.originalDynamicStringTableOffsetRange().end();
+      if(begin < end){
+        writer.fill(OffsetRange::fromBeginAndEndOffsets(begin, end), '\0');
+      }
     }
 
-    if( file.dynamicSectionMovesToEnd() ){
+    if( file.dynamicSectionMoves() ){
       if( !file.gotSection().isEmpty() && file.headers().containsGotSectionHeader() ){
-        setGlobalOffsetTableToMap( map, file.headers().gotSectionHeader(), file.gotSection(), file.fileHeader() );
+        setGlobalOffsetTableToMap( writer, file.headers().gotSectionHeader(), file.gotSection(), ident );
       }
       if( !file.gotPltSection().isEmpty() && file.headers().containsGotPltSectionHeader() ){
-        setGlobalOffsetTableToMap( map, file.headers().gotPltSectionHeader(), file.gotPltSection(), file.fileHeader() );
+        setGlobalOffsetTableToMap( writer, file.headers().gotPltSectionHeader(), file.gotPltSection(), ident );
       }
     }
 
     if( file.headers().containsProgramInterpreterSectionHeader() ){
-      setProgramInterpreterSectionToMap( map, file.headers().programInterpreterSectionHeader(), file.programInterpreterSection() );
+      const SectionHeader & header = file.headers().programInterpreterSectionHeader();
+      writer.write( sectionOffset(header), sectionSize(header), [&file](ByteArraySpan array){
+        setProgramInterpreterSectionToArray( array, file.programInterpreterSection() );
+      });
     }
 
     if( file.headers().containsGnuHashTableSectionHeader() ){
-      GnuHashTableWriter::setGnuHashTableToMap( map, file.headers().gnuHashTableSectionHeader(), file.gnuHashTableSection(), file.fileHeader() );
+      const SectionHeader & header = file.headers().gnuHashTableSectionHeader();
+      writer.write( sectionOffset(header), sectionSize(header), [&file,&ident](ByteArraySpan array){
+        GnuHashTableWriter::setGnuHashTableToArray( array, file.gnuHashTableSection(), ident );
+      });
     }
 
-    NoteSectionWriter::setNoteSectionTableToMap( map, file.noteSectionTable(), file.fileHeader() );
+    const NoteSectionTable & noteSectionTable = file.noteSectionTable();
+    for(size_t i=0; i < noteSectionTable.sectionCount(); ++i){
+      const SectionHeader & header = noteSectionTable.sectionHeaderAt(i);
+      const NoteSection & noteSection = noteSectionTable.sectionAt(i);
+      writer.write( sectionOffset(header), sectionSize(header), [&noteSection,&ident](ByteArraySpan array){
+        NoteSectionWriter::setNoteSectionToArray(array, noteSection, ident);
+      });
+    }
+
+    if( file.containsGnuDebugLink() ){
+      const SectionHeader & header = file.headers().gnuDebugLinkSectionHeader();
+      writer.write( sectionOffset(header), sectionSize(header), [&file,&ident](ByteArraySpan array){
+        setGnuDebugLinkToArray( array, file.gnuDebugLink(), ident.dataFormat );
+      });
+    }
 
     if( !file.symTab().isEmpty() ){
-      setSymbolTableToMap(map, file.symTab(), file.fileHeader().ident);
+      setSymbolTableToMap(writer, file.symTab(), ident);
+    }
+    setSymbolTableToMap(writer, file.dynSym(), ident);
+
+    const SectionHeader & dynamicSectionHeader = file.dynamicSectionHeader();
+    writer.write( sectionOffset(dynamicSectionHeader), sectionSize(dynamicSectionHeader), [&file,&ident](ByteArraySpan array){
+      dynamicSectionToArray( array, file.dynamicSection(), ident );
+    });
+
+    const SectionHeader & dynamicStringTableSectionHeader = file.headers().dynamicStringTableSectionHeader();
+    assert( static_cast<int64_t>(dynamicStringTableSectionHeader.size) == file.dynamicSection().stringTable().byteCount() );
+    writer.write( sectionOffset(dynamicStringTableSectionHeader), sectionSize(dynamicStringTableSectionHeader), [&file](ByteArraySpan array){
+      stringTableToArray( array, file.dynamicSection().stringTable() );
+    });
+
+    if( file.containsSectionNameStringTable() ){
+      const SectionHeader & sectionNameStringTableHeader = file.headers().sectionNameStringTableHeader();
+      assert( static_cast<int64_t>(sectionNameStringTableHeader.size) == file.sectionNameStringTable().byteCount() );
+      writer.write( sectionOffset(sectionNameStringTableHeader), sectionSize(sectionNameStringTableHeader), [&file](ByteArraySpan array){
+        stringTableToArray( array, file.sectionNameStringTable() );
+      });
+    }
+
+    if( file.dynamicStringTableIsCompacted() ){
+      setDynamicStringTableReferencesToMap(writer, file);
     }
-    setSymbolTableToMap(map, file.dynSym(), file.fileHeader().ident);
 
-    setDynamicSectionToMap( map, file.dynamicSectionHeader(), file.dynamicSection(), file.fileHeader() );
-    setStringTableToMap( map, file.headers().dynamicStringTableSectionHeader(), file.dynamicSection().stringTable() );
-    setAllHeadersToMap( map, file.headers() );
+    if( file.relativeRelocationsArePacked() || file.dynamicStringTableIsCompacted() ){
+      if( !file.gnuVersionNeedTable().isEmpty() ){
+        setGnuVersionNeedTableToMap(writer, file);
+      }
+    }
+
+    if( file.relativeRelocationsArePacked() ){
+      setPackedRelativeRelocationsToMap(writer, file);
+    }
+
+    setAllHeadersToMap( writer, file.headers() );
+
+    return writer.changedRanges();
   }
 
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
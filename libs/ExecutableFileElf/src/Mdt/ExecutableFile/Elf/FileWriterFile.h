@@ -12,8 +12,11 @@
 
 #include "Mdt/ExecutableFile/Elf/FileHeader.h"
 #include "Mdt/ExecutableFile/Elf/FileWriterFileLayout.h"
+#include "Mdt/ExecutableFile/Elf/FileWriterLayoutPlan.h"
+#include "Mdt/ExecutableFile/Elf/FreeSpaceMap.h"
 #include "Mdt/ExecutableFile/Elf/ProgramHeader.h"
 #include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderTableGrowthStrategy.h"
 #include "Mdt/ExecutableFile/Elf/SectionHeader.h"
 #include "Mdt/ExecutableFile/Elf/SectionIndexChangeMap.h"
 #include "Mdt/ExecutableFile/Elf/SectionSegmentUtils.h"
@@ -24,19 +27,38 @@
 #include "Mdt/ExecutableFile/Elf/GlobalOffsetTable.h"
 #include "Mdt/ExecutableFile/Elf/ProgramInterpreterSection.h"
 #include "Mdt/ExecutableFile/Elf/GnuHashTable.h"
+#include "Mdt/ExecutableFile/Elf/GnuHashTableBuilder.h"
 #include "Mdt/ExecutableFile/Elf/NoteSectionTable.h"
+#include "Mdt/ExecutableFile/Elf/DeployStampNote.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLink.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObject.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include "Mdt/ExecutableFile/Elf/RelrTable.h"
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTable.h"
+#include "Mdt/ExecutableFile/Elf/HashTable.h"
 #include "Mdt/ExecutableFile/Elf/FileOffsetChanges.h"
 #include "Mdt/ExecutableFile/Elf/StringTable.h"
+#include "Mdt/ExecutableFile/Elf/StringTableBuilder.h"
+#include "Mdt/ExecutableFile/Elf/DynamicStringTableReferences.h"
+#include "Mdt/ExecutableFile/Elf/RunPathInPlaceEditor.h"
 #include "Mdt/ExecutableFile/Elf/Algorithm.h"
 #include "Mdt/ExecutableFile/Elf/Exceptions.h"
+#include "Mdt/ExecutableFile/ExecutableFileEditTransaction.h"
+#include "Mdt/ExecutableFile/ExecutableFileWriteError.h"
+#include "Mdt/ExecutableFile/RPathElf.h"
+#include "Mdt/ExecutableFile/Algorithm.h"
 
 // #include "Mdt/DeployUtils/Algorithm.h"
 // #include "mdt_deployutilscore_export.h"
 
 #include <QObject>
 #include <QString>
+#include <QLatin1Char>
 #include <algorithm>
 #include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <cassert>
 
@@ -45,6 +67,17 @@
 
 namespace Mdt{ namespace ExecutableFile{ namespace Elf{
 
+  /*! \internal Content of a file shifted towards its end
+   *
+   * The content that starts at \a offset is moved by \a byteCount bytes,
+   * the gap is filled with null bytes.
+   */
+  struct FileContentShift
+  {
+    uint64_t offset = 0;
+    uint64_t byteCount = 0;
+  };
+
   /*! \internal
    */
   class /*MDT_DEPLOYUTILSCORE_EXPORT*/ FileWriterFile : public QObject
@@ -113,179 +146,245 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
      */
     void setRunPath(const QString & runPath)
     {
-      QString msg;
-
-      msg = tr("set runpath to '%1'").arg(runPath);
-      emit message(msg);
-
-      mDynamicSection.setRunPath(runPath);
-
-      const int64_t dynamicSectionSize = mDynamicSection.byteCount(fileHeader().ident._class);
-      assert( dynamicSectionSize >= 0 );
-      mHeaders.setDynamicSectionSize( static_cast<uint64_t>(dynamicSectionSize) );
-
-      const int64_t dynamicStringTableSize = mDynamicSection.stringTable().byteCount();
-      assert( dynamicStringTableSize >= 0 );
-      mHeaders.setDynamicStringTableSize( static_cast<uint64_t>(dynamicStringTableSize) );
-
-      const bool mustMoveDynamicSection = mFileOffsetChanges.dynamicSectionChangesOffset(mDynamicSection) > 0;
-      const bool mustMoveDynamicStringTable = mFileOffsetChanges.dynamicStringTableChangesOffset(mDynamicSection) > 0;
-      const bool mustMoveAnySection = mustMoveDynamicSection || mustMoveDynamicStringTable;
-
-      if(!mustMoveAnySection){
-        return;
-      }
+      editRunPath(runPath);
+      updateLayoutAfterEdits();
+    }
 
+    /*! \brief Apply all the changes of \a edits
+     *
+     * The dynamic section, its string table and the program interpreter
+     * are first edited in memory.
+     * The new layout of the file is then computed once,
+     * so that at most one new PT_LOAD segment is created,
+     * whatever the count of edits.
+     *
+     * If \a edits strips the sections not needed at run time,
+     * they are removed before the new layout is computed,
+     * so that the moved sections are put after the compacted content.
+     *
+     * If \a edits aligns load segments for huge pages,
+     * this is done first, so that the other edits work on the shifted content.
+     *
+     * If \a edits packs the relative relocations,
+     * this is done after the other edits of the dynamic section,
+     * and before the new layout is computed,
+     * because the grown .dynamic and .dynstr can then reuse
+     * the place freed in the relocation table.
+     *
+     * If \a edits compacts the dynamic string table,
+     * this is done after all other edits that change strings,
+     * so that the strings they no longer use are removed.
+     *
+     * If \a edits sets a deployment stamp,
+     * it is written after the other sections have been removed or added.
+     * The PT_NOTE that covers it, if the file has none yet,
+     * is added while the new layout is computed.
+     *
+     * If \a edits splits the debug information,
+     * the sections not needed at run time are removed like with strip.
+     * The .gnu_debuglink section is added afterwards with setGnuDebugLink(),
+     * once the debug file has been written.
+     *
+     * If \a edits rebuilds the .gnu.hash section,
+     * this is done last.
+     * A rebuilt table that is larger than the original one
+     * is put in free space inside the existing PT_LOAD segments,
+     * or past the end of the last PT_LOAD segment if it can be extended,
+     * otherwise the original table is kept.
+     *
+     * \exception ExecutableFileWriteError
+     * \exception MoveSectionError
+     */
+    void applyEdits(const ExecutableFileEditTransaction & edits)
+    {
       /*
-       * If either the .dynstr and/or the .dynamic section grows,
-       * we have to put them at the end of the file
-       * (shifting all the data after those sections is not a option,
-       * because this will inavlidate references we don't know
-       * how to handle. We are not a linker).
-       *
-       * Also, the .dynstr and .dynamic must be
-       * covered by a load segment (PT_LOAD).
-       * For this, a new entry must be added in the program header table.
-       * For this, we have to do some place after this table.
-       *
-       * Also putting the program header table at the end causes problems.
-       * In my case, on a Ubuntu 18.04, the resulting program allways crashed
-       * while glibc (2.27) parses the program header table,
-       * at rtld.c:1148.
-       * This could be worked around for gcc generated executables,
-       * which are shared object (DYN).
-       * For Clang generated executables (EXEC), this did not work.
-       * See also:
-       * - https://lwn.net/Articles/631631/
-       * - https://github.com/NixOS/patchelf/blob/master/BUGS
-       * - https://github.com/NixOS/patchelf/pull/117
-       *
-       * Try to make place just after the program header table,
-       * so we can add the new load segment.
-       * On x86-64, a entry is 56-bytes long.
-       *
-       * Looking at generated executables, the first sections that came
-       * just after the program header table are .interp (28-bytes)
-       * and .note.ABI-tag (32-bytes).
-       *
-       * A other note section could also follows: .note.gnu.build-id
-       * Because the PT_NOTE segment must cover all note sections,
-       * we have to move them all.
-       *
-       * As example, if we move the .dynamic and .dynstr,
-       * we would end up with soemthing like this:
-       *
-       * EOF (maybe section header table)
-       * .interp section
-       * .note.ABI-tag section
-       * .note.gnu.build-id
-       * .dynamic section
-       * .dynstr section
-       *
-       * PT_PHDR segment must cover the program header table (new size)
-       * PT_INTERP segment must cover .interp
-       * PT_LOAD new segment that covers .interp , .note.ABI-tag, .note.gnu.build-id , .dynamic and .dynstr
-       * PT_DYNAMIC segment must cover .dynamic
-       * PT_GNU_RELRO segment must be extended to also cover the .dynamic section
-       * PT_NOTE segment must cover .note.ABI-tag and .note.gnu.build-id
+       * The references from outside the dynamic section
+       * are indexes to the string table as read from the file
        */
+      StringTable originalDynamicStringTable;
+      if( edits.compactsDynamicStringTable() ){
+        originalDynamicStringTable = mDynamicSection.stringTable();
+      }
+
+      if( edits.alignsLoadSegmentsForHugePages() ){
+        alignLoadSegmentsForHugePages( edits.hugePageAlignment() );
+      }
+      if( edits.changesRunPath() ){
+        editRunPath( RPathElf::rPathToString( edits.runPath() ) );
+      }
+      if( edits.changesSoName() ){
+        editSoName( edits.soName() );
+      }
+      for(const NeededSharedLibraryEdit & edit : edits.neededSharedLibraryEdits()){
+        editNeededSharedLibraries(edit);
+      }
+      if( edits.dynamicFlagsToAdd() != 0 ){
+        addDynamicFlags(DynamicSectionTagType::Flags, edits.dynamicFlagsToAdd());
+      }
+      if( edits.dynamicFlags1ToAdd() != 0 ){
+        addDynamicFlags(DynamicSectionTagType::Flags1, edits.dynamicFlags1ToAdd());
+      }
+      if( edits.changesProgramInterpreter() ){
+        editProgramInterpreter( edits.programInterpreter() );
+      }
+      if( edits.stripsNonAllocatedSections() || edits.splitsDebugInfo() ){
+        stripNonAllocatedSections();
+      }
+      if( edits.packsRelativeRelocations() ){
+        packRelativeRelocations();
+      }
+      if( edits.compactsDynamicStringTable() ){
+        compactDynamicStringTable(originalDynamicStringTable);
+      }
+      if( edits.changesDeployStamp() ){
+        setDeployStamp( edits.deployStamp() );
+      }
 
-      assert(mustMoveAnySection);
+      updateLayoutAfterEdits();
 
       /*
-       * We need to add a new PT_LOAD to the program header table.
-       * For that, we need to move first sections to the end.
+       * The final place of the other sections is known,
+       * so a grown .gnu.hash will only use space that is really free.
        */
+      if( edits.rebuildsGnuHashTable() ){
+        rebuildGnuHashTable();
+      }
 
-      const SectionIndexChangeMap sectionIndexChangeMap = mHeaders.sortSectionHeaderTableByFileOffset();
       /*
-       * Sorting the section header table changes the index of some headers.
-       * We have to update parts, like symbol tables,
-       * that references indexes in the section header table.
+       * Sections could have been moved past the deployment stamp.
+       * Putting it back at the end lets a later stamp of the same size
+       * be written in place.
        */
-      mSymTab.updateSectionIndexes(sectionIndexChangeMap);
-      mDynSym.updateSectionIndexes(sectionIndexChangeMap);
-
-      const uint16_t sectionToMoveCount = findCountOfSectionsToMoveToFreeSize(mHeaders.sectionHeaderTable(), fileHeader().phentsize);
-      if( sectionToMoveCount >= mHeaders.sectionHeaderTable().size() ){
-        const QString msg = tr("should move %1 sections, but file contains only %2 sections")
-                            .arg(sectionToMoveCount).arg( mHeaders.sectionHeaderTable().size() );
-        throw MoveSectionError(msg);
+      if( edits.changesDeployStamp() && mHeaders.containsDeployStampNoteSectionHeader() ){
+        mHeaders.moveSectionNameStringTableAndSectionHeaderTableToEnd();
+        mNoteSectionTable.updateSectionHeaders( mHeaders.sectionHeaderTable() );
       }
+    }
 
-      std::vector<uint16_t> movedSectionHeadersIndexes;
-
-      if(sectionToMoveCount > 1){
-        msg = tr("will have to move %1 sections because the program header table must be updated")
-              .arg(sectionToMoveCount-1);
-        emit message(msg);
+    /*! \brief Force the layout used when the program header table must grow
+     *
+     * By default, the cheapest valid layout is chosen.
+     * This is mainly used by tests, to check each layout on real files.
+     * A forced layout that is not valid for this file is not used.
+     *
+     * \sa chooseProgramHeaderTableGrowthStrategy()
+     */
+    void forceProgramHeaderTableGrowthStrategy(ProgramHeaderTableGrowthStrategy strategy) noexcept
+    {
+      mForcedProgramHeaderTableGrowthStrategy = strategy;
+    }
 
-        movedSectionHeadersIndexes = moveFirstCountSectionsToEnd(sectionToMoveCount);
-      }
+    /*! \brief Set the maximum count of threads used to update the symbol tables once sections moved
+     *
+     * By default, the symbol tables are updated in the calling thread.
+     */
+    void setSymbolTableUpdateThreadCount(unsigned int count) noexcept
+    {
+      mSymbolTableUpdateThreadCount = count;
+    }
 
-      if(mustMoveDynamicSection){
-        msg = tr("moving .dynamic section to end");
-        emit verboseMessage(msg);
+    /*! \brief Link this file to its separate debug file
+     *
+     * The .gnu_debuglink section is added, or replaced,
+     * just before the section name string table.
+     * It is not loaded, so the segments are not changed.
+     *
+     * \pre \a link must not be null
+     * \exception ExecutableFileWriteError
+     */
+    void setGnuDebugLink(const GnuDebugLink & link)
+    {
+      assert( !link.isNull() );
 
-        moveDynamicSectionToEnd(MoveSectionAlignment::SectionAlignment);
-        movedSectionHeadersIndexes.push_back( mHeaders.dynamicSectionHeaderIndex() );
+      if( !containsSectionNameStringTable() ){
+        const QString msg = tr("adding the .gnu_debuglink section requires the section name string table");
+        throw ExecutableFileWriteError(msg);
       }
 
-      if(mustMoveDynamicStringTable){
-        msg = tr("moving .dynstr section to end");
-        emit verboseMessage(msg);
+      const uint64_t size = static_cast<uint64_t>( link.byteCount() );
 
-        moveDynamicStringTableToEnd(MoveSectionAlignment::SectionAlignment);
-        movedSectionHeadersIndexes.push_back( mHeaders.dynamicStringTableSectionHeaderIndex() );
+      if( mHeaders.containsGnuDebugLinkSectionHeader() ){
+        mHeaders.setSectionSizeAt(mHeaders.findIndexOfGnuDebugLinkSectionHeader(), size);
+      }else{
+        SectionHeader sectionHeader;
+        sectionHeader.name = GnuDebugLink::sectionName();
+        sectionHeader.nameIndex = 0;
+        sectionHeader.type = static_cast<uint32_t>(SectionType::ProgramData);
+        sectionHeader.flags = 0;
+        sectionHeader.addr = 0;
+        sectionHeader.offset = 0;
+        sectionHeader.size = size;
+        sectionHeader.addralign = 4;
+        sectionHeader.entsize = 0;
+        mHeaders.addSectionHeader(sectionHeader);
+        mSectionNameStringTable = mHeaders.rebuildSectionNameStringTable();
       }
+      mHeaders.moveSectionNameStringTableAndSectionHeaderTableToEnd();
+      mNoteSectionTable.updateSectionHeaders( mHeaders.sectionHeaderTable() );
+      mGnuDebugLink = link;
 
-      msg = tr("updating symbol tables");
+      const QString msg = tr("linking to debug file '%1' (CRC 0x%2)")
+                          .arg( QString::fromStdString(link.fileName) ).arg(link.crc, 8, 16, QLatin1Char('0'));
       emit verboseMessage(msg);
+    }
 
-      /*
-       * Moving sections will change offsets and addresses.
-       * We have to update some parts,
-       * like symbol tables, that references those addresses.
-       */
-      mSymTab.updateVirtualAddresses( movedSectionHeadersIndexes, mHeaders.sectionHeaderTable() );
-      mDynSym.updateVirtualAddresses( movedSectionHeadersIndexes, mHeaders.sectionHeaderTable() );
-
-      if( !movedSectionHeadersIndexes.empty() ){
-        msg = tr("creating PT_LOAD segment header");
-        emit verboseMessage(msg);
+    /*! \brief Plan the changes of \a edits without applying them
+     *
+     * Runs the same edits and layout computation than applyEdits()
+     * on a copy of this file, so this file is not modified
+     * and nothing is written.
+     *
+     * \exception ExecutableFileWriteError
+     * \exception MoveSectionError
+     */
+    FileWriterLayoutPlan planEdits(const ExecutableFileEditTransaction & edits) const
+    {
+      FileWriterFile plannedFile;
+      copyStateTo(plannedFile);
+      plannedFile.applyEdits(edits);
+
+      LayoutPlanRewrites rewrites;
+      rewrites.dynamicSection = edits.changesRunPath() || edits.changesSoName()
+                             || !edits.neededSharedLibraryEdits().empty()
+                             || (edits.dynamicFlagsToAdd() != 0) || (edits.dynamicFlags1ToAdd() != 0)
+                             || edits.packsRelativeRelocations() || edits.compactsDynamicStringTable();
+      rewrites.programInterpreter = edits.changesProgramInterpreter();
+      // Removing sections rebuilds the section name string table
+      rewrites.sectionNameStringTable = edits.stripsNonAllocatedSections() || edits.splitsDebugInfo()
+                                     || edits.changesDeployStamp();
+      rewrites.gnuHashTable = edits.rebuildsGnuHashTable();
+
+      return makeLayoutPlan(plannedFile, rewrites);
+    }
 
-        const ProgramHeader loadSegmentHeader = makeLoadProgramHeaderCoveringSections(
-          movedSectionHeadersIndexes, mHeaders.sectionHeaderTable(), mHeaders.fileHeader().pageSize()
-        );
-        mHeaders.addProgramHeader(loadSegmentHeader);
+    /*! \brief Plan setting the run path to \a runPath without applying it
+     *
+     * Like the file writer, setting the run path in place is tried first
+     * (see planRunPathInPlaceEdit()), then the file is planned to be rewritten.
+     * The run path can only be overwritten in place if the references
+     * to the dynamic string table are known (see setDynamicStringTableReferencesFromFile()).
+     *
+     * The in place edit is planned against this file as read,
+     * it must not have been edited yet.
+     *
+     * \sa setRunPath()
+     * \sa planEdits()
+     */
+    FileWriterLayoutPlan planRunPath(const QString & runPath) const
+    {
+      const RunPathInPlacePlan inPlacePlan = planRunPathInPlace(runPath);
+      if(inPlacePlan.edit != RunPathInPlaceEdit::NotPossible){
+        return makeRunPathInPlaceLayoutPlan(inPlacePlan);
       }
 
-      /** \todo The PT_GNU_RELRO segment should also cover the .dynamic section
-       *
-       * In elf files generated (at least by ld), a PT_GNU_RELRO segment
-       * also covers the .dynamic section.
-       *
-       * To have a idea of its role, see
-       * https://thr3ads.net/llvm-dev/2017/05/2818516-lld-ELF-Add-option-to-make-.dynamic-read-only
-       *
-       * Making PT_GNU_RELRO also cover the .dynamic section seems to be tricky,
-       * because it seems to require some sections to be properly aligned.
-       * Making a second PT_GNU_RELRO could be a idea, but:
-       * - it will require to add a new program header to the program header table,
-       *   that will again require to move more sections from the beginning of the file
-       * - it seems not to be well supported by the loaders
-       * For more details, see https://reviews.llvm.org/D40029
-       *
-       * This code below is commented, because it does not work:
-       * - launching a simple exectable segfaults
-       * - eu-elflint tells:
-       *  a) PT_GNU_RELRO is not covered by any PT_LOAD segment
-       *  b) PT_GNU_RELRO's file size is greater than its memory size
-       */
-//       if( mustMoveDynamicSection && mHeaders.containsGnuRelRoProgramHeader() ){
-//         std::cout << "extending PT_GNU_RELRO to also cover .dynamic section" << std::endl;
-//         extendProgramHeaderSizeToCoverSections( mHeaders.gnuRelRoProgramHeaderMutable(), {mHeaders.dynamicSectionHeader()} );
-//       }
+      FileWriterFile plannedFile;
+      copyStateTo(plannedFile);
+      plannedFile.setRunPath(runPath);
+
+      LayoutPlanRewrites rewrites;
+      rewrites.dynamicSection = mDynamicSection.isNull() || (mDynamicSection.getRunPath() != runPath);
+
+      return makeLayoutPlan(plannedFile, rewrites);
     }
 
     /*! \brief Move the .interp to the end
@@ -318,13 +417,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
 
       // Will also handle PT_DYNAMIC
       mHeaders.moveDynamicSectionToEnd(alignment);
-
-      if( mGotSection.containsDynamicSectionAddress() ){
-        mGotSection.setDynamicSectionAddress(mHeaders.dynamicSectionHeader().addr);
-      }
-      if( mGotPltSection.containsDynamicSectionAddress() ){
-        mGotPltSection.setDynamicSectionAddress(mHeaders.dynamicSectionHeader().addr);
-      }
+      updateDynamicSectionAddressReferences();
     }
 
     /*! \brief Move the .dynstr section to the end
@@ -334,10 +427,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       assert( mHeaders.containsDynamicStringTableSectionHeader() );
 
       mHeaders.moveDynamicStringTableToEnd(alignment);
-
-      if( mDynamicSection.containsStringTableAddress() ){
-        mDynamicSection.setStringTableAddress(mHeaders.dynamicStringTableSectionHeader().addr);
-      }
+      updateDynamicStringTableAddressReferences();
     }
 
     void moveSectionToEnd(const SectionHeader & header, MoveSectionAlignment alignment)
@@ -558,109 +648,1885 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mGnuHashTableSection;
     }
 
-    /*! \brief Set the note section table from file
+    /*! \brief Set the GNU hashes of the symbols covered by the .gnu.hash section, from file
+     *
+     * The hashes are in the order of .dynsym ,
+     * starting at the symoffset of the .gnu.hash section.
+     * They are only required to rebuild the .gnu.hash section.
      */
-    void setNoteSectionTableFromFile(const NoteSectionTable & table) noexcept
+    void setGnuHashedSymbolHashesFromFile(const std::vector<uint32_t> & hashes) noexcept
     {
-      mNoteSectionTable = table;
+      mGnuHashedSymbolHashes = hashes;
     }
 
-    /*! \brief Get the note section table
+    /*! \brief Set the dynamic relocation table (the one DT_RELA or DT_REL refers to), from file
+     *
+     * It is only required to pack the relative relocations.
      */
-    const NoteSectionTable & noteSectionTable() const noexcept
+    void setDynamicRelocationSectionFromFile(const RelocationSection & section) noexcept
     {
-      return mNoteSectionTable;
+      mDynamicRelocationSection = section;
     }
 
-    /*! \brief Get the minimum size required to write this file
+    /*! \brief Get the dynamic relocation table
+     *
+     * Once the relative relocations are packed,
+     * only the other relocations are left in this table.
      */
-    int64_t minimumSizeToWriteFile() const noexcept
+    const RelocationSection & dynamicRelocationSection() const noexcept
     {
-      return mHeaders.globalFileOffsetRange().minimumSizeToAccessRange();
+      return mDynamicRelocationSection;
     }
 
-    /*! \brief Get the file offset of the dynamic section
+    /*! \brief Set the .gnu.version_r section from file
      *
-     * \pre this file must contain the dynamic section program header
+     * It is only required to pack the relative relocations.
      */
-    uint64_t dynamicSectionOffset() const noexcept
+    void setGnuVersionNeedTableFromFile(const GnuVersionNeedTable & table) noexcept
     {
-      assert( mHeaders.containsDynamicProgramHeader() );
-
-      return mHeaders.dynamicProgramHeader().offset;
+      mGnuVersionNeedTable = table;
     }
 
-    /*! \brief Check if the dynamic section moves to the end of this file
+    /*! \brief Get the .gnu.version_r section
      */
-    bool dynamicSectionMovesToEnd() const noexcept
+    const GnuVersionNeedTable & gnuVersionNeedTable() const noexcept
     {
-      return mHeaders.dynamicProgramHeader().offset >= mOriginalLayout.globalOffsetRange().end();
+      return mGnuVersionNeedTable;
     }
 
-    /*! \brief Check if the dynamic string table moves to the end of this file
+    /*! \brief Set the references to the dynamic string table from outside the dynamic section, from file
+     *
+     * Those are the names of the dynamic symbols
+     * and of the symbol version definitions (.gnu.version_d).
+     * The names used by .gnu.version_r are taken from gnuVersionNeedTable().
+     * They are required to compact the dynamic string table
+     * and to plan overwriting the run path in place (see planRunPath()).
      */
-    bool dynamicStringTableMovesToEnd() const noexcept
+    void setDynamicStringTableReferencesFromFile(const std::vector<DynamicStringTableReference> & references) noexcept
     {
-      return dynamicStringTableSectionHeader().offset >= mOriginalLayout.globalOffsetRange().end();
+      mDynamicStringTableReferences = references;
+      mDynamicStringTableReferencesAreKnown = true;
     }
 
-    /*! \brief Get the file offset range of the dynamic string table
+    /*! \brief Get the references to the dynamic string table from outside the dynamic section
      *
-     * \pre this file must have the dynamic string table section header
+     * Once the dynamic string table is compacted,
+     * they refer to the compacted table.
      */
-    OffsetRange dynamicStringTableOffsetRange() const noexcept
+    const std::vector<DynamicStringTableReference> & dynamicStringTableReferences() const noexcept
     {
-      assert( containsDynamicStringTableSectionHeader() );
-
-      return OffsetRange::fromSectionHeader( dynamicStringTableSectionHeader() );
+      return mDynamicStringTableReferences;
     }
 
-    /*! \brief Get the file offset of the dynamic string table
+    /*! \brief Check if the dynamic string table has been compacted
      *
-     * \pre this file must have the dynamic string table section header
+     * \sa dynamicStringTableReferences()
      */
-    uint64_t dynamicStringTableOffset() const noexcept
+    bool dynamicStringTableIsCompacted() const noexcept
     {
-      assert( containsDynamicStringTableSectionHeader() );
-
-      return dynamicStringTableSectionHeader().offset;
+      return mDynamicStringTableIsCompacted;
     }
 
-    /*! \brief Get the size of the dynamic string table
+    /*! \brief Check if the relative relocations have been packed
      *
-     * \pre this file must have the dynamic string table section header
+     * \sa relrTable()
      */
-    uint64_t dynamicStringTableSize() const noexcept
+    bool relativeRelocationsArePacked() const noexcept
     {
-      assert( containsDynamicStringTableSectionHeader() );
-
-      return dynamicStringTableSectionHeader().size;
+      return !mRelrTable.empty();
     }
 
-    /*! \brief Get the file offset range of the original dynamic string table
+    /*! \brief Get the packed relative relocation table (DT_RELR)
      */
-    OffsetRange originalDynamicStringTableOffsetRange() const noexcept
+    const std::vector<uint64_t> & relrTable() const noexcept
     {
-      return mOriginalLayout.dynamicStringTableOffsetRange();
+      return mRelrTable;
     }
 
-    /*! \brief Check if this file semms valid
+    /*! \brief Get the relative relocations that have been packed
+     *
+     * Their addend has to be stored at their offset,
+     * because a packed relative relocation has no addend.
+     */
+    const std::vector<RelocationEntry> & packedRelativeRelocations() const noexcept
+    {
+      return mPackedRelativeRelocations;
+    }
+
+    /*! \brief Set the note section table from file
+     */
+    void setNoteSectionTableFromFile(const NoteSectionTable & table) noexcept
+    {
+      mNoteSectionTable = table;
+    }
+
+    /*! \brief Get the note section table
+     */
+    const NoteSectionTable & noteSectionTable() const noexcept
+    {
+      return mNoteSectionTable;
+    }
+
+    /*! \brief Set the .gnu_debuglink section content from file
+     */
+    void setGnuDebugLinkFromFile(const GnuDebugLink & link) noexcept
+    {
+      mGnuDebugLink = link;
+    }
+
+    /*! \brief Check if this file contains a .gnu_debuglink section that can be written
+     */
+    bool containsGnuDebugLink() const noexcept
+    {
+      return mHeaders.containsGnuDebugLinkSectionHeader() && !mGnuDebugLink.isNull();
+    }
+
+    /*! \brief Get the .gnu_debuglink section content
+     */
+    const GnuDebugLink & gnuDebugLink() const noexcept
+    {
+      return mGnuDebugLink;
+    }
+
+    /*! \brief Check if this file contains debug information
+     *
+     * Returns true if it has a .symtab section or a .debug_* section.
+     */
+    bool containsDebugInfo() const noexcept
+    {
+      const auto & sectionHeaderTable = mHeaders.sectionHeaderTable();
+
+      return std::any_of(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), [](const SectionHeader & header){
+        return (header.sectionType() == SectionType::SymbolTable) || stringStartsWith(header.name, ".debug");
+      });
+    }
+
+    /*! \brief Set the section name string table (.shstrtab) from file
+     */
+    void setSectionNameStringTableFromFile(const StringTable & table) noexcept
+    {
+      mSectionNameStringTable = table;
+    }
+
+    /*! \brief Check if this file contains the section name string table
+     */
+    bool containsSectionNameStringTable() const noexcept
+    {
+      return mHeaders.containsSectionNameStringTableHeader() && !mSectionNameStringTable.isEmpty();
+    }
+
+    /*! \brief Get the section name string table
+     */
+    const StringTable & sectionNameStringTable() const noexcept
+    {
+      return mSectionNameStringTable;
+    }
+
+    /*! \brief Get the minimum size required to write this file
+     */
+    int64_t minimumSizeToWriteFile() const noexcept
+    {
+      return mHeaders.globalFileOffsetRange().minimumSizeToAccessRange();
+    }
+
+    /*! \brief Get the file offset of the dynamic section
+     *
+     * \pre this file must contain the dynamic section program header
+     */
+    uint64_t dynamicSectionOffset() const noexcept
+    {
+      assert( mHeaders.containsDynamicProgramHeader() );
+
+      return mHeaders.dynamicProgramHeader().offset;
+    }
+
+    /*! \brief Check if the dynamic section moves to the end of this file
+     */
+    bool dynamicSectionMovesToEnd() const noexcept
+    {
+      return mHeaders.dynamicProgramHeader().offset >= mOriginalLayout.globalOffsetRange().end();
+    }
+
+    /*! \brief Check if the dynamic string table moves to the end of this file
+     */
+    bool dynamicStringTableMovesToEnd() const noexcept
+    {
+      return dynamicStringTableSectionHeader().offset >= mOriginalLayout.globalOffsetRange().end();
+    }
+
+    /*! \brief Check if the dynamic section changes its file offset
+     *
+     * This is the case if it moves to the end of this file,
+     * but also if it moves to some free space inside a existing segment.
+     */
+    bool dynamicSectionMoves() const noexcept
+    {
+      return mHeaders.dynamicProgramHeader().offset != mOriginalLayout.dynamicSectionOffset();
+    }
+
+    /*! \brief Check if the dynamic string table changes its file offset
+     *
+     * \sa dynamicSectionMoves()
+     */
+    bool dynamicStringTableMoves() const noexcept
+    {
+      return dynamicStringTableSectionHeader().offset != mOriginalLayout.dynamicStringTableOffset();
+    }
+
+    /*! \brief Get the file offset range of the dynamic string table
+     *
+     * \pre this file must have the dynamic string table section header
+     */
+    OffsetRange dynamicStringTableOffsetRange() const noexcept
+    {
+      assert( containsDynamicStringTableSectionHeader() );
+
+      return OffsetRange::fromSectionHeader( dynamicStringTableSectionHeader() );
+    }
+
+    /*! \brief Get the file offset of the dynamic string table
+     *
+     * \pre this file must have the dynamic string table section header
+     */
+    uint64_t dynamicStringTableOffset() const noexcept
+    {
+      assert( containsDynamicStringTableSectionHeader() );
+
+      return dynamicStringTableSectionHeader().offset;
+    }
+
+    /*! \brief Get the size of the dynamic string table
+     *
+     * \pre this file must have the dynamic string table section header
+     */
+    uint64_t dynamicStringTableSize() const noexcept
+    {
+      assert( containsDynamicStringTableSectionHeader() );
+
+      return dynamicStringTableSectionHeader().size;
+    }
+
+    /*! \brief Get the file offset range of the original dynamic string table
+     */
+    OffsetRange originalDynamicStringTableOffsetRange() const noexcept
+    {
+      return mOriginalLayout.dynamicStringTableOffsetRange();
+    }
+
+    /*! \brief Get the file offset range of the original content of this file
+     *
+     * If the file content has been shifted, the range is extended accordingly.
+     */
+    OffsetRange originalGlobalFileOffsetRange() const noexcept
+    {
+      return mOriginalLayout.globalOffsetRange();
+    }
+
+    /*! \brief Get the shifts of the file content, in the order they must be applied
+     *
+     * \sa FileContentShift
+     */
+    const std::vector<FileContentShift> & fileContentShifts() const noexcept
+    {
+      return mFileContentShifts;
+    }
+
+    /*! \brief Get the count of bytes the file content is shifted by
+     */
+    uint64_t fileContentShiftByteCount() const noexcept
+    {
+      uint64_t byteCount = 0;
+      for(const FileContentShift & shift : mFileContentShifts){
+        byteCount += shift.byteCount;
+      }
+
+      return byteCount;
+    }
+
+    /*! \brief Check if this file semms valid
      */
     bool seemsValid() const noexcept
     {
-      if( !mHeaders.seemsValid() ){
+      if( !mHeaders.seemsValid() ){
+        return false;
+      }
+
+      return true;
+    }
+
+   signals:
+
+    void message(const QString & message) const;
+    void verboseMessage(const QString & message) const;
+
+   private:
+
+    void editRunPath(const QString & runPath)
+    {
+      const QString msg = tr("set runpath to '%1'").arg(runPath);
+      emit message(msg);
+
+      mDynamicSection.setRunPath(runPath);
+    }
+
+    void editSoName(const QString & soName)
+    {
+      const QString msg = tr("set SONAME to '%1'").arg(soName);
+      emit message(msg);
+
+      mDynamicSection.setSoName(soName);
+    }
+
+    void editNeededSharedLibraries(const NeededSharedLibraryEdit & edit)
+    {
+      QString msg;
+
+      switch(edit.type){
+        case NeededSharedLibraryEditType::Add:
+          msg = tr("add needed library '%1'").arg(edit.library);
+          emit message(msg);
+          mDynamicSection.addNeededSharedLibrary(edit.library);
+          break;
+        case NeededSharedLibraryEditType::Remove:
+          msg = tr("remove needed library '%1'").arg(edit.library);
+          emit message(msg);
+          mDynamicSection.removeNeededSharedLibrary(edit.library);
+          break;
+        case NeededSharedLibraryEditType::Replace:
+          msg = tr("replace needed library '%1' with '%2'").arg(edit.library, edit.newLibrary);
+          emit message(msg);
+          mDynamicSection.replaceNeededSharedLibrary(edit.library, edit.newLibrary);
+          break;
+      }
+    }
+
+    void addDynamicFlags(DynamicSectionTagType tag, uint64_t flags)
+    {
+      const uint64_t currentFlags = mDynamicSection.valueForTag(tag);
+      if( (currentFlags & flags) == flags ){
+        return;
+      }
+
+      const QString msg = tr("set flags 0x%1 in %2")
+                          .arg( QString::number(currentFlags | flags, 16),
+                                (tag == DynamicSectionTagType::Flags) ? QLatin1String("DT_FLAGS") : QLatin1String("DT_FLAGS_1") );
+      emit verboseMessage(msg);
+
+      mDynamicSection.setValueForTag(tag, currentFlags | flags);
+    }
+
+    /*
+     * A shorter path is written in the existing .interp section.
+     * A longer one makes the section grow,
+     * it will be moved to the end by updateLayoutAfterEdits()
+     */
+    void editProgramInterpreter(const QString & path)
+    {
+      if( !mHeaders.containsProgramInterpreterSectionHeader() || !mHeaders.containsProgramInterpreterProgramHeader() ){
+        const QString msg = tr("cannot set the program interpreter, the file has no .interp section");
+        throw ExecutableFileWriteError(msg);
+      }
+
+      const QString msg = tr("set program interpreter to '%1'").arg(path);
+      emit message(msg);
+
+      mProgramInterpreterSection.path = path.toStdString();
+      mHeaders.setProgramInterpreterSectionSize( mProgramInterpreterSection.path.size() + 1 );
+    }
+
+    void stripNonAllocatedSections()
+    {
+      if( !containsSectionNameStringTable() ){
+        const QString msg = tr("removing the sections not needed at run time requires the section name string table");
+        throw ExecutableFileWriteError(msg);
+      }
+
+      const size_t sectionCount = mHeaders.sectionHeaderTable().size();
+      const SectionIndexChangeMap sectionIndexChangeMap = mHeaders.removeNonAllocatedSections();
+      const size_t removedSectionCount = sectionCount - mHeaders.sectionHeaderTable().size();
+      if(removedSectionCount == 0){
+        return;
+      }
+
+      const QString msg = tr("removing %1 sections not needed at run time")
+                          .arg(removedSectionCount);
+      emit verboseMessage(msg);
+
+      // .symtab has been removed
+      mSymTab.clear();
+      mDynSym.updateSectionIndexes(sectionIndexChangeMap);
+      mNoteSectionTable.removeNonAllocatedSections();
+      mNoteSectionTable.updateSectionHeaders( mHeaders.sectionHeaderTable() );
+
+      mSectionNameStringTable = mHeaders.rebuildSectionNameStringTable();
+      mHeaders.moveSectionNameStringTableAndSectionHeaderTableAfterAllocatedContent();
+    }
+
+    /*
+     * The dynamic loader maps a file at a address aligned to the largest PT_LOAD alignment,
+     * and the kernel can only back a range of a file mapping with a huge page
+     * if both its virtual address and its file offset are aligned to the huge page size.
+     * The virtual addresses can not change without relinking,
+     * so the file content is shifted to make the file offset
+     * of each selected segment congruent with its virtual address.
+     */
+    void alignLoadSegmentsForHugePages(HugePageAlignment segments)
+    {
+      assert( segments != HugePageAlignment::None );
+
+      const uint64_t pageSize = fileHeader().pageSize();
+      if(pageSize == 0){
+        const QString msg = tr("the page size of the file is unknown, the load segments are not aligned for huge pages");
+        emit message(msg);
+        return;
+      }
+
+      std::vector<size_t> indexes;
+      for(size_t i = 0; i < programHeaderTable().headerCount(); ++i){
+        if( loadSegmentMustBeAlignedForHugePages(programHeaderTable().headerAt(i), segments) ){
+          indexes.push_back(i);
+        }
+      }
+
+      // Shifting the content keeps the order of the segments in the file
+      std::sort(indexes.begin(), indexes.end(), [this](size_t a, size_t b){
+        return programHeaderTable().headerAt(a).offset < programHeaderTable().headerAt(b).offset;
+      });
+
+      for(size_t index : indexes){
+        alignLoadSegmentForHugePages(index, pageSize);
+      }
+    }
+
+    static
+    bool loadSegmentMustBeAlignedForHugePages(const ProgramHeader & header, HugePageAlignment segments) noexcept
+    {
+      if( (header.segmentType() != SegmentType::Load) || header.isWritable() ){
+        return false;
+      }
+      if( header.isExecutable() ){
+        return true;
+      }
+
+      return segments == HugePageAlignment::ExecutableAndReadOnlySegments;
+    }
+
+    void alignLoadSegmentForHugePages(size_t index, uint64_t pageSize)
+    {
+      const ProgramHeader & header = programHeaderTable().headerAt(index);
+      const uint64_t virtualAddress = header.vaddr;
+      QString msg;
+
+      if( (header.align >= hugePageSize) && ( (header.vaddr % hugePageSize) == (header.offset % hugePageSize) ) ){
+        return;
+      }
+
+      const uint64_t firstHugePageAddress = findNextAlignedAddress(header.vaddr, hugePageSize);
+      if( firstHugePageAddress + hugePageSize > header.vaddr + header.filesz ){
+        msg = tr("the PT_LOAD segment at 0x%1 is too small to be backed by huge pages, it is not aligned")
+              .arg( QString::number(virtualAddress, 16) );
+        emit verboseMessage(msg);
+        return;
+      }
+      if( (header.vaddr % pageSize) != (header.offset % pageSize) ){
+        msg = tr("the PT_LOAD segment at 0x%1 is not page aligned, it is not aligned for huge pages")
+              .arg( QString::number(virtualAddress, 16) );
+        emit message(msg);
+        return;
+      }
+
+      // The unsigned subtraction wraps modulo 2^64, which is a multiple of the huge page size
+      const uint64_t byteCount = (header.vaddr - header.offset) % hugePageSize;
+      if(byteCount > 0){
+        const uint64_t offset = header.offset;
+        if( !mHeaders.fileContentCanBeShiftedFrom(offset) ){
+          msg = tr("the PT_LOAD segment at 0x%1 shares file content with the previous segments, it is not aligned for huge pages")
+                .arg( QString::number(virtualAddress, 16) );
+          emit message(msg);
+          return;
+        }
+        msg = tr("inserting %1 bytes at file offset 0x%2")
+              .arg(byteCount).arg( QString::number(offset, 16) );
+        emit verboseMessage(msg);
+        shiftFileContentFrom(offset, byteCount);
+      }
+
+      msg = tr("aligning the PT_LOAD segment at 0x%1 for huge pages")
+            .arg( QString::number(virtualAddress, 16) );
+      emit verboseMessage(msg);
+      mHeaders.setSegmentAlignmentAt(index, hugePageSize);
+    }
+
+    void shiftFileContentFrom(uint64_t offset, uint64_t byteCount) noexcept
+    {
+      mHeaders.shiftFileContentFrom(offset, byteCount);
+      mOriginalLayout.shiftFileOffsetsFrom(offset, byteCount);
+      mSymTab.shiftFileOffsetsFrom(offset, byteCount);
+      mDynSym.shiftFileOffsetsFrom(offset, byteCount);
+      mNoteSectionTable.updateSectionHeaders( mHeaders.sectionHeaderTable() );
+      mFileContentShifts.push_back({offset, byteCount});
+    }
+
+    /*
+     * The relative relocations are removed from the dynamic relocation table
+     * and encoded in a packed relative relocation table.
+     * The remaining relocations are compacted at the start of the table,
+     * directly followed by the packed table, so nothing is added to the file.
+     *
+     * glibc only applies DT_RELR since 2.36, and a older one would silently skip it.
+     * Like the GNU linker does, the GLIBC_ABI_DT_RELR version of libc.so.6
+     * is then required, so that a older glibc refuses to load the file.
+     * The grown .gnu.version_r is put after the packed table.
+     */
+    void packRelativeRelocations()
+    {
+      QString msg;
+
+      if( mDynamicSection.valueForTag(DynamicSectionTagType::RelrTable) != 0 ){
+        msg = tr("the relative relocations are already packed (DT_RELR)");
+        emit verboseMessage(msg);
+        return;
+      }
+
+      const Class elfClass = fileHeader().ident._class;
+      const Machine machine = fileHeader().machineType();
+      if( (machine != Machine::X86) && (machine != Machine::X86_64) ){
+        msg = tr("packing the relative relocations is only supported on x86 and x86-64");
+        emit message(msg);
+        return;
+      }
+      if( !containsSectionNameStringTable() ){
+        msg = tr("packing the relative relocations requires the section name string table");
+        emit message(msg);
+        return;
+      }
+
+      const bool hasAddends = mDynamicRelocationSection.hasAddends;
+      const DynamicSectionTagType tableTag = hasAddends ? DynamicSectionTagType::RelocationTable : DynamicSectionTagType::RelTable;
+      const DynamicSectionTagType sizeTag = hasAddends ? DynamicSectionTagType::RelocationTableSize : DynamicSectionTagType::RelTableSize;
+      const DynamicSectionTagType countTag = hasAddends ? DynamicSectionTagType::RelaCount : DynamicSectionTagType::RelCount;
+      const uint64_t tableAddress = mDynamicSection.valueForTag(tableTag);
+      const uint16_t sectionIndex = mHeaders.findIndexOfSectionHeaderAtAddress(hasAddends ? SectionType::Rela : SectionType::Rel, tableAddress);
+      if( (tableAddress == 0) || ( sectionIndex >= mHeaders.sectionHeaderTable().size() ) ){
+        msg = tr("the file has no dynamic relocation table, there are no relative relocations to pack");
+        emit verboseMessage(msg);
+        return;
+      }
+
+      const SectionHeader relocationSectionHeader = mHeaders.sectionHeaderTable()[sectionIndex];
+      const uint64_t entrySize = static_cast<uint64_t>( relocationEntrySize(elfClass, hasAddends) );
+      const uint64_t originalSize = relocationSectionHeader.size;
+      if( (mDynamicSection.valueForTag(sizeTag) != originalSize)
+          || (mDynamicRelocationSection.entries.size() * entrySize != originalSize) ){
+        msg = tr("the dynamic relocation table does not match the %1 section, the relative relocations are not packed")
+              .arg( QString::fromStdString(relocationSectionHeader.name) );
+        emit message(msg);
+        return;
+      }
+
+      const uint16_t versionNeedSectionIndex = mHeaders.findIndexOfSectionHeaderAtAddress(
+        SectionType::GnuVersionNeed, mDynamicSection.valueForTag(DynamicSectionTagType::VersionNeed)
+      );
+      const size_t libcIndex = mGnuVersionNeedTable.findIndexOfEntryForFile("libc.so.6", mDynamicSection.stringTable());
+      if( ( versionNeedSectionIndex >= mHeaders.sectionHeaderTable().size() ) || ( libcIndex >= mGnuVersionNeedTable.entries.size() ) ){
+        msg = tr("the file requires no version of libc.so.6, so it can not require GLIBC_ABI_DT_RELR."
+                 " The relative relocations are not packed");
+        emit message(msg);
+        return;
+      }
+
+      std::vector<RelocationEntry> relativeRelocations;
+      std::vector<RelocationEntry> otherRelocations;
+      splitPackableRelativeRelocations(relativeRelocations, otherRelocations);
+      if( relativeRelocations.empty() ){
+        msg = tr("the file has no relative relocations to pack");
+        emit verboseMessage(msg);
+        return;
+      }
+
+      std::vector<uint64_t> addresses;
+      addresses.reserve( relativeRelocations.size() );
+      for(const RelocationEntry & entry : relativeRelocations){
+        addresses.push_back(entry.offset);
+      }
+      std::vector<uint64_t> relrTable = makeRelrTable(addresses, elfClass);
+
+      /*
+       * Layout inside the place of the original relocation table:
+       * the remaining relocations, the packed table, then .gnu.version_r
+       */
+      const uint64_t relrEntryByteCount = static_cast<uint64_t>( relrEntrySize(elfClass) );
+      const uint64_t remainingSize = otherRelocations.size() * entrySize;
+      const uint64_t relrSize = relrTable.size() * relrEntryByteCount;
+
+      constexpr std::string_view relrVersionName = "GLIBC_ABI_DT_RELR";
+      GnuVersionNeedTable versionNeedTable = mGnuVersionNeedTable;
+      const bool mustRequireRelrVersion = !versionNeedTable.entryRequiresVersion(libcIndex, relrVersionName, mDynamicSection.stringTable());
+      const SectionHeader & versionNeedSectionHeader = mHeaders.sectionHeaderTable()[versionNeedSectionIndex];
+      const uint64_t versionNeedAlignment = std::max(versionNeedSectionHeader.addralign, uint64_t(1));
+      const uint64_t versionNeedOffsetInTable = findNextAlignedAddress(remainingSize + relrSize, versionNeedAlignment);
+      const uint64_t versionNeedSize = static_cast<uint64_t>( versionNeedTable.byteCount() )
+                                     + (mustRequireRelrVersion ? GnuVersionNeedTable::auxEntryByteCount : 0);
+      if( mustRequireRelrVersion && (versionNeedOffsetInTable + versionNeedSize > originalSize) ){
+        msg = tr("packing the %1 relative relocations leaves no place to require GLIBC_ABI_DT_RELR, they are not packed")
+              .arg( relativeRelocations.size() );
+        emit message(msg);
+        return;
+      }
+
+      const uint64_t tableOffset = relocationSectionHeader.offset;
+
+      if(mustRequireRelrVersion){
+        GnuVersionNeedAuxEntry relrVersion;
+        relrVersion.hash = elfHash(relrVersionName);
+        relrVersion.other = static_cast<uint16_t>(
+          std::max<uint64_t>( versionNeedTable.highestVersionIndex(), mDynamicSection.valueForTag(DynamicSectionTagType::VersionDefinitionCount) ) + 1
+        );
+        relrVersion.name = static_cast<uint32_t>( mDynamicSection.addStringToStringTable( std::string(relrVersionName) ) );
+        versionNeedTable.entries[libcIndex].auxEntries.push_back(relrVersion);
+
+        mHeaders.setSectionSizeAt(versionNeedSectionIndex, versionNeedSize);
+        mHeaders.moveSectionAt(versionNeedSectionIndex, tableOffset + versionNeedOffsetInTable, tableAddress + versionNeedOffsetInTable);
+        mDynamicSection.setValueForTag(DynamicSectionTagType::VersionNeed, tableAddress + versionNeedOffsetInTable);
+        mGnuVersionNeedTable = versionNeedTable;
+      }
+
+      mHeaders.setSectionSizeAt(sectionIndex, remainingSize);
+      mDynamicSection.setValueForTag(sizeTag, remainingSize);
+      if( mDynamicSection.valueForTag(countTag) != 0 ){
+        mDynamicSection.setValueForTag( countTag, countOfLeadingRelativeRelocations(otherRelocations) );
+      }
+      mDynamicSection.setValueForTag(DynamicSectionTagType::RelrTable, tableAddress + remainingSize);
+      mDynamicSection.setValueForTag(DynamicSectionTagType::RelrTableSize, relrSize);
+      mDynamicSection.setValueForTag(DynamicSectionTagType::RelrEntrySize, relrEntryByteCount);
+
+      SectionHeader relrSectionHeader;
+      relrSectionHeader.name = ".relr.dyn";
+      relrSectionHeader.nameIndex = 0;
+      relrSectionHeader.type = static_cast<uint32_t>(SectionType::Relr);
+      relrSectionHeader.flags = static_cast<uint64_t>(SectionAttributeFlag::Alloc);
+      relrSectionHeader.addr = tableAddress + remainingSize;
+      relrSectionHeader.offset = tableOffset + remainingSize;
+      relrSectionHeader.size = relrSize;
+      relrSectionHeader.addralign = relrEntryByteCount;
+      relrSectionHeader.entsize = relrEntryByteCount;
+      mHeaders.addSectionHeader(relrSectionHeader);
+      mSectionNameStringTable = mHeaders.rebuildSectionNameStringTable();
+      mHeaders.moveSectionNameStringTableAndSectionHeaderTableToEnd();
+
+      msg = tr("packing %1 relative relocations in a %2 bytes DT_RELR table, %3 shrinks from %4 to %5 bytes")
+            .arg( relativeRelocations.size() ).arg(relrSize)
+            .arg( QString::fromStdString(relocationSectionHeader.name) ).arg(originalSize).arg(remainingSize);
+      emit verboseMessage(msg);
+
+      mDynamicRelocationSection.entries = otherRelocations;
+      mPackedRelativeRelocations = relativeRelocations;
+      mRelrTable = std::move(relrTable);
+    }
+
+    /*
+     * A relative relocation can be packed if it relocates a aligned word
+     * that is loaded from the file, so that its addend can be stored there.
+     * Relocations of the same address are kept as is,
+     * because their order matters.
+     * The packable ones are sorted by address, the other ones keep their order.
+     */
+    void splitPackableRelativeRelocations(std::vector<RelocationEntry> & relativeRelocations,
+                                          std::vector<RelocationEntry> & otherRelocations) const
+    {
+      const Machine machine = fileHeader().machineType();
+      const uint64_t wordSize = static_cast<uint64_t>( relrEntrySize(fileHeader().ident._class) );
+
+      const auto isPackable = [this, machine, wordSize](const RelocationEntry & entry){
+        return isRelativeRelocationType(machine, entry.type) && (entry.symbolIndex == 0)
+            && ( (entry.offset % wordSize) == 0 )
+            && ( mHeaders.programHeaderTable().findFileOffsetOfVirtualAddress(entry.offset, wordSize) != 0 );
+      };
+
+      std::vector<uint64_t> packableAddresses;
+      for(const RelocationEntry & entry : mDynamicRelocationSection.entries){
+        if( isPackable(entry) ){
+          packableAddresses.push_back(entry.offset);
+        }
+      }
+      std::sort(packableAddresses.begin(), packableAddresses.end());
+      std::vector<uint64_t> duplicateAddresses;
+      for(size_t i = 1; i < packableAddresses.size(); ++i){
+        if( packableAddresses[i] == packableAddresses[i-1] ){
+          duplicateAddresses.push_back(packableAddresses[i]);
+        }
+      }
+
+      for(const RelocationEntry & entry : mDynamicRelocationSection.entries){
+        if( isPackable(entry) && !std::binary_search(duplicateAddresses.cbegin(), duplicateAddresses.cend(), entry.offset) ){
+          relativeRelocations.push_back(entry);
+        }else{
+          otherRelocations.push_back(entry);
+        }
+      }
+
+      const auto cmp = [](const RelocationEntry & a, const RelocationEntry & b){
+        return a.offset < b.offset;
+      };
+      std::sort(relativeRelocations.begin(), relativeRelocations.end(), cmp);
+    }
+
+    /*
+     * DT_RELACOUNT (or DT_RELCOUNT) tells the dynamic loader
+     * how many relocations at the start of the table are relative ones.
+     */
+    uint64_t countOfLeadingRelativeRelocations(const std::vector<RelocationEntry> & relocations) const noexcept
+    {
+      const Machine machine = fileHeader().machineType();
+
+      const auto isNotRelative = [machine](const RelocationEntry & entry){
+        return !isRelativeRelocationType(machine, entry.type);
+      };
+      const auto it = std::find_if(relocations.cbegin(), relocations.cend(), isNotRelative);
+
+      return static_cast<uint64_t>( std::distance(relocations.cbegin(), it) );
+    }
+
+    /*
+     * The strings referenced from outside the dynamic section
+     * are taken from originalStringTable ,
+     * the other ones from the current string table,
+     * that can have been edited (run path, new version names, ...).
+     */
+    void compactDynamicStringTable(const StringTable & originalStringTable)
+    {
+      QString msg;
+
+      if( !mDynamicStringTableReferencesAreKnown ){
+        msg = tr("the references to the .dynstr section are unknown, it is not compacted");
+        emit message(msg);
+        return;
+      }
+
+      if( !mHeaders.containsDynamicSectionHeader() || !mHeaders.containsDynamicStringTableSectionHeader() ){
+        msg = tr("the file has no .dynamic or no .dynstr section, the dynamic string table is not compacted");
+        emit message(msg);
+        return;
+      }
+
+      const uint32_t dynamicStringTableIndex = mHeaders.dynamicSectionHeader().link;
+      for(const SectionHeader & header : mHeaders.sectionHeaderTable()){
+        if(header.link != dynamicStringTableIndex){
+          continue;
+        }
+        switch( header.sectionType() ){
+          case SectionType::Dynamic:
+          case SectionType::DynSym:
+          case SectionType::GnuVersionDef:
+            break;
+          case SectionType::GnuVersionNeed:
+            // The table is rewritten with the layout of the GNU linker, it must fit the section
+            if( static_cast<uint64_t>( mGnuVersionNeedTable.byteCount() ) != header.size ){
+              msg = tr("the .gnu.version_r section is unknown, the dynamic string table is not compacted");
+              emit message(msg);
+              return;
+            }
+            break;
+          default:
+            msg = tr("section %1 refers to the .dynstr section, the dynamic string table is not compacted")
+                  .arg( QString::fromStdString(header.name) );
+            emit message(msg);
+            return;
+        }
+      }
+
+      const StringTable & currentStringTable = mDynamicSection.stringTable();
+
+      std::vector<uint64_t> currentIndexes = mDynamicSection.stringTableIndexes();
+      for(const GnuVersionNeedEntry & entry : mGnuVersionNeedTable.entries){
+        currentIndexes.push_back(entry.file);
+        for(const GnuVersionNeedAuxEntry & auxEntry : entry.auxEntries){
+          currentIndexes.push_back(auxEntry.name);
+        }
+      }
+
+      std::vector<uint64_t> originalIndexes;
+      originalIndexes.reserve( mDynamicStringTableReferences.size() );
+      for(const DynamicStringTableReference & reference : mDynamicStringTableReferences){
+        originalIndexes.push_back(reference.index);
+      }
+
+      const auto isValidIn = [](const StringTable & table){
+        return [&table](uint64_t index){
+          return table.indexIsValid(index);
+        };
+      };
+      if( !std::all_of( currentIndexes.cbegin(), currentIndexes.cend(), isValidIn(currentStringTable) )
+       || !std::all_of( originalIndexes.cbegin(), originalIndexes.cend(), isValidIn(originalStringTable) ) ){
+        msg = tr("a reference to the .dynstr section is out of bound, it is not compacted");
+        emit message(msg);
+        return;
+      }
+
+      StringTableBuilder builder;
+      builder.addStringsAtIndexes(currentStringTable, currentIndexes);
+      builder.addStringsAtIndexes(originalStringTable, originalIndexes);
+      const StringTable stringTable = builder.build();
+
+      /*
+       * Even if the built table is not smaller,
+       * it is used, so that all references are consistent
+       * (a other edit can have removed a string from the current table)
+       */
+      assert( !stringTable.isEmpty() );
+
+      const StringTableIndexMap currentIndexMap = builder.indexMapForTable(currentStringTable, currentIndexes);
+      const StringTableIndexMap originalIndexMap = builder.indexMapForTable(originalStringTable, originalIndexes);
+
+      for(GnuVersionNeedEntry & entry : mGnuVersionNeedTable.entries){
+        entry.file = static_cast<uint32_t>( currentIndexMap.newIndexForOldIndex(entry.file) );
+        for(GnuVersionNeedAuxEntry & auxEntry : entry.auxEntries){
+          auxEntry.name = static_cast<uint32_t>( currentIndexMap.newIndexForOldIndex(auxEntry.name) );
+        }
+      }
+      for(DynamicStringTableReference & reference : mDynamicStringTableReferences){
+        reference.index = originalIndexMap.newIndexForOldIndex(reference.index);
+      }
+      mDynSym.updateNameIndexes(originalIndexMap);
+
+      msg = tr("compacting the .dynstr section: %1 strings in %2 bytes instead of %3")
+            .arg( builder.stringCount() ).arg( stringTable.byteCount() ).arg( originalStringTable.byteCount() );
+      emit verboseMessage(msg);
+
+      mDynamicSection.setStringTable(stringTable, currentIndexMap);
+      mDynamicStringTableIsCompacted = true;
+    }
+
+    /*
+     * The stamp is put in a note section that is not loaded,
+     * just before the section name string table.
+     * So that it can be read without the section headers,
+     * that are at the end of the file,
+     * it is covered by its own PT_NOTE, with a p_memsz of 0.
+     * If the file has no such PT_NOTE yet,
+     * it is added by updateLayoutAfterEdits(),
+     * that knows if some place must be made in the program header table.
+     */
+    void setDeployStamp(const DeployStamp & stamp)
+    {
+      assert( !stamp.isNull() );
+
+      QString msg;
+
+      if( !containsSectionNameStringTable() ){
+        msg = tr("writing the deployment stamp requires the section name string table");
+        emit message(msg);
+        return;
+      }
+
+      const NoteSection noteSection = DeployStampNote::noteSectionFromStamp( stamp, fileHeader().ident.dataFormat );
+      const uint64_t size = static_cast<uint64_t>( noteSection.byteCountAligned() );
+
+      if( mHeaders.containsDeployStampNoteSectionHeader() ){
+        mHeaders.setDeployStampNoteSize(size);
+      }else{
+        SectionHeader sectionHeader;
+        sectionHeader.name = DeployStampNote::sectionName();
+        sectionHeader.nameIndex = 0;
+        sectionHeader.type = static_cast<uint32_t>(SectionType::Note);
+        sectionHeader.flags = 0;
+        sectionHeader.addr = 0;
+        sectionHeader.offset = 0;
+        sectionHeader.size = size;
+        sectionHeader.addralign = 4;
+        sectionHeader.entsize = 0;
+        mHeaders.addSectionHeader(sectionHeader);
+        mSectionNameStringTable = mHeaders.rebuildSectionNameStringTable();
+      }
+      mHeaders.moveSectionNameStringTableAndSectionHeaderTableToEnd();
+
+      const uint16_t sectionIndex = mHeaders.findIndexOfDeployStampNoteSectionHeader();
+      mNoteSectionTable.setSection(mHeaders.sectionHeaderTable()[sectionIndex], noteSection);
+      mMustAddDeployStampNoteProgramHeader =
+        mHeaders.findIndexOfDeployStampNoteProgramHeader() >= mHeaders.programHeaderTable().headerCount();
+
+      msg = tr("writing a %1 bytes deployment stamp at offset 0x%2")
+            .arg(size).arg( mHeaders.sectionHeaderTable()[sectionIndex].offset, 0, 16 );
+      emit verboseMessage(msg);
+    }
+
+    void rebuildGnuHashTable()
+    {
+      QString msg;
+
+      if( !mHeaders.containsGnuHashTableSectionHeader() ){
+        msg = tr("the file has no .gnu.hash section, adding one is not supported");
+        emit message(msg);
+        return;
+      }
+
+      const uint32_t originalBucketCount = mGnuHashTableSection.bucketCount();
+      if( (originalBucketCount == 0) || (mGnuHashTableSection.symoffset == 0)
+          || (mGnuHashedSymbolHashes.size() != mGnuHashTableSection.chain.size()) ){
+        msg = tr("the symbols covered by the .gnu.hash section are unknown, it is not rebuilt");
+        emit message(msg);
+        return;
+      }
+      if( !symbolsAreInGnuHashOrder(mGnuHashedSymbolHashes, originalBucketCount) ){
+        msg = tr("the dynamic symbols are not ordered as the .gnu.hash section requires, it is not rebuilt");
+        emit message(msg);
+        return;
+      }
+
+      const Class elfClass = fileHeader().ident._class;
+      const GnuHashTable table = makeOptimizedGnuHashTable(mGnuHashedSymbolHashes, mGnuHashTableSection, elfClass);
+      if( gnuHashTablesAreEqual(table, mGnuHashTableSection) ){
+        msg = tr("the .gnu.hash section is already sized for its %1 symbols")
+              .arg( mGnuHashedSymbolHashes.size() );
+        emit verboseMessage(msg);
+        return;
+      }
+
+      const uint64_t originalSize = mHeaders.gnuHashTableSectionHeader().size;
+      const int64_t size = table.byteCount(elfClass);
+      assert( size > 0 );
+      mHeaders.setGnuHashTableSize( static_cast<uint64_t>(size) );
+
+      if( ( static_cast<uint64_t>(size) > originalSize ) && !moveGrownGnuHashTable() ){
+        mHeaders.setGnuHashTableSize(originalSize);
+        msg = tr("no free space in the loaded segments for the rebuilt .gnu.hash section (%1 bytes), it is not rebuilt")
+              .arg(size);
+        emit message(msg);
+        return;
+      }
+
+      msg = tr("rebuilding .gnu.hash section: %1 buckets (was %2), bloom size %3 (was %4)")
+            .arg( table.bucketCount() ).arg(originalBucketCount)
+            .arg( table.bloomSize() ).arg( mGnuHashTableSection.bloomSize() );
+      emit verboseMessage(msg);
+
+      mGnuHashTableSection = table;
+    }
+
+    /*
+     * Returns true if the .gnu.hash section, with its new size,
+     * could be placed in free space inside a existing PT_LOAD segment,
+     * or past the end of the last PT_LOAD segment, extending it.
+     * The layout is done at this point, so no program header will be added.
+     */
+    bool moveGrownGnuHashTable() noexcept
+    {
+      const uint16_t sectionIndex = mHeaders.gnuHashTableSectionHeaderIndex();
+
+      uint64_t offset;
+      uint64_t address;
+      const OffsetRange range = findFreeSpaceForSection(sectionIndex, 0);
+      if( !range.isEmpty() ){
+        if( range.begin() == mHeaders.gnuHashTableSectionHeader().offset ){
+          return true;
+        }
+        const ProgramHeader *loadProgramHeader = findLoadProgramHeaderContainingFileRange(mHeaders.programHeaderTable(), range);
+        assert( loadProgramHeader != nullptr );
+        offset = range.begin();
+        address = freeSpaceVirtualAddress(*loadProgramHeader, range);
+        mHeaders.moveGnuHashTableTo(offset, address);
+      }else{
+        const size_t loadIndex = mHeaders.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read);
+        if( loadIndex >= mHeaders.programHeaderTable().headerCount() ){
+          return false;
+        }
+        const uint64_t alignment = std::max(mHeaders.gnuHashTableSectionHeader().addralign, uint64_t(1));
+        address = mHeaders.findNextVirtualAddressToExtendLoadSegment(loadIndex, alignment);
+        offset = mHeaders.fileOffsetInLoadSegment(loadIndex, address);
+        mHeaders.moveGnuHashTableTo(offset, address);
+        mHeaders.extendLoadProgramHeaderToCoverSection( loadIndex, mHeaders.gnuHashTableSectionHeader() );
+      }
+
+      if( mDynamicSection.containsGnuHashTableAddress() ){
+        mDynamicSection.setGnuHashTableAddress(address);
+      }
+      mSymTab.updateVirtualAddresses( {sectionIndex}, mHeaders.sectionHeaderTable(), mSymbolTableUpdateThreadCount );
+      mDynSym.updateVirtualAddresses( {sectionIndex}, mHeaders.sectionHeaderTable(), mSymbolTableUpdateThreadCount );
+
+      const QString msg = tr("moving .gnu.hash section to offset 0x%1")
+                          .arg(offset, 0, 16);
+      emit verboseMessage(msg);
+
+      return true;
+    }
+
+    void updateDynamicSectionAddressReferences() noexcept
+    {
+      if( mGotSection.containsDynamicSectionAddress() ){
+        mGotSection.setDynamicSectionAddress(mHeaders.dynamicSectionHeader().addr);
+      }
+      if( mGotPltSection.containsDynamicSectionAddress() ){
+        mGotPltSection.setDynamicSectionAddress(mHeaders.dynamicSectionHeader().addr);
+      }
+    }
+
+    void updateDynamicStringTableAddressReferences() noexcept
+    {
+      if( mDynamicSection.containsStringTableAddress() ){
+        mDynamicSection.setStringTableAddress(mHeaders.dynamicStringTableSectionHeader().addr);
+      }
+    }
+
+    /*
+     * Find free space, inside a existing PT_LOAD segment,
+     * that can hold the section at sectionIndex with its current size.
+     * The section itself is not considered as using space,
+     * so it can stay at its place (or near) if it has enough padding after it.
+     * Place for reservedProgramHeaderCount more program headers
+     * is kept after the program header table.
+     *
+     * Returns a empty range if no such free space exists.
+     */
+    OffsetRange findFreeSpaceForSection(uint16_t sectionIndex, uint16_t reservedProgramHeaderCount) const noexcept
+    {
+      const SectionHeader & header = mHeaders.sectionHeaderTable()[sectionIndex];
+      assert( header.size > 0 );
+
+      SegmentPermissions permissions = SegmentPermission::Read;
+      if( header.isWritable() ){
+        permissions = SegmentPermission::Read | SegmentPermission::Write;
+      }
+      const uint64_t alignment = std::max(header.addralign, uint64_t(1));
+
+      const FreeSpaceMap freeSpaceMap = makeFreeSpaceMapInLoadSegments(mHeaders, permissions, {sectionIndex}, reservedProgramHeaderCount);
+      const OffsetRange range = freeSpaceMap.findFirstFit(header.size, alignment);
+      if( range.isEmpty() ){
+        return range;
+      }
+
+      const ProgramHeader *loadProgramHeader = findLoadProgramHeaderContainingFileRange(mHeaders.programHeaderTable(), range);
+      assert( loadProgramHeader != nullptr );
+      if( ( freeSpaceVirtualAddress(*loadProgramHeader, range) % alignment ) != 0 ){
+        return OffsetRange();
+      }
+
+      return range;
+    }
+
+    static
+    uint64_t freeSpaceVirtualAddress(const ProgramHeader & loadProgramHeader, const OffsetRange & range) noexcept
+    {
+      assert( range.begin() >= loadProgramHeader.offset );
+
+      return loadProgramHeader.vaddr + (range.begin() - loadProgramHeader.offset);
+    }
+
+    /*
+     * Returns true if the .dynamic section could be placed in free space
+     */
+    bool moveDynamicSectionToFreeSpace() noexcept
+    {
+      const OffsetRange range = findFreeSpaceForSection( mHeaders.dynamicSectionHeaderIndex(), static_cast<uint16_t>(1 + pendingProgramHeaderCount()) );
+      if( range.isEmpty() ){
+        return false;
+      }
+
+      const ProgramHeader *loadProgramHeader = findLoadProgramHeaderContainingFileRange(mHeaders.programHeaderTable(), range);
+      assert( loadProgramHeader != nullptr );
+      mHeaders.moveDynamicSectionTo( range.begin(), freeSpaceVirtualAddress(*loadProgramHeader, range) );
+      updateDynamicSectionAddressReferences();
+
+      return true;
+    }
+
+    /*
+     * Returns true if the .dynstr section could be placed in free space
+     */
+    bool moveDynamicStringTableToFreeSpace() noexcept
+    {
+      const OffsetRange range = findFreeSpaceForSection( mHeaders.dynamicStringTableSectionHeaderIndex(), static_cast<uint16_t>(1 + pendingProgramHeaderCount()) );
+      if( range.isEmpty() ){
+        return false;
+      }
+
+      const ProgramHeader *loadProgramHeader = findLoadProgramHeaderContainingFileRange(mHeaders.programHeaderTable(), range);
+      assert( loadProgramHeader != nullptr );
+      mHeaders.moveDynamicStringTableTo( range.begin(), freeSpaceVirtualAddress(*loadProgramHeader, range) );
+      updateDynamicStringTableAddressReferences();
+
+      return true;
+    }
+
+    /*
+     * Returns true if the sections could be put past the end
+     * of the last PT_LOAD segment, extending it.
+     * In that case, no new PT_LOAD is required,
+     * so no section has to be moved to make place in the program header table.
+     */
+    SegmentPermissions permissionsForSectionsToMove(bool moveProgramInterpreter, bool moveDynamicSection, bool moveDynamicStringTable) const noexcept
+    {
+      bool containsWritableSection = false;
+      if( moveProgramInterpreter && mHeaders.programInterpreterSectionHeader().isWritable() ){
+        containsWritableSection = true;
+      }
+      if( moveDynamicSection && mHeaders.dynamicSectionHeader().isWritable() ){
+        containsWritableSection = true;
+      }
+      if( moveDynamicStringTable && mHeaders.dynamicStringTableSectionHeader().isWritable() ){
+        containsWritableSection = true;
+      }
+
+      if(containsWritableSection){
+        return SegmentPermission::Read | SegmentPermission::Write;
+      }
+
+      return SegmentPermission::Read;
+    }
+
+    bool moveSectionsToEndExtendingLastLoadSegment(bool moveProgramInterpreter, bool moveDynamicSection, bool moveDynamicStringTable) noexcept
+    {
+      const SegmentPermissions permissions = permissionsForSectionsToMove(moveProgramInterpreter, moveDynamicSection, moveDynamicStringTable);
+
+      const size_t loadIndex = mHeaders.findIndexOfExtensibleLastLoadProgramHeader(permissions);
+      if( loadIndex >= mHeaders.programHeaderTable().headerCount() ){
+        return false;
+      }
+
+      const auto nextAddress = [this, loadIndex](const SectionHeader & header){
+        const uint64_t alignment = std::max(header.addralign, uint64_t(1));
+        return mHeaders.findNextVirtualAddressToExtendLoadSegment(loadIndex, alignment);
+      };
+
+      if(moveProgramInterpreter){
+        const uint64_t address = nextAddress( mHeaders.programInterpreterSectionHeader() );
+        mHeaders.moveProgramInterpreterSectionTo( mHeaders.fileOffsetInLoadSegment(loadIndex, address), address );
+        mHeaders.extendLoadProgramHeaderToCoverSection( loadIndex, mHeaders.programInterpreterSectionHeader() );
+      }
+      if(moveDynamicSection){
+        const uint64_t address = nextAddress( mHeaders.dynamicSectionHeader() );
+        mHeaders.moveDynamicSectionTo( mHeaders.fileOffsetInLoadSegment(loadIndex, address), address );
+        mHeaders.extendLoadProgramHeaderToCoverSection( loadIndex, mHeaders.dynamicSectionHeader() );
+        updateDynamicSectionAddressReferences();
+      }
+      if(moveDynamicStringTable){
+        const uint64_t address = nextAddress( mHeaders.dynamicStringTableSectionHeader() );
+        mHeaders.moveDynamicStringTableTo( mHeaders.fileOffsetInLoadSegment(loadIndex, address), address );
+        mHeaders.extendLoadProgramHeaderToCoverSection( loadIndex, mHeaders.dynamicStringTableSectionHeader() );
+        updateDynamicStringTableAddressReferences();
+      }
+
+      return true;
+    }
+
+    void updateSymbolTablesForMovedSections(bool programInterpreterMoved, bool dynamicSectionMoved, bool dynamicStringTableMoved) noexcept
+    {
+      std::vector<uint16_t> indexes;
+      if(programInterpreterMoved){
+        indexes.push_back( mHeaders.programInterpreterSectionHeaderIndex() );
+      }
+      if(dynamicSectionMoved){
+        indexes.push_back( mHeaders.dynamicSectionHeaderIndex() );
+      }
+      if(dynamicStringTableMoved){
+        indexes.push_back( mHeaders.dynamicStringTableSectionHeaderIndex() );
+      }
+      if( indexes.empty() ){
+        return;
+      }
+
+      mSymTab.updateVirtualAddresses( indexes, mHeaders.sectionHeaderTable(), mSymbolTableUpdateThreadCount );
+      mDynSym.updateVirtualAddresses( indexes, mHeaders.sectionHeaderTable(), mSymbolTableUpdateThreadCount );
+    }
+
+    uint64_t sizeOfSectionsToMove(bool moveProgramInterpreter, bool moveDynamicSection, bool moveDynamicStringTable) const noexcept
+    {
+      uint64_t size = 0;
+      if(moveProgramInterpreter){
+        size += mHeaders.programInterpreterSectionHeader().size;
+      }
+      if(moveDynamicSection){
+        size += mHeaders.dynamicSectionHeader().size;
+      }
+      if(moveDynamicStringTable){
+        size += mHeaders.dynamicStringTableSectionHeader().size;
+      }
+
+      return size;
+    }
+
+    /*
+     * Estimate the cost of moving the first sectionToMoveCount sections
+     * (the null section included) to the end, followed by the other sections to move.
+     * This is not valid if one of the first sections can not be moved.
+     *
+     * The section header table must be sorted by file offset.
+     */
+    LayoutCost estimateMoveFirstSectionsCost(uint16_t sectionToMoveCount, uint64_t sizeOfOtherSectionsToMove) const noexcept
+    {
+      assert( mHeaders.sectionHeaderTableIsSortedByFileOffset() );
+
+      LayoutCost cost;
+      const uint64_t pageSize = fileHeader().pageSize();
+      const auto & sectionHeaderTable = mHeaders.sectionHeaderTable();
+      if( (pageSize == 0) || ( sectionToMoveCount >= sectionHeaderTable.size() ) ){
+        return cost;
+      }
+
+      uint64_t movedSize = 0;
+      bool movesNoteSections = false;
+      for(uint16_t i = 1; i < sectionToMoveCount; ++i){
+        const SectionHeader & header = sectionHeaderTable[i];
+        if( header.sectionType() == SectionType::Note ){
+          movesNoteSections = true;
+        }else if( header.isProgramInterpreterSectionHeader() || header.isGnuHashTableSectionHeader() ){
+          movedSize += header.size;
+        }else{
+          return cost;
+        }
+      }
+      // All the note sections are moved together
+      if(movesNoteSections){
+        for( const SectionHeader & header : mHeaders.getNoteSectionHeaders() ){
+          movedSize += header.size;
+        }
+      }
+
+      // The first moved section is aligned to the next page
+      uint64_t padding = 0;
+      if(sectionToMoveCount > 1){
+        const uint64_t fileEnd = mHeaders.findGlobalFileOffsetEnd();
+        padding = findAddressOfNextPage(fileEnd, pageSize) - fileEnd;
+      }
+
+      cost.isValid = true;
+      cost.bytesCopied = movedSize + sizeOfOtherSectionsToMove;
+      cost.fileGrowth = padding + cost.bytesCopied;
+      cost.newSegmentCount = 1;
+      cost.pagesTouched = pageCountForByteCount(cost.bytesCopied, pageSize);
+
+      return cost;
+    }
+
+    /*
+     * Estimate the cost of moving the program header table,
+     * with one more entry (and the pending ones), to the next page past the end,
+     * followed by the sections to move.
+     *
+     * This is only valid for ET_DYN files (shared libraries and position independent executables).
+     * Executables (ET_EXEC) with the program header table at the end
+     * crashed while glibc parsed it (see updateLayoutAfterEdits()).
+     */
+    LayoutCost estimateMoveProgramHeaderTableCost(uint64_t sizeOfSectionsToMove) const noexcept
+    {
+      LayoutCost cost;
+      const uint64_t pageSize = fileHeader().pageSize();
+      if( (pageSize == 0) || ( fileHeader().objectFileType() != ObjectFileType::SharedObject ) ){
+        return cost;
+      }
+      if( !mHeaders.containsProgramHeaderTable() ){
+        return cost;
+      }
+
+      const uint64_t fileEnd = mHeaders.findGlobalFileOffsetEnd();
+      const uint64_t virtualAddressEnd = mHeaders.findGlobalVirtualAddressEnd();
+      const uint64_t programHeaderTableOffset = findAddressOfNextPage(std::max(virtualAddressEnd, fileEnd), pageSize);
+      const uint64_t programHeaderTableSize = ( static_cast<uint64_t>( fileHeader().phnum ) + 1 + pendingProgramHeaderCount() ) * fileHeader().phentsize;
+
+      cost.isValid = true;
+      cost.bytesCopied = programHeaderTableSize + sizeOfSectionsToMove;
+      cost.fileGrowth = programHeaderTableOffset - fileEnd + cost.bytesCopied;
+      cost.newSegmentCount = 1;
+      cost.pagesTouched = pageCountForByteCount(cost.bytesCopied, pageSize);
+
+      return cost;
+    }
+
+    ProgramHeaderTableGrowthStrategy forcedProgramHeaderTableGrowthStrategy(const LayoutCost & moveFirstSectionsCost,
+                                                                            const LayoutCost & moveProgramHeaderTableCost,
+                                                                            ProgramHeaderTableGrowthStrategy chosenStrategy) const noexcept
+    {
+      assert( mForcedProgramHeaderTableGrowthStrategy );
+
+      switch(*mForcedProgramHeaderTableGrowthStrategy){
+        case ProgramHeaderTableGrowthStrategy::MoveFirstSections:
+          if(moveFirstSectionsCost.isValid){
+            return ProgramHeaderTableGrowthStrategy::MoveFirstSections;
+          }
+          break;
+        case ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable:
+          if(moveProgramHeaderTableCost.isValid){
+            return ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable;
+          }
+          break;
+      }
+
+      return chosenStrategy;
+    }
+
+    QString layoutCostToString(const LayoutCost & cost) const
+    {
+      if(!cost.isValid){
+        return tr("not possible");
+      }
+
+      return tr("%1 bytes copied, file grows by %2 bytes, %3 new segment(s), %4 page(s) touched at load")
+             .arg(cost.bytesCopied).arg(cost.fileGrowth).arg(cost.newSegmentCount).arg(cost.pagesTouched);
+    }
+
+    /*
+     * Move the program header table to the next page past the end,
+     * covered by a new PT_LOAD segment,
+     * then extend this segment to also cover the sections to move.
+     */
+    void moveProgramHeaderTableAndSectionsToEnd(bool moveProgramInterpreter, bool moveDynamicSection, bool moveDynamicStringTable)
+    {
+      QString msg = tr("moving the program header table to the next page after the end");
+      emit verboseMessage(msg);
+
+      mHeaders.moveProgramHeaderTableToNextPageAfterEnd();
+
+      // The program header table is moved to a file offset that equals its virtual address
+      const uint64_t programHeaderTableOffset = fileHeader().phoff;
+      ProgramHeader loadSegmentHeader;
+      loadSegmentHeader.setSegmentType(SegmentType::Load);
+      loadSegmentHeader.setPermissions( permissionsForSectionsToMove(moveProgramInterpreter, moveDynamicSection, moveDynamicStringTable) );
+      loadSegmentHeader.offset = programHeaderTableOffset;
+      loadSegmentHeader.vaddr = programHeaderTableOffset;
+      loadSegmentHeader.paddr = programHeaderTableOffset;
+      loadSegmentHeader.filesz = ( static_cast<uint64_t>( fileHeader().phnum ) + 1 + pendingProgramHeaderCount() ) * fileHeader().phentsize;
+      loadSegmentHeader.memsz = loadSegmentHeader.filesz;
+      loadSegmentHeader.align = fileHeader().pageSize();
+
+      msg = tr("creating PT_LOAD segment header");
+      emit verboseMessage(msg);
+      mHeaders.addProgramHeader(loadSegmentHeader);
+
+      if( !moveProgramInterpreter && !moveDynamicSection && !moveDynamicStringTable ){
+        return;
+      }
+      if( !moveSectionsToEndExtendingLastLoadSegment(moveProgramInterpreter, moveDynamicSection, moveDynamicStringTable) ){
+        msg = tr("could not extend the PT_LOAD segment that covers the moved program header table");
+        throw MoveSectionError(msg);
+      }
+    }
+
+    /*
+     * Count of program headers that updateLayoutAfterEdits() must add,
+     * other than the PT_LOAD for the moved sections
+     */
+    uint16_t pendingProgramHeaderCount() const noexcept
+    {
+      return mMustAddDeployStampNoteProgramHeader ? 1 : 0;
+    }
+
+    /*
+     * Add the pending program headers if the program header table
+     * can grow without moving any section.
+     * Returns false if some place must be made first.
+     *
+     * Sorts the section header table by file offset.
+     */
+    bool addPendingProgramHeadersIfPlaceExists()
+    {
+      if( pendingProgramHeaderCount() == 0 ){
+        return true;
+      }
+
+      const SectionIndexChangeMap sectionIndexChangeMap = mHeaders.sortSectionHeaderTableByFileOffset();
+      mSymTab.updateSectionIndexes(sectionIndexChangeMap);
+      mDynSym.updateSectionIndexes(sectionIndexChangeMap);
+
+      const uint16_t size = static_cast<uint16_t>( pendingProgramHeaderCount() * fileHeader().phentsize );
+      if( findCountOfSectionsToMoveToFreeSize(mHeaders.sectionHeaderTable(), size) > 1 ){
+        return false;
+      }
+      addPendingProgramHeaders();
+
+      return true;
+    }
+
+    void addPendingProgramHeaders()
+    {
+      if(!mMustAddDeployStampNoteProgramHeader){
+        return;
+      }
+
+      const SectionHeader & sectionHeader = mHeaders.sectionHeaderTable()[ mHeaders.findIndexOfDeployStampNoteSectionHeader() ];
+      ProgramHeader noteSegmentHeader;
+      noteSegmentHeader.setSegmentType(SegmentType::Note);
+      noteSegmentHeader.setPermissions(SegmentPermission::Read);
+      noteSegmentHeader.offset = sectionHeader.offset;
+      noteSegmentHeader.vaddr = 0;
+      noteSegmentHeader.paddr = 0;
+      noteSegmentHeader.filesz = sectionHeader.size;
+      noteSegmentHeader.memsz = 0;
+      noteSegmentHeader.align = 4;
+
+      const QString msg = tr("creating PT_NOTE segment header for the deployment stamp");
+      emit verboseMessage(msg);
+      mHeaders.addProgramHeader(noteSegmentHeader);
+      mMustAddDeployStampNoteProgramHeader = false;
+    }
+
+    void copyStateTo(FileWriterFile & other) const noexcept
+    {
+      other.mDynamicRelocationSection = mDynamicRelocationSection;
+      other.mPackedRelativeRelocations = mPackedRelativeRelocations;
+      other.mRelrTable = mRelrTable;
+      other.mGnuVersionNeedTable = mGnuVersionNeedTable;
+      other.mDynamicStringTableReferences = mDynamicStringTableReferences;
+      other.mDynamicStringTableReferencesAreKnown = mDynamicStringTableReferencesAreKnown;
+      other.mDynamicStringTableIsCompacted = mDynamicStringTableIsCompacted;
+      other.mMustAddDeployStampNoteProgramHeader = mMustAddDeployStampNoteProgramHeader;
+      other.mForcedProgramHeaderTableGrowthStrategy = mForcedProgramHeaderTableGrowthStrategy;
+      other.mSymbolTableUpdateThreadCount = mSymbolTableUpdateThreadCount;
+      other.mOriginalLayout = mOriginalLayout;
+      other.mFileOffsetChanges = mFileOffsetChanges;
+      other.mHeaders = mHeaders;
+      other.mDynamicSection = mDynamicSection;
+      other.mSymTab = mSymTab;
+      other.mDynSym = mDynSym;
+      other.mGotSection = mGotSection;
+      other.mGotPltSection = mGotPltSection;
+      other.mProgramInterpreterSection = mProgramInterpreterSection;
+      other.mGnuHashTableSection = mGnuHashTableSection;
+      other.mGnuHashedSymbolHashes = mGnuHashedSymbolHashes;
+      other.mNoteSectionTable = mNoteSectionTable;
+      other.mSectionNameStringTable = mSectionNameStringTable;
+      other.mGnuDebugLink = mGnuDebugLink;
+      other.mFileContentShifts = mFileContentShifts;
+    }
+
+    /*
+     * Content that is rewritten in place by some edits
+     */
+    struct LayoutPlanRewrites
+    {
+      bool dynamicSection = false;
+      bool programInterpreter = false;
+      bool sectionNameStringTable = false;
+      bool gnuHashTable = false;
+    };
+
+    /*
+     * References into .dynstr from outside the dynamic section,
+     * as passed to planRunPathInPlaceEdit()
+     */
+    std::vector<uint64_t> dynamicStringTableOtherReferences() const
+    {
+      std::vector<uint64_t> references;
+      references.reserve( mDynamicStringTableReferences.size() );
+      for(const DynamicStringTableReference & reference : mDynamicStringTableReferences){
+        references.push_back(reference.index);
+      }
+      for(const GnuVersionNeedEntry & entry : mGnuVersionNeedTable.entries){
+        references.push_back(entry.file);
+        for(const GnuVersionNeedAuxEntry & auxEntry : entry.auxEntries){
+          references.push_back(auxEntry.name);
+        }
+      }
+      std::sort( references.begin(), references.end() );
+
+      return references;
+    }
+
+    RunPathInPlacePlan planRunPathInPlace(const QString & runPath) const
+    {
+      if( mDynamicSection.isNull() || !mHeaders.containsDynamicStringTableSectionHeader() ){
+        return RunPathInPlacePlan();
+      }
+
+      const QByteArray runPathUtf8 = runPath.toUtf8();
+      const std::string_view runPathView( runPathUtf8.constData(), static_cast<std::size_t>( runPathUtf8.size() ) );
+      const uint64_t stringTableSectionSize = mHeaders.dynamicStringTableSectionHeader().size;
+
+      const RunPathInPlacePlan plan = planRunPathInPlaceEdit(mDynamicSection, stringTableSectionSize, runPathView, dynamicStringTableOtherReferences());
+      // Without the references, a other string could share the bytes that are overwritten
+      if( (plan.edit == RunPathInPlaceEdit::OverwriteString) && !mDynamicStringTableReferencesAreKnown ){
+        return RunPathInPlacePlan();
+      }
+
+      return plan;
+    }
+
+    /*
+     * Only the run path string and the DT_RUNPATH and DT_STRSZ entries are written
+     */
+    FileWriterLayoutPlan makeRunPathInPlaceLayoutPlan(const RunPathInPlacePlan & inPlacePlan) const noexcept
+    {
+      assert( inPlacePlan.edit != RunPathInPlaceEdit::NotPossible );
+
+      FileWriterLayoutPlan plan;
+      plan.runPathInPlaceEdit = inPlacePlan.edit;
+      plan.originalFileSize = mHeaders.globalFileOffsetRange().minimumSizeToAccessRange();
+      plan.newFileSize = plan.originalFileSize;
+      if( !inPlacePlan.requiresWrite() ){
+        return plan;
+      }
+
+      const SectionHeader & stringTableHeader = mHeaders.dynamicStringTableSectionHeader();
+      const SectionHeader & dynamicSectionHeader = mHeaders.dynamicSectionHeader();
+
+      uint64_t pageSize = fileHeader().pageSize();
+      if(pageSize == 0){
+        pageSize = 0x1000;
+      }
+      FileWriterTouchedPages touchedPages(pageSize);
+
+      const uint64_t stringOffset = stringTableHeader.offset + inPlacePlan.stringTableIndex;
+      touchedPages.addRange( OffsetRange::fromBeginAndEndOffsets(stringOffset, stringOffset + inPlacePlan.stringTableByteCount) );
+
+      const uint64_t entrySize = fileHeader().ident._class == Class::Class32 ? 8 : 16;
+      for(std::size_t index : {inPlacePlan.runPathEntryIndex, inPlacePlan.stringTableSizeEntryIndex}){
+        const uint64_t entryOffset = dynamicSectionHeader.offset + index * entrySize;
+        touchedPages.addRange( OffsetRange::fromBeginAndEndOffsets(entryOffset, entryOffset + entrySize) );
+      }
+      plan.touchedPageCount = touchedPages.pageCount();
+
+      return plan;
+    }
+
+    /*
+     * Compare plannedFile, that has the edits applied, against this file.
+     * The content rewritten in place only counts for the touched pages.
+     */
+    FileWriterLayoutPlan makeLayoutPlan(const FileWriterFile & plannedFile, const LayoutPlanRewrites & rewrites) const noexcept
+    {
+      const FileAllHeaders & plannedHeaders = plannedFile.headers();
+      std::vector<OffsetRange> rewrittenRanges;
+
+      if(rewrites.dynamicSection){
+        rewrittenRanges.push_back( OffsetRange::fromSectionHeader( plannedHeaders.dynamicSectionHeader() ) );
+        rewrittenRanges.push_back( plannedFile.dynamicStringTableOffsetRange() );
+      }
+      if( rewrites.programInterpreter && plannedHeaders.containsProgramInterpreterSectionHeader() ){
+        rewrittenRanges.push_back( OffsetRange::fromSectionHeader( plannedHeaders.programInterpreterSectionHeader() ) );
+      }
+      if( rewrites.sectionNameStringTable && plannedHeaders.containsSectionNameStringTableHeader() ){
+        rewrittenRanges.push_back( OffsetRange::fromSectionHeader( plannedHeaders.sectionNameStringTableHeader() ) );
+      }
+      if( rewrites.gnuHashTable && plannedHeaders.containsGnuHashTableSectionHeader() ){
+        rewrittenRanges.push_back( OffsetRange::fromSectionHeader( plannedHeaders.gnuHashTableSectionHeader() ) );
+      }
+
+      // The addresses of the moved sections are updated in .got, .got.plt and the symbol tables
+      if( plannedHeaders.dynamicSectionHeader().offset != mHeaders.dynamicSectionHeader().offset ){
+        if( plannedHeaders.containsGotSectionHeader() ){
+          rewrittenRanges.push_back( OffsetRange::fromSectionHeader( plannedHeaders.gotSectionHeader() ) );
+        }
+        if( plannedHeaders.containsGotPltSectionHeader() ){
+          rewrittenRanges.push_back( OffsetRange::fromSectionHeader( plannedHeaders.gotPltSectionHeader() ) );
+        }
+      }
+      if( sectionHeaderTablesDiffer( mHeaders.sectionHeaderTable(), plannedHeaders.sectionHeaderTable() ) ){
+        const int64_t entrySize = symbolTableEntrySize( fileHeader().ident._class );
+        for(const PartialSymbolTable *table : {&plannedFile.mSymTab, &plannedFile.mDynSym}){
+          for(size_t i = 0; i < table->entriesCount(); ++i){
+            const int64_t offset = table->fileMapOffsetAt(i);
+            rewrittenRanges.push_back( OffsetRange::fromBeginAndEndOffsets( static_cast<uint64_t>(offset), static_cast<uint64_t>(offset + entrySize) ) );
+          }
+        }
+      }
+
+      return makeFileWriterLayoutPlan(mHeaders, plannedHeaders, rewrittenRanges);
+    }
+
+    bool programInterpreterSectionGrows() const noexcept
+    {
+      if( !mHeaders.containsProgramInterpreterSectionHeader() ){
         return false;
       }
 
-      return true;
+      return mHeaders.programInterpreterSectionHeader().size > mOriginalLayout.programInterpreterSectionSize();
     }
 
-   signals:
+    static
+    bool containsSectionIndex(const std::vector<uint16_t> & indexes, uint16_t index) noexcept
+    {
+      return std::find(indexes.cbegin(), indexes.cend(), index) != indexes.cend();
+    }
 
-    void message(const QString & message) const;
-    void verboseMessage(const QString & message) const;
+    /*
+     * Update the headers after the dynamic section,
+     * its string table and/or the program interpreter have been edited,
+     * and add the pending program headers.
+     */
+    void updateLayoutAfterEdits()
+    {
+      QString msg;
 
-   private:
+      const int64_t dynamicSectionSize = mDynamicSection.byteCount(fileHeader().ident._class);
+      assert( dynamicSectionSize >= 0 );
+      mHeaders.setDynamicSectionSize( static_cast<uint64_t>(dynamicSectionSize) );
+
+      const int64_t dynamicStringTableSize = mDynamicSection.stringTable().byteCount();
+      assert( dynamicStringTableSize >= 0 );
+      mHeaders.setDynamicStringTableSize( static_cast<uint64_t>(dynamicStringTableSize) );
+
+      bool mustMoveDynamicSection = mFileOffsetChanges.dynamicSectionChangesOffset(mDynamicSection) > 0;
+      bool mustMoveDynamicStringTable = mFileOffsetChanges.dynamicStringTableChangesOffset(mDynamicSection) > 0;
+      bool mustMoveProgramInterpreter = programInterpreterSectionGrows();
+
+      if( !mustMoveDynamicSection && !mustMoveDynamicStringTable && !mustMoveProgramInterpreter && (pendingProgramHeaderCount() == 0) ){
+        return;
+      }
+
+      /*
+       * Before appending sections to the end of the file,
+       * try to reuse free space inside the existing PT_LOAD segments
+       * (the old place of the section with its padding,
+       * or a hole left by a previous edit).
+       * A section placed there is already loaded,
+       * so no new PT_LOAD is required for it.
+       */
+      bool dynamicSectionMovedToFreeSpace = false;
+      bool dynamicStringTableMovedToFreeSpace = false;
+
+      if( mustMoveDynamicSection && moveDynamicSectionToFreeSpace() ){
+        msg = tr("moving .dynamic section to free space at offset 0x%1")
+              .arg( mHeaders.dynamicSectionHeader().offset, 0, 16 );
+        emit verboseMessage(msg);
+        dynamicSectionMovedToFreeSpace = true;
+        mustMoveDynamicSection = false;
+      }
+
+      if( mustMoveDynamicStringTable && moveDynamicStringTableToFreeSpace() ){
+        msg = tr("moving .dynstr section to free space at offset 0x%1")
+              .arg( mHeaders.dynamicStringTableSectionHeader().offset, 0, 16 );
+        emit verboseMessage(msg);
+        dynamicStringTableMovedToFreeSpace = true;
+        mustMoveDynamicStringTable = false;
+      }
+
+      bool mustMoveAnySection = mustMoveDynamicSection || mustMoveDynamicStringTable || mustMoveProgramInterpreter;
+
+      /*
+       * If the last PT_LOAD segment ends the file
+       * (typically the one added by a previous edit),
+       * extending it avoids adding a new one,
+       * which also avoids moving the first sections
+       * to make place in the program header table.
+       */
+      if( mustMoveAnySection && moveSectionsToEndExtendingLastLoadSegment(mustMoveProgramInterpreter, mustMoveDynamicSection, mustMoveDynamicStringTable) ){
+        msg = tr("extending the last PT_LOAD segment to cover the sections moved to the end");
+        emit verboseMessage(msg);
+
+        updateSymbolTablesForMovedSections(mustMoveProgramInterpreter,
+                                           mustMoveDynamicSection || dynamicSectionMovedToFreeSpace,
+                                           mustMoveDynamicStringTable || dynamicStringTableMovedToFreeSpace);
+        dynamicSectionMovedToFreeSpace = false;
+        dynamicStringTableMovedToFreeSpace = false;
+        mustMoveDynamicSection = false;
+        mustMoveDynamicStringTable = false;
+        mustMoveProgramInterpreter = false;
+        mustMoveAnySection = false;
+      }
+
+      /*
+       * No new PT_LOAD is required.
+       * If the pending program headers do not fit after the program header table,
+       * some place must be made like for a new PT_LOAD.
+       */
+      if(!mustMoveAnySection){
+        updateSymbolTablesForMovedSections(false, dynamicSectionMovedToFreeSpace, dynamicStringTableMovedToFreeSpace);
+        if( addPendingProgramHeadersIfPlaceExists() ){
+          return;
+        }
+        dynamicSectionMovedToFreeSpace = false;
+        dynamicStringTableMovedToFreeSpace = false;
+      }
+
+      /*
+       * If either the .dynstr and/or the .dynamic section grows,
+       * we have to put them at the end of the file
+       * (shifting all the data after those sections is not a option,
+       * because this will inavlidate references we don't know
+       * how to handle. We are not a linker).
+       *
+       * Also, the .dynstr and .dynamic must be
+       * covered by a load segment (PT_LOAD).
+       * For this, a new entry must be added in the program header table.
+       * For this, we have to do some place after this table.
+       *
+       * Also putting the program header table at the end causes problems.
+       * In my case, on a Ubuntu 18.04, the resulting program allways crashed
+       * while glibc (2.27) parses the program header table,
+       * at rtld.c:1148.
+       * This could be worked around for gcc generated executables,
+       * which are shared object (DYN).
+       * For Clang generated executables (EXEC), this did not work.
+       * See also:
+       * - https://lwn.net/Articles/631631/
+       * - https://github.com/NixOS/patchelf/blob/master/BUGS
+       * - https://github.com/NixOS/patchelf/pull/117
+       *
+       * Try to make place just after the program header table,
+       * so we can add the new load segment.
+       * On x86-64, a entry is 56-bytes long.
+       *
+       * Looking at generated executables, the first sections that came
+       * just after the program header table are .interp (28-bytes)
+       * and .note.ABI-tag (32-bytes).
+       *
+       * A other note section could also follows: .note.gnu.build-id
+       * Because the PT_NOTE segment must cover all note sections,
+       * we have to move them all.
+       *
+       * As example, if we move the .dynamic and .dynstr,
+       * we would end up with soemthing like this:
+       *
+       * EOF (maybe section header table)
+       * .interp section
+       * .note.ABI-tag section
+       * .note.gnu.build-id
+       * .dynamic section
+       * .dynstr section
+       *
+       * PT_PHDR segment must cover the program header table (new size)
+       * PT_INTERP segment must cover .interp
+       * PT_LOAD new segment that covers .interp , .note.ABI-tag, .note.gnu.build-id , .dynamic and .dynstr
+       * PT_DYNAMIC segment must cover .dynamic
+       * PT_GNU_RELRO segment must be extended to also cover the .dynamic section
+       * PT_NOTE segment must cover .note.ABI-tag and .note.gnu.build-id
+       */
+
+      assert( mustMoveAnySection || (pendingProgramHeaderCount() > 0) );
+
+      /*
+       * We need to add a new PT_LOAD to the program header table,
+       * followed by the pending program headers.
+       * For that, we need to move first sections to the end.
+       */
+
+      const SectionIndexChangeMap sectionIndexChangeMap = mHeaders.sortSectionHeaderTableByFileOffset();
+      /*
+       * Sorting the section header table changes the index of some headers.
+       * We have to update parts, like symbol tables,
+       * that references indexes in the section header table.
+       */
+      mSymTab.updateSectionIndexes(sectionIndexChangeMap);
+      mDynSym.updateSectionIndexes(sectionIndexChangeMap);
+
+      const uint16_t sectionToMoveCount = findCountOfSectionsToMoveToFreeSize(
+        mHeaders.sectionHeaderTable(), static_cast<uint16_t>( (1 + pendingProgramHeaderCount()) * fileHeader().phentsize )
+      );
+
+      /*
+       * Moving the program header table to the end is also possible for shared objects.
+       * Choose the cheapest of both layouts.
+       */
+      if( fileHeader().pageSize() > 0 ){
+        const uint64_t sizeOfOtherSectionsToMove = sizeOfSectionsToMove(mustMoveProgramInterpreter, mustMoveDynamicSection, mustMoveDynamicStringTable);
+        const LayoutCost moveFirstSectionsCost = estimateMoveFirstSectionsCost(sectionToMoveCount, sizeOfOtherSectionsToMove);
+        const LayoutCost moveProgramHeaderTableCost = estimateMoveProgramHeaderTableCost(sizeOfOtherSectionsToMove);
+        ProgramHeaderTableGrowthStrategy strategy = chooseProgramHeaderTableGrowthStrategy(
+          moveFirstSectionsCost, moveProgramHeaderTableCost, fileHeader().pageSize()
+        );
+        if(mForcedProgramHeaderTableGrowthStrategy){
+          strategy = forcedProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, strategy);
+        }
+
+        msg = tr("cost to move the first sections: %1").arg( layoutCostToString(moveFirstSectionsCost) );
+        emit verboseMessage(msg);
+        msg = tr("cost to move the program header table: %1").arg( layoutCostToString(moveProgramHeaderTableCost) );
+        emit verboseMessage(msg);
+
+        if(strategy == ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable){
+          msg = tr("choosing to move the program header table");
+          emit verboseMessage(msg);
+
+          moveProgramHeaderTableAndSectionsToEnd(mustMoveProgramInterpreter, mustMoveDynamicSection, mustMoveDynamicStringTable);
+          updateSymbolTablesForMovedSections(mustMoveProgramInterpreter,
+                                             mustMoveDynamicSection || dynamicSectionMovedToFreeSpace,
+                                             mustMoveDynamicStringTable || dynamicStringTableMovedToFreeSpace);
+          addPendingProgramHeaders();
+          return;
+        }
+
+        msg = tr("choosing to move the first sections");
+        emit verboseMessage(msg);
+      }
+
+      if( sectionToMoveCount >= mHeaders.sectionHeaderTable().size() ){
+        const QString msg = tr("should move %1 sections, but file contains only %2 sections")
+                            .arg(sectionToMoveCount).arg( mHeaders.sectionHeaderTable().size() );
+        throw MoveSectionError(msg);
+      }
+
+      std::vector<uint16_t> movedSectionHeadersIndexes;
+
+      if(sectionToMoveCount > 1){
+        msg = tr("will have to move %1 sections because the program header table must be updated")
+              .arg(sectionToMoveCount-1);
+        emit message(msg);
+
+        movedSectionHeadersIndexes = moveFirstCountSectionsToEnd(sectionToMoveCount);
+      }
+
+      if( mustMoveProgramInterpreter && !containsSectionIndex(movedSectionHeadersIndexes, mHeaders.programInterpreterSectionHeaderIndex()) ){
+        msg = tr("moving .interp section to end");
+        emit verboseMessage(msg);
+
+        moveProgramInterpreterSectionToEnd(MoveSectionAlignment::SectionAlignment);
+        movedSectionHeadersIndexes.push_back( mHeaders.programInterpreterSectionHeaderIndex() );
+      }
+
+      if(mustMoveDynamicSection){
+        msg = tr("moving .dynamic section to end");
+        emit verboseMessage(msg);
+
+        moveDynamicSectionToEnd(MoveSectionAlignment::SectionAlignment);
+        movedSectionHeadersIndexes.push_back( mHeaders.dynamicSectionHeaderIndex() );
+      }
+
+      if(mustMoveDynamicStringTable){
+        msg = tr("moving .dynstr section to end");
+        emit verboseMessage(msg);
+
+        moveDynamicStringTableToEnd(MoveSectionAlignment::SectionAlignment);
+        movedSectionHeadersIndexes.push_back( mHeaders.dynamicStringTableSectionHeaderIndex() );
+      }
+
+      msg = tr("updating symbol tables");
+      emit verboseMessage(msg);
+
+      /*
+       * Moving sections will change offsets and addresses.
+       * We have to update some parts,
+       * like symbol tables, that references those addresses.
+       */
+      mSymTab.updateVirtualAddresses( movedSectionHeadersIndexes, mHeaders.sectionHeaderTable(), mSymbolTableUpdateThreadCount );
+      mDynSym.updateVirtualAddresses( movedSectionHeadersIndexes, mHeaders.sectionHeaderTable(), mSymbolTableUpdateThreadCount );
+      updateSymbolTablesForMovedSections(false, dynamicSectionMovedToFreeSpace, dynamicStringTableMovedToFreeSpace);
+
+      if( !movedSectionHeadersIndexes.empty() ){
+        msg = tr("creating PT_LOAD segment header");
+        emit verboseMessage(msg);
+
+        const ProgramHeader loadSegmentHeader = makeLoadProgramHeaderCoveringSections(
+          movedSectionHeadersIndexes, mHeaders.sectionHeaderTable(), mHeaders.fileHeader().pageSize()
+        );
+        mHeaders.addProgramHeader(loadSegmentHeader);
+      }
+      addPendingProgramHeaders();
+
+      /** \todo The PT_GNU_RELRO segment should also cover the .dynamic section
+       *
+       * In elf files generated (at least by ld), a PT_GNU_RELRO segment
+       * also covers the .dynamic section.
+       *
+       * To have a idea of its role, see
+       * https://thr3ads.net/llvm-dev/2017/05/2818516-lld-ELF-Add-option-to-make-.dynamic-read-only
+       *
+       * Making PT_GNU_RELRO also cover the .dynamic section seems to be tricky,
+       * because it seems to require some sections to be properly aligned.
+       * Making a second PT_GNU_RELRO could be a idea, but:
+       * - it will require to add a new program header to the program header table,
+       *   that will again require to move more sections from the beginning of the file
+       * - it seems not to be well supported by the loaders
+       * For more details, see https://reviews.llvm.org/D40029
+       *
+       * This code below is commented, because it does not work:
+       * - launching a simple exectable segfaults
+       * - eu-elflint tells:
+       *  a) PT_GNU_RELRO is not covered by any PT_LOAD segment
+       *  b) PT_GNU_RELRO's file size is greater than its memory size
+       */
+//       if( mustMoveDynamicSection && mHeaders.containsGnuRelRoProgramHeader() ){
+//         std::cout << "extending PT_GNU_RELRO to also cover .dynamic section" << std::endl;
+//         extendProgramHeaderSizeToCoverSections( mHeaders.gnuRelRoProgramHeaderMutable(), {mHeaders.dynamicSectionHeader()} );
+//       }
+    }
 
     FileWriterFileLayout mOriginalLayout;
     FileOffsetChanges mFileOffsetChanges;
@@ -672,7 +2538,26 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     GlobalOffsetTable mGotPltSection;
     ProgramInterpreterSection mProgramInterpreterSection;
     GnuHashTable mGnuHashTableSection;
+    std::vector<uint32_t> mGnuHashedSymbolHashes;
     NoteSectionTable mNoteSectionTable;
+    StringTable mSectionNameStringTable;
+    GnuDebugLink mGnuDebugLink;
+    std::vector<FileContentShift> mFileContentShifts;
+    RelocationSection mDynamicRelocationSection;
+    std::vector<RelocationEntry> mPackedRelativeRelocations;
+    std::vector<uint64_t> mRelrTable;
+    GnuVersionNeedTable mGnuVersionNeedTable;
+    std::vector<DynamicStringTableReference> mDynamicStringTableReferences;
+    bool mDynamicStringTableReferencesAreKnown = false;
+    bool mDynamicStringTableIsCompacted = false;
+    bool mMustAddDeployStampNoteProgramHeader = false;
+    std::optional<ProgramHeaderTableGrowthStrategy> mForcedProgramHeaderTableGrowthStrategy;
+    unsigned int mSymbolTableUpdateThreadCount = 1;
+
+    /*
+     * Size of a transparent huge page on x86_64 and on aarch64 with 4 KiB pages
+     */
+    static constexpr uint64_t hugePageSize = 0x200000;
   };
 
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
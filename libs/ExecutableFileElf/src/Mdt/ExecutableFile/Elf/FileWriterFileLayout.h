@@ -59,6 +59,22 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mGlobalOffsetRange;
     }
 
+    uint64_t programInterpreterSectionSize() const noexcept
+    {
+      return mProgramInterpreterSectionSize;
+    }
+
+    /*! \brief Shift the file offsets starting from \a offset by \a byteCount
+     *
+     * \sa FileAllHeaders::shiftFileContentFrom()
+     */
+    void shiftFileOffsetsFrom(uint64_t offset, uint64_t byteCount) noexcept
+    {
+      mDynamicSectionOffsetRange = shiftedOffsetRange(mDynamicSectionOffsetRange, offset, byteCount);
+      mDynamicStringTableOffsetRange = shiftedOffsetRange(mDynamicStringTableOffsetRange, offset, byteCount);
+      mGlobalOffsetRange = OffsetRange::fromBeginAndEndOffsets(mGlobalOffsetRange.begin(), mGlobalOffsetRange.end() + byteCount);
+    }
+
     /*! \brief Get a file layout from a file
      *
      * \pre \a headers must be valid
@@ -77,15 +93,29 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       layout.mDynamicSectionOffsetRange = OffsetRange::fromProgrameHeader( headers.dynamicProgramHeader() );
       layout.mDynamicStringTableOffsetRange = OffsetRange::fromSectionHeader( headers.dynamicStringTableSectionHeader() );
       layout.mGlobalOffsetRange = headers.globalFileOffsetRange();
+      if( headers.containsProgramInterpreterSectionHeader() ){
+        layout.mProgramInterpreterSectionSize = headers.programInterpreterSectionHeader().size;
+      }
 
       return layout;
     }
 
   private:
 
+    static
+    OffsetRange shiftedOffsetRange(const OffsetRange & range, uint64_t offset, uint64_t byteCount) noexcept
+    {
+      if(range.begin() < offset){
+        return range;
+      }
+
+      return OffsetRange::fromBeginAndEndOffsets(range.begin() + byteCount, range.end() + byteCount);
+    }
+
     OffsetRange mDynamicSectionOffsetRange;
     OffsetRange mDynamicStringTableOffsetRange;
     OffsetRange mGlobalOffsetRange;
+    uint64_t mProgramInterpreterSectionSize = 0;
   };
 
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
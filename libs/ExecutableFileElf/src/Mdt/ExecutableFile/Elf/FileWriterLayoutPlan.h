@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_FILE_WRITER_LAYOUT_PLAN_H
+#define MDT_EXECUTABLE_FILE_ELF_FILE_WRITER_LAYOUT_PLAN_H
+
+#include "Mdt/ExecutableFile/Elf/FileAllHeaders.h"
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeader.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/OffsetRange.h"
+#include "Mdt/ExecutableFile/Elf/RunPathInPlaceEditor.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Result of a dry-run of the edits on a ELF file
+   *
+   * Describes what writing the edits would do to the file,
+   * without touching it.
+   *
+   * \sa FileWriterFile::planEdits()
+   */
+  struct FileWriterLayoutPlan
+  {
+    /*! \brief Names of the sections that move to the end of the file
+     */
+    std::vector<std::string> movedSectionNames;
+
+    /*! \brief True if a new PT_LOAD segment is added
+     */
+    bool addsLoadSegment = false;
+
+    /*! \brief Size of the file before the edits
+     */
+    int64_t originalFileSize = 0;
+
+    /*! \brief Size of the file after the edits
+     */
+    int64_t newFileSize = 0;
+
+    /*! \brief Count of file pages that are written
+     *
+     * This is a upper bound:
+     * a page is counted as soon as a header or a section it contains is rewritten,
+     * even if some bytes of it are finally unchanged.
+     */
+    int64_t touchedPageCount = 0;
+
+    /*! \brief How the run path is set without rewriting the file
+     *
+     * Only set by FileWriterFile::planRunPath().
+     * RunPathInPlaceEdit::NotPossible means that the file is rewritten.
+     */
+    RunPathInPlaceEdit runPathInPlaceEdit = RunPathInPlaceEdit::NotPossible;
+
+    /*! \brief Check if the edits are done in place
+     *
+     * Then, only the run path string and the DT_RUNPATH and DT_STRSZ entries
+     * are written, or nothing at all if the run path is unchanged.
+     */
+    bool isInPlace() const noexcept
+    {
+      return runPathInPlaceEdit != RunPathInPlaceEdit::NotPossible;
+    }
+
+    /*! \brief Check if some section moves
+     */
+    bool movesSections() const noexcept
+    {
+      return !movedSectionNames.empty();
+    }
+
+    /*! \brief Get the count of bytes the file grows
+     *
+     * Returns a negative value if the file shrinks.
+     */
+    int64_t fileSizeGrowth() const noexcept
+    {
+      return newFileSize - originalFileSize;
+    }
+  };
+
+  /*! \internal Collect the pages touched by some file offset ranges
+   */
+  class FileWriterTouchedPages
+  {
+   public:
+
+    /*! \brief Construct a collection for \a pageSize
+     *
+     * \pre \a pageSize must be > 0
+     */
+    explicit
+    FileWriterTouchedPages(uint64_t pageSize) noexcept
+     : mPageSize(pageSize)
+    {
+      assert( pageSize > 0 );
+    }
+
+    /*! \brief Add the pages covered by \a range
+     */
+    void addRange(const OffsetRange & range) noexcept
+    {
+      if( range.isEmpty() ){
+        return;
+      }
+
+      const uint64_t firstPage = range.begin() / mPageSize;
+      const uint64_t lastPage = range.lastOffset() / mPageSize;
+      for(uint64_t page = firstPage; page <= lastPage; ++page){
+        mPages.push_back(page);
+      }
+    }
+
+    /*! \brief Get the count of distinct pages
+     */
+    int64_t pageCount() const noexcept
+    {
+      std::vector<uint64_t> pages = mPages;
+      std::sort(pages.begin(), pages.end());
+      const auto last = std::unique(pages.begin(), pages.end());
+
+      return static_cast<int64_t>( std::distance(pages.begin(), last) );
+    }
+
+   private:
+
+    uint64_t mPageSize;
+    std::vector<uint64_t> mPages;
+  };
+
+  /*! \internal
+   */
+  inline
+  bool programHeadersDiffer(const ProgramHeader & a, const ProgramHeader & b) noexcept
+  {
+    return (a.type != b.type) || (a.flags != b.flags) || (a.offset != b.offset)
+        || (a.vaddr != b.vaddr) || (a.paddr != b.paddr)
+        || (a.filesz != b.filesz) || (a.memsz != b.memsz) || (a.align != b.align);
+  }
+
+  /*! \internal
+   */
+  inline
+  bool sectionHeadersDiffer(const SectionHeader & a, const SectionHeader & b) noexcept
+  {
+    return (a.name != b.name) || (a.nameIndex != b.nameIndex) || (a.type != b.type) || (a.flags != b.flags)
+        || (a.addr != b.addr) || (a.offset != b.offset) || (a.size != b.size)
+        || (a.link != b.link) || (a.info != b.info)
+        || (a.addralign != b.addralign) || (a.entsize != b.entsize);
+  }
+
+  /*! \internal
+   */
+  inline
+  bool programHeaderTablesDiffer(const ProgramHeaderTable & a, const ProgramHeaderTable & b) noexcept
+  {
+    if( a.headerCount() != b.headerCount() ){
+      return true;
+    }
+    for(size_t i = 0; i < a.headerCount(); ++i){
+      if( programHeadersDiffer( a.headerAt(i), b.headerAt(i) ) ){
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /*! \internal
+   */
+  inline
+  bool sectionHeaderTablesDiffer(const SectionHeaderTable & a, const SectionHeaderTable & b) noexcept
+  {
+    if( a.size() != b.size() ){
+      return true;
+    }
+    for(size_t i = 0; i < a.size(); ++i){
+      if( sectionHeadersDiffer(a[i], b[i]) ){
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /*! \internal
+   */
+  inline
+  int64_t loadProgramHeaderCount(const ProgramHeaderTable & table) noexcept
+  {
+    const auto isLoad = [](const ProgramHeader & header){
+      return header.segmentType() == SegmentType::Load;
+    };
+
+    return static_cast<int64_t>( std::count_if(table.cbegin(), table.cend(), isLoad) );
+  }
+
+  /*! \internal Make a layout plan by comparing \a originalHeaders and \a newHeaders
+   *
+   * \a rewrittenRanges are the file offset ranges, in the new layout,
+   * of the content that is rewritten in place
+   * (for example the dynamic section after a edit of the run path).
+   * They are only used to count the touched pages.
+   *
+   * \pre \a originalHeaders and \a newHeaders must be valid
+   */
+  inline
+  FileWriterLayoutPlan makeFileWriterLayoutPlan(const FileAllHeaders & originalHeaders, const FileAllHeaders & newHeaders,
+                                                const std::vector<OffsetRange> & rewrittenRanges) noexcept
+  {
+    assert( originalHeaders.seemsValid() );
+    assert( newHeaders.seemsValid() );
+
+    FileWriterLayoutPlan plan;
+
+    const SectionHeaderTable & originalSectionHeaders = originalHeaders.sectionHeaderTable();
+    const SectionHeaderTable & newSectionHeaders = newHeaders.sectionHeaderTable();
+
+    std::vector<OffsetRange> movedSectionRanges;
+    for(const SectionHeader & header : newSectionHeaders){
+      if( header.sectionType() == SectionType::Null ){
+        continue;
+      }
+      const uint16_t originalIndex = findIndexOfFirstSectionHeader(originalSectionHeaders, header.name);
+      if(originalIndex == 0){
+        continue;
+      }
+      const SectionHeader & originalHeader = originalSectionHeaders[originalIndex];
+      if( header.offset != originalHeader.offset ){
+        plan.movedSectionNames.push_back(header.name);
+        if( header.sectionType() != SectionType::NoBits ){
+          movedSectionRanges.push_back( OffsetRange::fromSectionHeader(header) );
+        }
+      }
+    }
+
+    plan.addsLoadSegment = loadProgramHeaderCount( newHeaders.programHeaderTable() )
+                         > loadProgramHeaderCount( originalHeaders.programHeaderTable() );
+
+    plan.originalFileSize = originalHeaders.globalFileOffsetRange().minimumSizeToAccessRange();
+    plan.newFileSize = newHeaders.globalFileOffsetRange().minimumSizeToAccessRange();
+
+    const FileHeader & originalFileHeader = originalHeaders.fileHeader();
+    const FileHeader & newFileHeader = newHeaders.fileHeader();
+
+    uint64_t pageSize = newFileHeader.pageSize();
+    if(pageSize == 0){
+      pageSize = 0x1000;
+    }
+    FileWriterTouchedPages touchedPages(pageSize);
+
+    const bool fileHeaderChanges = (newFileHeader.phoff != originalFileHeader.phoff)
+                                || (newFileHeader.phnum != originalFileHeader.phnum)
+                                || (newFileHeader.shoff != originalFileHeader.shoff)
+                                || (newFileHeader.shnum != originalFileHeader.shnum)
+                                || (newFileHeader.shstrndx != originalFileHeader.shstrndx);
+    if(fileHeaderChanges){
+      touchedPages.addRange( OffsetRange::fromBeginAndEndOffsets(0, newFileHeader.ehsize) );
+    }
+
+    if( programHeaderTablesDiffer( originalHeaders.programHeaderTable(), newHeaders.programHeaderTable() ) ){
+      const uint64_t end = newFileHeader.phoff + uint64_t(newFileHeader.phnum) * uint64_t(newFileHeader.phentsize);
+      touchedPages.addRange( OffsetRange::fromBeginAndEndOffsets(newFileHeader.phoff, end) );
+    }
+
+    if( sectionHeaderTablesDiffer(originalSectionHeaders, newSectionHeaders) ){
+      const uint64_t end = newFileHeader.shoff + uint64_t(newFileHeader.shnum) * uint64_t(newFileHeader.shentsize);
+      touchedPages.addRange( OffsetRange::fromBeginAndEndOffsets(newFileHeader.shoff, end) );
+    }
+
+    for(const OffsetRange & range : movedSectionRanges){
+      touchedPages.addRange(range);
+    }
+    for(const OffsetRange & range : rewrittenRanges){
+      touchedPages.addRange(range);
+    }
+
+    plan.touchedPageCount = touchedPages.pageCount();
+
+    return plan;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_FILE_WRITER_LAYOUT_PLAN_H
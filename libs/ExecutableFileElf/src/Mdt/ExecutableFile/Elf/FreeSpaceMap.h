@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_FREE_SPACE_MAP_H
+#define MDT_EXECUTABLE_FILE_ELF_FREE_SPACE_MAP_H
+
+#include "Mdt/ExecutableFile/Elf/OffsetRange.h"
+#include "Mdt/ExecutableFile/Elf/FileAllHeaders.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Map of the unused file offset ranges of a file
+   *
+   * The free ranges are kept sorted by offset, and never overlap.
+   * Adjacent ranges are merged.
+   */
+  class FreeSpaceMap
+  {
+   public:
+
+    /*! \brief Add \a range as free space
+     *
+     * \a range can overlap or be adjacent to ranges already in this map.
+     */
+    void addFreeRange(const OffsetRange & range) noexcept
+    {
+      if( range.isEmpty() ){
+        return;
+      }
+
+      uint64_t begin = range.begin();
+      uint64_t end = range.end();
+
+      std::vector<OffsetRange> ranges;
+      ranges.reserve(mRanges.size() + 1);
+      for(const OffsetRange & current : mRanges){
+        if( (current.end() < begin) || (current.begin() > end) ){
+          ranges.push_back(current);
+        }else{
+          begin = std::min( begin, current.begin() );
+          end = std::max( end, current.end() );
+        }
+      }
+      ranges.push_back( OffsetRange::fromBeginAndEndOffsets(begin, end) );
+      std::sort(ranges.begin(), ranges.end(), [](const OffsetRange & a, const OffsetRange & b){
+        return a.begin() < b.begin();
+      });
+
+      mRanges = ranges;
+    }
+
+    /*! \brief Mark \a range as used
+     *
+     * Free ranges that overlap \a range are shrinked or split.
+     */
+    void removeRange(const OffsetRange & range) noexcept
+    {
+      if( range.isEmpty() ){
+        return;
+      }
+
+      std::vector<OffsetRange> ranges;
+      ranges.reserve(mRanges.size() + 1);
+      for(const OffsetRange & current : mRanges){
+        if( (current.end() <= range.begin()) || (current.begin() >= range.end()) ){
+          ranges.push_back(current);
+          continue;
+        }
+        if( current.begin() < range.begin() ){
+          ranges.push_back( OffsetRange::fromBeginAndEndOffsets( current.begin(), range.begin() ) );
+        }
+        if( current.end() > range.end() ){
+          ranges.push_back( OffsetRange::fromBeginAndEndOffsets( range.end(), current.end() ) );
+        }
+      }
+
+      mRanges = ranges;
+    }
+
+    /*! \brief Find the first free range that can hold \a size bytes starting at a offset aligned to \a alignment
+     *
+     * Returns a range of \a size bytes if found,
+     * otherwise a empty range.
+     *
+     * \pre \a size must be > 0
+     * \pre \a alignment must be > 0
+     */
+    OffsetRange findFirstFit(uint64_t size, uint64_t alignment) const noexcept
+    {
+      assert( size > 0 );
+      assert( alignment > 0 );
+
+      for(const OffsetRange & current : mRanges){
+        const uint64_t begin = ( (current.begin() + alignment - 1) / alignment ) * alignment;
+        if( (begin < current.end()) && (current.end() - begin >= size) ){
+          return OffsetRange::fromBeginAndEndOffsets(begin, begin + size);
+        }
+      }
+
+      return OffsetRange();
+    }
+
+    /*! \brief Get the free ranges, sorted by offset
+     */
+    const std::vector<OffsetRange> & ranges() const noexcept
+    {
+      return mRanges;
+    }
+
+    /*! \brief Get the total count of free bytes
+     */
+    uint64_t byteCount() const noexcept
+    {
+      uint64_t count = 0;
+      for(const OffsetRange & range : mRanges){
+        count += range.byteCount();
+      }
+
+      return count;
+    }
+
+    /*! \brief Check if this map has no free space
+     */
+    bool isEmpty() const noexcept
+    {
+      return mRanges.empty();
+    }
+
+   private:
+
+    std::vector<OffsetRange> mRanges;
+  };
+
+  /*! \internal Check if a segment of \a type covers data that must not be reused
+   */
+  inline
+  bool segmentTypeProtectsFreeSpace(SegmentType type) noexcept
+  {
+    switch(type){
+      case SegmentType::Interpreter:
+      case SegmentType::Note:
+      case SegmentType::Tls:
+      case SegmentType::GnuEhFrame:
+        return true;
+      default:
+        break;
+    }
+
+    return false;
+  }
+
+  /*! \internal Make a map of the free space inside the PT_LOAD segments of a file
+   *
+   * Only PT_LOAD segments that grant at least \a permissions are considered.
+   * Inside those segments, the file offset ranges not used by any section,
+   * by the file header, by the program header table
+   * (with place for \a reservedProgramHeaderCount more program headers),
+   * by the section header table,
+   * or by some segments that must keep their content
+   * (PT_INTERP, PT_NOTE, PT_TLS, PT_GNU_EH_FRAME) are free.
+   *
+   * The sections at \a ignoredSectionIndexes do not use space
+   * (typically the sections that will be moved).
+   *
+   * Every free offset has a virtual address in its segment,
+   * so a section placed there is loaded without adding a new PT_LOAD.
+   *
+   * \pre \a headers must be valid
+   */
+  inline
+  FreeSpaceMap makeFreeSpaceMapInLoadSegments(const FileAllHeaders & headers, SegmentPermissions permissions,
+                                              const std::vector<uint16_t> & ignoredSectionIndexes,
+                                              uint16_t reservedProgramHeaderCount) noexcept
+  {
+    assert( headers.seemsValid() );
+
+    FreeSpaceMap map;
+    const uint32_t requiredFlags = permissions.toRawFlags();
+
+    for(const ProgramHeader & programHeader : headers.programHeaderTable()){
+      if( programHeader.segmentType() != SegmentType::Load ){
+        continue;
+      }
+      if( (programHeader.flags & requiredFlags) != requiredFlags ){
+        continue;
+      }
+      map.addFreeRange( OffsetRange::fromProgrameHeader(programHeader) );
+    }
+
+    if( map.isEmpty() ){
+      return map;
+    }
+
+    const FileHeader & fileHeader = headers.fileHeader();
+    map.removeRange( OffsetRange::fromBeginAndEndOffsets(0, fileHeader.ehsize) );
+    const uint64_t programHeaderTableEnd = fileHeader.phoff + (uint64_t(fileHeader.phnum) + reservedProgramHeaderCount) * uint64_t(fileHeader.phentsize);
+    map.removeRange( OffsetRange::fromBeginAndEndOffsets(fileHeader.phoff, programHeaderTableEnd) );
+    const uint64_t sectionHeaderTableEnd = fileHeader.shoff + uint64_t(fileHeader.shnum) * uint64_t(fileHeader.shentsize);
+    map.removeRange( OffsetRange::fromBeginAndEndOffsets(fileHeader.shoff, sectionHeaderTableEnd) );
+
+    for(const ProgramHeader & programHeader : headers.programHeaderTable()){
+      if( segmentTypeProtectsFreeSpace( programHeader.segmentType() ) ){
+        map.removeRange( OffsetRange::fromProgrameHeader(programHeader) );
+      }
+    }
+
+    const auto & sectionHeaderTable = headers.sectionHeaderTable();
+    for(size_t i = 0; i < sectionHeaderTable.size(); ++i){
+      const SectionHeader & header = sectionHeaderTable[i];
+      if( (header.sectionType() == SectionType::Null) || (header.sectionType() == SectionType::NoBits) ){
+        continue;
+      }
+      const auto index = static_cast<uint16_t>(i);
+      if( std::find(ignoredSectionIndexes.cbegin(), ignoredSectionIndexes.cend(), index) != ignoredSectionIndexes.cend() ){
+        continue;
+      }
+      map.removeRange( OffsetRange::fromSectionHeader(header) );
+    }
+
+    return map;
+  }
+
+  /*! \internal Find the PT_LOAD segment that contains \a range in the file
+   *
+   * Returns a pointer to the program header,
+   * or nullptr if no PT_LOAD segment contains \a range .
+   */
+  inline
+  const ProgramHeader *findLoadProgramHeaderContainingFileRange(const ProgramHeaderTable & table, const OffsetRange & range) noexcept
+  {
+    for(const ProgramHeader & programHeader : table){
+      if( programHeader.segmentType() != SegmentType::Load ){
+        continue;
+      }
+      if( (range.begin() >= programHeader.offset) && (range.end() <= programHeader.offset + programHeader.filesz) ){
+        return &programHeader;
+      }
+    }
+
+    return nullptr;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_FREE_SPACE_MAP_H
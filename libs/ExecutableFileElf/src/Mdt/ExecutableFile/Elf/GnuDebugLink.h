@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_H
+
+#include "Mdt/ExecutableFile/Elf/Algorithm.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Content of the .gnu_debuglink section
+   *
+   * The section contains the file name of the separate debug file,
+   * terminated by a null byte and padded to 4 bytes,
+   * followed by the CRC-32 of the whole debug file (4 bytes, in the data format of the file).
+   *
+   * A debugger looks for the debug file next to the executable,
+   * in its .debug sub-directory and in the global debug directories,
+   * and only accepts it if its CRC matches.
+   */
+  struct GnuDebugLink
+  {
+    std::string fileName;
+    uint32_t crc = 0;
+
+    /*! \brief Check if this link is null
+     */
+    bool isNull() const noexcept
+    {
+      return fileName.empty();
+    }
+
+    /*! \brief Get the size of the section for this link
+     *
+     * \pre this link must not be null
+     */
+    int64_t byteCount() const noexcept
+    {
+      assert( !isNull() );
+
+      return static_cast<int64_t>( findAlignedSize(fileName.size() + 1, 4) + 4 );
+    }
+
+    /*! \brief Get the name of the .gnu_debuglink section
+     */
+    static
+    std::string sectionName() noexcept
+    {
+      return ".gnu_debuglink";
+    }
+  };
+
+  /*! \internal Tables for the slicing-by-8 CRC-32
+   *
+   * The first table is the usual byte-wise table,
+   * each other one gives the CRC of a byte followed by 1 to 7 null bytes.
+   */
+  class GnuDebugLinkCrcTables
+  {
+   public:
+
+    GnuDebugLinkCrcTables() noexcept
+    {
+      for(uint32_t i = 0; i < 256; ++i){
+        uint32_t crc = i;
+        for(int bit = 0; bit < 8; ++bit){
+          crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+        }
+        mTables[0][i] = crc;
+      }
+      for(uint32_t i = 0; i < 256; ++i){
+        for(size_t t = 1; t < mTables.size(); ++t){
+          const uint32_t previous = mTables[t-1][i];
+          mTables[t][i] = (previous >> 8) ^ mTables[0][previous & 0xFF];
+        }
+      }
+    }
+
+    const std::array<uint32_t, 256> & operator[](size_t index) const noexcept
+    {
+      assert( index < mTables.size() );
+
+      return mTables[index];
+    }
+
+   private:
+
+    std::array< std::array<uint32_t, 256>, 8 > mTables;
+  };
+
+  /*! \internal Update \a crc with the bytes of \a data
+   *
+   * This is the CRC-32 used by zlib and by the .gnu_debuglink section.
+   * Start with a \a crc of 0, and pass the returned value for the next part:
+   * \code
+   * uint32_t crc = 0;
+   * crc = updateGnuDebugLinkCrc(crc, firstPart);
+   * crc = updateGnuDebugLinkCrc(crc, secondPart);
+   * \endcode
+   *
+   * The debug file can be several GB large,
+   * so 8 bytes are processed per step (slicing-by-8),
+   * which is several times faster than the usual byte-wise table.
+   * The bytes are combined one by one,
+   * so the result does not depend on the host byte order.
+   */
+  inline
+  uint32_t updateGnuDebugLinkCrc(uint32_t crc, const ByteArraySpan & data) noexcept
+  {
+    static const GnuDebugLinkCrcTables tables;
+
+    const unsigned char *it = data.data;
+    int64_t remainingSize = data.size;
+
+    crc = ~crc;
+
+    while(remainingSize >= 8){
+      const uint32_t one = crc ^ ( static_cast<uint32_t>(it[0]) | (static_cast<uint32_t>(it[1]) << 8)
+                               | (static_cast<uint32_t>(it[2]) << 16) | (static_cast<uint32_t>(it[3]) << 24) );
+      const uint32_t two = static_cast<uint32_t>(it[4]) | (static_cast<uint32_t>(it[5]) << 8)
+                         | (static_cast<uint32_t>(it[6]) << 16) | (static_cast<uint32_t>(it[7]) << 24);
+      crc = tables[7][one & 0xFF] ^ tables[6][(one >> 8) & 0xFF]
+          ^ tables[5][(one >> 16) & 0xFF] ^ tables[4][one >> 24]
+          ^ tables[3][two & 0xFF] ^ tables[2][(two >> 8) & 0xFF]
+          ^ tables[1][(two >> 16) & 0xFF] ^ tables[0][two >> 24];
+      it += 8;
+      remainingSize -= 8;
+    }
+
+    while(remainingSize > 0){
+      crc = tables[0][(crc ^ *it) & 0xFF] ^ (crc >> 8);
+      ++it;
+      --remainingSize;
+    }
+
+    return ~crc;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_H
@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_READER_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_READER_H
+
+#include "Mdt/ExecutableFile/Elf/GnuDebugLink.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/Elf/Algorithm.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Get the .gnu_debuglink section content out from \a map
+   *
+   * A section that is too small to contain the CRC
+   * after the file name gives a CRC of 0,
+   * a empty section gives a null link.
+   *
+   * \pre \a map must not be null
+   * \pre \a sectionHeader must be the .gnu_debuglink section header
+   * \pre \a map must be big enough to read the section
+   * \pre \a dataFormat must be valid
+   */
+  inline
+  GnuDebugLink extractGnuDebugLink(const ByteArraySpan & map, const SectionHeader & sectionHeader, DataFormat dataFormat) noexcept
+  {
+    assert( !map.isNull() );
+    assert( sectionHeader.isGnuDebugLinkSectionHeader() );
+    assert( map.size >= sectionHeader.minimumSizeToReadSection() );
+    assert( dataFormat != DataFormat::DataNone );
+
+    GnuDebugLink link;
+    if(sectionHeader.size == 0){
+      return link;
+    }
+
+    const int64_t offset = static_cast<int64_t>(sectionHeader.offset);
+    const int64_t size = static_cast<int64_t>(sectionHeader.size);
+    const ByteArraySpan section = map.subSpan(offset, size);
+    // The name is followed by its padding and the CRC, so it ends at the first null byte
+    const auto nameEnd = std::find( section.cbegin(), section.cend(), 0 );
+    link.fileName.assign( section.cbegin(), nameEnd );
+
+    const int64_t crcOffset = static_cast<int64_t>( findAlignedSize(link.fileName.size() + 1, 4) );
+    if( (crcOffset + 4) <= section.size ){
+      link.crc = getWord(section.data + crcOffset, dataFormat);
+    }
+
+    return link;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_READER_H
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_WRITER_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_WRITER_H
+
+#include "Mdt/ExecutableFile/Elf/GnuDebugLink.h"
+#include "Mdt/ExecutableFile/Elf/FileWriterUtils.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Set the .gnu_debuglink section content to \a array
+   *
+   * \pre \a array must not be null
+   * \pre \a link must not be null
+   * \pre \a array size must be the one of \a link
+   * \pre \a dataFormat must be valid
+   */
+  inline
+  void setGnuDebugLinkToArray(ByteArraySpan array, const GnuDebugLink & link, DataFormat dataFormat) noexcept
+  {
+    assert( !array.isNull() );
+    assert( !link.isNull() );
+    assert( array.size == link.byteCount() );
+    assert( dataFormat != DataFormat::DataNone );
+
+    const int64_t nameSize = static_cast<int64_t>( link.fileName.size() + 1 );
+    const int64_t crcOffset = array.size - 4;
+
+    setStringToUnsignedCharArray(array.subSpan(0, nameSize), link.fileName);
+    if(crcOffset > nameSize){
+      replaceBytesInArray(array.subSpan(nameSize, crcOffset - nameSize), '\0');
+    }
+    set32BitWord(array.subSpan(crcOffset, 4), link.crc, dataFormat);
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_DEBUG_LINK_WRITER_H
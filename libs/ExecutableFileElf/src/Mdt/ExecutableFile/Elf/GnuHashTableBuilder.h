@@ -0,0 +1,271 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_HASH_TABLE_BUILDER_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_HASH_TABLE_BUILDER_H
+
+#include "Mdt/ExecutableFile/Elf/GnuHashTable.h"
+#include "Mdt/ExecutableFile/Elf/Ident.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string_view>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Get the GNU hash of a symbol name
+   *
+   * \sa https://flapenguin.me/elf-dt-gnu-hash
+   */
+  inline
+  uint32_t gnuHash(std::string_view name) noexcept
+  {
+    uint32_t hash = 5381;
+    for(const char c : name){
+      hash = (hash << 5) + hash + static_cast<unsigned char>(c);
+    }
+
+    return hash;
+  }
+
+  /*! \internal Get the count of buckets of a GNU hash table for \a symbolCount hashed symbols
+   *
+   * Like the GNU linker, a prime is choosen so that the average chain
+   * holds between 1 and 2 symbols.
+   * A lookup then compares only a few hashes,
+   * while the buckets array stays small.
+   */
+  inline
+  uint32_t gnuHashBucketCountForSymbolCount(uint32_t symbolCount) noexcept
+  {
+    static constexpr uint32_t primes[] = {
+      1, 3, 17, 37, 67, 97, 131, 197, 263, 521, 1031, 2053, 4099, 8209,
+      16411, 32771, 65537, 131101, 262147
+    };
+    constexpr size_t primeCount = sizeof(primes) / sizeof(primes[0]);
+
+    uint32_t bucketCount = primes[0];
+    for(size_t i = 0; i < primeCount; ++i){
+      bucketCount = primes[i];
+      if( (i + 1 < primeCount) && (symbolCount < primes[i+1]) ){
+        break;
+      }
+    }
+
+    return bucketCount;
+  }
+
+  /*! \internal Parameters of the bloom filter of a GNU hash table
+   */
+  struct GnuHashBloomParameters
+  {
+    uint32_t bloomSize = 1;
+    uint32_t bloomShift = 0;
+  };
+
+  /*! \internal Get the bloom filter parameters of a GNU hash table for \a symbolCount hashed symbols
+   *
+   * The filter has between 4 and 8 bits per symbol
+   * (2 bits are set for each symbol),
+   * which rejects most of the lookups of symbols that are not defined
+   * without reading the buckets and the chains.
+   * The bloom size is a power of 2, as required by the dynamic loader.
+   */
+  inline
+  GnuHashBloomParameters gnuHashBloomParametersForSymbolCount(uint32_t symbolCount, Class _class) noexcept
+  {
+    assert(_class != Class::ClassNone);
+
+    // floor(log2(symbolCount)), 0 for 0 or 1 symbol
+    uint32_t log2 = 0;
+    while( (uint64_t(2) << log2) <= symbolCount ){
+      ++log2;
+    }
+
+    uint32_t maskBitsLog2 = log2 + 1;
+    if(maskBitsLog2 < 3){
+      maskBitsLog2 = 5;
+    }else if( ( (uint64_t(1) << (maskBitsLog2 - 2)) & symbolCount ) != 0 ){
+      maskBitsLog2 += 3;
+    }else{
+      maskBitsLog2 += 2;
+    }
+
+    uint32_t entryBitsLog2 = 5;
+    if(_class == Class::Class64){
+      entryBitsLog2 = 6;
+      maskBitsLog2 = std::max(maskBitsLog2, entryBitsLog2);
+    }
+
+    GnuHashBloomParameters parameters;
+    parameters.bloomSize = uint32_t(1) << (maskBitsLog2 - entryBitsLog2);
+    parameters.bloomShift = maskBitsLog2;
+
+    return parameters;
+  }
+
+  /*! \internal Check if the symbols with \a hashes are ordered as a GNU hash table with \a bucketCount requires
+   *
+   * The symbols that fall in the same bucket must be contiguous.
+   *
+   * \pre \a bucketCount must be > 0
+   */
+  inline
+  bool symbolsAreInGnuHashOrder(const std::vector<uint32_t> & hashes, uint32_t bucketCount) noexcept
+  {
+    assert(bucketCount > 0);
+
+    std::vector<bool> closedBuckets(bucketCount, false);
+    for(size_t i = 0; i < hashes.size(); ++i){
+      const uint32_t bucket = hashes[i] % bucketCount;
+      if( (i > 0) && ( (hashes[i-1] % bucketCount) == bucket ) ){
+        continue;
+      }
+      if(closedBuckets[bucket]){
+        return false;
+      }
+      closedBuckets[bucket] = true;
+    }
+
+    return true;
+  }
+
+  /*! \internal Get the order of the hashed symbols for a GNU hash table with \a bucketCount
+   *
+   * Returns a permutation: the element at position i is the index,
+   * in \a hashes , of the symbol that must be put at position i.
+   * The symbols are sorted by bucket, keeping their relative order in a bucket.
+   *
+   * \note sorting the .dynsym of a linked file also requires to update
+   * everything that refers to a symbol by its index
+   * (relocations, .gnu.version, ...)
+   * \pre \a bucketCount must be > 0
+   */
+  inline
+  std::vector<size_t> gnuHashSymbolOrder(const std::vector<uint32_t> & hashes, uint32_t bucketCount) noexcept
+  {
+    assert(bucketCount > 0);
+
+    std::vector<size_t> order(hashes.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+
+    std::stable_sort(order.begin(), order.end(), [&hashes, bucketCount](size_t a, size_t b){
+      return (hashes[a] % bucketCount) < (hashes[b] % bucketCount);
+    });
+
+    return order;
+  }
+
+  /*! \internal Make a GNU hash table
+   *
+   * \a hashes are the hashes of the symbols that start at \a symoffset in the dynamic symbol table,
+   * in the order of that table.
+   *
+   * \pre \a symoffset must be > 0 (the first symbol is the null symbol)
+   * \pre \a bucketCount must be > 0
+   * \pre \a bloom size must be a power of 2
+   * \pre the symbols must be ordered as required for \a bucketCount
+   * \sa symbolsAreInGnuHashOrder()
+   */
+  inline
+  GnuHashTable makeGnuHashTable(const std::vector<uint32_t> & hashes, uint32_t symoffset, uint32_t bucketCount,
+                                const GnuHashBloomParameters & bloomParameters, Class _class) noexcept
+  {
+    assert(symoffset > 0);
+    assert(bucketCount > 0);
+    assert(bloomParameters.bloomSize > 0);
+    assert( (bloomParameters.bloomSize & (bloomParameters.bloomSize - 1)) == 0 );
+    assert( symbolsAreInGnuHashOrder(hashes, bucketCount) );
+    assert(_class != Class::ClassNone);
+
+    const uint32_t entryBits = static_cast<uint32_t>( GnuHashTable::bloomEntryByteCount(_class) * 8 );
+
+    GnuHashTable table;
+    table.symoffset = symoffset;
+    table.bloomShift = bloomParameters.bloomShift;
+    table.bloom.assign(bloomParameters.bloomSize, 0);
+    table.buckets.assign(bucketCount, 0);
+    table.chain.resize( hashes.size() );
+
+    for(size_t i = 0; i < hashes.size(); ++i){
+      const uint32_t hash = hashes[i];
+
+      const uint32_t bloomIndex = (hash / entryBits) & (bloomParameters.bloomSize - 1);
+      table.bloom[bloomIndex] |= uint64_t(1) << (hash % entryBits);
+      table.bloom[bloomIndex] |= uint64_t(1) << ( (hash >> bloomParameters.bloomShift) % entryBits );
+
+      const uint32_t bucket = hash % bucketCount;
+      if(table.buckets[bucket] == 0){
+        table.buckets[bucket] = symoffset + static_cast<uint32_t>(i);
+      }
+
+      // The lowest bit marks the end of the chain of a bucket
+      table.chain[i] = hash & ~uint32_t(1);
+      if( (i + 1 == hashes.size()) || ( (hashes[i+1] % bucketCount) != bucket ) ){
+        table.chain[i] |= 1;
+      }
+    }
+
+    return table;
+  }
+
+  /*! \internal Make a optimized GNU hash table for the symbols having \a hashes
+   *
+   * The count of buckets and the bloom filter are sized
+   * for the count of hashed symbols.
+   * They are never made smaller than in \a currentTable ,
+   * so a table produced by a recent linker is kept as is.
+   *
+   * The count of buckets is only changed if the symbols are already
+   * ordered as required for the new count
+   * (reordering the dynamic symbol table of a linked file is not supported).
+   *
+   * \pre the symoffset of \a currentTable must be > 0
+   * \pre \a currentTable must have at least 1 bucket
+   * \pre the symbols must be ordered as required for the buckets of \a currentTable
+   */
+  inline
+  GnuHashTable makeOptimizedGnuHashTable(const std::vector<uint32_t> & hashes, const GnuHashTable & currentTable, Class _class) noexcept
+  {
+    assert(currentTable.symoffset > 0);
+    assert(currentTable.bucketCount() > 0);
+    assert(_class != Class::ClassNone);
+
+    const auto symbolCount = static_cast<uint32_t>( hashes.size() );
+
+    uint32_t bucketCount = gnuHashBucketCountForSymbolCount(symbolCount);
+    if( (bucketCount <= currentTable.bucketCount()) || !symbolsAreInGnuHashOrder(hashes, bucketCount) ){
+      bucketCount = currentTable.bucketCount();
+    }
+
+    GnuHashBloomParameters bloomParameters = gnuHashBloomParametersForSymbolCount(symbolCount, _class);
+    const uint32_t currentBloomSize = currentTable.bloomSize();
+    const bool currentBloomSizeIsPowerOf2 = (currentBloomSize > 0) && ( (currentBloomSize & (currentBloomSize - 1)) == 0 );
+    if( (bloomParameters.bloomSize <= currentBloomSize) && currentBloomSizeIsPowerOf2 ){
+      bloomParameters.bloomSize = currentBloomSize;
+      bloomParameters.bloomShift = currentTable.bloomShift;
+    }
+
+    return makeGnuHashTable(hashes, currentTable.symoffset, bucketCount, bloomParameters, _class);
+  }
+
+  /*! \internal Check if \a a and \a b are the same GNU hash tables
+   */
+  inline
+  bool gnuHashTablesAreEqual(const GnuHashTable & a, const GnuHashTable & b) noexcept
+  {
+    return (a.symoffset == b.symoffset) && (a.bloomShift == b.bloomShift)
+        && (a.bloom == b.bloom) && (a.buckets == b.buckets) && (a.chain == b.chain);
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_HASH_TABLE_BUILDER_H
@@ -11,6 +11,9 @@
 #define MDT_EXECUTABLE_FILE_ELF_GNU_HASH_TABLE_READER_H
 
 #include "Mdt/ExecutableFile/Elf/GnuHashTable.h"
+#include "Mdt/ExecutableFile/Elf/GnuHashTableBuilder.h"
+#include "Mdt/ExecutableFile/Elf/StringTable.h"
+#include "Mdt/ExecutableFile/Elf/SymbolTableReader.h"
 #include "Mdt/ExecutableFile/Elf/FileHeader.h"
 #include "Mdt/ExecutableFile/Elf/FileReader.h"
 #include "Mdt/ExecutableFile/Elf/SectionHeader.h"
@@ -18,7 +21,9 @@
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
 #include <QObject>
 #include <QString>
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 #include <cassert>
 
 namespace Mdt{ namespace ExecutableFile{ namespace Elf{
@@ -126,6 +131,60 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       }
     }
 
+
+    /*! \internal Extract the GNU hashes of the symbols starting at \a symoffset in .dynsym
+     *
+     * The names are taken from \a dynamicStringTable (.dynstr).
+     * Returns a empty list if the file has no .dynsym .
+     *
+     * \exception GnuHashTableReadError
+     */
+    static
+    std::vector<uint32_t> extractHashedSymbolHashes(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                                    const std::vector<SectionHeader> & sectionHeaderTable,
+                                                    uint32_t symoffset, const StringTable & dynamicStringTable)
+    {
+      assert( !map.isNull() );
+      assert( fileHeader.seemsValid() );
+
+      std::vector<uint32_t> hashes;
+
+      const auto dynSymPred = [](const SectionHeader & header){
+        return header.sectionType() == SectionType::DynSym;
+      };
+      const auto dynSymIt = std::find_if(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), dynSymPred);
+      if( dynSymIt == sectionHeaderTable.cend() ){
+        return hashes;
+      }
+      if( map.size < dynSymIt->minimumSizeToReadSection() ){
+        const QString msg = tr("reading hashed symbols failed: section %1 ends past the end of the file")
+                            .arg( QString::fromStdString(dynSymIt->name) );
+        throw GnuHashTableReadError(msg);
+      }
+
+      const uint64_t entrySize = static_cast<uint64_t>( symbolTableEntrySize(fileHeader.ident._class) );
+      const uint64_t entryCount = dynSymIt->size / entrySize;
+      if(symoffset > entryCount){
+        const QString msg = tr("reading hashed symbols failed: symoffset %1 is past the %2 symbols of %3")
+                            .arg(symoffset).arg(entryCount).arg( QString::fromStdString(dynSymIt->name) );
+        throw GnuHashTableReadError(msg);
+      }
+
+      hashes.reserve(entryCount - symoffset);
+      for(uint64_t i = symoffset; i < entryCount; ++i){
+        const int64_t offset = static_cast<int64_t>(dynSymIt->offset + i * entrySize);
+        const SymbolTableEntry entry = symbolTableEntryFromArray( map.subSpan( offset, static_cast<int64_t>(entrySize) ), fileHeader.ident );
+        if( !dynamicStringTable.indexIsValid(entry.name) ){
+          const QString msg = tr("reading hashed symbols failed: symbol %1 has a invalid name index")
+                              .arg(i);
+          throw GnuHashTableReadError(msg);
+        }
+        hashes.push_back( gnuHash( dynamicStringTable.stringViewAtIndex(entry.name) ) );
+      }
+
+      return hashes;
+    }
+
   };
 
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
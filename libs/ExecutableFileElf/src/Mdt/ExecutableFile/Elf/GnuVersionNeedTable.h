@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_H
+
+#include "Mdt/ExecutableFile/Elf/StringTable.h"
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal A version required from a shared library (Elf_Vernaux)
+   *
+   * \a name is a index in the .dynstr section
+   * and \a other is the version index used in .gnu.version .
+   */
+  struct GnuVersionNeedAuxEntry
+  {
+    uint32_t hash = 0;
+    uint16_t flags = 0;
+    uint16_t other = 0;
+    uint32_t name = 0;
+  };
+
+  /*! \internal A shared library from which versions are required (Elf_Verneed)
+   *
+   * \a file is a index in the .dynstr section.
+   */
+  struct GnuVersionNeedEntry
+  {
+    uint16_t version = 1;
+    uint32_t file = 0;
+    std::vector<GnuVersionNeedAuxEntry> auxEntries;
+  };
+
+  /*! \internal The .gnu.version_r section
+   *
+   * \sa https://refspecs.linuxfoundation.org/LSB_5.0.0/LSB-Core-generic/LSB-Core-generic/symversion.html
+   */
+  struct GnuVersionNeedTable
+  {
+    std::vector<GnuVersionNeedEntry> entries;
+
+    /*! \brief Size of a Elf_Verneed entry (the same for 32-bit and 64-bit files)
+     */
+    static constexpr int64_t entryByteCount = 16;
+
+    /*! \brief Size of a Elf_Vernaux entry (the same for 32-bit and 64-bit files)
+     */
+    static constexpr int64_t auxEntryByteCount = 16;
+
+    /*! \brief Check if this table is empty
+     */
+    bool isEmpty() const noexcept
+    {
+      return entries.empty();
+    }
+
+    /*! \brief Get the size of this table, in bytes
+     */
+    int64_t byteCount() const noexcept
+    {
+      int64_t size = 0;
+
+      for(const GnuVersionNeedEntry & entry : entries){
+        size += entryByteCount + auxEntryByteCount * static_cast<int64_t>( entry.auxEntries.size() );
+      }
+
+      return size;
+    }
+
+    /*! \brief Get the highest version index used by this table
+     */
+    uint16_t highestVersionIndex() const noexcept
+    {
+      uint16_t index = 0;
+
+      for(const GnuVersionNeedEntry & entry : entries){
+        for(const GnuVersionNeedAuxEntry & auxEntry : entry.auxEntries){
+          index = std::max(index, auxEntry.other);
+        }
+      }
+
+      return index;
+    }
+
+    /*! \brief Find the entry for the shared library \a file
+     *
+     * The names are taken from \a stringTable (.dynstr).
+     * Returns entries.size() if no entry exists for \a file .
+     */
+    size_t findIndexOfEntryForFile(std::string_view file, const StringTable & stringTable) const noexcept
+    {
+      for(size_t i = 0; i < entries.size(); ++i){
+        if( stringTable.indexIsValid(entries[i].file) && (stringTable.stringViewAtIndex(entries[i].file) == file) ){
+          return i;
+        }
+      }
+
+      return entries.size();
+    }
+
+    /*! \brief Check if the entry at \a index requires the version \a name
+     *
+     * \pre \a index must be valid
+     */
+    bool entryRequiresVersion(size_t index, std::string_view name, const StringTable & stringTable) const noexcept
+    {
+      assert( index < entries.size() );
+
+      for(const GnuVersionNeedAuxEntry & auxEntry : entries[index].auxEntries){
+        if( stringTable.indexIsValid(auxEntry.name) && (stringTable.stringViewAtIndex(auxEntry.name) == name) ){
+          return true;
+        }
+      }
+
+      return false;
+    }
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_H
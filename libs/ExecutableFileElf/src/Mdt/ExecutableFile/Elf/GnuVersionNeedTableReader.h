@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_READER_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_READER_H
+
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTable.h"
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/Exceptions.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <QObject>
+#include <QString>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal
+   */
+  class GnuVersionNeedTableReader : public QObject
+  {
+    Q_OBJECT
+
+   public:
+
+    /*! \internal Read \a entryCount entries from \a array
+     *
+     * The entries are followed using their vn_next and vna_next offsets,
+     * like the dynamic loader does.
+     *
+     * \exception GnuVersionNeedTableReadError
+     */
+    static
+    GnuVersionNeedTable tableFromArray(const ByteArraySpan & array, const Ident & ident, uint32_t entryCount)
+    {
+      assert( !array.isNull() );
+      assert( ident.isValid() );
+
+      GnuVersionNeedTable table;
+
+      int64_t entryOffset = 0;
+      for(uint32_t i = 0; i < entryCount; ++i){
+        checkEntryIsInArray(array, entryOffset, GnuVersionNeedTable::entryByteCount);
+
+        GnuVersionNeedEntry entry;
+        entry.version = getHalfWord(array.data + entryOffset, ident.dataFormat);
+        const uint16_t auxEntryCount = getHalfWord(array.data + entryOffset + 2, ident.dataFormat);
+        entry.file = getWord(array.data + entryOffset + 4, ident.dataFormat);
+        const uint32_t auxOffset = getWord(array.data + entryOffset + 8, ident.dataFormat);
+        const uint32_t next = getWord(array.data + entryOffset + 12, ident.dataFormat);
+
+        int64_t auxEntryOffset = entryOffset + auxOffset;
+        for(uint16_t j = 0; j < auxEntryCount; ++j){
+          checkEntryIsInArray(array, auxEntryOffset, GnuVersionNeedTable::auxEntryByteCount);
+
+          GnuVersionNeedAuxEntry auxEntry;
+          auxEntry.hash = getWord(array.data + auxEntryOffset, ident.dataFormat);
+          auxEntry.flags = getHalfWord(array.data + auxEntryOffset + 4, ident.dataFormat);
+          auxEntry.other = getHalfWord(array.data + auxEntryOffset + 6, ident.dataFormat);
+          auxEntry.name = getWord(array.data + auxEntryOffset + 8, ident.dataFormat);
+          entry.auxEntries.push_back(auxEntry);
+
+          auxEntryOffset += getWord(array.data + auxEntryOffset + 12, ident.dataFormat);
+        }
+
+        table.entries.push_back(entry);
+        entryOffset += next;
+      }
+
+      return table;
+    }
+
+    /*! \internal
+     *
+     * The count of entries is taken from the sh_info of \a sectionHeader .
+     *
+     * \exception GnuVersionNeedTableReadError
+     */
+    static
+    GnuVersionNeedTable extractTable(const ByteArraySpan & map, const FileHeader & fileHeader, const SectionHeader & sectionHeader)
+    {
+      assert( !map.isNull() );
+      assert( fileHeader.seemsValid() );
+      assert( sectionHeader.sectionType() == SectionType::GnuVersionNeed );
+
+      if( map.size < sectionHeader.minimumSizeToReadSection() ){
+        const QString msg = tr("section %1 ends past the end of the file")
+                            .arg( QString::fromStdString(sectionHeader.name) );
+        throw GnuVersionNeedTableReadError(msg);
+      }
+
+      const int64_t offset = static_cast<int64_t>(sectionHeader.offset);
+      const int64_t size = static_cast<int64_t>(sectionHeader.size);
+
+      try{
+        return tableFromArray(map.subSpan(offset, size), fileHeader.ident, sectionHeader.info);
+      }catch(const GnuVersionNeedTableReadError & error){
+        const QString msg = tr("section %1 is corrupted: %2")
+                            .arg( QString::fromStdString(sectionHeader.name), error.whatQString() );
+        throw GnuVersionNeedTableReadError(msg);
+      }
+    }
+
+   private:
+
+    static
+    void checkEntryIsInArray(const ByteArraySpan & array, int64_t offset, int64_t entrySize)
+    {
+      if( (offset < 0) || (offset + entrySize > array.size) ){
+        const QString msg = tr("a entry at offset %1 ends past the end of the section")
+                            .arg(offset);
+        throw GnuVersionNeedTableReadError(msg);
+      }
+    }
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_READER_H
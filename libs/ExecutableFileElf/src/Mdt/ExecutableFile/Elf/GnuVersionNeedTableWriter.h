@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_WRITER_H
+#define MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_WRITER_H
+
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTable.h"
+#include "Mdt/ExecutableFile/Elf/FileWriterUtils.h"
+#include "Mdt/ExecutableFile/Elf/Ident.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Write \a table to \a array
+   *
+   * Like the GNU linker does, each Elf_Verneed entry
+   * is directly followed by its Elf_Vernaux entries.
+   *
+   * \pre \a array must not be null
+   * \pre \a array size must be \a table byteCount()
+   */
+  inline
+  void setGnuVersionNeedTableToArray(ByteArraySpan array, const GnuVersionNeedTable & table, const Ident & ident) noexcept
+  {
+    assert( !array.isNull() );
+    assert( ident.isValid() );
+    assert( array.size == table.byteCount() );
+
+    const int64_t entrySize = GnuVersionNeedTable::entryByteCount;
+    const int64_t auxEntrySize = GnuVersionNeedTable::auxEntryByteCount;
+
+    int64_t offset = 0;
+    for(size_t i = 0; i < table.entries.size(); ++i){
+      const GnuVersionNeedEntry & entry = table.entries[i];
+      const int64_t auxEntryCount = static_cast<int64_t>( entry.auxEntries.size() );
+      const bool isLast = (i + 1) == table.entries.size();
+      const uint32_t next = isLast ? 0 : static_cast<uint32_t>(entrySize + auxEntrySize * auxEntryCount);
+
+      setHalfWord( array.subSpan(offset, 2), entry.version, ident.dataFormat );
+      setHalfWord( array.subSpan(offset + 2, 2), static_cast<uint16_t>(auxEntryCount), ident.dataFormat );
+      set32BitWord( array.subSpan(offset + 4, 4), entry.file, ident.dataFormat );
+      set32BitWord( array.subSpan(offset + 8, 4), auxEntryCount > 0 ? static_cast<uint32_t>(entrySize) : 0, ident.dataFormat );
+      set32BitWord( array.subSpan(offset + 12, 4), next, ident.dataFormat );
+      offset += entrySize;
+
+      for(int64_t j = 0; j < auxEntryCount; ++j){
+        const GnuVersionNeedAuxEntry & auxEntry = entry.auxEntries[static_cast<size_t>(j)];
+        const uint32_t auxNext = (j + 1) == auxEntryCount ? 0 : static_cast<uint32_t>(auxEntrySize);
+
+        set32BitWord( array.subSpan(offset, 4), auxEntry.hash, ident.dataFormat );
+        setHalfWord( array.subSpan(offset + 4, 2), auxEntry.flags, ident.dataFormat );
+        setHalfWord( array.subSpan(offset + 6, 2), auxEntry.other, ident.dataFormat );
+        set32BitWord( array.subSpan(offset + 8, 4), auxEntry.name, ident.dataFormat );
+        set32BitWord( array.subSpan(offset + 12, 4), auxNext, ident.dataFormat );
+        offset += auxEntrySize;
+      }
+    }
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_GNU_VERSION_NEED_TABLE_WRITER_H
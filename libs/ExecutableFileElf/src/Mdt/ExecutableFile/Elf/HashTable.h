@@ -11,11 +11,35 @@
 #define MDT_EXECUTABLE_FILE_ELF_HASH_TABLE_H
 
 #include <cstdint>
+#include <string_view>
 #include <vector>
 #include <cassert>
 
 namespace Mdt{ namespace ExecutableFile{ namespace Elf{
 
+  /*! \internal Get the ELF (SysV) hash of \a name
+   *
+   * This is the hash used by DT_HASH tables,
+   * and by the version names of .gnu.version_r .
+   *
+   * \sa https://refspecs.linuxfoundation.org/elf/gabi4+/ch5.dynamic.html#hash
+   */
+  inline
+  uint32_t elfHash(std::string_view name) noexcept
+  {
+    uint32_t hash = 0;
+    for(const char c : name){
+      hash = (hash << 4) + static_cast<unsigned char>(c);
+      const uint32_t high = hash & 0xf0000000;
+      if(high != 0){
+        hash ^= high >> 24;
+      }
+      hash &= ~high;
+    }
+
+    return hash;
+  }
+
   /*! \internal
    *
    * \sa https://flapenguin.me/elf-dt-hash
@@ -59,6 +59,26 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mTable.emplace_back(header, section);
     }
 
+    /*! \brief Set the section named like \a header
+     *
+     * If this table has no section with the name of \a header,
+     * it is added.
+     *
+     * \pre \a header must be a note section header
+     */
+    void setSection(const SectionHeader & header, const NoteSection & section) noexcept
+    {
+      assert( isNoteSectionHeader(header) );
+
+      const auto it = findSectionHeader(header.name);
+      if( it == mTable.end() ){
+        mTable.emplace_back(header, section);
+      }else{
+        it->header = header;
+        it->section = section;
+      }
+    }
+
     /*! \brief Get the count of sections in this table
      */
     size_t sectionCount() const noexcept
@@ -117,6 +137,22 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       }
     }
 
+    /*! \brief Remove the sections that do not occupy memory during process execution
+     *
+     * The deployment stamp note is kept.
+     *
+     * Should be called when those sections are removed
+     * from the section header table.
+     */
+    void removeNonAllocatedSections() noexcept
+    {
+      const auto isNotAllocated = [](const NoteSectionTableEntry & entry){
+        return !entry.header.allocatesMemory() && !entry.header.isDeployStampNoteSectionHeader();
+      };
+
+      mTable.erase( std::remove_if(mTable.begin(), mTable.end(), isNotAllocated), mTable.end() );
+    }
+
     /*! \brief Find the minimum size required to write this table to a file
      */
     int64_t findMinimumSizeToWriteTable() const noexcept
@@ -202,6 +202,16 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return align > 1;
     }
 
+    /*! \brief Check if this header is a PT_NOTE that is only in the file
+     *
+     * Such a note has some file content, but is not loaded (p_memsz is 0),
+     * like the deployment stamp note.
+     */
+    bool isNoteOnlyInFile() const noexcept
+    {
+      return (segmentType() == SegmentType::Note) && (filesz > 0) && (memsz == 0);
+    }
+
     /*! \brief Get the virtual address of the end of the segment represented by this header
      *
      * \note the returned address is 1 byte past the last virtual address of the segment
@@ -60,6 +60,43 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mTable[index];
     }
 
+    /*! \brief Set the file and memory size of the segment at \a index
+     *
+     * \pre \a index must be in valid range ( \a index < headerCount() )
+     */
+    void setSegmentSizeAt(size_t index, uint64_t size) noexcept
+    {
+      assert( index < headerCount() );
+
+      mTable[index].filesz = size;
+      mTable[index].memsz = size;
+    }
+
+    /*! \brief Set the file offset and the file size of the segment at \a index
+     *
+     * The virtual address and the memory size are not changed.
+     *
+     * \pre \a index must be in valid range ( \a index < headerCount() )
+     */
+    void setFileOffsetAndFileSizeAt(size_t index, uint64_t offset, uint64_t size) noexcept
+    {
+      assert( index < headerCount() );
+
+      mTable[index].offset = offset;
+      mTable[index].filesz = size;
+    }
+
+    /*! \brief Set the alignment of the segment at \a index
+     *
+     * \pre \a index must be in valid range ( \a index < headerCount() )
+     */
+    void setSegmentAlignmentAt(size_t index, uint64_t alignment) noexcept
+    {
+      assert( index < headerCount() );
+
+      mTable[index].align = alignment;
+    }
+
     /*! \brief Add \a header readen from a file
      *
      * This method simply adds \a header,
@@ -79,7 +116,10 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
           mProgramInterpreterHeaderIndex = mTable.size();
           break;
         case SegmentType::Note:
-          mNoteSegmentHeaderIndex = mTable.size();
+          // A note that is not loaded (like the deployment stamp) is not covered by the loaded notes
+          if( !header.isNoteOnlyInFile() ){
+            mNoteSegmentHeaderIndex = mTable.size();
+          }
           break;
         case SegmentType::GnuRelRo:
           mGnuRelRoSegmentHeaderIndex = mTable.size();
@@ -232,6 +272,19 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mTable[mProgramInterpreterHeaderIndex].offset = fileOffset;
     }
 
+    /*! \brief Set the size of the program interpreter header (PT_INTERP)
+     *
+     * \pre the PT_INTERP program header must exist in this table
+     * \sa containsProgramInterpreterProgramHeader()
+     */
+    void setProgramInterpreterSize(uint64_t size) noexcept
+    {
+      assert( containsProgramInterpreterProgramHeader() );
+
+      mTable[mProgramInterpreterHeaderIndex].memsz = size;
+      mTable[mProgramInterpreterHeaderIndex].filesz = size;
+    }
+
     /*! \brief Check if the PT_NOTE program header exists
      */
     bool containsNoteProgramHeader() const noexcept
@@ -344,6 +397,26 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return it->fileOffsetEnd();
     }
 
+    /*! \brief Find the file offset of the \a byteCount bytes loaded at \a virtualAddress
+     *
+     * Only the file content of the PT_LOAD segments is considered.
+     * Returns 0 if no PT_LOAD segment loads those bytes from the file
+     * (for example, for a address in .bss ).
+     */
+    uint64_t findFileOffsetOfVirtualAddress(uint64_t virtualAddress, uint64_t byteCount) const noexcept
+    {
+      for(const ProgramHeader & header : mTable){
+        if( header.segmentType() != SegmentType::Load ){
+          continue;
+        }
+        if( (virtualAddress >= header.vaddr) && (virtualAddress + byteCount <= header.vaddr + header.filesz) ){
+          return header.offset + (virtualAddress - header.vaddr);
+        }
+      }
+
+      return 0;
+    }
+
     /*! \brief get the begin iterator
      */
     const_iterator cbegin() const noexcept
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_PROGRAM_HEADER_TABLE_GROWTH_STRATEGY_H
+#define MDT_EXECUTABLE_FILE_ELF_PROGRAM_HEADER_TABLE_GROWTH_STRATEGY_H
+
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal How to make place for a new entry in the program header table
+   */
+  enum class ProgramHeaderTableGrowthStrategy
+  {
+    MoveFirstSections,      /*!< Move the sections that follow the program header table to the end */
+    MoveProgramHeaderTable  /*!< Move the program header table to the next page after the end */
+  };
+
+  /*! \internal Estimated cost of a layout
+   *
+   * A layout that is not valid
+   * (for example, because a section that should be moved is not supported)
+   * is never chosen.
+   */
+  struct LayoutCost
+  {
+    bool isValid = false;
+    uint64_t bytesCopied = 0;
+    uint64_t fileGrowth = 0;
+    uint64_t newSegmentCount = 0;
+    uint64_t pagesTouched = 0;
+
+    /*! \brief Get a single value to compare layouts
+     *
+     * Each new segment and each page touched at load
+     * costs as much as copying a page.
+     *
+     * \pre \a pageSize must be > 0
+     */
+    uint64_t score(uint64_t pageSize) const noexcept
+    {
+      assert( pageSize > 0 );
+
+      return bytesCopied + fileGrowth + pageSize * (newSegmentCount + pagesTouched);
+    }
+  };
+
+  /*! \internal Get the count of pages touched at load to map \a byteCount bytes
+   *
+   * \pre \a pageSize must be > 0
+   */
+  inline
+  uint64_t pageCountForByteCount(uint64_t byteCount, uint64_t pageSize) noexcept
+  {
+    assert( pageSize > 0 );
+
+    return (byteCount + pageSize - 1) / pageSize;
+  }
+
+  /*! \internal Choose the cheapest valid strategy
+   *
+   * On equal costs, or if none is valid, MoveFirstSections is returned,
+   * because it does not change the place of the program header table.
+   *
+   * \pre \a pageSize must be > 0
+   */
+  inline
+  ProgramHeaderTableGrowthStrategy
+  chooseProgramHeaderTableGrowthStrategy(const LayoutCost & moveFirstSectionsCost,
+                                         const LayoutCost & moveProgramHeaderTableCost, uint64_t pageSize) noexcept
+  {
+    assert( pageSize > 0 );
+
+    if( !moveProgramHeaderTableCost.isValid ){
+      return ProgramHeaderTableGrowthStrategy::MoveFirstSections;
+    }
+    if( !moveFirstSectionsCost.isValid ){
+      return ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable;
+    }
+    if( moveProgramHeaderTableCost.score(pageSize) < moveFirstSectionsCost.score(pageSize) ){
+      return ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable;
+    }
+
+    return ProgramHeaderTableGrowthStrategy::MoveFirstSections;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_PROGRAM_HEADER_TABLE_GROWTH_STRATEGY_H
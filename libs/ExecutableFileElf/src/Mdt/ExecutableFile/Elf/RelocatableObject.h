@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_RELOCATABLE_OBJECT_H
+#define MDT_EXECUTABLE_FILE_ELF_RELOCATABLE_OBJECT_H
+
+#include "Mdt/ExecutableFile/Elf/SymbolTable.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal A symbol of a relocatable object (ET_REL)
+   *
+   * \a name refers to the .strtab section in the mapped file,
+   * so it is only valid as long as the file is mapped.
+   */
+  struct RelocatableObjectSymbol
+  {
+    std::string_view name;
+    SymbolTableEntry entry;
+
+    /*! \brief Check if this symbol is defined in the object
+     */
+    bool isDefined() const noexcept
+    {
+      return !entry.isUndefined();
+    }
+
+    /*! \brief Check if this symbol is visible outside the object (global or weak)
+     */
+    bool isGlobalOrWeak() const noexcept
+    {
+      switch( entry.symbolBinding() ){
+        case SymbolBinding::Global:
+        case SymbolBinding::Weak:
+          return true;
+        default:
+          break;
+      }
+
+      return false;
+    }
+  };
+
+  /*! \internal A relocation entry (Elf_Rel or Elf_Rela)
+   *
+   * \a symbolIndex and \a type are already decoded from r_info,
+   * which is encoded differently for 32-bit and 64-bit files.
+   * \a addend is 0 for Elf_Rel entries.
+   */
+  struct RelocationEntry
+  {
+    uint64_t offset = 0;
+    uint32_t symbolIndex = 0;
+    uint32_t type = 0;
+    int64_t addend = 0;
+  };
+
+  /*! \internal A relocation section (SHT_REL or SHT_RELA)
+   */
+  struct RelocationSection
+  {
+    uint16_t sectionIndex = 0;
+    uint32_t symbolTableSectionIndex = 0;
+    uint32_t targetSectionIndex = 0;
+    bool hasAddends = false;
+    std::vector<RelocationEntry> entries;
+  };
+
+  /*! \internal A section group (SHT_GROUP)
+   *
+   * \a signature refers to the .strtab section in the mapped file,
+   * so it is only valid as long as the file is mapped.
+   */
+  struct SectionGroup
+  {
+    uint16_t sectionIndex = 0;
+    uint32_t signatureSymbolIndex = 0;
+    std::string_view signature;
+    bool isComdat = false;
+    std::vector<uint32_t> memberSectionIndexes;
+  };
+
+  /*! \internal Content of a relocatable object file (ET_REL) required to index it
+   *
+   * The section header table is not part of this struct,
+   * it is read with the same function as for executables and shared libraries.
+   *
+   * \sa extractRelocatableObject()
+   */
+  struct RelocatableObject
+  {
+    /*! \brief Symbols of the .symtab, in the file order
+     *
+     * The first symbol is the null symbol (if the object has a .symtab)
+     */
+    std::vector<RelocatableObjectSymbol> symbols;
+
+    std::vector<RelocationSection> relocationSections;
+    std::vector<SectionGroup> sectionGroups;
+
+    /*! \brief Call \a visitor for each global or weak symbol defined in this object
+     */
+    template<typename Visitor>
+    void forEachDefinedGlobalSymbol(Visitor visitor) const
+    {
+      for(const RelocatableObjectSymbol & symbol : symbols){
+        if( symbol.isDefined() && symbol.isGlobalOrWeak() ){
+          visitor(symbol);
+        }
+      }
+    }
+
+    /*! \brief Call \a visitor for each symbol this object refers to, but does not define
+     */
+    template<typename Visitor>
+    void forEachUndefinedSymbol(Visitor visitor) const
+    {
+      for(const RelocatableObjectSymbol & symbol : symbols){
+        if( !symbol.isDefined() && !symbol.name.empty() ){
+          visitor(symbol);
+        }
+      }
+    }
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_RELOCATABLE_OBJECT_H
@@ -0,0 +1,375 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_RELOCATABLE_OBJECT_READER_H
+#define MDT_EXECUTABLE_FILE_ELF_RELOCATABLE_OBJECT_READER_H
+
+#include "Mdt/ExecutableFile/Elf/RelocatableObject.h"
+#include "Mdt/ExecutableFile/Elf/Exceptions.h"
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/SymbolTableReader.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include <QString>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Get the size of a relocation entry
+   *
+   * Elf32_Rel: 8 bytes, Elf32_Rela: 12 bytes,
+   * Elf64_Rel: 16 bytes, Elf64_Rela: 24 bytes.
+   */
+  inline
+  int64_t relocationEntrySize(Class c, bool hasAddends) noexcept
+  {
+    assert( c != Class::ClassNone );
+
+    if(c == Class::Class32){
+      return hasAddends ? 12 : 8;
+    }
+    assert( c == Class::Class64 );
+
+    return hasAddends ? 24 : 16;
+  }
+
+  /*! \internal Check if \a header is a relocation section header (SHT_REL or SHT_RELA)
+   */
+  inline
+  bool isRelocationSectionHeader(const SectionHeader & header) noexcept
+  {
+    switch( header.sectionType() ){
+      case SectionType::Rel:
+      case SectionType::Rela:
+        return true;
+      default:
+        break;
+    }
+
+    return false;
+  }
+
+  /*! \internal
+   *
+   * \pre \a array must not be null
+   * \pre \a ident must be valid
+   * \pre \a array size must be relocationEntrySize()
+   */
+  inline
+  RelocationEntry relocationEntryFromArray(const ByteArraySpan & array, const Ident & ident, bool hasAddends) noexcept
+  {
+    assert( !array.isNull() );
+    assert( ident.isValid() );
+    assert( array.size == relocationEntrySize(ident._class, hasAddends) );
+
+    RelocationEntry entry;
+    const unsigned char *it = array.data;
+
+    entry.offset = getAddress(it, ident);
+    advance4or8bytes(it, ident);
+
+    const uint64_t info = getNWord(it, ident);
+    advance4or8bytes(it, ident);
+
+    if(ident._class == Class::Class32){
+      entry.symbolIndex = static_cast<uint32_t>(info >> 8);
+      entry.type = static_cast<uint32_t>(info & 0xff);
+    }else{
+      assert( ident._class == Class::Class64 );
+      entry.symbolIndex = static_cast<uint32_t>(info >> 32);
+      entry.type = static_cast<uint32_t>(info & 0xffffffff);
+    }
+
+    if(hasAddends){
+      entry.addend = getSignedNWord(it, ident);
+    }
+
+    return entry;
+  }
+
+  /*! \internal Check that the section \a header refers to is in \a map
+   *
+   * The offset and size come from the file,
+   * so they are checked as unsigned values,
+   * without computing their sum, that could overflow.
+   *
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  void checkSectionIsInMap(const ByteArraySpan & map, const SectionHeader & header)
+  {
+    assert( !map.isNull() );
+    assert( map.size >= 0 );
+
+    const uint64_t mapSize = static_cast<uint64_t>(map.size);
+    if( (header.offset > mapSize) || (header.size > mapSize - header.offset) ){
+      const QString msg = tr(
+        "file is to small to read section '%1'."
+        " section offset: %2 , section size: %3 , file size: %4"
+      ).arg( QString::fromStdString(header.name) ).arg(header.offset).arg(header.size).arg(map.size);
+      throw RelocatableObjectReadError(msg);
+    }
+  }
+
+  /*! \internal Check that \a header has the expected entry size and a size that is a multiple of it
+   *
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  void checkSectionEntrySize(const SectionHeader & header, int64_t expectedEntrySize)
+  {
+    assert( expectedEntrySize > 0 );
+
+    const uint64_t entrySize = static_cast<uint64_t>(expectedEntrySize);
+    if( (header.entsize != entrySize) || ( (header.size % entrySize) != 0 ) ){
+      const QString msg = tr(
+        "section '%1' has a invalid entry size or size."
+        " entry size: %2 (expected %3) , size: %4"
+      ).arg( QString::fromStdString(header.name) ).arg(header.entsize).arg(expectedEntrySize).arg(header.size);
+      throw RelocatableObjectReadError(msg);
+    }
+  }
+
+  /*! \internal Get a view to the string at \a index in the string table section \a stringTableHeader refers to
+   *
+   * No copy is made: the returned view refers to \a map .
+   *
+   * \pre \a map must not be null
+   * \pre \a stringTableHeader must be a string table section header that is in \a map
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  std::string_view stringViewFromStringTableSection(const ByteArraySpan & map, const SectionHeader & stringTableHeader, uint64_t index)
+  {
+    assert( !map.isNull() );
+    assert( headerIsStringTableSection(stringTableHeader) );
+    assert( map.size >= stringTableHeader.minimumSizeToReadSection() );
+
+    if( index >= stringTableHeader.size ){
+      const QString msg = tr("index %1 is out of the string table '%2' (size: %3)")
+                          .arg(index).arg( QString::fromStdString(stringTableHeader.name) ).arg(stringTableHeader.size);
+      throw RelocatableObjectReadError(msg);
+    }
+
+    const char *first = reinterpret_cast<const char*>(map.data + stringTableHeader.offset + index);
+    const size_t maxLength = static_cast<size_t>(stringTableHeader.size - index);
+    const void *end = std::memchr(first, 0, maxLength);
+    if(end == nullptr){
+      const QString msg = tr("string at index %1 in the string table '%2' is not null terminated")
+                          .arg(index).arg( QString::fromStdString(stringTableHeader.name) );
+      throw RelocatableObjectReadError(msg);
+    }
+
+    return std::string_view( first, static_cast<size_t>(static_cast<const char*>(end) - first) );
+  }
+
+  /*! \internal Get the string table section header that \a header links to (sh_link)
+   *
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  const SectionHeader & linkedStringTableSectionHeader(const ByteArraySpan & map, const SectionHeaderTable & sectionHeaderTable,
+                                                       const SectionHeader & header)
+  {
+    if( header.link >= sectionHeaderTable.size() ){
+      const QString msg = tr("section '%1' links to section %2, which does not exist")
+                          .arg( QString::fromStdString(header.name) ).arg(header.link);
+      throw RelocatableObjectReadError(msg);
+    }
+    const SectionHeader & stringTableHeader = sectionHeaderTable[header.link];
+    if( !headerIsStringTableSection(stringTableHeader) ){
+      const QString msg = tr("section '%1' links to section '%2', which is not a string table")
+                          .arg( QString::fromStdString(header.name), QString::fromStdString(stringTableHeader.name) );
+      throw RelocatableObjectReadError(msg);
+    }
+    checkSectionIsInMap(map, stringTableHeader);
+
+    return stringTableHeader;
+  }
+
+  /*! \internal Extract the symbols of the symbol table section \a symTabHeader refers to, with their names
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   * \pre \a symTabHeader must be a .symtab section header
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  std::vector<RelocatableObjectSymbol> extractRelocatableObjectSymbols(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                                                       const SectionHeaderTable & sectionHeaderTable,
+                                                                       const SectionHeader & symTabHeader)
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( symTabHeader.sectionType() == SectionType::SymbolTable );
+
+    const int64_t entrySize = symbolTableEntrySize(fileHeader.ident._class);
+    checkSectionIsInMap(map, symTabHeader);
+    checkSectionEntrySize(symTabHeader, entrySize);
+    const SectionHeader & stringTableHeader = linkedStringTableSectionHeader(map, sectionHeaderTable, symTabHeader);
+
+    const uint64_t count = symTabHeader.size / static_cast<uint64_t>(entrySize);
+    std::vector<RelocatableObjectSymbol> symbols;
+    symbols.reserve(count);
+
+    ByteArraySpan entryArray;
+    entryArray.size = entrySize;
+    for(uint64_t i = 0; i < count; ++i){
+      entryArray.data = map.data + symTabHeader.offset + i * static_cast<uint64_t>(entrySize);
+      RelocatableObjectSymbol symbol;
+      symbol.entry = symbolTableEntryFromArray(entryArray, fileHeader.ident);
+      symbol.name = stringViewFromStringTableSection(map, stringTableHeader, symbol.entry.name);
+      symbols.push_back(symbol);
+    }
+
+    return symbols;
+  }
+
+  /*! \internal Extract the relocation section \a header refers to
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   * \pre \a header must be a relocation section header
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  RelocationSection extractRelocationSection(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                             const SectionHeader & header, uint16_t sectionIndex)
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( isRelocationSectionHeader(header) );
+
+    RelocationSection section;
+    section.sectionIndex = sectionIndex;
+    section.symbolTableSectionIndex = header.link;
+    section.targetSectionIndex = header.info;
+    section.hasAddends = header.sectionType() == SectionType::Rela;
+
+    const int64_t entrySize = relocationEntrySize(fileHeader.ident._class, section.hasAddends);
+    checkSectionIsInMap(map, header);
+    checkSectionEntrySize(header, entrySize);
+
+    const uint64_t count = header.size / static_cast<uint64_t>(entrySize);
+    section.entries.reserve(count);
+
+    ByteArraySpan entryArray;
+    entryArray.size = entrySize;
+    for(uint64_t i = 0; i < count; ++i){
+      entryArray.data = map.data + header.offset + i * static_cast<uint64_t>(entrySize);
+      section.entries.push_back( relocationEntryFromArray(entryArray, fileHeader.ident, section.hasAddends) );
+    }
+
+    return section;
+  }
+
+  /*! \internal Extract the section group \a header refers to
+   *
+   * The signature is resolved from \a symbols .
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid
+   * \pre \a header must be a section group header
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  SectionGroup extractSectionGroup(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                   const SectionHeader & header, uint16_t sectionIndex,
+                                   const std::vector<RelocatableObjectSymbol> & symbols)
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( header.sectionType() == SectionType::Group );
+
+    checkSectionIsInMap(map, header);
+    if( (header.size < 4) || ( (header.size % 4) != 0 ) ){
+      const QString msg = tr("section group '%1' has a invalid size: %2")
+                          .arg( QString::fromStdString(header.name) ).arg(header.size);
+      throw RelocatableObjectReadError(msg);
+    }
+    if( header.info >= symbols.size() ){
+      const QString msg = tr("section group '%1' refers to signature symbol %2, which does not exist")
+                          .arg( QString::fromStdString(header.name) ).arg(header.info);
+      throw RelocatableObjectReadError(msg);
+    }
+
+    SectionGroup group;
+    group.sectionIndex = sectionIndex;
+    group.signatureSymbolIndex = header.info;
+    group.signature = symbols[header.info].name;
+
+    const unsigned char *it = map.data + header.offset;
+    const unsigned char * const last = it + header.size;
+
+    const uint32_t flags = getWord(it, fileHeader.ident.dataFormat);
+    group.isComdat = (flags & 0x1) != 0; // GRP_COMDAT
+    it += 4;
+
+    group.memberSectionIndexes.reserve( (header.size / 4) - 1 );
+    while(it < last){
+      group.memberSectionIndexes.push_back( getWord(it, fileHeader.ident.dataFormat) );
+      it += 4;
+    }
+
+    return group;
+  }
+
+  /*! \internal Extract the content of a relocatable object file (ET_REL)
+   *
+   * Reads the .symtab with the symbol names,
+   * all relocation sections and all section groups.
+   * Symbol names and group signatures are views to \a map ,
+   * they are only valid as long as \a map is.
+   *
+   * \pre \a map must not be null
+   * \pre \a fileHeader must be valid and be a relocatable file
+   * \pre \a sectionHeaderTable must be the section header table of the file, with the names
+   * \exception RelocatableObjectReadError
+   */
+  inline
+  RelocatableObject extractRelocatableObject(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                             const SectionHeaderTable & sectionHeaderTable)
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( fileHeader.objectFileType() == ObjectFileType::RelocatableFile );
+
+    RelocatableObject object;
+
+    for(const SectionHeader & header : sectionHeaderTable){
+      if(header.sectionType() == SectionType::SymbolTable){
+        object.symbols = extractRelocatableObjectSymbols(map, fileHeader, sectionHeaderTable, header);
+        break;
+      }
+    }
+
+    const size_t count = sectionHeaderTable.size();
+    for(size_t i = 0; i < count; ++i){
+      const SectionHeader & header = sectionHeaderTable[i];
+      const uint16_t index = static_cast<uint16_t>(i);
+      if( isRelocationSectionHeader(header) ){
+        object.relocationSections.push_back( extractRelocationSection(map, fileHeader, header, index) );
+      }else if(header.sectionType() == SectionType::Group){
+        object.sectionGroups.push_back( extractSectionGroup(map, fileHeader, header, index, object.symbols) );
+      }
+    }
+
+    return object;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_RELOCATABLE_OBJECT_READER_H
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_RELOCATION_TABLE_WRITER_H
+#define MDT_EXECUTABLE_FILE_ELF_RELOCATION_TABLE_WRITER_H
+
+#include "Mdt/ExecutableFile/Elf/RelocatableObject.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include "Mdt/ExecutableFile/Elf/RelrTable.h"
+#include "Mdt/ExecutableFile/Elf/FileWriterUtils.h"
+#include "Mdt/ExecutableFile/Elf/Ident.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <cstdint>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal
+   *
+   * \pre \a array must not be null
+   * \pre \a ident must be valid
+   * \pre \a array size must be relocationEntrySize()
+   * \sa relocationEntryFromArray()
+   */
+  inline
+  void relocationEntryToArray(ByteArraySpan array, const RelocationEntry & entry, const Ident & ident, bool hasAddends) noexcept
+  {
+    assert( !array.isNull() );
+    assert( ident.isValid() );
+    assert( array.size == relocationEntrySize(ident._class, hasAddends) );
+
+    const int64_t wordSize = ident._class == Class::Class32 ? 4 : 8;
+
+    uint64_t info;
+    if(ident._class == Class::Class32){
+      info = (uint64_t(entry.symbolIndex) << 8) | (entry.type & 0xff);
+    }else{
+      assert( ident._class == Class::Class64 );
+      info = (uint64_t(entry.symbolIndex) << 32) | entry.type;
+    }
+
+    setAddress(array.subSpan(0, wordSize), entry.offset, ident);
+    setNWord(array.subSpan(wordSize, wordSize), info, ident);
+    if(hasAddends){
+      setSignedNWord(array.subSpan(2 * wordSize, wordSize), entry.addend, ident);
+    }
+  }
+
+  /*! \internal Write the \a entries of a relocation table (Elf_Rel or Elf_Rela) to \a array
+   *
+   * \pre \a array must not be null
+   * \pre \a array size must be the count of \a entries times relocationEntrySize()
+   */
+  inline
+  void setRelocationTableToArray(ByteArraySpan array, const std::vector<RelocationEntry> & entries,
+                                 const Ident & ident, bool hasAddends) noexcept
+  {
+    assert( !array.isNull() );
+    assert( ident.isValid() );
+
+    const int64_t entrySize = relocationEntrySize(ident._class, hasAddends);
+    assert( array.size == entrySize * static_cast<int64_t>( entries.size() ) );
+
+    int64_t offset = 0;
+    for(const RelocationEntry & entry : entries){
+      relocationEntryToArray(array.subSpan(offset, entrySize), entry, ident, hasAddends);
+      offset += entrySize;
+    }
+  }
+
+  /*! \internal Write a packed relative relocation table (Elf_Relr) to \a array
+   *
+   * \pre \a array must not be null
+   * \pre \a array size must be the count of entries in \a table times relrEntrySize()
+   * \sa makeRelrTable()
+   */
+  inline
+  void setRelrTableToArray(ByteArraySpan array, const std::vector<uint64_t> & table, const Ident & ident) noexcept
+  {
+    assert( !array.isNull() );
+    assert( ident.isValid() );
+
+    const int64_t entrySize = relrEntrySize(ident._class);
+    assert( array.size == entrySize * static_cast<int64_t>( table.size() ) );
+
+    int64_t offset = 0;
+    for(uint64_t entry : table){
+      setNWord(array.subSpan(offset, entrySize), entry, ident);
+      offset += entrySize;
+    }
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_RELOCATION_TABLE_WRITER_H
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_RELR_TABLE_H
+#define MDT_EXECUTABLE_FILE_ELF_RELR_TABLE_H
+
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/Ident.h"
+#include <cstdint>
+#include <vector>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Check if \a type is the relative relocation type for \a machine
+   *
+   * A relative relocation (R_X86_64_RELATIVE, R_386_RELATIVE)
+   * adds the load base address to the word at its offset.
+   * Returns false for unsupported machines.
+   */
+  inline
+  bool isRelativeRelocationType(Machine machine, uint32_t type) noexcept
+  {
+    switch(machine){
+      case Machine::X86:
+      case Machine::X86_64:
+        return type == 8;
+      default:
+        break;
+    }
+
+    return false;
+  }
+
+  /*! \internal Get the size of a entry of a packed relative relocation table (Elf_Relr)
+   *
+   * This is also the size of a relocated word.
+   */
+  inline
+  int64_t relrEntrySize(Class c) noexcept
+  {
+    assert( c != Class::ClassNone );
+
+    if(c == Class::Class32){
+      return 4;
+    }
+
+    return 8;
+  }
+
+  /*! \internal Encode \a addresses as a packed relative relocation table (DT_RELR)
+   *
+   * A even entry is the address of a relocated word.
+   * It is followed by bitmap entries (with the lowest bit set),
+   * each one telling which of the next 63 (31 for 32-bit files) words are relocated.
+   *
+   * \pre \a addresses must be sorted, without duplicates,
+   *  and each one aligned to relrEntrySize()
+   * \sa https://groups.google.com/g/generic-abi/c/bX460iggiKg
+   */
+  inline
+  std::vector<uint64_t> makeRelrTable(const std::vector<uint64_t> & addresses, Class c)
+  {
+    const uint64_t wordSize = static_cast<uint64_t>( relrEntrySize(c) );
+    const uint64_t bitmapBitCount = wordSize * 8 - 1;
+
+    std::vector<uint64_t> table;
+
+    size_t i = 0;
+    while( i < addresses.size() ){
+      assert( (addresses[i] % wordSize) == 0 );
+      assert( (i == 0) || (addresses[i-1] < addresses[i]) );
+
+      table.push_back(addresses[i]);
+      uint64_t base = addresses[i] + wordSize;
+      ++i;
+
+      while(true){
+        uint64_t bitmap = 0;
+        while( i < addresses.size() ){
+          const uint64_t delta = addresses[i] - base;
+          if( (delta >= bitmapBitCount * wordSize) || ( (delta % wordSize) != 0 ) ){
+            break;
+          }
+          bitmap |= uint64_t(1) << (delta / wordSize);
+          ++i;
+        }
+        if(bitmap == 0){
+          break;
+        }
+        table.push_back( (bitmap << 1) | 1 );
+        base += bitmapBitCount * wordSize;
+      }
+    }
+
+    return table;
+  }
+
+  /*! \internal Decode the addresses of a packed relative relocation table (DT_RELR)
+   *
+   * \sa makeRelrTable()
+   */
+  inline
+  std::vector<uint64_t> relrTableAddresses(const std::vector<uint64_t> & table, Class c)
+  {
+    const uint64_t wordSize = static_cast<uint64_t>( relrEntrySize(c) );
+    const uint64_t bitmapBitCount = wordSize * 8 - 1;
+
+    std::vector<uint64_t> addresses;
+
+    uint64_t base = 0;
+    for(uint64_t entry : table){
+      if( (entry & 1) == 0 ){
+        addresses.push_back(entry);
+        base = entry + wordSize;
+        continue;
+      }
+      uint64_t bitmap = entry >> 1;
+      for(uint64_t address = base; bitmap != 0; bitmap >>= 1, address += wordSize){
+        if( (bitmap & 1) != 0 ){
+          addresses.push_back(address);
+        }
+      }
+      base += bitmapBitCount * wordSize;
+    }
+
+    return addresses;
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_RELR_TABLE_H
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_RUN_PATH_IN_PLACE_EDITOR_H
+#define MDT_EXECUTABLE_FILE_ELF_RUN_PATH_IN_PLACE_EDITOR_H
+
+#include "Mdt/ExecutableFile/Elf/DynamicSection.h"
+#include "Mdt/ExecutableFile/Elf/DynamicStringTableReferences.h"
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeader.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/Elf/FileWriterUtils.h"
+#include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include <QString>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal How the run path can be set without rewriting the file
+   */
+  enum class RunPathInPlaceEdit
+  {
+    Unchanged,            /*!< The file already has the requested run path, nothing has to be written */
+    OverwriteString,      /*!< The new run path is not longer than the current one and overwrites it */
+    UseStringTableSlack,  /*!< The new run path is written to the unused bytes at the end of .dynstr */
+    NotPossible           /*!< The file must be rewritten (see FileWriterFile) */
+  };
+
+  /*! \internal Plan to set the run path in place
+   *
+   * \sa planRunPathInPlaceEdit()
+   */
+  struct RunPathInPlacePlan
+  {
+    RunPathInPlaceEdit edit = RunPathInPlaceEdit::NotPossible;
+
+    /*! \brief Index, in the dynamic section, of the entry that becomes DT_RUNPATH
+     */
+    std::size_t runPathEntryIndex = 0;
+
+    /*! \brief Index, in the dynamic section, of the DT_STRSZ entry
+     */
+    std::size_t stringTableSizeEntryIndex = 0;
+
+    /*! \brief Offset, in .dynstr, where the new run path is written
+     */
+    uint64_t stringTableIndex = 0;
+
+    /*! \brief Count of bytes, starting from stringTableIndex, to write
+     *
+     * Includes the null terminator.
+     * When overwriting a longer string, the remaining bytes are set to 0.
+     */
+    uint64_t stringTableByteCount = 0;
+
+    /*! \brief New value of DT_STRSZ
+     */
+    uint64_t stringTableSize = 0;
+
+    bool requiresWrite() const noexcept
+    {
+      return (edit == RunPathInPlaceEdit::OverwriteString) || (edit == RunPathInPlaceEdit::UseStringTableSlack);
+    }
+  };
+
+  /*! \internal Get the offset of each string referenced in the dynamic string table, outside the dynamic section
+   *
+   * Collects the names of the dynamic symbols
+   * and the names used by the symbol versioning sections
+   * that are linked to the section at \a dynamicStringTableSectionIndex .
+   *
+   * \exception ExecutableFileReadError
+   * \sa extractDynamicStringTableReferenceLocations()
+   */
+  inline
+  std::vector<uint64_t> extractDynamicStringTableReferences(const ByteArraySpan & map, const FileHeader & fileHeader,
+                                                            const std::vector<SectionHeader> & sectionHeaderTable,
+                                                            uint16_t dynamicStringTableSectionIndex)
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+
+    const std::vector<DynamicStringTableReference> locations = extractDynamicStringTableReferenceLocations(map, fileHeader, sectionHeaderTable, dynamicStringTableSectionIndex);
+
+    std::vector<uint64_t> references;
+    references.reserve( locations.size() );
+    for(const DynamicStringTableReference & location : locations){
+      references.push_back(location.index);
+    }
+
+    std::sort( references.begin(), references.end() );
+
+    return references;
+  }
+
+  /*! \internal Check if any of the sorted \a references is in [first, last)
+   */
+  inline
+  bool referencesContainsAnyInRange(const std::vector<uint64_t> & references, uint64_t first, uint64_t last) noexcept
+  {
+    assert( std::is_sorted( references.cbegin(), references.cend() ) );
+
+    const auto it = std::lower_bound(references.cbegin(), references.cend(), first);
+
+    return (it != references.cend()) && (*it < last);
+  }
+
+  /*! \internal Find how the run path of \a dynamicSection can be set to \a runPath without rewriting the file
+   *
+   * The current run path string can only be overwritten
+   * if no other string shares its bytes.
+   * Linkers can merge strings that are the tail of a other one,
+   * so \a otherReferences must contain every offset into .dynstr
+   * that is not stored in the dynamic section
+   * (see extractDynamicStringTableReferences()).
+   * The run path itself can also be the tail of a other string,
+   * this is the case if it does not start right after a null byte.
+   *
+   * When the run path does not fit, the unused bytes at the end of .dynstr
+   * (between DT_STRSZ and the section size) are used, if any.
+   * If the file has no DT_RUNPATH yet, a spare DT_NULL entry
+   * (not the last one) is used for it.
+   *
+   * Removing the run path is never done in place.
+   *
+   * \a runPath is UTF-8 encoded.
+   * \pre \a dynamicSection must not be null
+   * \pre \a otherReferences must be sorted
+   */
+  inline
+  RunPathInPlacePlan planRunPathInPlaceEdit(const DynamicSection & dynamicSection, uint64_t stringTableSectionSize,
+                                            std::string_view runPath, const std::vector<uint64_t> & otherReferences)
+  {
+    assert( !dynamicSection.isNull() );
+    assert( std::is_sorted( otherReferences.cbegin(), otherReferences.cend() ) );
+
+    RunPathInPlacePlan plan;
+
+    const std::size_t entryCount = static_cast<std::size_t>( std::distance( dynamicSection.cbegin(), dynamicSection.cend() ) );
+    std::size_t runPathEntryIndex = entryCount;
+    std::size_t stringTableSizeEntryIndex = entryCount;
+    std::size_t spareNullEntryIndex = entryCount;
+    std::vector<uint64_t> references = otherReferences;
+
+    for(std::size_t i = 0; i < entryCount; ++i){
+      const DynamicStruct & entry = *(dynamicSection.cbegin() + static_cast<std::ptrdiff_t>(i));
+      switch( entry.tagType() ){
+        case DynamicSectionTagType::Runpath:
+          runPathEntryIndex = i;
+          break;
+        case DynamicSectionTagType::StringTableSize:
+          stringTableSizeEntryIndex = i;
+          break;
+        case DynamicSectionTagType::Null:
+          if( (spareNullEntryIndex == entryCount) && (i + 1 < entryCount) ){
+            spareNullEntryIndex = i;
+          }
+          break;
+        default:
+          if( entry.isIndexToStrTab() ){
+            references.push_back(entry.val_or_ptr);
+          }
+          break;
+      }
+    }
+    std::sort( references.begin(), references.end() );
+
+    const bool hasRunPath = runPathEntryIndex < entryCount;
+    const std::string_view currentRunPath = dynamicSection.runPathView();
+
+    if( hasRunPath && (currentRunPath == runPath) ){
+      plan.edit = RunPathInPlaceEdit::Unchanged;
+      return plan;
+    }
+    if( runPath.empty() ){
+      if(!hasRunPath){
+        plan.edit = RunPathInPlaceEdit::Unchanged;
+      }
+      return plan;
+    }
+    if( stringTableSizeEntryIndex == entryCount ){
+      return plan;
+    }
+
+    const uint64_t stringTableSize = dynamicSection.getStringTableSize();
+    const uint64_t requiredByteCount = runPath.size() + 1;
+
+    plan.stringTableSizeEntryIndex = stringTableSizeEntryIndex;
+    plan.stringTableSize = stringTableSize;
+
+    if(hasRunPath){
+      const uint64_t index = (dynamicSection.cbegin() + static_cast<std::ptrdiff_t>(runPathEntryIndex))->val_or_ptr;
+      const uint64_t currentByteCount = currentRunPath.size() + 1;
+      const bool isShared = !dynamicSection.isStartOfString(index) || referencesContainsAnyInRange(references, index, index + currentRunPath.size());
+      if( (requiredByteCount <= currentByteCount) && !isShared ){
+        plan.edit = RunPathInPlaceEdit::OverwriteString;
+        plan.runPathEntryIndex = runPathEntryIndex;
+        plan.stringTableIndex = index;
+        plan.stringTableByteCount = currentByteCount;
+        return plan;
+      }
+    }
+
+    if( (stringTableSize > stringTableSectionSize) || ((stringTableSectionSize - stringTableSize) < requiredByteCount) ){
+      return plan;
+    }
+    if( !hasRunPath && (spareNullEntryIndex == entryCount) ){
+      return plan;
+    }
+
+    plan.edit = RunPathInPlaceEdit::UseStringTableSlack;
+    plan.runPathEntryIndex = hasRunPath ? runPathEntryIndex : spareNullEntryIndex;
+    plan.stringTableIndex = stringTableSize;
+    plan.stringTableByteCount = requiredByteCount;
+    plan.stringTableSize = stringTableSize + requiredByteCount;
+
+    return plan;
+  }
+
+  /*! \internal Apply \a plan to \a map
+   *
+   * Only the bytes of the run path string,
+   * the DT_RUNPATH entry and the DT_STRSZ entry are written.
+   *
+   * \pre \a plan must require a write
+   * \pre \a map must be big enough to access the dynamic section and .dynstr
+   */
+  inline
+  void applyRunPathInPlaceEdit(ByteArraySpan map, const FileHeader & fileHeader,
+                               const SectionHeader & dynamicSectionHeader, const SectionHeader & dynamicStringTableSectionHeader,
+                               const RunPathInPlacePlan & plan, std::string_view runPath) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( plan.requiresWrite() );
+    assert( (runPath.size() + 1) <= plan.stringTableByteCount );
+    assert( (plan.stringTableIndex + plan.stringTableByteCount) <= dynamicStringTableSectionHeader.size );
+    assert( map.size >= dynamicStringTableSectionHeader.minimumSizeToReadSection() );
+    assert( map.size >= dynamicSectionHeader.minimumSizeToReadSection() );
+
+    const ByteArraySpan str = map.subSpan( static_cast<int64_t>(dynamicStringTableSectionHeader.offset + plan.stringTableIndex),
+                                           static_cast<int64_t>(plan.stringTableByteCount) );
+    replaceBytesInArray(str, '\0');
+    std::copy( runPath.cbegin(), runPath.cend(), str.data );
+
+    const int64_t nWordSize = fileHeader.ident._class == Class::Class32 ? 4 : 8;
+    const int64_t entrySize = 2 * nWordSize;
+    const int64_t sectionOffset = static_cast<int64_t>(dynamicSectionHeader.offset);
+
+    const int64_t runPathEntryOffset = sectionOffset + static_cast<int64_t>(plan.runPathEntryIndex) * entrySize;
+    setSignedNWord( map.subSpan(runPathEntryOffset, nWordSize), static_cast<int64_t>(DynamicSectionTagType::Runpath), fileHeader.ident );
+    setNWord( map.subSpan(runPathEntryOffset + nWordSize, nWordSize), plan.stringTableIndex, fileHeader.ident );
+
+    const int64_t sizeEntryOffset = sectionOffset + static_cast<int64_t>(plan.stringTableSizeEntryIndex) * entrySize;
+    setNWord( map.subSpan(sizeEntryOffset + nWordSize, nWordSize), plan.stringTableSize, fileHeader.ident );
+  }
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_RUN_PATH_IN_PLACE_EDITOR_H
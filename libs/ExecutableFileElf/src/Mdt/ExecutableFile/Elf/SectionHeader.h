@@ -35,6 +35,8 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     DynSym = 0x0B,            /*!< Dynamic linker symbol table */
     InitArray = 0x0E,         /*!< array of constructors */
     FiniArray = 0x0F,         /*!< array of destructors */
+    Group = 0x11,             /*!< Section group (SHT_GROUP), for example a COMDAT group */
+    Relr = 0x13,              /*!< Packed relative relocation entries (SHT_RELR) */
     OsSpecific = 0x60000000,  /*!< Value >= 0x60000000 */
     GnuHash = 0x6ffffff6,         /*!< GNU_HASH: GNU hash table. Did not find standards doc, but got the value from a executable */
     GnuVersionDef = 0x6ffffffd,   /*!< This section contains the symbol versions that are provided */
@@ -112,6 +114,10 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
           return SectionType::InitArray;
         case 0x0F:
           return SectionType::FiniArray;
+        case 0x11:
+          return SectionType::Group;
+        case 0x13:
+          return SectionType::Relr;
         case 0x6ffffff6:
           return SectionType::GnuHash;
         case 0x6ffffffd:
@@ -203,6 +209,39 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return name == ".interp";
     }
 
+    /*! \brief Check if this section is the deployment stamp note (.note.mdt.deploy-stamp)
+     */
+    bool isDeployStampNoteSectionHeader() const noexcept
+    {
+      if(sectionType() != SectionType::Note){
+        return false;
+      }
+
+      return name == ".note.mdt.deploy-stamp";
+    }
+
+    /*! \brief Check if this section is the .gnu_debuglink section
+     */
+    bool isGnuDebugLinkSectionHeader() const noexcept
+    {
+      if(sectionType() != SectionType::ProgramData){
+        return false;
+      }
+
+      return name == ".gnu_debuglink";
+    }
+
+    /*! \brief Check if this section is kept at the end of the file
+     *
+     * Those sections (the deployment stamp note and .gnu_debuglink)
+     * are not loaded, are kept when the sections not needed at run time are removed,
+     * and are moved together with the section name string table.
+     */
+    bool isTrailingSectionHeader() const noexcept
+    {
+      return isDeployStampNoteSectionHeader() || isGnuDebugLinkSectionHeader();
+    }
+
     /*! \brief Check if this section is the .gnu.hash section
      */
     bool isGnuHashTableSectionHeader() const noexcept
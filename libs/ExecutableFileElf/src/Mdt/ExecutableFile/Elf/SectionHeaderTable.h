@@ -17,6 +17,7 @@
 #include <iterator>
 #include <utility>
 #include <algorithm>
+#include <numeric>
 #include <cstdint>
 #include <limits>
 #include <cassert>
@@ -129,26 +130,29 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return indexChangeMap;
     }
 
-    const auto aLessThanB = [](const SectionHeader & a, const SectionHeader & b){
-      return a.offset < b.offset;
-    };
     /*
-     * If we use std::sort(), we loose track of index changes.
-     * A section header table has about 50 entries,
-     * so a O(N^2) sort should be ok.
+     * Sorting the headers directly, we would loose track of index changes,
+     * so the original indexes are sorted, then the headers are placed.
+     *
+     * A empty section, or a SHT_NOBITS one like .bss,
+     * can have the same offset than a other section.
+     * Those keep their relative order (the sort is stable),
+     * so that the same input always gives the same section header table.
      */
-    for(auto it = headers.begin(); it != headers.end(); ++it){
-      const auto selectionIt = std::min_element(it, headers.end(), aLessThanB);
-      assert( selectionIt != headers.end() );
-
-      if( aLessThanB(*selectionIt, *it) ){
-        const uint16_t itIndex = static_cast<uint16_t>( std::distance(headers.begin(), selectionIt) );
-        const uint16_t selectionIndex = static_cast<uint16_t>( std::distance(headers.begin(), it) );
-        indexChangeMap.swapIndexes(itIndex, selectionIndex);
-
-        std::swap(*it, *selectionIt);
-      }
+    std::vector<uint16_t> originalIndexes(headers.size());
+    std::iota(originalIndexes.begin(), originalIndexes.end(), uint16_t(0));
+
+    std::stable_sort(originalIndexes.begin(), originalIndexes.end(), [&headers](uint16_t a, uint16_t b){
+      return headers[a].offset < headers[b].offset;
+    });
+
+    SectionHeaderTable sortedHeaders;
+    sortedHeaders.reserve( headers.size() );
+    for(size_t position = 0; position < originalIndexes.size(); ++position){
+      sortedHeaders.push_back( std::move(headers[originalIndexes[position]]) );
+      indexChangeMap.setIndexForOldIndex( originalIndexes[position], static_cast<uint16_t>(position) );
     }
+    headers = std::move(sortedHeaders);
 
     /*
      * Some sections have a index to a other.
@@ -170,6 +174,52 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     return indexChangeMap;
   }
 
+  /*! \internal Remove the section headers for which \a mustRemove returns true
+   *
+   * \a mustRemove is called with the index of a section header and the header itself.
+   * The null section header, at index 0, is never removed.
+   *
+   * In the returned map, a removed section header has 0 as new index.
+   * The sh_link and sh_info of the remaining headers are updated,
+   * and set to 0 if they referenced a removed section.
+   */
+  template<typename Predicate>
+  SectionIndexChangeMap removeSectionHeaders(SectionHeaderTable & headers, Predicate mustRemove) noexcept
+  {
+    SectionIndexChangeMap indexChangeMap = makeSectionIndexChangeMap(headers);
+
+    if( headers.empty() ){
+      return indexChangeMap;
+    }
+
+    SectionHeaderTable remainingHeaders;
+    remainingHeaders.reserve( headers.size() );
+    remainingHeaders.push_back( headers[0] );
+
+    for(size_t i = 1; i < headers.size(); ++i){
+      const uint16_t oldIndex = static_cast<uint16_t>(i);
+      if( mustRemove(oldIndex, headers[i]) ){
+        indexChangeMap.setIndexForOldIndex(oldIndex, 0);
+      }else{
+        indexChangeMap.setIndexForOldIndex( oldIndex, static_cast<uint16_t>( remainingHeaders.size() ) );
+        remainingHeaders.push_back( headers[i] );
+      }
+    }
+
+    for(SectionHeader & header : remainingHeaders){
+      if( header.linkIsIndexInSectionHeaderTable() && (header.link < indexChangeMap.indexCount()) ){
+        header.link = indexChangeMap.indexForOldIndex( static_cast<uint16_t>(header.link) );
+      }
+      if( header.infoIsIndexInSectionHeaderTable() && (header.info < indexChangeMap.indexCount()) ){
+        header.info = indexChangeMap.indexForOldIndex( static_cast<uint16_t>(header.info) );
+      }
+    }
+
+    headers = std::move(remainingHeaders);
+
+    return indexChangeMap;
+  }
+
   /*! \internal Find the count of sections to move to free given \a size in \a headers
    *
    * If the requested size is greater than the total size represented in \a headers ,
@@ -65,6 +65,18 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mMap[b] = a;
     }
 
+    /*! \brief Set the new index for \a oldIndex
+     *
+     * A section that is removed should have 0 as new index
+     * (which corresponds to the null section header).
+     */
+    void setIndexForOldIndex(uint16_t oldIndex, uint16_t newIndex) noexcept
+    {
+      assert( oldIndex < mMap.size() );
+
+      mMap[oldIndex] = newIndex;
+    }
+
     /*! \brief Get the index for given \a oldIndex
      */
     uint16_t indexForOldIndex(uint16_t oldIndex) const noexcept
@@ -14,12 +14,14 @@
 #include "Mdt/ExecutableFile/StringTableError.h"
 // #include "mdt_deployutilscore_export.h"
 #include <string>
+#include <string_view>
 #include <vector>
 #include <QString>
 #include <QObject>
 #include <cstdint>
 #include <algorithm>
 #include <iterator>
+#include <utility>
 #include <cassert>
 
 // #include <iostream>
@@ -177,147 +179,42 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return std::string(mTable.data() + index);
     }
 
-    /*! \brief Add \a str to the end of this table
-     *
-     * Returns the index to the \a str once added
-     *
-     * \note here the name \a index is used,
-     *  which is the one used in the standrad.
-     *  In reality, it is more a offset from the start of the table
-     *
-     * \pre \a str must not be empty
-     */
-    uint64_t appendString(const std::string & str)
-    {
-      assert( !str.empty() );
-
-      const uint64_t index = mTable.size();
-
-      mTable.insert( mTable.cend(), str.cbegin(), str.cend() );
-      mTable.push_back('\0');
-
-      return index;
-    }
-
-    /*! \brief Remove the string at \a index from this table
-     *
-     * \code
-     * int64_t offset = 0;
-     * StringTable table;
-     *
-     * // string table: \0libA.so\0
-     * offset = table.removeStringAtIndex(1);
-     * // offset: -8
-     * // string table: \0
-     * \endcode
+    /*! \brief Get a view to the string at \a index in this table
      *
-     * \note here the name \a index is used,
-     *  which is the one used in the standrad.
-     *  In reality, it is more a offset from the start of the table
+     * Unlike stringAtIndex(), this does not copy the string.
+     * The returned view refers to the internal data of this table,
+     * so it is invalidated as soon as this table is modified or destroyed.
      *
-     * \pre \a index must be > 0 (the first bye must allways be a null char in this table)
-     * \pre \a index must be < byteCount()
+     * \pre \a index must be valid
+     * \sa indexIsValid()
      */
-    int64_t removeStringAtIndex(uint64_t index) noexcept
+    std::string_view stringViewAtIndex(uint64_t index) const noexcept
     {
-      assert( index > 0 );
-
-      const int64_t sIndex = static_cast<int64_t>(index);
-      assert( sIndex < byteCount() );
-
-      const auto first = mTable.cbegin() + sIndex;
-      const auto last = std::find(first, mTable.cend(), '\0') + 1;
-      if(first == last){
-        return 0;
-      }
-
-      mTable.erase(first, last);
+      assert( indexIsValid(index) );
 
-      return first - last;
+      return std::string_view(mTable.data() + index);
     }
 
-    /*! \brief Set the string at \a index to \a str in this table
-     *
-     * \code
-     * int64_t offset = 0;
-     * StringTable table;
-     *
-     * // string table: \0
-     * offset = table.setStringAtIndex(1, "libA.so");
-     * // offset: 7
-     *
-     * // string table: \0libA.so\0
-     * offset = table.setStringAtIndex(1, "libB.so");
-     * // offset: 0
-     *
-     * // string table: \0libB.so\0
-     * offset = table.setStringAtIndex(1, "libQt5Core.so");
-     * // offset: 6
+    /*! \brief Add \a str to the end of this table
      *
-     * // string table: \0libQt5Core.so\0
-     * offset = table.setStringAtIndex(1, "libC.so");
-     * // offset: -6
-     * \endcode
+     * Returns the index to the \a str once added
      *
      * \note here the name \a index is used,
      *  which is the one used in the standrad.
      *  In reality, it is more a offset from the start of the table
      *
-     * \pre \a index must be > 0 (the first bye must allways be a null char in this table)
-     * \pre \a index must be <= byteCount() (in bound of this table, or 1 byte after the last byte, but not above)
      * \pre \a str must not be empty
      */
-    int64_t setStringAtIndex(uint64_t index, const std::string & str) noexcept
+    uint64_t appendString(const std::string & str)
     {
       assert( !str.empty() );
-      assert( index > 0 );
-
-      const int64_t sIndex = static_cast<int64_t>(index);
-      assert( sIndex <= byteCount() );
-
-      const bool addNewString = ( sIndex >= byteCount() );
 
-      std::string currentString;
-      if( !addNewString ){
-        currentString = stringAtIndex(index);
-      }
-
-      const int64_t strSize = static_cast<int64_t>( str.size() );
-      const int64_t currentStringSize = static_cast<int64_t>( currentString.size() );
-      const int64_t offset = strSize - currentStringSize;
-
-      /*
-       * \0
-       * \0NewString\0
-       *
-       * \0Old\0
-       * \0NewString\0
-       *
-       * \0OldString\0
-       * \0NewString\0
-       *
-       * \0OldString\0
-       * \0New\0
-       */
-      if(offset > 0){
-        const auto pos = mTable.cbegin() + sIndex + currentStringSize;
-        mTable.insert(pos, static_cast<size_t>(offset), '\0');
-
-        if(addNewString){
-          mTable.push_back('\0');
-        }
-      }
-
-      if(offset < 0){
-        const auto first = mTable.cbegin() + sIndex + strSize;
-        const auto last = mTable.cbegin() + sIndex + currentStringSize;
-        mTable.erase(first, last);
-      }
+      const uint64_t index = mTable.size();
 
-      auto it = mTable.begin() + sIndex;
-      std::copy(str.cbegin(), str.cend(), it);
+      mTable.insert( mTable.cend(), str.cbegin(), str.cend() );
+      mTable.push_back('\0');
 
-      return offset;
+      return index;
     }
 
     /*! \brief Get the string at \a index in this table
@@ -359,27 +256,6 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return appendString( str.toStdString() );
     }
 
-    /*! \brief Set the string at \a index to \a str in this table
-     *
-     * \note here the name \a index is used,
-     *  which is the one used in the standrad.
-     *  In reality, it is more a offset from the start of the table
-     *
-     * \sa setStringAtIndex()
-     *
-     * \pre \a index must be > 0 (the first bye must allways be a null char in this table)
-     * \pre \a index must be <= byteCount() (in bound of this table, or 1 byte after the last byte, but not above)
-     * \pre \a str must not be empty
-     */
-    int64_t setUnicodeStringAtIndex(uint64_t index, const QString & str) noexcept
-    {
-      assert( !str.isEmpty() );
-      assert( index > 0 );
-      assert( static_cast<int64_t>(index) <= byteCount() );
-
-      return setStringAtIndex( index, str.toStdString() );
-    }
-
     /*! \brief get the begin iterator
      */
     const_iterator cbegin() const noexcept
@@ -424,6 +300,23 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return StringTable(charArray);
     }
 
+    /*! \brief Construct a string table that takes the ownership of \a table
+     *
+     * This is used by StringTableEditor ,
+     * that builds the content of the new table itself.
+     *
+     * \pre \a table must begin with a null byte and be null terminated
+     */
+    static
+    StringTable fromCharVector(std::vector<char> && table) noexcept
+    {
+      assert( !table.empty() );
+      assert( table.front() == '\0' );
+      assert( table.back() == '\0' );
+
+      return StringTable( std::move(table) );
+    }
+
    private:
 
     StringTable(const ByteArraySpan & charArray)
@@ -432,6 +325,11 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       std::copy( charArray.cbegin(), charArray.cend(), std::back_inserter(mTable) );
     }
 
+    StringTable(std::vector<char> && table) noexcept
+     : mTable( std::move(table) )
+    {
+    }
+
     std::vector<char> mTable;
   };
 
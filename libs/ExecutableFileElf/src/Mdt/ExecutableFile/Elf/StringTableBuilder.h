@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_STRING_TABLE_BUILDER_H
+#define MDT_EXECUTABLE_FILE_ELF_STRING_TABLE_BUILDER_H
+
+#include "Mdt/ExecutableFile/Elf/StringTable.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Map the indexes of a string table to the ones of a other table
+   *
+   * \code
+   * StringTableIndexMap map;
+   * map.addIndex(1, 9);
+   * map.addIndex(6, 1);
+   * map.sort();
+   *
+   * const uint64_t newIndex = map.newIndexForOldIndex(6);
+   * // newIndex: 1
+   * \endcode
+   */
+  class StringTableIndexMap
+  {
+   public:
+
+    /*! \brief Add the mapping of \a oldIndex to \a newIndex
+     *
+     * sort() must be called once all indexes are added.
+     */
+    void addIndex(uint64_t oldIndex, uint64_t newIndex)
+    {
+      mIndexes.push_back({oldIndex, newIndex});
+    }
+
+    /*! \brief Sort this map, so that it can be used
+     *
+     * A old index that is added more than once
+     * is only kept once (the first added mapping is kept).
+     */
+    void sort() noexcept
+    {
+      std::stable_sort(mIndexes.begin(), mIndexes.end(), compareOldIndexes);
+      const auto last = std::unique(mIndexes.begin(), mIndexes.end(), [](const IndexPair & a, const IndexPair & b){
+        return a.oldIndex == b.oldIndex;
+      });
+      mIndexes.erase( last, mIndexes.end() );
+    }
+
+    /*! \brief Check if this map contains \a oldIndex
+     *
+     * \pre this map must be sorted
+     */
+    bool containsOldIndex(uint64_t oldIndex) const noexcept
+    {
+      return findOldIndex(oldIndex) != mIndexes.cend();
+    }
+
+    /*! \brief Get the new index for \a oldIndex
+     *
+     * \pre this map must be sorted
+     * \pre \a oldIndex must be in this map
+     * \sa containsOldIndex()
+     */
+    uint64_t newIndexForOldIndex(uint64_t oldIndex) const noexcept
+    {
+      const auto it = findOldIndex(oldIndex);
+      assert( it != mIndexes.cend() );
+
+      return it->newIndex;
+    }
+
+    /*! \brief Get the count of indexes in this map
+     */
+    size_t indexCount() const noexcept
+    {
+      return mIndexes.size();
+    }
+
+   private:
+
+    struct IndexPair
+    {
+      uint64_t oldIndex;
+      uint64_t newIndex;
+    };
+
+    static
+    bool compareOldIndexes(const IndexPair & a, const IndexPair & b) noexcept
+    {
+      return a.oldIndex < b.oldIndex;
+    }
+
+    std::vector<IndexPair>::const_iterator findOldIndex(uint64_t oldIndex) const noexcept
+    {
+      assert( std::is_sorted(mIndexes.cbegin(), mIndexes.cend(), compareOldIndexes) );
+
+      const auto it = std::lower_bound( mIndexes.cbegin(), mIndexes.cend(), IndexPair{oldIndex, 0}, compareOldIndexes );
+      if( (it != mIndexes.cend()) && (it->oldIndex == oldIndex) ){
+        return it;
+      }
+
+      return mIndexes.cend();
+    }
+
+    std::vector<IndexPair> mIndexes;
+  };
+
+  /*! \internal Build a string table in which each string is stored once
+   *
+   * Like linkers do, a string that ends a other one
+   * shares its bytes (tail merging):
+   * \code
+   * StringTableBuilder builder;
+   * builder.addString("liblibfoo.so");
+   * builder.addString("libfoo.so");
+   * builder.addString("libfoo.so");
+   *
+   * const StringTable table = builder.build();
+   * // string table: \0liblibfoo.so\0
+   * // indexOfString("liblibfoo.so"): 1
+   * // indexOfString("libfoo.so"): 4
+   * \endcode
+   *
+   * The result only depends on the set of added strings,
+   * not on the order they are added.
+   */
+  class StringTableBuilder
+  {
+   public:
+
+    /*! \brief Add \a str to the table to build
+     *
+     * A empty string is allways at index 0,
+     * so it is not added.
+     */
+    void addString(std::string_view str)
+    {
+      if( str.empty() ){
+        return;
+      }
+
+      mIndexes.emplace(std::string(str), 0);
+    }
+
+    /*! \brief Add the strings at \a indexes of \a table to the table to build
+     *
+     * A index can refer to the middle of a string
+     * (that is the case of a string that has been tail merged).
+     *
+     * \pre each of \a indexes must be valid in \a table
+     */
+    void addStringsAtIndexes(const StringTable & table, const std::vector<uint64_t> & indexes)
+    {
+      for(uint64_t index : indexes){
+        assert( table.indexIsValid(index) );
+        addString( table.stringViewAtIndex(index) );
+      }
+    }
+
+    /*! \brief Get the count of distinct strings added to this builder
+     */
+    size_t stringCount() const noexcept
+    {
+      return mIndexes.size();
+    }
+
+    /*! \brief Build the string table
+     *
+     * The strings are sorted by their reversed content,
+     * so that a string comes just after a string it ends,
+     * and can share its bytes.
+     */
+    StringTable build()
+    {
+      std::vector<std::pair<const std::string, uint64_t>*> entries;
+      entries.reserve( mIndexes.size() );
+      for(auto & entry : mIndexes){
+        entries.push_back(&entry);
+      }
+
+      std::sort(entries.begin(), entries.end(), [](const auto *a, const auto *b){
+        return std::lexicographical_compare( b->first.crbegin(), b->first.crend(), a->first.crbegin(), a->first.crend() );
+      });
+
+      StringTable table;
+      const std::pair<const std::string, uint64_t> *previous = nullptr;
+      for(auto *entry : entries){
+        if( (previous != nullptr) && stringEndsWith(previous->first, entry->first) ){
+          entry->second = previous->second + previous->first.size() - entry->first.size();
+        }else{
+          entry->second = table.appendString(entry->first);
+        }
+        previous = entry;
+      }
+
+      mIsBuilt = true;
+
+      return table;
+    }
+
+    /*! \brief Get the index of \a str in the built table
+     *
+     * Returns 0 for a empty string.
+     *
+     * \pre build() must have been called
+     * \pre \a str must have been added before build()
+     */
+    uint64_t indexOfString(std::string_view str) const noexcept
+    {
+      assert( mIsBuilt );
+
+      if( str.empty() ){
+        return 0;
+      }
+
+      const auto it = mIndexes.find( std::string(str) );
+      assert( it != mIndexes.cend() );
+
+      return it->second;
+    }
+
+    /*! \brief Get the index in the built table for each of \a indexes of \a table
+     *
+     * \pre build() must have been called
+     * \pre the strings at \a indexes must have been added before build()
+     * \sa addStringsAtIndexes()
+     */
+    StringTableIndexMap indexMapForTable(const StringTable & table, const std::vector<uint64_t> & indexes) const
+    {
+      assert( mIsBuilt );
+
+      StringTableIndexMap map;
+      for(uint64_t index : indexes){
+        assert( table.indexIsValid(index) );
+        map.addIndex( index, indexOfString( table.stringViewAtIndex(index) ) );
+      }
+      map.sort();
+
+      return map;
+    }
+
+   private:
+
+    static
+    bool stringEndsWith(const std::string & str, const std::string & end) noexcept
+    {
+      if( end.size() > str.size() ){
+        return false;
+      }
+
+      return std::equal( end.crbegin(), end.crend(), str.crbegin() );
+    }
+
+    bool mIsBuilt = false;
+    std::unordered_map<std::string, uint64_t> mIndexes;
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_STRING_TABLE_BUILDER_H
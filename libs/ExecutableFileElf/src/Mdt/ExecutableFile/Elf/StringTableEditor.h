@@ -0,0 +1,266 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_STRING_TABLE_EDITOR_H
+#define MDT_EXECUTABLE_FILE_ELF_STRING_TABLE_EDITOR_H
+
+#include "Mdt/ExecutableFile/Elf/StringTable.h"
+#include "Mdt/ExecutableFile/Elf/StringTableBuilder.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+  /*! \internal Edit strings of a string table in a single pass
+   *
+   * Replacing or removing a string in place would move all the bytes after it,
+   * and each index after it would then have to be shifted, once per edit.
+   * Here, the edits are only recorded,
+   * and commit() builds the new table in one pass over the original one:
+   * \code
+   * // string table: \0/tmp\0libA.so\0
+   * StringTableEditor editor(table);
+   * editor.setStringAtIndex(1, "/path1");
+   *
+   * const StringTable newTable = editor.commit();
+   * // new string table: \0/path1\0libA.so\0
+   *
+   * const uint64_t libAIndex = editor.newIndexForOldIndex(6);
+   * // libAIndex: 8
+   * \endcode
+   *
+   * \note the editor refers to the original table,
+   *  that must not be modified or destroyed before commit()
+   */
+  class StringTableEditor
+  {
+   public:
+
+    /*! \brief Construct a editor for \a table
+     */
+    explicit
+    StringTableEditor(const StringTable & table) noexcept
+     : mTable(table),
+       mOriginalByteCount( table.byteCount() )
+    {
+    }
+
+    StringTableEditor(const StringTableEditor &) = delete;
+    StringTableEditor & operator=(const StringTableEditor &) = delete;
+    StringTableEditor(StringTableEditor &&) = delete;
+    StringTableEditor & operator=(StringTableEditor &&) = delete;
+
+    /*! \brief Replace the string at \a index with \a str
+     *
+     * If the same string is edited more than once,
+     * the last edit is the one that is applied.
+     *
+     * \pre \a index must be > 0 and valid in the original table
+     * \pre \a index must be the start of a string
+     *   (a index to the middle of a tail merged string is not supported)
+     * \pre \a str must not be empty
+     * \pre commit() must not have been called
+     */
+    void setStringAtIndex(uint64_t index, const std::string & str)
+    {
+      assert( !str.empty() );
+
+      addEdit(index, str);
+    }
+
+    /*! \brief Remove the string at \a index
+     *
+     * \pre \a index must be > 0 and valid in the original table
+     * \pre \a index must be the start of a string
+     * \pre commit() must not have been called
+     */
+    void removeStringAtIndex(uint64_t index)
+    {
+      addEdit( index, std::string() );
+    }
+
+    /*! \brief Check if some edit has been recorded
+     */
+    bool hasEdits() const noexcept
+    {
+      return !mEdits.empty();
+    }
+
+    /*! \brief Apply the recorded edits and return the new table
+     *
+     * \pre commit() must not have been called
+     */
+    StringTable commit()
+    {
+      assert( !mIsCommitted );
+
+      std::stable_sort(mEdits.begin(), mEdits.end(), [](const Edit & a, const Edit & b){
+        return a.oldBegin < b.oldBegin;
+      });
+      // Only keep the last edit of each string
+      std::vector<Edit> edits;
+      edits.reserve( mEdits.size() );
+      for(size_t i = 0; i < mEdits.size(); ++i){
+        if( ( (i + 1) == mEdits.size() ) || ( mEdits[i+1].oldBegin != mEdits[i].oldBegin ) ){
+          edits.push_back( std::move(mEdits[i]) );
+        }
+      }
+      mEdits = std::move(edits);
+
+      int64_t byteCount = mTable.byteCount();
+      for(const Edit & edit : mEdits){
+        byteCount += static_cast<int64_t>( edit.newSize() ) - static_cast<int64_t>( edit.oldSize() );
+      }
+
+      std::vector<char> table;
+      table.reserve( static_cast<size_t>(byteCount) );
+
+      auto first = mTable.cbegin();
+      for(Edit & edit : mEdits){
+        assert( static_cast<int64_t>(edit.oldBegin) >= first - mTable.cbegin() );
+        table.insert( table.end(), first, mTable.cbegin() + static_cast<int64_t>(edit.oldBegin) );
+        edit.newBegin = table.size();
+        if( !edit.str.empty() ){
+          table.insert( table.end(), edit.str.cbegin(), edit.str.cend() );
+          table.push_back('\0');
+        }
+        first = mTable.cbegin() + static_cast<int64_t>(edit.oldEnd);
+      }
+      table.insert( table.end(), first, mTable.cend() );
+      assert( static_cast<int64_t>( table.size() ) == byteCount );
+
+      mIsCommitted = true;
+
+      return StringTable::fromCharVector( std::move(table) );
+    }
+
+    /*! \brief Check if \a oldIndex still refers to a string in the new table
+     *
+     * Returns false if \a oldIndex refers to a removed string.
+     *
+     * \pre commit() must have been called
+     * \pre \a oldIndex must be valid in the original table
+     */
+    bool oldIndexIsKept(uint64_t oldIndex) const noexcept
+    {
+      assert( mIsCommitted );
+      assert( static_cast<int64_t>(oldIndex) < mOriginalByteCount );
+
+      const Edit *edit = findLastEditStartingAtOrBefore(oldIndex);
+      if( (edit != nullptr) && (oldIndex < edit->oldEnd) ){
+        return !edit->str.empty();
+      }
+
+      return true;
+    }
+
+    /*! \brief Get the index in the new table for \a oldIndex
+     *
+     * A index to the middle of a replaced string
+     * refers to the same offset in the new string,
+     * or to its terminating null byte if the new string is shorter.
+     *
+     * \pre commit() must have been called
+     * \pre \a oldIndex must be kept
+     * \sa oldIndexIsKept()
+     */
+    uint64_t newIndexForOldIndex(uint64_t oldIndex) const noexcept
+    {
+      assert( oldIndexIsKept(oldIndex) );
+
+      const Edit *edit = findLastEditStartingAtOrBefore(oldIndex);
+      if(edit == nullptr){
+        return oldIndex;
+      }
+      if(oldIndex < edit->oldEnd){
+        return edit->newBegin + std::min<uint64_t>( oldIndex - edit->oldBegin, edit->str.size() );
+      }
+
+      return oldIndex - edit->oldEnd + edit->newBegin + edit->newSize();
+    }
+
+    /*! \brief Get the index in the new table for each of \a oldIndexes
+     *
+     * The indexes that are not kept are not in the returned map.
+     *
+     * \pre commit() must have been called
+     * \pre each of \a oldIndexes must be valid in the original table
+     */
+    StringTableIndexMap indexMapForIndexes(const std::vector<uint64_t> & oldIndexes) const
+    {
+      assert( mIsCommitted );
+
+      StringTableIndexMap map;
+      for(uint64_t oldIndex : oldIndexes){
+        if( oldIndexIsKept(oldIndex) ){
+          map.addIndex( oldIndex, newIndexForOldIndex(oldIndex) );
+        }
+      }
+      map.sort();
+
+      return map;
+    }
+
+   private:
+
+    struct Edit
+    {
+      uint64_t oldBegin;
+      uint64_t oldEnd;
+      uint64_t newBegin;
+      std::string str;
+
+      uint64_t oldSize() const noexcept
+      {
+        return oldEnd - oldBegin;
+      }
+
+      uint64_t newSize() const noexcept
+      {
+        return str.empty() ? 0 : str.size() + 1;
+      }
+    };
+
+    void addEdit(uint64_t index, const std::string & str)
+    {
+      assert( !mIsCommitted );
+      assert( index > 0 );
+      assert( mTable.indexIsValid(index) );
+      assert( *(mTable.cbegin() + static_cast<int64_t>(index) - 1) == '\0' );
+
+      const uint64_t oldSize = mTable.stringViewAtIndex(index).size() + 1;
+      mEdits.push_back( Edit{index, index + oldSize, 0, str} );
+    }
+
+    const Edit *findLastEditStartingAtOrBefore(uint64_t oldIndex) const noexcept
+    {
+      const auto it = std::upper_bound(mEdits.cbegin(), mEdits.cend(), oldIndex, [](uint64_t index, const Edit & edit){
+        return index < edit.oldBegin;
+      });
+      if( it == mEdits.cbegin() ){
+        return nullptr;
+      }
+
+      return &*std::prev(it);
+    }
+
+    const StringTable & mTable;
+    int64_t mOriginalByteCount;
+    std::vector<Edit> mEdits;
+    bool mIsCommitted = false;
+  };
+
+}}} // namespace Mdt{ namespace ExecutableFile{ namespace Elf{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_STRING_TABLE_EDITOR_H
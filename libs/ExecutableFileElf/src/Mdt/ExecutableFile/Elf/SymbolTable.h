@@ -14,9 +14,12 @@
 #include "Mdt/ExecutableFile/Elf/SectionHeader.h"
 #include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
 #include "Mdt/ExecutableFile/Elf/SectionIndexChangeMap.h"
+#include "Mdt/ExecutableFile/Elf/StringTableBuilder.h"
 #include <cstdint>
 #include <limits>
 #include <vector>
+#include <thread>
+#include <system_error>
 #include <algorithm>
 #include <cassert>
 
@@ -37,6 +40,16 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     HighProc = 15 /*!< High bound of CPU specific semantics. */
   };
 
+  /*! \internal
+   */
+  enum class SymbolBinding : unsigned char
+  {
+    Local = 0,  /*!< Local symbol, not visible outside the object file */
+    Global = 1, /*!< Global symbol, visible to all object files being combined */
+    Weak = 2,   /*!< Like global symbols, but with lower precedence */
+    Other = 3   /*!< OS or CPU specific binding */
+  };
+
   /*! \internal
    *
    * From the TIS ELF specification v1.2:
@@ -105,6 +118,33 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return SymbolType::NoType;
     }
 
+    /*! \brief Get the symbol binding
+     */
+    SymbolBinding symbolBinding() const noexcept
+    {
+      const unsigned char binding = info >> 4;
+
+      switch(binding){
+        case 0:
+          return SymbolBinding::Local;
+        case 1:
+          return SymbolBinding::Global;
+        case 2:
+          return SymbolBinding::Weak;
+      }
+
+      return SymbolBinding::Other;
+    }
+
+    /*! \brief Check if this entry is a undefined symbol (SHN_UNDEF)
+     *
+     * \note the null symbol (index 0) is also undefined
+     */
+    bool isUndefined() const noexcept
+    {
+      return shndx == 0;
+    }
+
     /*! \brief Check if this entry is realted to a section
      *
      * From the TIS ELF specification v1.2:
@@ -161,6 +201,26 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
   };
 
+  /*! \internal Minimum count of symbol table entries a thread should decode or update
+   *
+   * Below this count, starting a thread costs more than processing the entries.
+   */
+  static constexpr uint64_t minimumSymbolTableEntriesPerThread = 65536;
+
+  /*! \internal Get the count of chunks to use to decode or update \a entryCount entries with at most \a threadCount threads
+   */
+  inline
+  uint64_t symbolTableDecodeChunkCount(uint64_t entryCount, unsigned int threadCount) noexcept
+  {
+    if(threadCount <= 1){
+      return 1;
+    }
+
+    const uint64_t maxChunkCount = std::max<uint64_t>(entryCount / minimumSymbolTableEntriesPerThread, 1);
+
+    return std::min<uint64_t>(threadCount, maxChunkCount);
+  }
+
   /*! \internal
    */
   class PartialSymbolTable
@@ -174,6 +234,15 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       mTable.push_back(entry);
     }
 
+    /*! \brief Add entries from file
+     *
+     * \a entries are added to the end of this table, in the same order.
+     */
+    void addEntriesFromFile(const std::vector<PartialSymbolTableEntry> & entries) noexcept
+    {
+      mTable.insert( mTable.end(), entries.cbegin(), entries.cend() );
+    }
+
     /*! \brief Updates the symbols referring to a index in the section header table regarding \a indexChanges
      */
     void updateSectionIndexes(const SectionIndexChangeMap & indexChanges) noexcept
@@ -187,17 +256,97 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     }
 
     /*! \brief Update the virtual addresses in this symbol table regarding given section headers indexes referring \a sectionHeaderTable
+     *
+     * A lookup table, indexed by section index, is first built,
+     * so the cost does not depend on the count of \a sectionHeadersIndexes
+     * for each entry.
+     *
+     * Large tables are split in contiguous chunks
+     * that are updated by up to \a threadCount threads
+     * (see minimumSymbolTableEntriesPerThread).
+     * If a thread could not be started,
+     * its chunk is updated in the calling thread.
+     *
+     * \pre each of \a sectionHeadersIndexes must be in \a sectionHeaderTable
      */
-    void updateVirtualAddresses(const std::vector<uint16_t> sectionHeadersIndexes, const SectionHeaderTable & sectionHeaderTable) noexcept
+    void updateVirtualAddresses(const std::vector<uint16_t> & sectionHeadersIndexes, const SectionHeaderTable & sectionHeaderTable,
+                                unsigned int threadCount = 1)
     {
-      for(PartialSymbolTableEntry & entry : mTable){
-        if( entry.entry.isRelatedToASection() ){
-          const auto sectionHeaderIndexIt = std::find(sectionHeadersIndexes.cbegin(), sectionHeadersIndexes.cend(), entry.entry.shndx);
-          if( sectionHeaderIndexIt != sectionHeadersIndexes.cend() ){
-            assert( *sectionHeaderIndexIt < sectionHeaderTable.size() );
-            entry.entry.value = sectionHeaderTable[*sectionHeaderIndexIt].addr;
+      if( sectionHeadersIndexes.empty() || mTable.empty() ){
+        return;
+      }
+
+      const size_t sectionCount = sectionHeaderTable.size();
+      std::vector<unsigned char> sectionMoves(sectionCount, 0);
+      for(uint16_t index : sectionHeadersIndexes){
+        assert( index < sectionCount );
+        sectionMoves[index] = 1;
+      }
+
+      const auto updateEntries = [&](size_t firstEntry, size_t lastEntry){
+        for(size_t i = firstEntry; i < lastEntry; ++i){
+          PartialSymbolTableEntry & entry = mTable[i];
+          const uint16_t shndx = entry.entry.shndx;
+          if( entry.entry.isRelatedToASection() && (shndx < sectionCount) && (sectionMoves[shndx] != 0) ){
+            entry.entry.value = sectionHeaderTable[shndx].addr;
           }
         }
+      };
+
+      const size_t entryCount = mTable.size();
+      const size_t chunkCount = static_cast<size_t>( symbolTableDecodeChunkCount(entryCount, threadCount) );
+      if(chunkCount <= 1){
+        updateEntries(0, entryCount);
+        return;
+      }
+
+      const size_t entriesPerChunk = (entryCount + chunkCount - 1) / chunkCount;
+      std::vector<std::thread> threads;
+      threads.reserve(chunkCount);
+
+      const auto updateChunk = [&](size_t chunkIndex){
+        const size_t firstEntry = std::min(chunkIndex * entriesPerChunk, entryCount);
+        const size_t lastEntry = std::min(firstEntry + entriesPerChunk, entryCount);
+        updateEntries(firstEntry, lastEntry);
+      };
+
+      /*
+       * The calling thread updates the first chunk itself
+       */
+      for(size_t chunkIndex = 1; chunkIndex < chunkCount; ++chunkIndex){
+        try{
+          threads.emplace_back(updateChunk, chunkIndex);
+        }catch(const std::system_error &){
+          updateChunk(chunkIndex);
+        }
+      }
+      updateChunk(0);
+      for(std::thread & thread : threads){
+        thread.join();
+      }
+    }
+
+    /*! \brief Update the name of each entry regarding \a indexMap
+     *
+     * This is used once the string table the names refer to has been rebuilt.
+     *
+     * \pre \a indexMap must contain the name of each entry
+     */
+    void updateNameIndexes(const StringTableIndexMap & indexMap) noexcept
+    {
+      for(PartialSymbolTableEntry & entry : mTable){
+        entry.entry.name = static_cast<uint32_t>( indexMap.newIndexForOldIndex(entry.entry.name) );
+      }
+    }
+
+    /*! \brief Shift the file offsets of the entries starting from \a offset by \a byteCount
+     */
+    void shiftFileOffsetsFrom(uint64_t offset, uint64_t byteCount) noexcept
+    {
+      for(PartialSymbolTableEntry & entry : mTable){
+        if( static_cast<uint64_t>(entry.fileOffset) >= offset ){
+          entry.fileOffset += static_cast<int64_t>(byteCount);
+        }
       }
     }
 
@@ -253,6 +402,16 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return mTable.empty();
     }
 
+    /*! \brief Clear this table
+     */
+    void clear() noexcept
+    {
+      mDynamicSectionIndex = std::numeric_limits<size_t>::max();
+      mDynamicObjectIndex = std::numeric_limits<size_t>::max();
+      mDynamicStringTableIndex = std::numeric_limits<size_t>::max();
+      mTable.clear();
+    }
+
     /*! \brief Get the cout of entries if this table
      */
     size_t entriesCount() const noexcept
@@ -19,6 +19,8 @@
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
 #include <cstdint>
 #include <vector>
+#include <thread>
+#include <system_error>
 #include <algorithm>
 #include <cassert>
 
@@ -150,13 +152,123 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
     return symbolTable;
   }
 
+  /*! \internal Extract the entries of the symbol table \a symTabHeader that satisfy \a symbolPredicate
+   *
+   * Only the entries in the range [ \a firstEntry, \a lastEntry ) are decoded,
+   * and are added to the end of \a entries, in the order they appear in the file.
+   *
+   * \pre \a symTabHeader must have a entry size > 0
+   * \pre \a firstEntry must be <= \a lastEntry
+   * \pre \a map must be big enough to read the entries in given range
+   */
+  template<typename SymbolPredicate>
+  void extractPartialSymbolTableEntries(const ByteArraySpan & map, const SectionHeader & symTabHeader, const Ident & ident,
+                                        uint64_t firstEntry, uint64_t lastEntry,
+                                        const SymbolPredicate & symbolPredicate,
+                                        std::vector<PartialSymbolTableEntry> & entries) noexcept
+  {
+    assert( !map.isNull() );
+    assert( ident.isValid() );
+    assert( symTabHeader.entsize > 0 );
+    assert( firstEntry <= lastEntry );
+
+    for(uint64_t i = firstEntry; i < lastEntry; ++i){
+      const uint64_t offset = symTabHeader.offset + i * symTabHeader.entsize;
+      const PartialSymbolTableEntry entry = extractPartialSymbolTableEntry(map, static_cast<int64_t>(offset), ident);
+      if( symbolPredicate(entry.entry) ){
+        entries.push_back(entry);
+      }
+    }
+  }
+
+  /*! \internal Extract a partial symbol table for given \a sectionType that satisfy \a symbolPredicate using up to \a threadCount threads
+   *
+   * The entries are split in contiguous chunks that are decoded and filtered independently.
+   * The chunks are then merged in file order,
+   * so the result is the same than the one returned by the single threaded version,
+   * regardless of \a threadCount .
+   *
+   * Small tables are decoded in the calling thread
+   * (see minimumSymbolTableEntriesPerThread).
+   * If a thread could not be started,
+   * its chunk is also decoded in the calling thread.
+   *
+   * \a symbolPredicate is called concurrently, so it must be thread safe.
+   */
+  template<typename SymbolPredicate>
+  PartialSymbolTable extractPartialSymbolTable(const ByteArraySpan & map,
+                                               const FileHeader & fileHeader,
+                                               const std::vector<SectionHeader> & sectionHeaderTable,
+                                               SectionType sectionType, const SymbolPredicate & symbolPredicate,
+                                               unsigned int threadCount) noexcept
+  {
+    assert( !map.isNull() );
+    assert( fileHeader.seemsValid() );
+    assert( map.size >= fileHeader.minimumSizeToReadAllSectionHeaders() );
+    assert( isSymbolTableSection(sectionType) );
+
+    const auto symTabPred = [sectionType](const SectionHeader & header){
+      return header.sectionType() == sectionType;
+    };
+    const auto symTabIt = std::find_if(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), symTabPred);
+    if( (symTabIt == sectionHeaderTable.cend()) || (symTabIt->entsize == 0) ){
+      return extractPartialSymbolTable(map, fileHeader, sectionHeaderTable, sectionType, symbolPredicate);
+    }
+
+    const uint64_t entryCount = symTabIt->size / symTabIt->entsize;
+    const uint64_t chunkCount = symbolTableDecodeChunkCount(entryCount, threadCount);
+    if(chunkCount <= 1){
+      return extractPartialSymbolTable(map, fileHeader, sectionHeaderTable, sectionType, symbolPredicate);
+    }
+
+    assert( map.size >= symTabIt->minimumSizeToReadSection() );
+
+    const uint64_t entriesPerChunk = (entryCount + chunkCount - 1) / chunkCount;
+    std::vector< std::vector<PartialSymbolTableEntry> > chunks(chunkCount);
+    std::vector<std::thread> threads;
+    threads.reserve(chunkCount);
+
+    const auto decodeChunk = [&](uint64_t chunkIndex){
+      const uint64_t firstEntry = std::min(chunkIndex * entriesPerChunk, entryCount);
+      const uint64_t lastEntry = std::min(firstEntry + entriesPerChunk, entryCount);
+      extractPartialSymbolTableEntries(map, *symTabIt, fileHeader.ident, firstEntry, lastEntry, symbolPredicate, chunks[chunkIndex]);
+    };
+
+    /*
+     * The calling thread decodes the first chunk itself
+     */
+    for(uint64_t chunkIndex = 1; chunkIndex < chunkCount; ++chunkIndex){
+      try{
+        threads.emplace_back(decodeChunk, chunkIndex);
+      }catch(const std::system_error &){
+        decodeChunk(chunkIndex);
+      }
+    }
+    decodeChunk(0);
+    for(std::thread & thread : threads){
+      thread.join();
+    }
+
+    PartialSymbolTable symbolTable;
+    for(const auto & chunk : chunks){
+      symbolTable.addEntriesFromFile(chunk);
+    }
+
+    symbolTable.indexAssociationsKnownSections(sectionHeaderTable);
+
+    return symbolTable;
+  }
+
   /*! \internal Extract the part of a symbol table that refers to a section in the file
+   *
+   * \sa extractPartialSymbolTable(const ByteArraySpan &, const FileHeader &, const std::vector<SectionHeader> &, SectionType, const SymbolPredicate &, unsigned int)
    */
   inline
   PartialSymbolTable extractPartialSymbolTableReferringToSection(const ByteArraySpan & map,
                                                                  const FileHeader & fileHeader,
                                                                  const std::vector<SectionHeader> & sectionHeaderTable,
-                                                                 SectionType sectionType) noexcept
+                                                                 SectionType sectionType,
+                                                                 unsigned int threadCount = 1) noexcept
   {
     assert( !map.isNull() );
     assert( fileHeader.seemsValid() );
@@ -167,21 +279,25 @@ namespace Mdt{ namespace ExecutableFile{ namespace Elf{
       return entry.isRelatedToASection();
     };
 
-    return extractPartialSymbolTable(map, fileHeader, sectionHeaderTable, sectionType, symbolPredicate);
+    return extractPartialSymbolTable(map, fileHeader, sectionHeaderTable, sectionType, symbolPredicate, threadCount);
   }
 
   /*! \internal Extract the part of .symtab that refers to a section in the file
+   *
+   * For very large symbol tables,
+   * \a threadCount can be > 1 to decode the table in parallel.
    */
   inline
   PartialSymbolTable extractSymTabPartReferringToSection(const ByteArraySpan & map,
                                                          const FileHeader & fileHeader,
-                                                         const std::vector<SectionHeader> & sectionHeaderTable) noexcept
+                                                         const std::vector<SectionHeader> & sectionHeaderTable,
+                                                         unsigned int threadCount = 1) noexcept
   {
     assert( !map.isNull() );
     assert( fileHeader.seemsValid() );
     assert( map.size >= fileHeader.minimumSizeToReadAllSectionHeaders() );
 
-    return extractPartialSymbolTableReferringToSection(map, fileHeader, sectionHeaderTable, SectionType::SymbolTable);
+    return extractPartialSymbolTableReferringToSection(map, fileHeader, sectionHeaderTable, SectionType::SymbolTable, threadCount);
   }
 
   /*! \internal Extract the part of .dynsym that refers to a section in the file
@@ -11,6 +11,11 @@
 #include "Mdt/ExecutableFile/RPathElf.h"
 #include "Mdt/ExecutableFile/Elf/FileWriterFile.h"
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/FileCloneUtils.h"
+#include "Mdt/ExecutableFile/ExecutableFileWriteError.h"
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
 #include <cassert>
 
 namespace Mdt{ namespace ExecutableFile{
@@ -59,6 +64,7 @@ QString ElfFileIoEngine::getSoName()
 void ElfFileIoEngine::newFileOpen(const QString & fileName)
 {
   mImpl.setFileName(fileName);
+  mImpl.setReadLimits( readLimits() );
 }
 
 void ElfFileIoEngine::fileClosed()
@@ -194,21 +200,57 @@ RPath ElfFileIoEngine::doGetRunPath()
   return mImpl.getRunPath(map);
 }
 
+DeployStamp ElfFileIoEngine::doGetDeployStamp()
+{
+  const qint64 size = fileSize();
+
+  /*
+   * Only the first pages and the stamp are touched,
+   * the rest of the mapping is never read
+   */
+  const ByteArraySpan map = mapIfRequired(0, size);
+
+  return mImpl.getDeployStamp(map);
+}
+
 void ElfFileIoEngine::doSetRunPath(const RPath & rPath)
 {
   using Elf::FileWriterFile;
+  using Elf::RunPathInPlaceEdit;
 
   const qint64 size = fileSize();
+  const QString runPath = RPathElf::rPathToString(rPath);
 
   ByteArraySpan map = mapIfRequired(0, size);
 
+  /*
+   * Most of the time, the new run path replaces one of the same length,
+   * or is already set.
+   * Patching a few bytes then avoids rewriting the whole file.
+   */
+  switch( mImpl.setRunPathInPlaceIfPossible(map, runPath) ){
+    case RunPathInPlaceEdit::Unchanged:
+      emit verboseMessage(
+        tr("file '%1' already has the run path '%2', nothing to write").arg(fileName(), runPath)
+      );
+      return;
+    case RunPathInPlaceEdit::OverwriteString:
+    case RunPathInPlaceEdit::UseStringTableSlack:
+      emit verboseMessage(
+        tr("run path of file '%1' set in place to '%2'").arg(fileName(), runPath)
+      );
+      return;
+    case RunPathInPlaceEdit::NotPossible:
+      break;
+  }
+
   FileWriterFile file;
   connect(&file, &FileWriterFile::message, this, &ElfFileIoEngine::message);
   connect(&file, &FileWriterFile::verboseMessage, this, &ElfFileIoEngine::verboseMessage);
 
   mImpl.readToFileWriterFile(file, map);
 
-  file.setRunPath( RPathElf::rPathToString(rPath) );
+  file.setRunPath(runPath);
 
   const qint64 newSize = file.minimumSizeToWriteFile();
   if(newSize > size){
@@ -216,7 +258,157 @@ void ElfFileIoEngine::doSetRunPath(const RPath & rPath)
     map = mapIfRequired(0, newSize);
   }
 
-  mImpl.setFileWriterToMap(map, file);
+  writeFileWriterToMap(map, file);
+}
+
+void ElfFileIoEngine::doApplyEdits(const ExecutableFileEditTransaction & edits)
+{
+  using Elf::FileWriterFile;
+
+  if( !edits.changesMoreThanRunPath() ){
+    doSetRunPath( edits.runPath() );
+    return;
+  }
+
+  const qint64 size = fileSize();
+  ByteArraySpan map = mapIfRequired(0, size);
+
+  FileWriterFile file;
+  connect(&file, &FileWriterFile::message, this, &ElfFileIoEngine::message);
+  connect(&file, &FileWriterFile::verboseMessage, this, &ElfFileIoEngine::verboseMessage);
+
+  mImpl.readToFileWriterFile(file, map);
+  if( edits.rebuildsGnuHashTable() ){
+    mImpl.readGnuHashedSymbolHashesToFileWriterFile(file, map);
+  }
+  if( edits.packsRelativeRelocations() ){
+    mImpl.readDynamicRelocationsToFileWriterFile(file, map);
+  }
+  if( edits.compactsDynamicStringTable() ){
+    mImpl.readDynamicStringTableReferencesToFileWriterFile(file, map);
+  }
+
+  /*
+   * The debug file is a copy of the file before any edit.
+   * Its CRC is computed now, from the unchanged map,
+   * but the debug file is only written once the edits are applied,
+   * so a failing edit leaves no debug file behind.
+   */
+  Elf::GnuDebugLink debugLink;
+  if( edits.splitsDebugInfo() ){
+    if( file.containsDebugInfo() ){
+      debugLink = makeGnuDebugLink( map, edits.debugInfoFilePath() );
+    }else{
+      emit message(
+        tr("file '%1' contains no debug information, no debug file is written").arg( fileName() )
+      );
+    }
+  }
+
+  try{
+    file.applyEdits(edits);
+  }catch(const Elf::MoveSectionError & error){
+    const QString msg = tr("editing file '%1' failed: %2")
+                        .arg( fileName(), error.whatQString() );
+    throw ExecutableFileWriteError(msg);
+  }
+
+  if( !debugLink.isNull() ){
+    file.setGnuDebugLink(debugLink);
+    // The file is still unchanged here
+    writeDebugInfoFile( edits.debugInfoFilePath() );
+  }
+
+  const qint64 newSize = file.minimumSizeToWriteFile();
+  const qint64 mapSize = std::max( newSize, size + static_cast<qint64>( file.fileContentShiftByteCount() ) );
+  try{
+    if(mapSize > size){
+      resizeFile(mapSize);
+      map = mapIfRequired(0, mapSize);
+    }
+
+    if( !file.fileContentShifts().empty() ){
+      const uint64_t movedByteCount = mImpl.shiftFileContentInMap( map, file, static_cast<uint64_t>(size) );
+      emit verboseMessage(
+        tr("file '%1': %2 bytes moved to align the load segments").arg( fileName() ).arg(movedByteCount)
+      );
+    }
+
+    writeFileWriterToMap(map, file);
+  }catch(...){
+    if( !debugLink.isNull() ){
+      QFile::remove( edits.debugInfoFilePath() );
+    }
+    throw;
+  }
+
+  /*
+   * The removed sections are no longer referenced,
+   * cut them off once the compacted content has been written.
+   */
+  if( ( edits.stripsNonAllocatedSections() || edits.splitsDebugInfo() ) && (newSize < mapSize) ){
+    resizeFile(newSize);
+    emit verboseMessage(
+      tr("file '%1': size reduced from %2 to %3 bytes").arg( fileName() ).arg(size).arg(newSize)
+    );
+  }
+}
+
+Elf::GnuDebugLink ElfFileIoEngine::makeGnuDebugLink(const ByteArraySpan & map, const QString & debugFilePath) const noexcept
+{
+  assert( !map.isNull() );
+  assert( !debugFilePath.isEmpty() );
+
+  Elf::GnuDebugLink link;
+  link.fileName = QFileInfo(debugFilePath).fileName().toStdString();
+  link.crc = Elf::updateGnuDebugLinkCrc(0, map);
+
+  return link;
+}
+
+/*
+ * The whole file is cloned (a reflink, when the file system supports it,
+ * costs no copy and no space until one of the files changes),
+ * so the allocated sections, needed to symbolise addresses, are also in the debug file.
+ */
+void ElfFileIoEngine::writeDebugInfoFile(const QString & debugFilePath)
+{
+  assert( !debugFilePath.isEmpty() );
+
+  QFile source( fileName() );
+  if( !source.open(QIODevice::ReadOnly) ){
+    const QString msg = tr("could not open file '%1' to write its debug file: %2")
+                        .arg( fileName(), source.errorString() );
+    throw ExecutableFileWriteError(msg);
+  }
+
+  QFile debugFile(debugFilePath);
+  if( !debugFile.open(QIODevice::WriteOnly | QIODevice::Truncate) ){
+    const QString msg = tr("could not open debug file '%1': %2")
+                        .arg( debugFilePath, debugFile.errorString() );
+    throw ExecutableFileWriteError(msg);
+  }
+  try{
+    cloneFileContent(source, debugFile);
+  }catch(...){
+    debugFile.close();
+    QFile::remove(debugFilePath);
+    throw;
+  }
+  debugFile.close();
+
+  emit verboseMessage(
+    tr("file '%1': debug information written to '%2'").arg( fileName(), debugFilePath )
+  );
+}
+
+void ElfFileIoEngine::writeFileWriterToMap(ByteArraySpan map, const Elf::FileWriterFile & file)
+{
+  const uint64_t writtenByteCount = mImpl.setFileWriterToMap(map, file);
+
+  emit verboseMessage(
+    tr("file '%1': %2 bytes changed").arg( fileName() ).arg(writtenByteCount)
+  );
 }
 
 }} // namespace Mdt{ namespace ExecutableFile{
@@ -17,6 +17,7 @@
 #include "Mdt/ExecutableFile/Elf/FileIoEngine.h"
 #include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
 #include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLink.h"
 #include <QObject>
 #include <QString>
 #include <QStringList>
@@ -83,7 +84,14 @@ namespace Mdt{ namespace ExecutableFile{
     bool doContainsDebugSymbols() override;
     QStringList doGetNeededSharedLibraries() override;
     RPath doGetRunPath() override;
+    DeployStamp doGetDeployStamp() override;
     void doSetRunPath(const RPath & rPath) override;
+    void doApplyEdits(const ExecutableFileEditTransaction & edits) override;
+
+    void writeFileWriterToMap(ByteArraySpan map, const Elf::FileWriterFile & file);
+
+    Elf::GnuDebugLink makeGnuDebugLink(const ByteArraySpan & map, const QString & debugFilePath) const noexcept;
+    void writeDebugInfoFile(const QString & debugFilePath);
 
     Elf::FileIoEngine mImpl;
   };
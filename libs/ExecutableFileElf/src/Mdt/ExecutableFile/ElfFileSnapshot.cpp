@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "ElfFileSnapshot.h"
+#include "Mdt/ExecutableFile/RPathElf.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include "Mdt/ExecutableFile/Elf/FileIoEngine.h"
+#include "Mdt/ExecutableFile/Elf/SymbolTableReader.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include <algorithm>
+
+namespace Mdt{ namespace ExecutableFile{
+
+QString ElfFileSnapshot::getSoName() const
+{
+  assert( !isNull() );
+
+  if( !containsDynamicSection() ){
+    return QString();
+  }
+
+  return mData->dynamicSection.getSoName();
+}
+
+QStringList ElfFileSnapshot::getNeededSharedLibraries() const
+{
+  assert( !isNull() );
+
+  if( !containsDynamicSection() ){
+    return QStringList();
+  }
+
+  return mData->dynamicSection.getNeededSharedLibraries();
+}
+
+RPath ElfFileSnapshot::getRunPath() const
+{
+  assert( !isNull() );
+
+  if( !containsDynamicSection() ){
+    return RPath();
+  }
+
+  return RPathElf::rPathFromString( mData->dynamicSection.getRunPath() );
+}
+
+FileScanResult ElfFileSnapshot::scan(ScanContext & context) const
+{
+  assert( !isNull() );
+
+  FileScanResult result;
+  result.fileName = context.intern( fileName() );
+  result.format = ExecutableFileFormat::Elf;
+
+  if( !containsDynamicSection() ){
+    return result;
+  }
+
+  const std::string_view soName = mData->dynamicSection.soNameView();
+  if( !soName.empty() ){
+    result.soName = context.intern(soName);
+  }
+
+  forEachNeeded([&context](std::string_view name){
+    context.appendToList(name);
+  });
+  result.neededSharedLibraries = context.takeList();
+
+  forEachRunPathEntry([&context](std::string_view entry){
+    context.appendToList(entry);
+  });
+  result.runPath = context.takeList();
+
+  return result;
+}
+
+ElfFileSnapshot ElfFileSnapshot::fromFile(const QFileInfo & fileInfo)
+{
+  using Elf::SectionHeader;
+  using Elf::SectionType;
+  using Elf::SymbolTableEntry;
+
+  assert( !fileInfo.filePath().isEmpty() );
+
+  auto data = std::make_shared<Data>();
+  data->mapping.mapFile(fileInfo);
+
+  const ByteArraySpan map = data->mapping.span();
+  Elf::FileIoEngine reader;
+  reader.setFileName( data->mapping.fileName() );
+
+  if( map.size < reader.minimumSizeToReadFileHeader() ){
+    const QString message = tr("file '%1' is to small to read the file header")
+                            .arg( data->mapping.fileName() );
+    throw ExecutableFileReadError(message);
+  }
+
+  data->fileHeader = reader.getFileHeader(map);
+  data->sectionHeaderTable = reader.getSectionHeaderTable(map);
+  data->programHeaderTable = reader.getProgramHeaderTable(map);
+
+  const auto isDynamicSection = [](const SectionHeader & header){
+    return header.sectionType() == SectionType::Dynamic;
+  };
+  if( std::any_of(data->sectionHeaderTable.cbegin(), data->sectionHeaderTable.cend(), isDynamicSection) ){
+    data->dynamicSection = reader.getDynamicSection(map);
+  }
+
+  const auto isDynSym = [](const SectionHeader & header){
+    return header.sectionType() == SectionType::DynSym;
+  };
+  const auto dynSymIt = std::find_if(data->sectionHeaderTable.cbegin(), data->sectionHeaderTable.cend(), isDynSym);
+  if( dynSymIt != data->sectionHeaderTable.cend() ){
+    if( (dynSymIt->entsize == 0) || (map.size < dynSymIt->minimumSizeToReadSection()) ){
+      const QString message = tr("file '%1' contains a invalid .dynsym section header")
+                              .arg( data->mapping.fileName() );
+      throw ExecutableFileReadError(message);
+    }
+    const auto allSymbols = [](const SymbolTableEntry &){
+      return true;
+    };
+    data->dynamicSymbolTable = extractPartialSymbolTable(map, data->fileHeader, data->sectionHeaderTable, SectionType::DynSym, allSymbols);
+  }
+
+  if(data->fileHeader.objectFileType() == Elf::ObjectFileType::RelocatableFile){
+    try{
+      data->relocatableObject = Elf::extractRelocatableObject(map, data->fileHeader, data->sectionHeaderTable);
+    }catch(const Elf::RelocatableObjectReadError & error){
+      const QString message = tr("file '%1': error while reading the relocatable object: %2")
+                              .arg( data->mapping.fileName(), error.whatQString() );
+      throw ExecutableFileReadError(message);
+    }
+  }
+
+  ElfFileSnapshot snapshot;
+  snapshot.mData = std::move(data);
+
+  return snapshot;
+}
+
+}} // namespace Mdt{ namespace ExecutableFile{
@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_ELF_FILE_SNAPSHOT_H
+#define MDT_EXECUTABLE_FILE_ELF_FILE_SNAPSHOT_H
+
+#include "Mdt/ExecutableFile/FileOpenError.h"
+#include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "Mdt/ExecutableFile/ReadOnlyFileMapping.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/RPath.h"
+#include "Mdt/ExecutableFile/ScanContext.h"
+#include "Mdt/ExecutableFile/Elf/FileHeader.h"
+#include "Mdt/ExecutableFile/Elf/SectionHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderTable.h"
+#include "Mdt/ExecutableFile/Elf/DynamicSection.h"
+#include "Mdt/ExecutableFile/Elf/SymbolTable.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObject.h"
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <string_view>
+#include <memory>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Immutable parsed model of a ELF file
+   *
+   * A snapshot is built once from a file.
+   * It keeps the file mapped into memory as long as
+   * at least one copy of the snapshot is alive.
+   *
+   * Copying a snapshot is cheap: all copies share the same data,
+   * which is never modified after construction.
+   * Because of that, any number of threads can read the same snapshot
+   * (or copies of it) without locking.
+   *
+   * \code
+   * const ElfFileSnapshot library = ElfFileSnapshot::fromFile(libraryFilePath);
+   *
+   * // in some worker threads
+   * const QStringList needed = library.getNeededSharedLibraries();
+   * \endcode
+   *
+   * Unlike ElfFileIoEngine, this class is not a QObject .
+   */
+  class ElfFileSnapshot
+  {
+   public:
+
+    /*! \brief Construct a null snapshot
+     */
+    ElfFileSnapshot() noexcept = default;
+
+    /*! \brief Copy construct a snapshot from \a other
+     *
+     * Both snapshots share the same data.
+     */
+    ElfFileSnapshot(const ElfFileSnapshot & other) noexcept = default;
+
+    /*! \brief Copy assign \a other to this snapshot
+     */
+    ElfFileSnapshot & operator=(const ElfFileSnapshot & other) noexcept = default;
+
+    /*! \brief Move construct a snapshot from \a other
+     */
+    ElfFileSnapshot(ElfFileSnapshot && other) noexcept = default;
+
+    /*! \brief Move assign \a other to this snapshot
+     */
+    ElfFileSnapshot & operator=(ElfFileSnapshot && other) noexcept = default;
+
+    /*! \brief Check if this snapshot is null
+     */
+    bool isNull() const noexcept
+    {
+      return mData.get() == nullptr;
+    }
+
+    /*! \brief Get the name of the file this snapshot refers to
+     *
+     * \pre this snapshot must not be null
+     */
+    QString fileName() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->mapping.fileName();
+    }
+
+    /*! \brief Access the file mapped into memory
+     *
+     * \warning the returned span must only be used to read the file
+     * \pre this snapshot must not be null
+     */
+    ByteArraySpan map() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->mapping.span();
+    }
+
+    /*! \brief Get the file header
+     *
+     * \pre this snapshot must not be null
+     */
+    const Elf::FileHeader & fileHeader() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->fileHeader;
+    }
+
+    /*! \brief Get the section header table
+     *
+     * \pre this snapshot must not be null
+     */
+    const Elf::SectionHeaderTable & sectionHeaderTable() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->sectionHeaderTable;
+    }
+
+    /*! \brief Get the program header table
+     *
+     * \pre this snapshot must not be null
+     */
+    const Elf::ProgramHeaderTable & programHeaderTable() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->programHeaderTable;
+    }
+
+    /*! \brief Check if the file contains a dynamic section
+     *
+     * \pre this snapshot must not be null
+     */
+    bool containsDynamicSection() const noexcept
+    {
+      assert( !isNull() );
+
+      return !mData->dynamicSection.isNull();
+    }
+
+    /*! \brief Get the dynamic section
+     *
+     * \pre this snapshot must not be null
+     * \pre the file must contain a dynamic section
+     * \sa containsDynamicSection()
+     */
+    const Elf::DynamicSection & dynamicSection() const noexcept
+    {
+      assert( !isNull() );
+      assert( containsDynamicSection() );
+
+      return mData->dynamicSection;
+    }
+
+    /*! \brief Get the dynamic linker symbol table (.dynsym)
+     *
+     * Returns a empty table if the file has no .dynsym section.
+     *
+     * \pre this snapshot must not be null
+     */
+    const Elf::PartialSymbolTable & dynamicSymbolTable() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->dynamicSymbolTable;
+    }
+
+    /*! \brief Check if the file is a relocatable object (ET_REL)
+     *
+     * \pre this snapshot must not be null
+     */
+    bool isRelocatableObject() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->fileHeader.objectFileType() == Elf::ObjectFileType::RelocatableFile;
+    }
+
+    /*! \brief Get the symbols, relocation sections and section groups of a relocatable object
+     *
+     * Symbol names and group signatures refer to the mapped file,
+     * they stay valid as long as this snapshot (or a copy of it) is alive.
+     *
+     * \pre this snapshot must not be null
+     * \pre the file must be a relocatable object
+     * \sa isRelocatableObject()
+     */
+    const Elf::RelocatableObject & relocatableObject() const noexcept
+    {
+      assert( !isNull() );
+      assert( isRelocatableObject() );
+
+      return mData->relocatableObject;
+    }
+
+    /*! \brief Get the shared object name (SONAME)
+     *
+     * Returns a empty string if the file has no dynamic section,
+     * or if it has no SONAME.
+     *
+     * \pre this snapshot must not be null
+     */
+    QString getSoName() const;
+
+    /*! \brief Get the needed shared libraries
+     *
+     * \pre this snapshot must not be null
+     */
+    QStringList getNeededSharedLibraries() const;
+
+    /*! \brief Call \a visitor for each needed shared library
+     *
+     * \a visitor is called with a std::string_view
+     * that refers to the UTF-8 string in the dynamic string table.
+     * The views stay valid as long as this snapshot (or a copy of it) is alive.
+     *
+     * Does nothing if the file has no dynamic section.
+     *
+     * \pre this snapshot must not be null
+     * \exception ExecutableFileReadError
+     * \sa Elf::DynamicSection::forEachNeeded()
+     */
+    template<typename Visitor>
+    void forEachNeeded(Visitor visitor) const
+    {
+      assert( !isNull() );
+
+      if( containsDynamicSection() ){
+        mData->dynamicSection.forEachNeeded(visitor);
+      }
+    }
+
+    /*! \brief Get the run path
+     *
+     * \pre this snapshot must not be null
+     * \exception RPathFormatError
+     */
+    RPath getRunPath() const;
+
+    /*! \brief Call \a visitor for each entry of the run path
+     *
+     * \a visitor is called with a std::string_view
+     * for each raw entry (for example, $ORIGIN is not expanded).
+     * The views stay valid as long as this snapshot (or a copy of it) is alive.
+     *
+     * Does nothing if the file has no dynamic section.
+     *
+     * \pre this snapshot must not be null
+     * \exception ExecutableFileReadError
+     * \sa Elf::DynamicSection::forEachRunPathEntry()
+     */
+    template<typename Visitor>
+    void forEachRunPathEntry(Visitor visitor) const
+    {
+      assert( !isNull() );
+
+      if( containsDynamicSection() ){
+        mData->dynamicSection.forEachRunPathEntry(visitor);
+      }
+    }
+
+    /*! \brief Scan this file into \a context
+     *
+     * The SONAME, the needed shared libraries
+     * and the run path entries are interned in \a context
+     * directly from the dynamic string table,
+     * without creating any intermediate QString .
+     *
+     * The returned result is only valid as long as \a context is alive.
+     * It does not depend on this snapshot.
+     *
+     * \pre this snapshot must not be null
+     * \exception ExecutableFileReadError
+     */
+    FileScanResult scan(ScanContext & context) const;
+
+    /*! \brief Build a snapshot of the ELF file \a fileInfo refers to
+     *
+     * \pre \a fileInfo must have a file path set
+     * \exception FileOpenError
+     * \exception ExecutableFileReadError
+     */
+    static
+    ElfFileSnapshot fromFile(const QFileInfo & fileInfo);
+
+   private:
+
+    struct Data
+    {
+      ReadOnlyFileMapping mapping;
+      Elf::FileHeader fileHeader;
+      Elf::SectionHeaderTable sectionHeaderTable;
+      Elf::ProgramHeaderTable programHeaderTable;
+      Elf::DynamicSection dynamicSection;
+      Elf::PartialSymbolTable dynamicSymbolTable;
+      Elf::RelocatableObject relocatableObject;
+    };
+
+    std::shared_ptr<const Data> mData;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_ELF_FILE_SNAPSHOT_H
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "TestUtils.h"
+#include "Mdt/ExecutableFile/Elf/ChangedBytesMapWriter.h"
+#include <vector>
+
+using Mdt::ExecutableFile::ByteArraySpan;
+using Mdt::ExecutableFile::Elf::ChangedBytesMapWriter;
+using Mdt::ExecutableFile::Elf::OffsetRange;
+
+ByteArraySpan spanFromVector(std::vector<unsigned char> & v)
+{
+  ByteArraySpan span;
+
+  span.data = v.data();
+  span.size = static_cast<int64_t>( v.size() );
+
+  return span;
+}
+
+
+TEST_CASE("write")
+{
+  std::vector<unsigned char> bytes(64, 0);
+  ChangedBytesMapWriter writer( spanFromVector(bytes) );
+
+  SECTION("write the same bytes")
+  {
+    writer.write(8, 4, [](ByteArraySpan array){
+      REQUIRE( array.size == 4 );
+      array.data[0] = 0;
+    });
+    REQUIRE( writer.changedRanges().empty() );
+    REQUIRE( writer.changedByteCount() == 0 );
+  }
+
+  SECTION("write 2 bytes")
+  {
+    writer.write(8, 4, [](ByteArraySpan array){
+      array.data[1] = 1;
+      array.data[2] = 2;
+    });
+    REQUIRE( bytes[9] == 1 );
+    REQUIRE( bytes[10] == 2 );
+    const auto ranges = writer.changedRanges();
+    REQUIRE( ranges.size() == 1 );
+    REQUIRE( ranges[0].begin() == 9 );
+    REQUIRE( ranges[0].end() == 11 );
+  }
+
+  SECTION("the array initially contains the bytes of the map")
+  {
+    bytes[20] = 5;
+    writer.write(20, 2, [](ByteArraySpan array){
+      REQUIRE( array.data[0] == 5 );
+      array.data[1] = 6;
+    });
+    REQUIRE( bytes[20] == 5 );
+    REQUIRE( bytes[21] == 6 );
+    REQUIRE( writer.changedByteCount() == 1 );
+  }
+
+  SECTION("2 distant changes give 2 ranges")
+  {
+    writer.write(0, 64, [](ByteArraySpan array){
+      array.data[2] = 1;
+      array.data[40] = 1;
+    });
+    const auto ranges = writer.changedRanges();
+    REQUIRE( ranges.size() == 2 );
+    REQUIRE( ranges[0].begin() == 2 );
+    REQUIRE( ranges[0].end() == 3 );
+    REQUIRE( ranges[1].begin() == 40 );
+    REQUIRE( ranges[1].end() == 41 );
+  }
+
+  SECTION("adjacent writes are merged")
+  {
+    writer.write(12, 4, [](ByteArraySpan array){
+      array.data[3] = 1;
+    });
+    writer.write(16, 4, [](ByteArraySpan array){
+      array.data[0] = 1;
+    });
+    const auto ranges = writer.changedRanges();
+    REQUIRE( ranges.size() == 1 );
+    REQUIRE( ranges[0].begin() == 15 );
+    REQUIRE( ranges[0].end() == 17 );
+  }
+
+  SECTION("a byte changed several times is counted once")
+  {
+    writer.write(8, 4, [](ByteArraySpan array){
+      array.data[0] = 1;
+      array.data[1] = 1;
+    });
+    writer.write(9, 4, [](ByteArraySpan array){
+      array.data[0] = 2;
+      array.data[1] = 2;
+    });
+    REQUIRE( writer.changedRanges().size() == 1 );
+    REQUIRE( writer.changedByteCount() == 3 );
+  }
+}
+
+TEST_CASE("fill")
+{
+  std::vector<unsigned char> bytes(16, 0);
+  bytes[4] = 1;
+  bytes[5] = 1;
+  ChangedBytesMapWriter writer( spanFromVector(bytes) );
+
+  writer.fill(OffsetRange::fromBeginAndEndOffsets(0, 16), 0);
+  REQUIRE( bytes[4] == 0 );
+  REQUIRE( bytes[5] == 0 );
+  const auto ranges = writer.changedRanges();
+  REQUIRE( ranges.size() == 1 );
+  REQUIRE( ranges[0].begin() == 4 );
+  REQUIRE( ranges[0].end() == 6 );
+}
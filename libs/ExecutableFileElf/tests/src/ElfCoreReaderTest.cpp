@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileIoTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/CoreReader.h"
+#include "Mdt/ExecutableFile/Elf/FileHeaderWriter.h"
+#include <QLatin1String>
+#include <vector>
+
+using Mdt::ExecutableFile::ByteArraySpan;
+using Mdt::ExecutableFile::Elf::FileHeader;
+using Mdt::ExecutableFile::Elf::ReadError;
+
+TEST_CASE("readFileHeader")
+{
+  using Mdt::ExecutableFile::Elf::readFileHeader;
+
+  std::vector<uchar> array(64, 0);
+  ByteArraySpan map;
+  map.data = array.data();
+
+  SECTION("map too small")
+  {
+    map.size = 10;
+    const auto result = readFileHeader(map);
+    REQUIRE( !result.hasValue() );
+    REQUIRE( result.error() == ReadError::FileTooSmallToReadFileHeader );
+  }
+
+  SECTION("not a ELF file")
+  {
+    map.size = 64;
+    const auto result = readFileHeader(map);
+    REQUIRE( !result );
+    REQUIRE( result.error() == ReadError::InvalidFileHeader );
+  }
+
+  SECTION("valid file header")
+  {
+    map.size = 64;
+    const FileHeader expectedFileHeader = make64BitLittleEndianFileHeader();
+    fileHeaderToArray(map, expectedFileHeader);
+    const auto result = readFileHeader(map);
+    REQUIRE( result.hasValue() );
+    REQUIRE( result.error() == ReadError::NoError );
+    REQUIRE( result.value().shoff == expectedFileHeader.shoff );
+    REQUIRE( result.value().shnum == expectedFileHeader.shnum );
+  }
+}
+
+TEST_CASE("map too small to read headers")
+{
+  using Mdt::ExecutableFile::Elf::checkSizeToReadSectionHeaders;
+  using Mdt::ExecutableFile::Elf::checkSizeToReadProgramHeaderTable;
+  using Mdt::ExecutableFile::Elf::readSectionHeaderTable;
+  using Mdt::ExecutableFile::Elf::readProgramHeaderTable;
+
+  std::vector<uchar> array(64, 0);
+  ByteArraySpan map;
+  map.data = array.data();
+  map.size = 64;
+
+  const FileHeader fileHeader = make64BitLittleEndianFileHeader();
+  fileHeaderToArray(map, fileHeader);
+
+  REQUIRE( checkSizeToReadSectionHeaders(map, fileHeader) == ReadError::FileTooSmallToReadSectionHeaders );
+  REQUIRE( checkSizeToReadProgramHeaderTable(map, fileHeader) == ReadError::FileTooSmallToReadProgramHeaderTable );
+  REQUIRE( readSectionHeaderTable(map, fileHeader).error() == ReadError::FileTooSmallToReadSectionHeaders );
+  REQUIRE( readProgramHeaderTable(map, fileHeader).error() == ReadError::FileTooSmallToReadProgramHeaderTable );
+}
+
+TEST_CASE("readErrorMessage")
+{
+  using Mdt::ExecutableFile::Elf::readErrorMessage;
+
+  const QString message = readErrorMessage( ReadError::InvalidFileHeader, QLatin1String("libA.so") );
+  REQUIRE( message.contains( QLatin1String("libA.so") ) );
+}
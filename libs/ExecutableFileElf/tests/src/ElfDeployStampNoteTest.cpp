@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileIoTestUtils.h"
+#include "ElfProgramHeaderTestUtils.h"
+#include "ByteArraySpanTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/DeployStampNote.h"
+#include "Mdt/ExecutableFile/Elf/NoteSectionWriter.h"
+#include <QLatin1String>
+#include <vector>
+
+using namespace Mdt::ExecutableFile::Elf;
+using Mdt::ExecutableFile::ByteArraySpan;
+using Mdt::ExecutableFile::DeployStamp;
+using Mdt::ExecutableFile::RPath;
+
+DeployStamp makeStamp()
+{
+  RPath rpath;
+  rpath.appendPath( QLatin1String("../lib") );
+
+  return DeployStamp( QLatin1String("1.2"), rpath, QByteArray("\x01\x02\x03\x04\x05", 5) );
+}
+
+TEST_CASE("noteSectionFromStamp")
+{
+  const NoteSection section = DeployStampNote::noteSectionFromStamp( makeStamp(), DataFormat::Data2LSB );
+
+  REQUIRE( DeployStampNote::isDeployStampNote(section) );
+  REQUIRE( section.name == "Mdt" );
+  REQUIRE( section.type == 1 );
+  // 16 bytes of sizes, then "1.2" "$ORIGIN/../lib" and 5 bytes of fingerprint
+  REQUIRE( section.descriptionSize == 16 + 3 + 14 + 5 );
+  REQUIRE( section.description.size() == 4 + 6 );
+  REQUIRE( section.description[0] == 1 );
+  REQUIRE( section.description[1] == 3 );
+  REQUIRE( section.description[2] == 14 );
+  REQUIRE( section.description[3] == 5 );
+  // "1.2$" in file order
+  REQUIRE( section.description[4] == 0x24322e31 );
+  REQUIRE( section.byteCountAligned() == 12 + 4 + 40 );
+}
+
+TEST_CASE("stampFromNoteSection")
+{
+  const DeployStamp stamp = makeStamp();
+
+  SECTION("little-endian")
+  {
+    const NoteSection section = DeployStampNote::noteSectionFromStamp(stamp, DataFormat::Data2LSB);
+    REQUIRE( DeployStampNote::stampFromNoteSection(section, DataFormat::Data2LSB) == stamp );
+  }
+
+  SECTION("big-endian")
+  {
+    const NoteSection section = DeployStampNote::noteSectionFromStamp(stamp, DataFormat::Data2MSB);
+    REQUIRE( DeployStampNote::stampFromNoteSection(section, DataFormat::Data2MSB) == stamp );
+  }
+
+  SECTION("empty run path and fingerprint")
+  {
+    const DeployStamp emptyStamp( QLatin1String("2.0"), RPath(), QByteArray() );
+    const NoteSection section = DeployStampNote::noteSectionFromStamp(emptyStamp, DataFormat::Data2LSB);
+    REQUIRE( DeployStampNote::stampFromNoteSection(section, DataFormat::Data2LSB) == emptyStamp );
+  }
+
+  SECTION("unsupported format version")
+  {
+    NoteSection section = DeployStampNote::noteSectionFromStamp(stamp, DataFormat::Data2LSB);
+    section.description[0] = 2;
+    REQUIRE_THROWS_AS( DeployStampNote::stampFromNoteSection(section, DataFormat::Data2LSB), NoteSectionReadError );
+  }
+
+  SECTION("inconsistent sizes")
+  {
+    NoteSection section = DeployStampNote::noteSectionFromStamp(stamp, DataFormat::Data2LSB);
+    section.description[3] = 50;
+    REQUIRE_THROWS_AS( DeployStampNote::stampFromNoteSection(section, DataFormat::Data2LSB), NoteSectionReadError );
+  }
+}
+
+TEST_CASE("extractStamp")
+{
+  const DeployStamp stamp = makeStamp();
+  const FileHeader fileHeader = make64BitLittleEndianFileHeader();
+  ProgramHeaderTable programHeaderTable;
+
+  NoteSection otherNote;
+  otherNote.name = "GNU";
+  otherNote.type = 3;
+  otherNote.descriptionSize = 8;
+  otherNote.description = {0x12345678, 0x9abcdef0};
+  const int64_t otherNoteSize = otherNote.byteCountAligned();
+
+  const NoteSection stampNote = DeployStampNote::noteSectionFromStamp(stamp, fileHeader.ident.dataFormat);
+  const int64_t stampNoteSize = stampNote.byteCountAligned();
+
+  std::vector<unsigned char> fileData( static_cast<size_t>(100 + otherNoteSize + stampNoteSize), 0 );
+  const ByteArraySpan map = arraySpanFromArray( fileData.data(), static_cast<int64_t>( fileData.size() ) );
+  NoteSectionWriter::setNoteSectionToArray(map.subSpan(100, otherNoteSize), otherNote, fileHeader.ident);
+  NoteSectionWriter::setNoteSectionToArray(map.subSpan(100 + otherNoteSize, stampNoteSize), stampNote, fileHeader.ident);
+
+  ProgramHeader otherNoteHeader = makeNoteProgramHeader();
+  otherNoteHeader.offset = 100;
+  otherNoteHeader.filesz = static_cast<uint64_t>(otherNoteSize);
+  otherNoteHeader.memsz = otherNoteHeader.filesz;
+  otherNoteHeader.align = 4;
+  programHeaderTable.addHeaderFromFile(otherNoteHeader);
+
+  SECTION("no deployment stamp")
+  {
+    REQUIRE( DeployStampNote::extractStamp(map, fileHeader, programHeaderTable).isNull() );
+  }
+
+  SECTION("deployment stamp in its own PT_NOTE")
+  {
+    ProgramHeader stampNoteHeader = makeNoteProgramHeader();
+    stampNoteHeader.offset = static_cast<uint64_t>(100 + otherNoteSize);
+    stampNoteHeader.filesz = static_cast<uint64_t>(stampNoteSize);
+    stampNoteHeader.memsz = 0;
+    stampNoteHeader.align = 4;
+    programHeaderTable.addHeaderFromFile(stampNoteHeader);
+
+    REQUIRE( DeployStampNote::extractStamp(map, fileHeader, programHeaderTable) == stamp );
+  }
+
+  SECTION("deployment stamp after a other note in the same PT_NOTE")
+  {
+    programHeaderTable.setFileOffsetAndFileSizeAt( 0, 100, static_cast<uint64_t>(otherNoteSize + stampNoteSize) );
+
+    REQUIRE( DeployStampNote::extractStamp(map, fileHeader, programHeaderTable) == stamp );
+  }
+
+  SECTION("PT_NOTE past the end of the file")
+  {
+    ProgramHeader stampNoteHeader = makeNoteProgramHeader();
+    stampNoteHeader.offset = static_cast<uint64_t>(100 + otherNoteSize);
+    stampNoteHeader.filesz = static_cast<uint64_t>(stampNoteSize) + 1;
+    stampNoteHeader.memsz = 0;
+    programHeaderTable.addHeaderFromFile(stampNoteHeader);
+
+    REQUIRE( DeployStampNote::extractStamp(map, fileHeader, programHeaderTable).isNull() );
+  }
+}
@@ -13,6 +13,9 @@
 #include "ElfDynamicSectionTestCommon.h"
 #include "Mdt/ExecutableFile/Elf/DynamicSection.h"
 #include <QLatin1String>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <QDebug>
 
@@ -348,6 +351,58 @@ TEST_CASE("getNeededSharedLibraries")
   }
 }
 
+TEST_CASE("soNameView")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(1) );
+
+  uchar stringTable[8] = {'\0','S','o','N','a','m','e','\0'};
+  section.setStringTable( stringTableFromCharArray( stringTable, sizeof(stringTable) ) );
+
+  SECTION("no DT_SONAME present")
+  {
+    REQUIRE( section.soNameView().empty() );
+  }
+
+  SECTION("SoName")
+  {
+    section.addEntry( makeSoNameEntry(1) );
+    REQUIRE( section.soNameView() == "SoName" );
+  }
+}
+
+TEST_CASE("forEachNeeded")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(1) );
+
+  uchar stringTable[17] = {
+    '\0',
+    'l','i','b','A','.','s','o','\0',
+    'l','i','b','B','.','s','o','\0'
+  };
+  section.setStringTable( stringTableFromCharArray( stringTable, sizeof(stringTable) ) );
+
+  std::vector<std::string> libraries;
+  const auto visitor = [&libraries](std::string_view library){
+    libraries.emplace_back(library);
+  };
+
+  SECTION("no DT_NEEDED present")
+  {
+    section.forEachNeeded(visitor);
+    REQUIRE( libraries.empty() );
+  }
+
+  SECTION("libA.so libB.so")
+  {
+    section.addEntry( makeNeededEntry(1) );
+    section.addEntry( makeNeededEntry(9) );
+    section.forEachNeeded(visitor);
+    REQUIRE( libraries == std::vector<std::string>{"libA.so","libB.so"} );
+  }
+}
+
 TEST_CASE("addRunPathEntry")
 {
   DynamicSection section;
@@ -406,6 +461,40 @@ TEST_CASE("getRunPath")
   }
 }
 
+TEST_CASE("forEachRunPathEntry")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(1) );
+
+  uchar stringTable[21] = {
+    '\0',
+    '/','t','m','p',':',':',
+    '$','O','R','I','G','I','N',':',
+    '/','l','i','b',':','\0'
+  };
+  section.setStringTable( stringTableFromCharArray( stringTable, sizeof(stringTable) ) );
+
+  std::vector<std::string> entries;
+  const auto visitor = [&entries](std::string_view entry){
+    entries.emplace_back(entry);
+  };
+
+  SECTION("no DT_RUNPATH present")
+  {
+    REQUIRE( section.runPathView().empty() );
+    section.forEachRunPathEntry(visitor);
+    REQUIRE( entries.empty() );
+  }
+
+  SECTION("/tmp::$ORIGIN:/lib:")
+  {
+    section.addEntry( makeRunPathEntry(1) );
+    REQUIRE( section.runPathView() == "/tmp::$ORIGIN:/lib:" );
+    section.forEachRunPathEntry(visitor);
+    REQUIRE( entries == std::vector<std::string>{"/tmp","$ORIGIN","/lib"} );
+  }
+}
+
 TEST_CASE("removeRunPath")
 {
   DynamicSection section;
@@ -600,4 +689,208 @@ TEST_CASE("setRunPath")
       }
     }
   }
+
+  SECTION("the DT_RUNPATH string is shared with a other entry (the new run path is appended)")
+  {
+    uchar initialStringTable[6] = {
+      '\0',
+      '/','t','m','p','\0'
+    };
+    section.setStringTable( stringTableFromCharArray( initialStringTable, sizeof(initialStringTable) ) );
+    section.addEntry( makeSoNameEntry(1) );
+    section.addEntry( makeRunPathEntry(1) );
+    REQUIRE( section.getSoName() == QLatin1String("/tmp") );
+    REQUIRE( section.getRunPath() == QLatin1String("/tmp") );
+
+    section.setRunPath( QLatin1String("/opt") );
+    REQUIRE( section.getRunPath() == QLatin1String("/opt") );
+    REQUIRE( section.entryAt(2).val_or_ptr == 6 );
+    REQUIRE( section.getSoName() == QLatin1String("/tmp") );
+    REQUIRE( section.entryAt(1).val_or_ptr == 1 );
+    REQUIRE( section.stringTable().byteCount() == 1+4+1+4+1 );
+    REQUIRE( section.getStringTableSize() == 1+4+1+4+1 );
+  }
+
+  SECTION("the DT_RUNPATH string is the tail of a other string (the new run path is appended)")
+  {
+    uchar initialStringTable[9] = {
+      '\0',
+      'l','i','b','A','.','s','o','\0'
+    };
+    section.setStringTable( stringTableFromCharArray( initialStringTable, sizeof(initialStringTable) ) );
+    section.addEntry( makeNeededEntry(1) );
+    section.addEntry( makeRunPathEntry(5) );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so"}) );
+    REQUIRE( section.getRunPath() == QLatin1String(".so") );
+
+    section.setRunPath( QLatin1String("/opt") );
+    REQUIRE( section.getRunPath() == QLatin1String("/opt") );
+    REQUIRE( section.entryAt(2).val_or_ptr == 9 );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so"}) );
+    REQUIRE( section.entryAt(1).val_or_ptr == 1 );
+    REQUIRE( section.stringTable().byteCount() == 1+7+1+4+1 );
+    REQUIRE( section.getStringTableSize() == 1+7+1+4+1 );
+  }
+}
+
+TEST_CASE("setSoName")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(1) );
+
+  uchar initialStringTable[9] = {
+    '\0',
+    'l','i','b','A','.','s','o','\0'
+  };
+  section.setStringTable( stringTableFromCharArray( initialStringTable, sizeof(initialStringTable) ) );
+  section.addEntry( makeNeededEntry(1) );
+  section.addEntry( makeNullEntry() );
+
+  SECTION("there is initially no DT_SONAME")
+  {
+    section.setSoName( QLatin1String("libB.so.1") );
+    REQUIRE( section.getSoName() == QLatin1String("libB.so.1") );
+    REQUIRE( section.entriesCount() == 4 );
+    REQUIRE( section.entryAt(3).isNull() );
+    REQUIRE( section.getStringTableSize() == 9+10 );
+  }
+
+  SECTION("the DT_SONAME is changed, other indexes are preserved")
+  {
+    section.setSoName( QLatin1String("libB.so.1") );
+    section.setSoName( QLatin1String("libB.so.2") );
+    REQUIRE( section.getSoName() == QLatin1String("libB.so.2") );
+    REQUIRE( section.entriesCount() == 4 );
+    REQUIRE( section.entryAt(1).val_or_ptr == 1 );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so"}) );
+  }
+
+  SECTION("the same DT_SONAME is set again")
+  {
+    section.setSoName( QLatin1String("libB.so.1") );
+    const int64_t stringTableSize = section.stringTable().byteCount();
+    section.setSoName( QLatin1String("libB.so.1") );
+    REQUIRE( section.stringTable().byteCount() == stringTableSize );
+  }
+
+  SECTION("remove the DT_SONAME")
+  {
+    section.setSoName( QLatin1String("libB.so.1") );
+    section.setSoName( QString() );
+    REQUIRE( section.getSoName().isEmpty() );
+    REQUIRE( section.entriesCount() == 3 );
+  }
+}
+
+TEST_CASE("addNeededSharedLibrary")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(1) );
+
+  uchar initialStringTable[14] = {
+    '\0',
+    'l','i','b','A','.','s','o','\0',
+    '/','t','m','p','\0'
+  };
+  section.setStringTable( stringTableFromCharArray( initialStringTable, sizeof(initialStringTable) ) );
+  section.addEntry( makeNeededEntry(1) );
+  section.addEntry( makeRunPathEntry(9) );
+  section.addEntry( makeNullEntry() );
+
+  SECTION("add libB.so")
+  {
+    section.addNeededSharedLibrary( QLatin1String("libB.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so","libB.so"}) );
+    REQUIRE( section.entryAt(2).tagType() == DynamicSectionTagType::Needed );
+    REQUIRE( section.getRunPath() == QLatin1String("/tmp") );
+    REQUIRE( section.getStringTableSize() == 14+8 );
+  }
+
+  SECTION("add libA.so, that is already needed")
+  {
+    section.addNeededSharedLibrary( QLatin1String("libA.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so"}) );
+    REQUIRE( section.getStringTableSize() == 14 );
+  }
+}
+
+TEST_CASE("removeNeededSharedLibrary")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(17) );
+
+  uchar initialStringTable[17] = {
+    '\0',
+    'l','i','b','A','.','s','o','\0',
+    'l','i','b','B','.','s','o','\0'
+  };
+  section.setStringTable( stringTableFromCharArray( initialStringTable, sizeof(initialStringTable) ) );
+  section.addEntry( makeNeededEntry(1) );
+  section.addEntry( makeNeededEntry(9) );
+
+  SECTION("remove libA.so")
+  {
+    section.removeNeededSharedLibrary( QLatin1String("libA.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libB.so"}) );
+    REQUIRE( section.stringTable().byteCount() == 17 );
+  }
+
+  SECTION("remove a library that is not needed")
+  {
+    section.removeNeededSharedLibrary( QLatin1String("libC.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so","libB.so"}) );
+  }
+}
+
+TEST_CASE("replaceNeededSharedLibrary")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(17) );
+
+  uchar initialStringTable[17] = {
+    '\0',
+    'l','i','b','A','.','s','o','\0',
+    'l','i','b','B','.','s','o','\0'
+  };
+  section.setStringTable( stringTableFromCharArray( initialStringTable, sizeof(initialStringTable) ) );
+  section.addEntry( makeNeededEntry(1) );
+  section.addEntry( makeNeededEntry(9) );
+
+  SECTION("replace libA.so with libC.so")
+  {
+    section.replaceNeededSharedLibrary( QLatin1String("libA.so"), QLatin1String("libC.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libC.so","libB.so"}) );
+    REQUIRE( section.getStringTableSize() == 17+8 );
+  }
+
+  SECTION("replace libA.so with libB.so, that is already needed")
+  {
+    section.replaceNeededSharedLibrary( QLatin1String("libA.so"), QLatin1String("libB.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libB.so"}) );
+  }
+
+  SECTION("replace a library that is not needed")
+  {
+    section.replaceNeededSharedLibrary( QLatin1String("libC.so"), QLatin1String("libD.so") );
+    REQUIRE( section.getNeededSharedLibraries() == qStringListFromUtf8Strings({"libA.so","libB.so"}) );
+  }
+}
+
+TEST_CASE("setValueForTag")
+{
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(1) );
+  section.addEntry( makeNullEntry() );
+
+  REQUIRE( section.valueForTag(DynamicSectionTagType::Flags1) == 0 );
+
+  section.setValueForTag(DynamicSectionTagType::Flags1, 0x1);
+  REQUIRE( section.valueForTag(DynamicSectionTagType::Flags1) == 0x1 );
+  REQUIRE( section.entriesCount() == 3 );
+  REQUIRE( section.entryAt(1).tag == 0x6ffffffb );
+  REQUIRE( section.entryAt(2).isNull() );
+
+  section.setValueForTag(DynamicSectionTagType::Flags1, 0x9);
+  REQUIRE( section.valueForTag(DynamicSectionTagType::Flags1) == 0x9 );
+  REQUIRE( section.entriesCount() == 3 );
 }
@@ -22,8 +22,14 @@ using Mdt::ExecutableFile::Elf::MoveSectionAlignment;
 using Mdt::ExecutableFile::Elf::FileHeader;
 using Mdt::ExecutableFile::Elf::ProgramHeader;
 using Mdt::ExecutableFile::Elf::SegmentType;
+using Mdt::ExecutableFile::Elf::SegmentPermission;
+using Mdt::ExecutableFile::Elf::SegmentPermissions;
 using Mdt::ExecutableFile::Elf::ProgramHeaderTable;
 using Mdt::ExecutableFile::Elf::SectionHeader;
+using Mdt::ExecutableFile::Elf::SectionType;
+using Mdt::ExecutableFile::Elf::SectionAttributeFlag;
+using Mdt::ExecutableFile::Elf::SectionIndexChangeMap;
+using Mdt::ExecutableFile::Elf::StringTable;
 
 std::vector<SectionHeader> makeSectionHeaderTable(int n)
 {
@@ -427,6 +433,53 @@ TEST_CASE("moveProgramHeaderTableToNextPageAfterEnd")
   REQUIRE( headers.fileHeader().phoff == headers.programHeaderTableProgramHeader().offset );
 }
 
+TEST_CASE("moveProgramHeaderTableToNextPageAfterEnd_noPtPhdr")
+{
+  TestHeadersSetup setup;
+  setup.programHeaderTableOffset = 0x40;
+  setup.dynamicSectionOffset = 0x1000;
+  setup.dynamicSectionAddress = 0x1000;
+  setup.dynamicSectionSize = 0x100;
+  setup.sectionHeaderTableOffset = 0x1200;
+
+  FileAllHeaders headers = makeTestHeaders(setup);
+
+  /*
+   * A shared library often has no PT_PHDR,
+   * the program header table is then covered by the first PT_LOAD
+   */
+  ProgramHeader loadProgramHeader;
+  loadProgramHeader.setSegmentType(SegmentType::Load);
+  loadProgramHeader.setPermissions(SegmentPermission::Read);
+  loadProgramHeader.offset = 0;
+  loadProgramHeader.vaddr = 0;
+  loadProgramHeader.paddr = 0;
+  loadProgramHeader.filesz = 0x1100;
+  loadProgramHeader.memsz = 0x1100;
+  loadProgramHeader.align = 0x1000;
+
+  ProgramHeaderTable programHeaderTable;
+  programHeaderTable.addHeaderFromFile(loadProgramHeader);
+  for(size_t i = 0; i < headers.programHeaderTable().headerCount(); ++i){
+    const ProgramHeader & header = headers.programHeaderTable().headerAt(i);
+    if( header.segmentType() != SegmentType::ProgramHeaderTable ){
+      programHeaderTable.addHeaderFromFile(header);
+    }
+  }
+  headers.setProgramHeaderTable(programHeaderTable);
+  REQUIRE( !headers.containsProgramHeaderTableProgramHeader() );
+
+  const uint64_t originalVirtualMemoryEnd = headers.findGlobalVirtualAddressEnd();
+  const uint64_t originalFileEnd = headers.findGlobalFileOffsetEnd();
+
+  headers.moveProgramHeaderTableToNextPageAfterEnd();
+
+  REQUIRE( !headers.containsProgramHeaderTableProgramHeader() );
+  REQUIRE( headers.fileHeader().phoff >= originalVirtualMemoryEnd );
+  REQUIRE( headers.fileHeader().phoff >= originalFileEnd );
+  REQUIRE( (headers.fileHeader().phoff % headers.fileHeader().pageSize()) == 0 );
+}
+
 TEST_CASE("moveProgramInterpreterSectionToEnd")
 {
   TestHeadersSetup setup;
@@ -592,6 +645,154 @@ TEST_CASE("moveDynamicStringTableToEnd")
   }
 }
 
+TEST_CASE("findIndexOfExtensibleLastLoadProgramHeader")
+{
+  TestHeadersSetup setup;
+  setup.programHeaderTableOffset = 64;
+  setup.dynamicSectionOffset = 0x1000;
+  setup.dynamicSectionAddress = 0x1000;
+  setup.dynamicSectionSize = 0x100;
+  setup.dynamicStringTableOffset = 0x1100;
+  setup.dynamicStringTableAddress = 0x1100;
+  setup.dynamicStringTableSize = 0x100;
+  setup.sectionHeaderTableOffset = 0x1200;
+
+  FileAllHeaders headers = makeTestHeaders(setup);
+
+  ProgramHeader loadProgramHeader;
+  loadProgramHeader.setSegmentType(SegmentType::Load);
+  loadProgramHeader.offset = 0x1000;
+  loadProgramHeader.vaddr = 0x1000;
+  loadProgramHeader.paddr = 0x1000;
+  loadProgramHeader.filesz = 0x200;
+  loadProgramHeader.memsz = 0x200;
+  loadProgramHeader.align = 0x1000;
+
+  const size_t loadIndex = headers.programHeaderTable().headerCount();
+
+  SECTION("read only segment")
+  {
+    loadProgramHeader.setPermissions(SegmentPermission::Read);
+    headers.addProgramHeader(loadProgramHeader);
+
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read) == loadIndex );
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read | SegmentPermission::Write) == headers.programHeaderTable().headerCount() );
+  }
+
+  SECTION("a writable segment can also hold read only sections")
+  {
+    loadProgramHeader.setPermissions(SegmentPermission::Read | SegmentPermission::Write);
+    headers.addProgramHeader(loadProgramHeader);
+
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read) == loadIndex );
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read | SegmentPermission::Write) == loadIndex );
+  }
+
+  SECTION("a executable segment is not extended for data")
+  {
+    loadProgramHeader.setPermissions(SegmentPermission::Read | SegmentPermission::Execute);
+    headers.addProgramHeader(loadProgramHeader);
+
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read) == headers.programHeaderTable().headerCount() );
+  }
+
+  SECTION("the segment has a part not backed by the file (like .bss)")
+  {
+    loadProgramHeader.setPermissions(SegmentPermission::Read | SegmentPermission::Write);
+    loadProgramHeader.memsz = 0x300;
+    headers.addProgramHeader(loadProgramHeader);
+
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read) == headers.programHeaderTable().headerCount() );
+  }
+
+  SECTION("a other segment is mapped after it")
+  {
+    loadProgramHeader.setPermissions(SegmentPermission::Read);
+    headers.addProgramHeader(loadProgramHeader);
+
+    ProgramHeader lastLoadProgramHeader = loadProgramHeader;
+    lastLoadProgramHeader.setPermissions(SegmentPermission::Read | SegmentPermission::Execute);
+    lastLoadProgramHeader.offset = 0;
+    lastLoadProgramHeader.vaddr = 0x3000;
+    lastLoadProgramHeader.paddr = 0x3000;
+    lastLoadProgramHeader.filesz = 0x100;
+    lastLoadProgramHeader.memsz = 0x100;
+    headers.addProgramHeader(lastLoadProgramHeader);
+
+    REQUIRE( headers.findIndexOfExtensibleLastLoadProgramHeader(SegmentPermission::Read) == headers.programHeaderTable().headerCount() );
+  }
+
+  SECTION("extend the segment to cover the moved .dynstr")
+  {
+    loadProgramHeader.setPermissions(SegmentPermission::Read);
+    headers.addProgramHeader(loadProgramHeader);
+    const uint64_t originalFileEnd = headers.findGlobalFileOffsetEnd();
+
+    const uint64_t address = headers.findNextVirtualAddressToExtendLoadSegment(loadIndex, 8);
+    const uint64_t offset = headers.fileOffsetInLoadSegment(loadIndex, address);
+    REQUIRE( (address % 8) == 0 );
+    REQUIRE( offset >= originalFileEnd );
+    REQUIRE( (offset - 0x1000) == (address - 0x1000) );
+
+    headers.moveDynamicStringTableTo(offset, address);
+    headers.extendLoadProgramHeaderToCoverSection( loadIndex, headers.dynamicStringTableSectionHeader() );
+
+    const ProgramHeader & extendedProgramHeader = headers.programHeaderTable().headerAt(loadIndex);
+    REQUIRE( extendedProgramHeader.offset == 0x1000 );
+    REQUIRE( extendedProgramHeader.fileOffsetEnd() == headers.dynamicStringTableSectionHeader().fileOffsetEnd() );
+    REQUIRE( extendedProgramHeader.memsz == extendedProgramHeader.filesz );
+  }
+}
+
+TEST_CASE("shiftFileContentFrom")
+{
+  TestHeadersSetup setup;
+  setup.programHeaderTableOffset = 64;
+  setup.dynamicSectionOffset = 0x1000;
+  setup.dynamicSectionAddress = 0x3000;
+  setup.dynamicSectionSize = 0x100;
+  setup.dynamicStringTableOffset = 0x1100;
+  setup.dynamicStringTableAddress = 0x3100;
+  setup.dynamicStringTableSize = 0x100;
+  setup.sectionHeaderTableOffset = 0x1200;
+
+  FileAllHeaders headers = makeTestHeaders(setup);
+
+  SECTION("the content can only be cut between the structures")
+  {
+    REQUIRE( !headers.fileContentCanBeShiftedFrom(0) );
+    REQUIRE( !headers.fileContentCanBeShiftedFrom(10) );
+    REQUIRE( !headers.fileContentCanBeShiftedFrom(70) );
+    REQUIRE( headers.fileContentCanBeShiftedFrom(0x1000) );
+    REQUIRE( !headers.fileContentCanBeShiftedFrom(0x1080) );
+    REQUIRE( headers.fileContentCanBeShiftedFrom(0x1100) );
+  }
+
+  SECTION("shift from the .dynamic section")
+  {
+    headers.shiftFileContentFrom(0x1000, 0x1000);
+
+    REQUIRE( headers.fileHeader().phoff == 64 );
+    REQUIRE( headers.fileHeader().shoff == 0x2200 );
+    REQUIRE( headers.dynamicSectionHeader().offset == 0x2000 );
+    REQUIRE( headers.dynamicSectionHeader().addr == 0x3000 );
+    REQUIRE( headers.dynamicProgramHeader().offset == 0x2000 );
+    REQUIRE( headers.dynamicProgramHeader().vaddr == 0x3000 );
+    REQUIRE( headers.dynamicStringTableSectionHeader().offset == 0x2100 );
+    REQUIRE( headers.dynamicStringTableSectionHeader().addr == 0x3100 );
+    REQUIRE( headers.seemsValid() );
+  }
+
+  SECTION("shift from the .dynstr section")
+  {
+    headers.shiftFileContentFrom(0x1100, 0x1000);
+
+    REQUIRE( headers.dynamicSectionHeader().offset == 0x1000 );
+    REQUIRE( headers.dynamicStringTableSectionHeader().offset == 0x2100 );
+    REQUIRE( headers.fileHeader().shoff == 0x2200 );
+  }
+}
+
 TEST_CASE("setDynamicStringTableSize")
 {
   TestHeadersSetup setup;
@@ -666,6 +867,33 @@ TEST_CASE("findGlobalFileOffsetEnd")
 
     REQUIRE( allHeaders.findGlobalFileOffsetEnd() == expectedEnd );
   }
+
+  SECTION("a .bss section is at the end of the file (it occupies no space in the file)")
+  {
+    setup.programHeaderTableOffset = 50;
+    setup.dynamicSectionOffset = 100;
+    setup.dynamicSectionSize = 10;
+    setup.dynamicStringTableOffset = 10'000;
+    setup.dynamicStringTableAddress = 10'000;
+    setup.dynamicStringTableSize = 100;
+    setup.sectionHeaderTableOffset = 2'000;
+    allHeaders = makeTestHeaders(setup);
+
+    SectionHeader bss;
+    bss.name = ".bss";
+    bss.type = static_cast<uint32_t>(SectionType::NoBits);
+    bss.offset = 10'100;
+    bss.addr = 10'100;
+    bss.size = 5'000;
+    std::vector<SectionHeader> sectionHeaderTable = allHeaders.sectionHeaderTable();
+    sectionHeaderTable.push_back(bss);
+    allHeaders.setSectionHeaderTable(sectionHeaderTable);
+    REQUIRE( allHeaders.seemsValid() );
+
+    const uint64_t expectedEnd = setup.dynamicStringTableOffset + setup.dynamicStringTableSize;
+
+    REQUIRE( allHeaders.findGlobalFileOffsetEnd() == expectedEnd );
+  }
 }
 
 TEST_CASE("globalFileOffsetRange")
@@ -710,6 +938,140 @@ TEST_CASE("globalFileOffsetRange")
   }
 }
 
+TEST_CASE("removeNonAllocatedSections")
+{
+  TestHeadersSetup setup;
+  setup.programHeaderTableOffset = 64;
+  setup.dynamicSectionOffset = 1'000;
+  setup.dynamicSectionAddress = 1'000;
+  setup.dynamicSectionSize = 100;
+  setup.dynamicStringTableOffset = 2'000;
+  setup.dynamicStringTableAddress = 2'000;
+  setup.dynamicStringTableSize = 100;
+  setup.sectionNameStringTableOffset = 10'000;
+  setup.sectionHeaderTableOffset = 11'000;
+  FileAllHeaders allHeaders = makeTestHeaders(setup);
+
+  std::vector<SectionHeader> sectionHeaderTable = allHeaders.sectionHeaderTable();
+  for(SectionHeader & header : sectionHeaderTable){
+    if( header.name == ".dynamic" || header.name == ".dynstr" ){
+      header.flags = static_cast<uint64_t>(SectionAttributeFlag::Alloc);
+    }
+  }
+
+  SectionHeader comment;
+  comment.name = ".comment";
+  comment.type = static_cast<uint32_t>(SectionType::ProgramData);
+  comment.offset = 3'000;
+  comment.size = 50;
+  comment.addr = 0;
+
+  SectionHeader symTab = makeSymbolTableSectionHeader();
+  symTab.offset = 4'000;
+  symTab.size = 5'000;
+  symTab.addr = 0;
+
+  /*
+   * .dynamic , .dynstr , .shstrtab , .comment , .symtab
+   */
+  sectionHeaderTable.push_back(comment);
+  sectionHeaderTable.push_back(symTab);
+  allHeaders.setSectionHeaderTable(sectionHeaderTable);
+  REQUIRE( allHeaders.seemsValid() );
+  REQUIRE( allHeaders.fileHeader().shnum == 6 );
+  REQUIRE( allHeaders.fileHeader().shstrndx == 3 );
+
+  const SectionIndexChangeMap indexChangeMap = allHeaders.removeNonAllocatedSections();
+
+  REQUIRE( allHeaders.sectionHeaderTable().size() == 4 );
+  REQUIRE( allHeaders.fileHeader().shnum == 4 );
+  REQUIRE( allHeaders.fileHeader().shstrndx == 3 );
+  REQUIRE( allHeaders.sectionNameStringTableHeader().name == ".shstrtab" );
+  REQUIRE( allHeaders.dynamicSectionHeader().name == ".dynamic" );
+  REQUIRE( allHeaders.dynamicStringTableSectionHeader().name == ".dynstr" );
+  REQUIRE( indexChangeMap.indexForOldIndex(4) == 0 );
+  REQUIRE( indexChangeMap.indexForOldIndex(5) == 0 );
+
+  SECTION("rebuild the section name string table")
+  {
+    const StringTable stringTable = allHeaders.rebuildSectionNameStringTable();
+
+    REQUIRE( allHeaders.sectionNameStringTableHeader().size == static_cast<uint64_t>( stringTable.byteCount() ) );
+    for(const SectionHeader & header : allHeaders.sectionHeaderTable()){
+      REQUIRE( stringTable.stringAtIndex(header.nameIndex) == header.name );
+    }
+  }
+
+  SECTION("move the section name string table and the section header table after the allocated content")
+  {
+    allHeaders.moveSectionNameStringTableAndSectionHeaderTableAfterAllocatedContent();
+
+    const uint64_t allocatedContentEnd = setup.dynamicStringTableOffset + setup.dynamicStringTableSize;
+    REQUIRE( allHeaders.sectionNameStringTableHeader().offset == allocatedContentEnd );
+    REQUIRE( allHeaders.fileHeader().shoff >= allocatedContentEnd + allHeaders.sectionNameStringTableHeader().size );
+    REQUIRE( allHeaders.fileHeader().shoff % 8 == 0 );
+    REQUIRE( allHeaders.findGlobalFileOffsetEnd() < setup.sectionHeaderTableOffset );
+  }
+}
+
+TEST_CASE("removeNonAllocatedSections_keepsGnuDebugLink")
+{
+  TestHeadersSetup setup;
+  setup.programHeaderTableOffset = 64;
+  setup.dynamicSectionOffset = 1'000;
+  setup.dynamicSectionAddress = 1'000;
+  setup.dynamicSectionSize = 100;
+  setup.dynamicStringTableOffset = 2'000;
+  setup.dynamicStringTableAddress = 2'000;
+  setup.dynamicStringTableSize = 102;
+  setup.sectionNameStringTableOffset = 10'000;
+  setup.sectionHeaderTableOffset = 11'000;
+  FileAllHeaders allHeaders = makeTestHeaders(setup);
+
+  std::vector<SectionHeader> sectionHeaderTable = allHeaders.sectionHeaderTable();
+  for(SectionHeader & header : sectionHeaderTable){
+    if( header.name == ".dynamic" || header.name == ".dynstr" ){
+      header.flags = static_cast<uint64_t>(SectionAttributeFlag::Alloc);
+    }
+  }
+
+  SectionHeader debugLink;
+  debugLink.name = ".gnu_debuglink";
+  debugLink.type = static_cast<uint32_t>(SectionType::ProgramData);
+  debugLink.offset = 3'000;
+  debugLink.size = 16;
+  debugLink.addr = 0;
+  debugLink.addralign = 4;
+
+  SectionHeader symTab = makeSymbolTableSectionHeader();
+  symTab.offset = 4'000;
+  symTab.size = 5'000;
+  symTab.addr = 0;
+
+  /*
+   * .dynamic , .dynstr , .shstrtab , .gnu_debuglink , .symtab
+   */
+  sectionHeaderTable.push_back(debugLink);
+  sectionHeaderTable.push_back(symTab);
+  allHeaders.setSectionHeaderTable(sectionHeaderTable);
+  REQUIRE( allHeaders.seemsValid() );
+
+  allHeaders.removeNonAllocatedSections();
+
+  REQUIRE( allHeaders.sectionHeaderTable().size() == 5 );
+  REQUIRE( allHeaders.containsGnuDebugLinkSectionHeader() );
+  REQUIRE( allHeaders.findIndexOfGnuDebugLinkSectionHeader() == 4 );
+
+  SECTION("the .gnu_debuglink is placed just before the section name string table")
+  {
+    allHeaders.moveSectionNameStringTableAndSectionHeaderTableAfterAllocatedContent();
+
+    // 2'102 aligned to 4
+    REQUIRE( allHeaders.gnuDebugLinkSectionHeader().offset == 2'104 );
+    REQUIRE( allHeaders.sectionNameStringTableHeader().offset == 2'120 );
+  }
+}
+
 TEST_CASE("seemsValid")
 {
   FileAllHeaders allHeaders;
@@ -13,13 +13,31 @@
 #include "TestUtils.h"
 #include "TestFileUtils.h"
 #include "Mdt/ExecutableFile/ElfFileIoEngine.h"
+#include "Mdt/ExecutableFile/ElfFileSnapshot.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
+#include "Mdt/ExecutableFile/ReadLimitExceededError.h"
 #include <QString>
 #include <QLatin1String>
+#include <algorithm>
+#include <cstdint>
 
 using namespace Mdt::ExecutableFile;
+using Mdt::ExecutableFile::Elf::SectionHeader;
 using Mdt::ExecutableFile::Elf::SectionHeaderTable;
+using Mdt::ExecutableFile::Elf::SectionType;
 using Mdt::ExecutableFile::Elf::ProgramHeaderTable;
 
+const SectionHeader & findSectionHeader(const SectionHeaderTable & table, const std::string & name)
+{
+  const auto pred = [&name](const SectionHeader & header){
+    return header.name == name;
+  };
+  const auto it = std::find_if(table.cbegin(), table.cend(), pred);
+  REQUIRE( it != table.cend() );
+
+  return *it;
+}
+
 
 TEST_CASE("isElfFile")
 {
@@ -191,3 +209,91 @@ TEST_CASE("call_many_members_one_1_instance")
   REQUIRE( !engine.getRunPath().isEmpty() );
   engine.close();
 }
+
+TEST_CASE("readLimits")
+{
+  ElfFileIoEngine engine;
+
+  const ElfFileSnapshot snapshot = ElfFileSnapshot::fromFile( testSharedLibraryFilePath() );
+  const SectionHeaderTable & table = snapshot.sectionHeaderTable();
+
+  const SectionHeader & sectionNamesStringTableHeader = findSectionHeader(table, ".shstrtab");
+  const SectionHeader & dynamicSectionHeader = findSectionHeader(table, ".dynamic");
+  REQUIRE( dynamicSectionHeader.link < table.size() );
+  const SectionHeader & dynamicStringTableHeader = table[dynamicSectionHeader.link];
+  REQUIRE( dynamicStringTableHeader.sectionType() == SectionType::StringTable );
+
+  /*
+   * The section header table, the section names string table,
+   * the .dynamic section and its string table
+   */
+  const uint64_t sectionHeaderTableByteCount = table.size() * snapshot.fileHeader().shentsize;
+  const int64_t byteCountToRead = static_cast<int64_t>( sectionHeaderTableByteCount
+                                                        + sectionNamesStringTableHeader.size
+                                                        + dynamicSectionHeader.size
+                                                        + dynamicStringTableHeader.size );
+
+  ReadLimits limits;
+
+  SECTION("section count")
+  {
+    limits.maximumSectionCount = static_cast<int64_t>( table.size() ) - 1;
+    engine.setReadLimits(limits);
+    engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+    REQUIRE_THROWS_AS( engine.getSectionHeaderTable(), ReadLimitExceededError );
+    engine.close();
+  }
+
+  SECTION("entry count")
+  {
+    limits.maximumEntryCount = 1;
+    engine.setReadLimits(limits);
+    engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+    REQUIRE_THROWS_AS( engine.getNeededSharedLibraries(), ReadLimitExceededError );
+    engine.close();
+  }
+
+  SECTION("string table byte count")
+  {
+    limits.maximumStringTableByteCount = static_cast<int64_t>(dynamicStringTableHeader.size) - 1;
+    engine.setReadLimits(limits);
+    engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+    REQUIRE_THROWS_AS( engine.getNeededSharedLibraries(), ReadLimitExceededError );
+    engine.close();
+  }
+
+  SECTION("total byte count - reading several times charges once")
+  {
+    limits.maximumTotalByteCount = byteCountToRead;
+    engine.setReadLimits(limits);
+    engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+    REQUIRE( engine.getSectionHeaderTable().size() == table.size() );
+    REQUIRE( !engine.getNeededSharedLibraries().isEmpty() );
+    REQUIRE( engine.getSoName() == QLatin1String("libtestSharedLibrary.so") );
+    REQUIRE( engine.getSectionHeaderTable().size() == table.size() );
+    REQUIRE( engine.getSectionHeaderTable().size() == table.size() );
+    engine.close();
+  }
+
+  SECTION("total byte count exceeded")
+  {
+    limits.maximumTotalByteCount = byteCountToRead - 1;
+    engine.setReadLimits(limits);
+    engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+    REQUIRE( engine.getSectionHeaderTable().size() == table.size() );
+    REQUIRE_THROWS_AS( engine.getNeededSharedLibraries(), ReadLimitExceededError );
+    engine.close();
+  }
+
+  SECTION("the budget is reset for the next file")
+  {
+    limits.maximumTotalByteCount = byteCountToRead;
+    engine.setReadLimits(limits);
+    for(int i = 0; i < 2; ++i){
+      engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+      REQUIRE( engine.getSectionHeaderTable().size() == table.size() );
+      REQUIRE( !engine.getNeededSharedLibraries().isEmpty() );
+      engine.close();
+    }
+  }
+}
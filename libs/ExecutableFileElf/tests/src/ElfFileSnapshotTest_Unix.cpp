@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "TestBinariesUtils.h"
+#include "Mdt/ExecutableFile/ElfFileSnapshot.h"
+#include "Mdt/ExecutableFile/ElfFileIoEngine.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include <QString>
+#include <QStringList>
+#include <thread>
+#include <vector>
+#include <string_view>
+#include <algorithm>
+
+using namespace Mdt::ExecutableFile;
+
+
+TEST_CASE("fromFile")
+{
+  ElfFileSnapshot snapshot;
+  REQUIRE( snapshot.isNull() );
+
+  SECTION("shared library")
+  {
+    snapshot = ElfFileSnapshot::fromFile( testSharedLibraryFilePath() );
+    REQUIRE( !snapshot.isNull() );
+    REQUIRE( snapshot.fileHeader().seemsValid() );
+    REQUIRE( !snapshot.sectionHeaderTable().empty() );
+    REQUIRE( !snapshot.programHeaderTable().isEmpty() );
+    REQUIRE( snapshot.containsDynamicSection() );
+    REQUIRE( !snapshot.dynamicSymbolTable().isEmpty() );
+    REQUIRE( containsQt5Core( snapshot.getNeededSharedLibraries() ) );
+    REQUIRE( !snapshot.getRunPath().isEmpty() );
+  }
+
+  SECTION("dynamic linked executable")
+  {
+    snapshot = ElfFileSnapshot::fromFile( testExecutableFilePath() );
+    REQUIRE( !snapshot.isNull() );
+    REQUIRE( containsTestSharedLibrary( snapshot.getNeededSharedLibraries() ) );
+  }
+}
+
+TEST_CASE("sameResultAsIoEngine")
+{
+  const ElfFileSnapshot snapshot = ElfFileSnapshot::fromFile( testSharedLibraryFilePath() );
+
+  ElfFileIoEngine engine;
+  engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+
+  REQUIRE( snapshot.getNeededSharedLibraries() == engine.getNeededSharedLibraries() );
+  REQUIRE( snapshot.getRunPath() == engine.getRunPath() );
+  REQUIRE( snapshot.getSoName() == engine.getSoName() );
+  REQUIRE( snapshot.sectionHeaderTable().size() == engine.getSectionHeaderTable().size() );
+
+  engine.close();
+}
+
+TEST_CASE("shareAcrossThreads")
+{
+  ElfFileSnapshot snapshot = ElfFileSnapshot::fromFile( testSharedLibraryFilePath() );
+  const QStringList expectedLibraries = snapshot.getNeededSharedLibraries();
+
+  constexpr size_t threadCount = 4;
+  std::vector<QStringList> results(threadCount);
+  std::vector<std::thread> threads;
+
+  for(size_t i = 0; i < threadCount; ++i){
+    const ElfFileSnapshot copy = snapshot;
+    threads.emplace_back([copy, &results, i](){
+      results[i] = copy.getNeededSharedLibraries();
+    });
+  }
+
+  /*
+   * The mapping must stay alive while copies exist
+   */
+  snapshot = ElfFileSnapshot();
+
+  for(auto & thread : threads){
+    thread.join();
+  }
+
+  for(const auto & libraries : results){
+    REQUIRE( libraries == expectedLibraries );
+  }
+}
+
+TEST_CASE("scan")
+{
+  ScanContext context;
+
+  const ElfFileSnapshot snapshot = ElfFileSnapshot::fromFile( testSharedLibraryFilePath() );
+  const FileScanResult result = snapshot.scan(context);
+
+  REQUIRE( result.format == ExecutableFileFormat::Elf );
+  REQUIRE( result.fileName.toQString() == snapshot.fileName() );
+  REQUIRE( result.soName.toQString() == snapshot.getSoName() );
+
+  const QStringList expectedLibraries = snapshot.getNeededSharedLibraries();
+  REQUIRE( result.neededSharedLibraries.size() == static_cast<size_t>( expectedLibraries.size() ) );
+  for(size_t i = 0; i < result.neededSharedLibraries.size(); ++i){
+    REQUIRE( result.neededSharedLibraries[i].toQString() == expectedLibraries.at( static_cast<int>(i) ) );
+  }
+
+  SECTION("scanning twice gives the same handles")
+  {
+    const std::size_t stringCount = context.stringPool().size();
+    const FileScanResult secondResult = snapshot.scan(context);
+
+    REQUIRE( context.stringPool().size() == stringCount );
+    REQUIRE( secondResult.fileName == result.fileName );
+    REQUIRE( secondResult.neededSharedLibraries.size() == result.neededSharedLibraries.size() );
+    for(size_t i = 0; i < result.neededSharedLibraries.size(); ++i){
+      REQUIRE( secondResult.neededSharedLibraries[i] == result.neededSharedLibraries[i] );
+    }
+  }
+}
+
+TEST_CASE("relocatableObject")
+{
+  using Elf::RelocatableObject;
+  using Elf::RelocatableObjectSymbol;
+  using Elf::RelocationSection;
+  using Elf::RelocationEntry;
+  using Elf::SectionGroup;
+
+  const ElfFileSnapshot snapshot = ElfFileSnapshot::fromFile( testObjectFilePath() );
+  REQUIRE( snapshot.isRelocatableObject() );
+
+  const RelocatableObject object = Elf::extractRelocatableObject( snapshot.map(), snapshot.fileHeader(), snapshot.sectionHeaderTable() );
+  const size_t sectionCount = snapshot.sectionHeaderTable().size();
+
+  REQUIRE( object.symbols.size() == snapshot.relocatableObject().symbols.size() );
+  REQUIRE( object.relocationSections.size() == snapshot.relocatableObject().relocationSections.size() );
+  REQUIRE( object.sectionGroups.size() == snapshot.relocatableObject().sectionGroups.size() );
+
+  SECTION("symbols")
+  {
+    REQUIRE( object.symbols.size() > 1 );
+
+    std::vector<std::string_view> definedNames;
+    object.forEachDefinedGlobalSymbol([&definedNames](const RelocatableObjectSymbol & symbol){
+      definedNames.push_back(symbol.name);
+    });
+    const auto containsName = [&definedNames](std::string_view name){
+      return std::find(definedNames.cbegin(), definedNames.cend(), name) != definedNames.cend();
+    };
+    // void sayHelloStatic() and int processStatic(const char*), Itanium C++ ABI mangling
+    REQUIRE( containsName("_Z14sayHelloStaticv") );
+    REQUIRE( containsName("_Z13processStaticPKc") );
+
+    bool refersToCout = false;
+    object.forEachUndefinedSymbol([&refersToCout](const RelocatableObjectSymbol & symbol){
+      if(symbol.name == "_ZSt4cout"){
+        refersToCout = true;
+      }
+    });
+    REQUIRE( refersToCout );
+  }
+
+  SECTION("relocations")
+  {
+    REQUIRE( !object.relocationSections.empty() );
+    for(const RelocationSection & section : object.relocationSections){
+      REQUIRE( section.sectionIndex < sectionCount );
+      REQUIRE( section.targetSectionIndex < sectionCount );
+      REQUIRE( !section.entries.empty() );
+      for(const RelocationEntry & entry : section.entries){
+        REQUIRE( entry.symbolIndex < object.symbols.size() );
+      }
+    }
+  }
+
+  SECTION("section groups")
+  {
+    for(const SectionGroup & group : object.sectionGroups){
+      REQUIRE( group.sectionIndex < sectionCount );
+      REQUIRE( !group.signature.empty() );
+      REQUIRE( !group.memberSectionIndexes.empty() );
+      for(uint32_t index : group.memberSectionIndexes){
+        REQUIRE( index < sectionCount );
+      }
+    }
+  }
+}
@@ -20,21 +20,28 @@
 #include "Mdt/ExecutableFile/Elf/FileWriterFile.h"
 #include "Mdt/ExecutableFile/Elf/FileOffsetChanges.h"
 #include <QLatin1String>
+#include <algorithm>
 #include <cassert>
 
 using Mdt::ExecutableFile::Elf::FileWriterFile;
 using Mdt::ExecutableFile::Elf::FileWriterFileLayout;
+using Mdt::ExecutableFile::Elf::FileWriterLayoutPlan;
+using Mdt::ExecutableFile::Elf::RunPathInPlaceEdit;
 using Mdt::ExecutableFile::Elf::FileAllHeaders;
 using Mdt::ExecutableFile::Elf::DynamicSection;
 using Mdt::ExecutableFile::Elf::FileHeader;
 using Mdt::ExecutableFile::Elf::ProgramHeader;
 using Mdt::ExecutableFile::Elf::ProgramHeaderTable;
 using Mdt::ExecutableFile::Elf::SectionHeader;
+using Mdt::ExecutableFile::Elf::SectionAttributeFlag;
+using Mdt::ExecutableFile::Elf::SectionType;
 using Mdt::ExecutableFile::Elf::PartialSymbolTable;
 using Mdt::ExecutableFile::Elf::GlobalOffsetTable;
 using Mdt::ExecutableFile::Elf::GlobalOffsetTableEntry;
 using Mdt::ExecutableFile::Elf::globalOffsetTableEntrySize;
 using Mdt::ExecutableFile::Elf::MoveSectionAlignment;
+using Mdt::ExecutableFile::Elf::StringTable;
+using Mdt::ExecutableFile::ExecutableFileEditTransaction;
 
 FileAllHeaders makeBasicFileAllHeaders()
 {
@@ -809,6 +816,141 @@ TEST_CASE("setRunPath_fileLayout")
   }
 }
 
+TEST_CASE("planRunPath")
+{
+  TestFileSetup setup;
+  FileWriterFile file;
+  FileWriterLayoutPlan plan;
+
+  setup.programHeaderTableOffset = 50;
+  setup.noteGnuBuilIdSectionOffset = 100;
+  setup.noteGnuBuilIdSectionAddress = 1000;
+  setup.gnuHashTableSectionOffset = 140;
+  setup.gnuHashTableSectionAddress = 1040;
+  setup.dynSymOffset = 200;
+  setup.dynamicStringTableOffset = 300;
+  setup.dynamicStringTableAddress = 1300;
+  setup.dynamicSectionOffset = 500;
+  setup.dynamicSectionAddress = 1500;
+  setup.sectionNameStringTableOffset = 5000;
+  setup.sectionHeaderTableOffset = 10'000;
+  setup.runPath = QLatin1String("/opt/libA");
+
+  makeWriterFile(file, setup);
+  const uint64_t originalDynamicStringTableOffset = file.dynamicStringTableOffset();
+  const int64_t originalFileSize = file.minimumSizeToWriteFile();
+
+  SECTION("same RUNPATH")
+  {
+    plan = file.planRunPath( QLatin1String("/opt/libA") );
+    REQUIRE( plan.runPathInPlaceEdit == RunPathInPlaceEdit::Unchanged );
+    REQUIRE( !plan.movesSections() );
+    REQUIRE( !plan.addsLoadSegment );
+    REQUIRE( plan.fileSizeGrowth() == 0 );
+    REQUIRE( plan.touchedPageCount == 0 );
+  }
+
+  SECTION("shorter RUNPATH")
+  {
+    // The references to .dynstr are not known, so the file is rewritten
+    plan = file.planRunPath( QLatin1String("/opt") );
+    REQUIRE( !plan.isInPlace() );
+    REQUIRE( !plan.movesSections() );
+    REQUIRE( !plan.addsLoadSegment );
+    REQUIRE( plan.originalFileSize == originalFileSize );
+    REQUIRE( plan.fileSizeGrowth() == 0 );
+    // .dynstr, .dynamic and the section header table
+    REQUIRE( plan.touchedPageCount == 2 );
+  }
+
+  SECTION("shorter RUNPATH in place")
+  {
+    file.setDynamicStringTableReferencesFromFile({});
+    plan = file.planRunPath( QLatin1String("/opt") );
+    REQUIRE( plan.runPathInPlaceEdit == RunPathInPlaceEdit::OverwriteString );
+    REQUIRE( !plan.movesSections() );
+    REQUIRE( !plan.addsLoadSegment );
+    REQUIRE( plan.fileSizeGrowth() == 0 );
+    // The run path string, DT_RUNPATH and DT_STRSZ
+    REQUIRE( plan.touchedPageCount == 1 );
+  }
+
+  SECTION("much longer RUNPATH")
+  {
+    file.setDynamicStringTableReferencesFromFile({});
+    plan = file.planRunPath( generateStringWithNChars(10000) );
+    REQUIRE( !plan.isInPlace() );
+    REQUIRE( plan.movesSections() );
+    REQUIRE( std::find(plan.movedSectionNames.cbegin(), plan.movedSectionNames.cend(), ".dynstr") != plan.movedSectionNames.cend() );
+    REQUIRE( plan.addsLoadSegment );
+    REQUIRE( plan.fileSizeGrowth() > 10000 );
+    REQUIRE( plan.touchedPageCount > 3 );
+  }
+
+  /*
+   * The file itself must not change
+   */
+  REQUIRE( file.dynamicSection().getRunPath() == QLatin1String("/opt/libA") );
+  REQUIRE( file.dynamicStringTableOffset() == originalDynamicStringTableOffset );
+  REQUIRE( file.minimumSizeToWriteFile() == originalFileSize );
+}
+
+TEST_CASE("planEdits")
+{
+  TestFileSetup setup;
+  FileWriterFile file;
+  FileWriterLayoutPlan plan;
+  ExecutableFileEditTransaction edits;
+
+  setup.programHeaderTableOffset = 50;
+  setup.dynamicStringTableOffset = 300;
+  setup.dynamicStringTableAddress = 1300;
+  setup.dynamicSectionOffset = 500;
+  setup.dynamicSectionAddress = 1500;
+  setup.sectionNameStringTableOffset = 5000;
+  setup.sectionHeaderTableOffset = 10'000;
+
+  makeWriterFile(file, setup);
+
+  SECTION("strip non allocated sections")
+  {
+    // The sections that have a address are loaded
+    FileAllHeaders headers = file.headers();
+    std::vector<SectionHeader> sectionHeaderTable = headers.sectionHeaderTable();
+    for(SectionHeader & header : sectionHeaderTable){
+      if(header.addr != 0){
+        header.flags |= static_cast<uint64_t>(SectionAttributeFlag::Alloc);
+      }
+    }
+    SectionHeader commentSectionHeader;
+    commentSectionHeader.name = ".comment";
+    commentSectionHeader.type = static_cast<uint32_t>(SectionType::ProgramData);
+    commentSectionHeader.offset = 7000;
+    commentSectionHeader.size = 50;
+    commentSectionHeader.addr = 0;
+    commentSectionHeader.addralign = 1;
+    commentSectionHeader.entsize = 0;
+    sectionHeaderTable.push_back(commentSectionHeader);
+    headers.setSectionHeaderTable(sectionHeaderTable);
+    file.setHeadersFromFile(headers);
+
+    StringTable sectionNameStringTable;
+    sectionNameStringTable.appendString(".shstrtab");
+    sectionNameStringTable.appendString(".comment");
+    file.setSectionNameStringTableFromFile(sectionNameStringTable);
+    edits.stripNonAllocatedSections();
+    plan = file.planEdits(edits);
+    REQUIRE( std::find(plan.movedSectionNames.cbegin(), plan.movedSectionNames.cend(), ".shstrtab") != plan.movedSectionNames.cend() );
+    REQUIRE( !plan.addsLoadSegment );
+    REQUIRE( plan.fileSizeGrowth() < 0 );
+    // The rebuilt .shstrtab and the section header table, after the allocated content
+    REQUIRE( plan.touchedPageCount == 1 );
+    // The file itself must not change
+    REQUIRE( file.headers().sectionHeaderTable().size() == sectionHeaderTable.size() );
+    REQUIRE( file.headers().sectionNameStringTableHeader().offset == 5000 );
+  }
+}
+
 TEST_CASE("minimumSizeToWriteFile")
 {
   TestFileSetup setup;
@@ -11,6 +11,7 @@
 #include "Catch2QString.h"
 #include "TestUtils.h"
 #include "TestFileUtils.h"
+#include "TestBinariesUtils.h"
 #include "Mdt/ExecutableFile/Elf/FileReader.h"
 #include "Mdt/ExecutableFile/Elf/FileAllHeadersReader.h"
 #include "Mdt/ExecutableFile/Elf/SymbolTableReader.h"
@@ -23,6 +24,8 @@
 #include "Mdt/ExecutableFile/QRuntimeError.h"
 #include <QTemporaryDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QProcessEnvironment>
 #include <QString>
 #include <QLatin1String>
 #include <QDebug>
@@ -276,6 +279,42 @@ QString getExecutableRunPath(const QString & filePath)
   return elfFile.dynamicSection().getRunPath();
 }
 
+void setRunPathAndWrite(FileWriterFile & elfFile, const QString & filePath, const QString & runPath)
+{
+  using Elf::setFileToMap;
+
+  QFile file;
+
+  elfFile.setRunPath(runPath);
+
+  openFileForWrite(file, filePath);
+  resizeFile( file, elfFile.minimumSizeToWriteFile() );
+  ByteArraySpan map = mapFile(file);
+  REQUIRE( !map.isNull() );
+
+  setFileToMap(map, elfFile);
+
+  REQUIRE( unmapAndCloseFile(file, map) );
+}
+
+/*
+ * The dynamic linker finds the program header table
+ * with PT_PHDR, or in the PT_LOAD segment that covers it
+ */
+bool programHeaderTableIsCoveredByLoadSegment(const FileWriterFile & elfFile)
+{
+  const uint64_t offset = elfFile.fileHeader().phoff;
+  const uint64_t size = static_cast<uint64_t>( elfFile.fileHeader().phnum ) * elfFile.fileHeader().phentsize;
+
+  for(auto it = elfFile.programHeaderTable().cbegin(); it != elfFile.programHeaderTable().cend(); ++it){
+    if( (it->segmentType() == Elf::SegmentType::Load) && (it->offset <= offset) && (offset + size <= it->fileOffsetEnd()) ){
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /*
  * Here we simply read a ELF executable
  * then write it back, without changing anything.
@@ -307,7 +346,8 @@ TEST_CASE("simpleReadWrite")
   map = openAndMapFileForWrite(file, targetFilePath);
   REQUIRE( !map.isNull() );
 
-  setFileToMap(map, elfFile);
+  // Nothing changed, so nothing must be written
+  REQUIRE( setFileToMap(map, elfFile).empty() );
 
   unmapAndCloseFile(file, map);
   REQUIRE( runElfExecutable(targetFilePath) );
@@ -484,6 +524,82 @@ TEST_CASE("editRunPath_SharedLibrary")
   }
 }
 
+/*
+ * The cost based choice rarely moves the program header table,
+ * so force it on a shared library (that has no PT_PHDR)
+ * and on a position independent executable (that has a PT_PHDR)
+ */
+TEST_CASE("editRunPath_moveProgramHeaderTable")
+{
+  using Elf::ProgramHeaderTableGrowthStrategy;
+
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+
+  FileWriterFile elfFile;
+
+  /*
+   * A very long run path moves .dynstr to the end,
+   * so a new PT_LOAD is required
+   */
+  const QString testSharedLibraryDirectory = QFileInfo( testSharedLibraryFilePath() ).absolutePath();
+  const QString runPath = testSharedLibraryDirectory + QLatin1String(":/") + generateStringWithNChars(10000);
+
+  SECTION("shared library")
+  {
+    const QString libraryFilePath = makePath( dir, testSharedLibraryFileName().toLocal8Bit().constData() );
+    const QString executableFilePath = makePath(dir, "executable");
+    REQUIRE( copyFile(testSharedLibraryFilePath(), libraryFilePath) );
+    REQUIRE( copyFile(testExecutableFilePath(), executableFilePath) );
+
+    readElfFile(elfFile, libraryFilePath);
+    REQUIRE( elfFile.seemsValid() );
+    const uint64_t originalProgramHeaderTableOffset = elfFile.fileHeader().phoff;
+
+    elfFile.forceProgramHeaderTableGrowthStrategy(ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable);
+    setRunPathAndWrite(elfFile, libraryFilePath, runPath);
+
+    readElfFile(elfFile, libraryFilePath);
+    REQUIRE( elfFile.seemsValid() );
+    REQUIRE( elfFile.fileHeader().phoff > originalProgramHeaderTableOffset );
+    REQUIRE( programHeaderTableIsCoveredByLoadSegment(elfFile) );
+    REQUIRE( elfFile.dynamicSection().getRunPath() == runPath );
+    REQUIRE( lintElfFile(libraryFilePath) );
+
+    // The executable must load the edited library, and run
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert( QLatin1String("LD_LIBRARY_PATH"), dir.path() );
+    env.insert( QLatin1String("LD_BIND_NOW"), QLatin1String("1") );
+    REQUIRE( setFileExePermissionsIfRequired(executableFilePath) );
+    REQUIRE( runExecutable(executableFilePath, QStringList(), env) );
+  }
+
+  SECTION("position independent executable")
+  {
+    const QString executableFilePath = makePath(dir, "executable");
+    REQUIRE( copyFile(testExecutableFilePath(), executableFilePath) );
+
+    readElfFile(elfFile, executableFilePath);
+    REQUIRE( elfFile.seemsValid() );
+    REQUIRE( elfFile.fileHeader().objectFileType() == Elf::ObjectFileType::SharedObject );
+    REQUIRE( elfFile.headers().containsProgramHeaderTableProgramHeader() );
+    const uint64_t originalProgramHeaderTableOffset = elfFile.fileHeader().phoff;
+
+    elfFile.forceProgramHeaderTableGrowthStrategy(ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable);
+    setRunPathAndWrite(elfFile, executableFilePath, runPath);
+
+    readElfFile(elfFile, executableFilePath);
+    REQUIRE( elfFile.seemsValid() );
+    REQUIRE( elfFile.fileHeader().phoff > originalProgramHeaderTableOffset );
+    REQUIRE( elfFile.headers().programHeaderTableProgramHeader().offset == elfFile.fileHeader().phoff );
+    REQUIRE( programHeaderTableIsCoveredByLoadSegment(elfFile) );
+    REQUIRE( elfFile.dynamicSection().getRunPath() == runPath );
+    REQUIRE( lintElfFile(executableFilePath) );
+    REQUIRE( runElfExecutable(executableFilePath) );
+  }
+}
+
 TEST_CASE("sandboxWith_libasan", "[.]")
 {
   using Elf::setFileToMap;
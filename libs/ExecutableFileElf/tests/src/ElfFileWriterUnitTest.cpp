@@ -420,6 +420,27 @@ TEST_CASE("shiftBytesToEnd")
   }
 }
 
+TEST_CASE("shiftFileContentInMap")
+{
+  using Elf::shiftFileContentInMap;
+  using Elf::FileContentShift;
+
+  uchar charArray[10] = {'A','B','C','D','E','F',0,0,0,0};
+  ByteArraySpan map = arraySpanFromArray( charArray, sizeof(charArray) );
+
+  SECTION("{A,B,C,D,E,F} -> {A,B,0,0,C,D,E,F}")
+  {
+    shiftFileContentInMap(map, {{2, 2}}, 6);
+    REQUIRE( arraysAreEqual(map.subSpan(0, 8), {'A','B',0,0,'C','D','E','F'}) );
+  }
+
+  SECTION("{A,B,C,D,E,F} -> {A,0,B,C,D,0,0,E,F}")
+  {
+    shiftFileContentInMap(map, {{1, 1}, {5, 2}}, 6);
+    REQUIRE( arraysAreEqual(map.subSpan(0, 9), {'A',0,'B','C','D',0,0,'E','F'}) );
+  }
+}
+
 TEST_CASE("replaceBytes")
 {
   using Elf::replaceBytes;
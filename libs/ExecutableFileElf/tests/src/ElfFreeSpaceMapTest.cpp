@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileAllHeadersTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/FreeSpaceMap.h"
+
+using Mdt::ExecutableFile::Elf::FreeSpaceMap;
+using Mdt::ExecutableFile::Elf::OffsetRange;
+using Mdt::ExecutableFile::Elf::FileAllHeaders;
+using Mdt::ExecutableFile::Elf::ProgramHeader;
+using Mdt::ExecutableFile::Elf::SegmentType;
+using Mdt::ExecutableFile::Elf::SegmentPermission;
+using Mdt::ExecutableFile::Elf::SegmentPermissions;
+
+bool mapContainsRange(const FreeSpaceMap & map, uint64_t begin, uint64_t end)
+{
+  for(const OffsetRange & range : map.ranges()){
+    if( (range.begin() <= begin) && (range.end() >= end) ){
+      return true;
+    }
+  }
+  return false;
+}
+
+bool mapOverlapsRange(const FreeSpaceMap & map, uint64_t begin, uint64_t end)
+{
+  for(const OffsetRange & range : map.ranges()){
+    if( (range.begin() < end) && (range.end() > begin) ){
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST_CASE("addFreeRange")
+{
+  FreeSpaceMap map;
+
+  REQUIRE( map.isEmpty() );
+
+  SECTION("empty range")
+  {
+    map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(10, 10) );
+    REQUIRE( map.isEmpty() );
+  }
+
+  SECTION("disjoint ranges are sorted")
+  {
+    map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(100, 110) );
+    map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(10, 20) );
+
+    REQUIRE( map.ranges().size() == 2 );
+    REQUIRE( map.ranges()[0].begin() == 10 );
+    REQUIRE( map.ranges()[1].begin() == 100 );
+    REQUIRE( map.byteCount() == 20 );
+  }
+
+  SECTION("adjacent and overlapping ranges are merged")
+  {
+    map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(10, 20) );
+    map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(30, 40) );
+    map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(20, 35) );
+
+    REQUIRE( map.ranges().size() == 1 );
+    REQUIRE( map.ranges()[0].begin() == 10 );
+    REQUIRE( map.ranges()[0].end() == 40 );
+  }
+}
+
+TEST_CASE("removeRange")
+{
+  FreeSpaceMap map;
+  map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(10, 100) );
+
+  SECTION("split")
+  {
+    map.removeRange( OffsetRange::fromBeginAndEndOffsets(40, 50) );
+
+    REQUIRE( map.ranges().size() == 2 );
+    REQUIRE( map.ranges()[0].begin() == 10 );
+    REQUIRE( map.ranges()[0].end() == 40 );
+    REQUIRE( map.ranges()[1].begin() == 50 );
+    REQUIRE( map.ranges()[1].end() == 100 );
+  }
+
+  SECTION("shrink the beginning")
+  {
+    map.removeRange( OffsetRange::fromBeginAndEndOffsets(0, 20) );
+
+    REQUIRE( map.ranges().size() == 1 );
+    REQUIRE( map.ranges()[0].begin() == 20 );
+    REQUIRE( map.ranges()[0].end() == 100 );
+  }
+
+  SECTION("remove all")
+  {
+    map.removeRange( OffsetRange::fromBeginAndEndOffsets(0, 200) );
+
+    REQUIRE( map.isEmpty() );
+  }
+}
+
+TEST_CASE("findFirstFit")
+{
+  FreeSpaceMap map;
+  map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(10, 20) );
+  map.addFreeRange( OffsetRange::fromBeginAndEndOffsets(33, 60) );
+
+  SECTION("fits in the first range")
+  {
+    const OffsetRange range = map.findFirstFit(10, 1);
+
+    REQUIRE( range.begin() == 10 );
+    REQUIRE( range.byteCount() == 10 );
+  }
+
+  SECTION("too big for the first range")
+  {
+    const OffsetRange range = map.findFirstFit(11, 1);
+
+    REQUIRE( range.begin() == 33 );
+    REQUIRE( range.byteCount() == 11 );
+  }
+
+  SECTION("aligned")
+  {
+    const OffsetRange range = map.findFirstFit(8, 16);
+
+    REQUIRE( range.begin() == 48 );
+    REQUIRE( range.byteCount() == 8 );
+  }
+
+  SECTION("no fit")
+  {
+    REQUIRE( map.findFirstFit(28, 1).isEmpty() );
+    REQUIRE( map.findFirstFit(16, 16).isEmpty() );
+  }
+}
+
+TEST_CASE("makeFreeSpaceMapInLoadSegments")
+{
+  TestHeadersSetup setup;
+  setup.programHeaderTableOffset = 64;
+  setup.dynamicStringTableOffset = 300;
+  setup.dynamicStringTableAddress = 300;
+  setup.dynamicStringTableSize = 50;
+  setup.dynamicSectionOffset = 500;
+  setup.dynamicSectionAddress = 500;
+  setup.dynamicSectionSize = 100;
+  setup.sectionNameStringTableOffset = 5000;
+  setup.sectionHeaderTableOffset = 10'000;
+
+  FileAllHeaders headers = makeTestHeaders(setup);
+
+  ProgramHeader loadProgramHeader;
+  loadProgramHeader.setSegmentType(SegmentType::Load);
+  loadProgramHeader.setPermissions(SegmentPermission::Read);
+  loadProgramHeader.offset = 0;
+  loadProgramHeader.vaddr = 0;
+  loadProgramHeader.paddr = 0;
+  loadProgramHeader.filesz = 1000;
+  loadProgramHeader.memsz = 1000;
+  loadProgramHeader.align = 0x1000;
+  headers.addProgramHeader(loadProgramHeader);
+
+  const uint64_t programHeaderTableEnd = 64 + (headers.fileHeader().phnum + 1) * 56;
+  const uint16_t dynamicStringTableIndex = headers.dynamicStringTableSectionHeaderIndex();
+
+  SECTION("read only")
+  {
+    const FreeSpaceMap map = makeFreeSpaceMapInLoadSegments(headers, SegmentPermission::Read, {}, 1);
+
+    REQUIRE( !mapOverlapsRange(map, 0, programHeaderTableEnd) );
+    REQUIRE( mapContainsRange(map, programHeaderTableEnd, 300) );
+    REQUIRE( !mapOverlapsRange(map, 300, 350) );
+    REQUIRE( mapContainsRange(map, 350, 500) );
+    REQUIRE( !mapOverlapsRange(map, 500, 600) );
+    REQUIRE( mapContainsRange(map, 600, 1000) );
+    REQUIRE( !mapOverlapsRange(map, 1000, 20'000) );
+  }
+
+  SECTION("no program header is reserved")
+  {
+    const uint64_t programHeaderTableCurrentEnd = 64 + headers.fileHeader().phnum * 56;
+    const FreeSpaceMap map = makeFreeSpaceMapInLoadSegments(headers, SegmentPermission::Read, {}, 0);
+
+    REQUIRE( !mapOverlapsRange(map, 0, programHeaderTableCurrentEnd) );
+    REQUIRE( mapContainsRange(map, programHeaderTableCurrentEnd, 300) );
+  }
+
+  SECTION("the .dynstr is ignored")
+  {
+    const FreeSpaceMap map = makeFreeSpaceMapInLoadSegments(headers, SegmentPermission::Read, {dynamicStringTableIndex}, 1);
+
+    REQUIRE( mapContainsRange(map, programHeaderTableEnd, 500) );
+  }
+
+  SECTION("no writable segment")
+  {
+    const SegmentPermissions permissions = SegmentPermission::Read | SegmentPermission::Write;
+    const FreeSpaceMap map = makeFreeSpaceMapInLoadSegments(headers, permissions, {}, 1);
+
+    REQUIRE( map.isEmpty() );
+  }
+
+  SECTION("findLoadProgramHeaderContainingFileRange")
+  {
+    const ProgramHeader *programHeader = findLoadProgramHeaderContainingFileRange(
+      headers.programHeaderTable(), OffsetRange::fromBeginAndEndOffsets(350, 400)
+    );
+    REQUIRE( programHeader != nullptr );
+    REQUIRE( programHeader->filesz == 1000 );
+
+    REQUIRE( findLoadProgramHeaderContainingFileRange(
+      headers.programHeaderTable(), OffsetRange::fromBeginAndEndOffsets(950, 1050) ) == nullptr );
+  }
+}
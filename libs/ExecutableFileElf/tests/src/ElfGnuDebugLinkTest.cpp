@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileIoTestUtils.h"
+#include "ByteArraySpanTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLink.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLinkReader.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLinkWriter.h"
+#include <vector>
+#include <cstdint>
+
+using namespace Mdt::ExecutableFile::Elf;
+using Mdt::ExecutableFile::ByteArraySpan;
+
+uint32_t byteWiseCrc(const std::vector<unsigned char> & data)
+{
+  uint32_t crc = 0xFFFFFFFF;
+
+  for(unsigned char c : data){
+    crc ^= c;
+    for(int bit = 0; bit < 8; ++bit){
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+    }
+  }
+
+  return ~crc;
+}
+
+TEST_CASE("byteCount")
+{
+  GnuDebugLink link;
+
+  SECTION("name and null byte take 4 bytes")
+  {
+    link.fileName = "a.d";
+    REQUIRE( link.byteCount() == 8 );
+  }
+
+  SECTION("name and null byte take 5 bytes")
+  {
+    link.fileName = "a.so";
+    REQUIRE( link.byteCount() == 12 );
+  }
+}
+
+TEST_CASE("updateGnuDebugLinkCrc")
+{
+  std::vector<unsigned char> data;
+
+  SECTION("empty")
+  {
+    REQUIRE( updateGnuDebugLinkCrc( 0, ByteArraySpan() ) == 0 );
+  }
+
+  SECTION("check value")
+  {
+    data = {'1','2','3','4','5','6','7','8','9'};
+    const ByteArraySpan array = arraySpanFromArray( data.data(), static_cast<int64_t>( data.size() ) );
+
+    REQUIRE( updateGnuDebugLinkCrc(0, array) == 0xCBF43926 );
+  }
+
+  SECTION("same as the byte-wise CRC for any size")
+  {
+    for(int size = 1; size < 40; ++size){
+      data.push_back( static_cast<unsigned char>(size * 37 + 11) );
+      const ByteArraySpan array = arraySpanFromArray( data.data(), static_cast<int64_t>( data.size() ) );
+      REQUIRE( updateGnuDebugLinkCrc(0, array) == byteWiseCrc(data) );
+    }
+  }
+
+  SECTION("in several parts")
+  {
+    for(int i = 0; i < 1000; ++i){
+      data.push_back( static_cast<unsigned char>(i * 7) );
+    }
+    const ByteArraySpan array = arraySpanFromArray( data.data(), static_cast<int64_t>( data.size() ) );
+
+    uint32_t crc = 0;
+    crc = updateGnuDebugLinkCrc( crc, array.subSpan(0, 13) );
+    crc = updateGnuDebugLinkCrc( crc, array.subSpan(13, 500) );
+    crc = updateGnuDebugLinkCrc( crc, array.subSpan(513, 487) );
+
+    REQUIRE( crc == updateGnuDebugLinkCrc(0, array) );
+  }
+}
+
+TEST_CASE("setGnuDebugLinkToArray")
+{
+  GnuDebugLink link;
+  link.fileName = "a.so";
+  link.crc = 0x12345678;
+
+  uchar arrayData[12];
+  const ByteArraySpan array = arraySpanFromArray( arrayData, sizeof(arrayData) );
+
+  SECTION("little-endian")
+  {
+    uchar expectedArrayData[12] = {'a','.','s','o','\0',0,0,0,0x78,0x56,0x34,0x12};
+    const ByteArraySpan expectedArray = arraySpanFromArray( expectedArrayData, sizeof(expectedArrayData) );
+
+    setGnuDebugLinkToArray(array, link, DataFormat::Data2LSB);
+    REQUIRE( arraysAreEqual(array, expectedArray) );
+  }
+
+  SECTION("big-endian")
+  {
+    uchar expectedArrayData[12] = {'a','.','s','o','\0',0,0,0,0x12,0x34,0x56,0x78};
+    const ByteArraySpan expectedArray = arraySpanFromArray( expectedArrayData, sizeof(expectedArrayData) );
+
+    setGnuDebugLinkToArray(array, link, DataFormat::Data2MSB);
+    REQUIRE( arraysAreEqual(array, expectedArray) );
+  }
+}
+
+TEST_CASE("extractGnuDebugLink")
+{
+  GnuDebugLink link;
+  link.fileName = "app.debug";
+  link.crc = 0x9abcdef0;
+
+  std::vector<unsigned char> fileData( static_cast<size_t>(100 + link.byteCount()), 0 );
+  const ByteArraySpan map = arraySpanFromArray( fileData.data(), static_cast<int64_t>( fileData.size() ) );
+  setGnuDebugLinkToArray(map.subSpan(100, link.byteCount()), link, DataFormat::Data2LSB);
+
+  SectionHeader sectionHeader;
+  sectionHeader.name = ".gnu_debuglink";
+  sectionHeader.type = static_cast<uint32_t>(SectionType::ProgramData);
+  sectionHeader.offset = 100;
+  sectionHeader.size = static_cast<uint64_t>( link.byteCount() );
+
+  SECTION("complete section")
+  {
+    const GnuDebugLink readLink = extractGnuDebugLink(map, sectionHeader, DataFormat::Data2LSB);
+    REQUIRE( readLink.fileName == link.fileName );
+    REQUIRE( readLink.crc == link.crc );
+  }
+
+  SECTION("section without the CRC")
+  {
+    sectionHeader.size -= 4;
+
+    const GnuDebugLink readLink = extractGnuDebugLink(map, sectionHeader, DataFormat::Data2LSB);
+    REQUIRE( readLink.fileName == link.fileName );
+    REQUIRE( readLink.crc == 0 );
+  }
+}
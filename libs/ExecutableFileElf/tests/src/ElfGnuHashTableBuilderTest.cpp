@@ -0,0 +1,243 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "Mdt/ExecutableFile/Elf/GnuHashTableBuilder.h"
+#include <string>
+#include <vector>
+
+using namespace Mdt::ExecutableFile::Elf;
+
+/*
+ * Lookup like the dynamic loader does
+ */
+bool gnuHashTableContainsSymbol(const GnuHashTable & table, const std::vector<uint32_t> & hashes, uint32_t hash, Class _class)
+{
+  const uint32_t entryBits = static_cast<uint32_t>( GnuHashTable::bloomEntryByteCount(_class) * 8 );
+
+  const uint64_t bloomWord = table.bloom[ (hash / entryBits) & (table.bloomSize() - 1) ];
+  const uint64_t mask = ( uint64_t(1) << (hash % entryBits) ) | ( uint64_t(1) << ( (hash >> table.bloomShift) % entryBits ) );
+  if( (bloomWord & mask) != mask ){
+    return false;
+  }
+
+  uint32_t symbolIndex = table.buckets[hash % table.bucketCount()];
+  if(symbolIndex == 0){
+    return false;
+  }
+
+  while(true){
+    const uint32_t chainHash = table.chain[symbolIndex - table.symoffset];
+    if( ( (chainHash | 1) == (hash | 1) ) && (hashes[symbolIndex - table.symoffset] == hash) ){
+      return true;
+    }
+    if( (chainHash & 1) != 0 ){
+      return false;
+    }
+    ++symbolIndex;
+  }
+}
+
+std::vector<uint32_t> makeHashes(int count)
+{
+  std::vector<uint32_t> hashes;
+
+  for(int i = 0; i < count; ++i){
+    hashes.push_back( gnuHash( "symbol_" + std::to_string(i) ) );
+  }
+
+  return hashes;
+}
+
+std::vector<uint32_t> sortHashesForBucketCount(const std::vector<uint32_t> & hashes, uint32_t bucketCount)
+{
+  std::vector<uint32_t> sortedHashes;
+
+  for(size_t index : gnuHashSymbolOrder(hashes, bucketCount)){
+    sortedHashes.push_back(hashes[index]);
+  }
+
+  return sortedHashes;
+}
+
+TEST_CASE("gnuHash")
+{
+  REQUIRE( gnuHash("") == 0x00001505 );
+  REQUIRE( gnuHash("printf") == 0x156b2bb8 );
+  REQUIRE( gnuHash("exit") == 0x7c967e3f );
+  REQUIRE( gnuHash("syscall") == 0xbac212a0 );
+}
+
+TEST_CASE("gnuHashBucketCountForSymbolCount")
+{
+  REQUIRE( gnuHashBucketCountForSymbolCount(0) == 1 );
+  REQUIRE( gnuHashBucketCountForSymbolCount(2) == 1 );
+  REQUIRE( gnuHashBucketCountForSymbolCount(21) == 17 );
+  REQUIRE( gnuHashBucketCountForSymbolCount(300) == 263 );
+  REQUIRE( gnuHashBucketCountForSymbolCount(2349) == 2053 );
+  REQUIRE( gnuHashBucketCountForSymbolCount(1'000'000) == 262147 );
+}
+
+TEST_CASE("gnuHashBloomParametersForSymbolCount")
+{
+  SECTION("64-bit")
+  {
+    GnuHashBloomParameters parameters = gnuHashBloomParametersForSymbolCount(1, Class::Class64);
+    REQUIRE( parameters.bloomSize == 1 );
+    REQUIRE( parameters.bloomShift == 6 );
+
+    parameters = gnuHashBloomParametersForSymbolCount(21, Class::Class64);
+    REQUIRE( parameters.bloomSize == 2 );
+    REQUIRE( parameters.bloomShift == 7 );
+
+    parameters = gnuHashBloomParametersForSymbolCount(2349, Class::Class64);
+    REQUIRE( parameters.bloomSize == 256 );
+    REQUIRE( parameters.bloomShift == 14 );
+  }
+
+  SECTION("32-bit")
+  {
+    GnuHashBloomParameters parameters = gnuHashBloomParametersForSymbolCount(1, Class::Class32);
+    REQUIRE( parameters.bloomSize == 1 );
+    REQUIRE( parameters.bloomShift == 5 );
+
+    parameters = gnuHashBloomParametersForSymbolCount(21, Class::Class32);
+    REQUIRE( parameters.bloomSize == 4 );
+    REQUIRE( parameters.bloomShift == 7 );
+  }
+}
+
+TEST_CASE("symbolsAreInGnuHashOrder")
+{
+  SECTION("empty")
+  {
+    REQUIRE( symbolsAreInGnuHashOrder({}, 3) );
+  }
+
+  SECTION("a single bucket accepts any order")
+  {
+    REQUIRE( symbolsAreInGnuHashOrder({5, 1, 4, 2}, 1) );
+  }
+
+  SECTION("buckets are contiguous")
+  {
+    REQUIRE( symbolsAreInGnuHashOrder({3, 6, 1, 4, 2}, 3) );
+  }
+
+  SECTION("bucket 0 appears twice")
+  {
+    REQUIRE( !symbolsAreInGnuHashOrder({3, 1, 6}, 3) );
+  }
+}
+
+TEST_CASE("gnuHashSymbolOrder")
+{
+  const std::vector<uint32_t> hashes = {4, 3, 7, 6, 2};
+
+  const std::vector<size_t> order = gnuHashSymbolOrder(hashes, 3);
+
+  REQUIRE( order == std::vector<size_t>{1, 3, 0, 2, 4} );
+  REQUIRE( symbolsAreInGnuHashOrder(sortHashesForBucketCount(hashes, 3), 3) );
+}
+
+TEST_CASE("makeGnuHashTable")
+{
+  const Class elfClass = Class::Class64;
+  const uint32_t symoffset = 5;
+  const uint32_t bucketCount = 17;
+  const std::vector<uint32_t> hashes = sortHashesForBucketCount(makeHashes(40), bucketCount);
+  const GnuHashBloomParameters bloomParameters = gnuHashBloomParametersForSymbolCount(40, elfClass);
+
+  const GnuHashTable table = makeGnuHashTable(hashes, symoffset, bucketCount, bloomParameters, elfClass);
+
+  REQUIRE( table.symoffset == symoffset );
+  REQUIRE( table.bucketCount() == bucketCount );
+  REQUIRE( table.bloomSize() == bloomParameters.bloomSize );
+  REQUIRE( table.bloomShift == bloomParameters.bloomShift );
+  REQUIRE( table.chain.size() == hashes.size() );
+  REQUIRE( (table.chain.back() & 1) == 1 );
+
+  SECTION("all symbols are found")
+  {
+    for(uint32_t hash : hashes){
+      REQUIRE( gnuHashTableContainsSymbol(table, hashes, hash, elfClass) );
+    }
+  }
+
+  SECTION("most of the undefined symbols are rejected by the bloom filter")
+  {
+    int rejectedCount = 0;
+    for(int i = 0; i < 1000; ++i){
+      const uint32_t hash = gnuHash( "undefined_" + std::to_string(i) );
+      const uint64_t bloomWord = table.bloom[ (hash / 64) & (table.bloomSize() - 1) ];
+      const uint64_t mask = ( uint64_t(1) << (hash % 64) ) | ( uint64_t(1) << ( (hash >> table.bloomShift) % 64 ) );
+      if( (bloomWord & mask) != mask ){
+        ++rejectedCount;
+      }
+      REQUIRE( !gnuHashTableContainsSymbol(table, hashes, hash, elfClass) );
+    }
+    REQUIRE( rejectedCount > 800 );
+  }
+}
+
+TEST_CASE("makeOptimizedGnuHashTable")
+{
+  const Class elfClass = Class::Class64;
+  const uint32_t symoffset = 3;
+  const std::vector<uint32_t> hashes = sortHashesForBucketCount(makeHashes(300), 263);
+
+  SECTION("a table made by a recent linker is kept")
+  {
+    const GnuHashTable linkerTable = makeGnuHashTable( hashes, symoffset, 263, gnuHashBloomParametersForSymbolCount(300, elfClass), elfClass );
+
+    const GnuHashTable table = makeOptimizedGnuHashTable(hashes, linkerTable, elfClass);
+
+    REQUIRE( gnuHashTablesAreEqual(table, linkerTable) );
+  }
+
+  SECTION("a too small bloom filter is enlarged")
+  {
+    GnuHashBloomParameters smallBloomParameters;
+    smallBloomParameters.bloomSize = 1;
+    smallBloomParameters.bloomShift = 6;
+    const GnuHashTable oldTable = makeGnuHashTable(hashes, symoffset, 263, smallBloomParameters, elfClass);
+
+    const GnuHashTable table = makeOptimizedGnuHashTable(hashes, oldTable, elfClass);
+
+    REQUIRE( table.bucketCount() == 263 );
+    REQUIRE( table.bloomSize() == 32 );
+    REQUIRE( table.byteCount(elfClass) > oldTable.byteCount(elfClass) );
+  }
+
+  SECTION("more buckets are used if the symbols are already in order for them")
+  {
+    const GnuHashTable oldTable = makeGnuHashTable( hashes, symoffset, 1, gnuHashBloomParametersForSymbolCount(300, elfClass), elfClass );
+
+    const GnuHashTable table = makeOptimizedGnuHashTable(hashes, oldTable, elfClass);
+
+    REQUIRE( table.bucketCount() == 263 );
+    for(uint32_t hash : hashes){
+      REQUIRE( gnuHashTableContainsSymbol(table, hashes, hash, elfClass) );
+    }
+  }
+
+  SECTION("the count of buckets is kept if the symbols are not in order for the new count")
+  {
+    const std::vector<uint32_t> unsortedHashes = makeHashes(300);
+    const GnuHashTable oldTable = makeGnuHashTable( unsortedHashes, symoffset, 1, gnuHashBloomParametersForSymbolCount(300, elfClass), elfClass );
+
+    const GnuHashTable table = makeOptimizedGnuHashTable(unsortedHashes, oldTable, elfClass);
+
+    REQUIRE( table.bucketCount() == 1 );
+    for(uint32_t hash : unsortedHashes){
+      REQUIRE( gnuHashTableContainsSymbol(table, unsortedHashes, hash, elfClass) );
+    }
+  }
+}
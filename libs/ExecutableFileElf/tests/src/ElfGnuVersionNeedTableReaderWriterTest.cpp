@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileIoTestUtils.h"
+#include "ByteArraySpanTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTableReader.h"
+#include "Mdt/ExecutableFile/Elf/GnuVersionNeedTableWriter.h"
+#include "Mdt/ExecutableFile/Elf/HashTable.h"
+#include <vector>
+
+using namespace Mdt::ExecutableFile::Elf;
+using Mdt::ExecutableFile::ByteArraySpan;
+
+TEST_CASE("elfHash")
+{
+  REQUIRE( elfHash("") == 0 );
+  REQUIRE( elfHash("GLIBC_2.2.5") == 0x09691a75 );
+  REQUIRE( elfHash("GLIBC_ABI_DT_RELR") == 0x0fd0e42 );
+}
+
+TEST_CASE("GnuVersionNeedTable")
+{
+  GnuVersionNeedTable table;
+  REQUIRE( table.isEmpty() );
+  REQUIRE( table.byteCount() == 0 );
+  REQUIRE( table.highestVersionIndex() == 0 );
+
+  GnuVersionNeedEntry entry;
+  GnuVersionNeedAuxEntry auxEntry;
+  auxEntry.other = 3;
+  entry.auxEntries.push_back(auxEntry);
+  auxEntry.other = 2;
+  entry.auxEntries.push_back(auxEntry);
+  table.entries.push_back(entry);
+
+  REQUIRE( !table.isEmpty() );
+  REQUIRE( table.byteCount() == 48 );
+  REQUIRE( table.highestVersionIndex() == 3 );
+}
+
+TEST_CASE("setGnuVersionNeedTableToArray_tableFromArray")
+{
+  GnuVersionNeedTable table;
+  Ident ident;
+
+  GnuVersionNeedEntry libA;
+  libA.file = 0x10;
+  GnuVersionNeedAuxEntry auxEntry;
+  auxEntry.hash = 0x09691a75;
+  auxEntry.other = 2;
+  auxEntry.name = 0x20;
+  libA.auxEntries.push_back(auxEntry);
+  auxEntry.hash = 0x0fd0e42;
+  auxEntry.other = 4;
+  auxEntry.name = 0x30;
+  libA.auxEntries.push_back(auxEntry);
+  table.entries.push_back(libA);
+
+  GnuVersionNeedEntry libB;
+  libB.file = 0x40;
+  auxEntry.hash = 0x12345678;
+  auxEntry.flags = 2;
+  auxEntry.other = 3;
+  auxEntry.name = 0x50;
+  libB.auxEntries.push_back(auxEntry);
+  table.entries.push_back(libB);
+
+  REQUIRE( table.byteCount() == 80 );
+
+  SECTION("32-bit big-endian")
+  {
+    ident = make32BitBigEndianIdent();
+  }
+
+  SECTION("64-bit little-endian")
+  {
+    ident = make64BitLittleEndianIdent();
+  }
+
+  uchar arrayData[80] = {};
+  const ByteArraySpan array = arraySpanFromArray( arrayData, sizeof(arrayData) );
+
+  setGnuVersionNeedTableToArray(array, table, ident);
+  const GnuVersionNeedTable readTable = GnuVersionNeedTableReader::tableFromArray(array, ident, 2);
+
+  REQUIRE( readTable.entries.size() == 2 );
+  REQUIRE( readTable.entries[0].version == 1 );
+  REQUIRE( readTable.entries[0].file == 0x10 );
+  REQUIRE( readTable.entries[0].auxEntries.size() == 2 );
+  REQUIRE( readTable.entries[0].auxEntries[1].hash == 0x0fd0e42 );
+  REQUIRE( readTable.entries[0].auxEntries[1].other == 4 );
+  REQUIRE( readTable.entries[0].auxEntries[1].name == 0x30 );
+  REQUIRE( readTable.entries[1].file == 0x40 );
+  REQUIRE( readTable.entries[1].auxEntries.size() == 1 );
+  REQUIRE( readTable.entries[1].auxEntries[0].hash == 0x12345678 );
+  REQUIRE( readTable.entries[1].auxEntries[0].flags == 2 );
+  REQUIRE( readTable.entries[1].auxEntries[0].other == 3 );
+  REQUIRE( readTable.highestVersionIndex() == 4 );
+}
+
+TEST_CASE("tableFromArray_corrupted")
+{
+  const Ident ident = make64BitLittleEndianIdent();
+
+  uchar arrayData[24] = {
+    // vn_version, vn_cnt
+    1,0, 1,0,
+    // vn_file
+    0x10,0,0,0,
+    // vn_aux
+    16,0,0,0,
+    // vn_next
+    0,0,0,0,
+    // Truncated Elf_Vernaux
+    0,0,0,0, 0,0,0,0
+  };
+  const ByteArraySpan array = arraySpanFromArray( arrayData, sizeof(arrayData) );
+
+  REQUIRE_THROWS_AS( GnuVersionNeedTableReader::tableFromArray(array, ident, 1), GnuVersionNeedTableReadError );
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Mdt/ExecutableFile/Elf/ProgramHeaderTableGrowthStrategy.h"
+
+using Mdt::ExecutableFile::Elf::LayoutCost;
+using Mdt::ExecutableFile::Elf::ProgramHeaderTableGrowthStrategy;
+using Mdt::ExecutableFile::Elf::chooseProgramHeaderTableGrowthStrategy;
+using Mdt::ExecutableFile::Elf::pageCountForByteCount;
+
+LayoutCost makeValidCost(uint64_t bytesCopied, uint64_t fileGrowth)
+{
+  LayoutCost cost;
+
+  cost.isValid = true;
+  cost.bytesCopied = bytesCopied;
+  cost.fileGrowth = fileGrowth;
+  cost.newSegmentCount = 1;
+  cost.pagesTouched = pageCountForByteCount(bytesCopied, 4096);
+
+  return cost;
+}
+
+
+TEST_CASE("pageCountForByteCount")
+{
+  REQUIRE( pageCountForByteCount(0, 4096) == 0 );
+  REQUIRE( pageCountForByteCount(1, 4096) == 1 );
+  REQUIRE( pageCountForByteCount(4096, 4096) == 1 );
+  REQUIRE( pageCountForByteCount(4097, 4096) == 2 );
+}
+
+TEST_CASE("LayoutCost_score")
+{
+  const LayoutCost cost = makeValidCost(100, 200);
+
+  REQUIRE( cost.score(4096) == 100 + 200 + 4096 * 2 );
+}
+
+TEST_CASE("chooseProgramHeaderTableGrowthStrategy")
+{
+  const uint64_t pageSize = 4096;
+  LayoutCost moveFirstSectionsCost;
+  LayoutCost moveProgramHeaderTableCost;
+
+  SECTION("none is valid")
+  {
+    REQUIRE( chooseProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, pageSize)
+             == ProgramHeaderTableGrowthStrategy::MoveFirstSections );
+  }
+
+  SECTION("only moving the first sections is valid")
+  {
+    moveFirstSectionsCost = makeValidCost(10000, 20000);
+    REQUIRE( chooseProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, pageSize)
+             == ProgramHeaderTableGrowthStrategy::MoveFirstSections );
+  }
+
+  SECTION("only moving the program header table is valid")
+  {
+    moveProgramHeaderTableCost = makeValidCost(10000, 20000);
+    REQUIRE( chooseProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, pageSize)
+             == ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable );
+  }
+
+  SECTION("moving the first sections is cheaper")
+  {
+    moveFirstSectionsCost = makeValidCost(2564, 2804);
+    moveProgramHeaderTableCost = makeValidCost(3220, 7556);
+    REQUIRE( chooseProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, pageSize)
+             == ProgramHeaderTableGrowthStrategy::MoveFirstSections );
+  }
+
+  SECTION("moving the program header table is cheaper")
+  {
+    moveFirstSectionsCost = makeValidCost(20000, 24000);
+    moveProgramHeaderTableCost = makeValidCost(3220, 7556);
+    REQUIRE( chooseProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, pageSize)
+             == ProgramHeaderTableGrowthStrategy::MoveProgramHeaderTable );
+  }
+
+  SECTION("same cost")
+  {
+    moveFirstSectionsCost = makeValidCost(3000, 4000);
+    moveProgramHeaderTableCost = makeValidCost(3000, 4000);
+    REQUIRE( chooseProgramHeaderTableGrowthStrategy(moveFirstSectionsCost, moveProgramHeaderTableCost, pageSize)
+             == ProgramHeaderTableGrowthStrategy::MoveFirstSections );
+  }
+}
@@ -145,6 +145,25 @@ TEST_CASE("notesSegment")
     table.addHeaderFromFile( makeNullProgramHeader() );
     REQUIRE( !table.containsNoteProgramHeader() );
   }
+
+  SECTION("a note that is only in the file is not the PT_NOTE header")
+  {
+    noteHeader = makeNoteProgramHeader();
+    noteHeader.offset = 160;
+    noteHeader.filesz = 32;
+    noteHeader.memsz = 32;
+    table.addHeaderFromFile(noteHeader);
+
+    ProgramHeader deployStampNoteHeader = makeNoteProgramHeader();
+    deployStampNoteHeader.offset = 5000;
+    deployStampNoteHeader.filesz = 60;
+    deployStampNoteHeader.memsz = 0;
+    REQUIRE( deployStampNoteHeader.isNoteOnlyInFile() );
+    table.addHeaderFromFile(deployStampNoteHeader);
+
+    REQUIRE( table.containsNoteProgramHeader() );
+    REQUIRE( table.noteProgramHeader().offset == 160 );
+  }
 }
 
 TEST_CASE("gnuRelRoHeader")
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileIoTestUtils.h"
+#include "ByteArraySpanTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include <vector>
+
+using Mdt::ExecutableFile::ByteArraySpan;
+using Mdt::ExecutableFile::Elf::FileHeader;
+using Mdt::ExecutableFile::Elf::ObjectFileType;
+using Mdt::ExecutableFile::Elf::SectionHeader;
+using Mdt::ExecutableFile::Elf::SectionType;
+using Mdt::ExecutableFile::Elf::RelocationEntry;
+using Mdt::ExecutableFile::Elf::RelocatableObjectSymbol;
+using Mdt::ExecutableFile::Elf::RelocatableObjectReadError;
+
+TEST_CASE("relocationEntrySize")
+{
+  using Mdt::ExecutableFile::Elf::relocationEntrySize;
+  using Mdt::ExecutableFile::Elf::Class;
+
+  REQUIRE( relocationEntrySize(Class::Class32, false) == 8 );
+  REQUIRE( relocationEntrySize(Class::Class32, true) == 12 );
+  REQUIRE( relocationEntrySize(Class::Class64, false) == 16 );
+  REQUIRE( relocationEntrySize(Class::Class64, true) == 24 );
+}
+
+TEST_CASE("relocationEntryFromArray")
+{
+  using Mdt::ExecutableFile::Elf::relocationEntryFromArray;
+
+  RelocationEntry entry;
+
+  SECTION("32-bit big-endian Rel")
+  {
+    uchar array[8] = {
+      // r_offset
+      0x00,0x00,0x01,0x02,
+      // r_info: symbol 5, type 2
+      0x00,0x00,0x05,0x02
+    };
+    entry = relocationEntryFromArray( arraySpanFromArray( array, sizeof(array) ), make32BitBigEndianIdent(), false );
+    REQUIRE( entry.offset == 0x0102 );
+    REQUIRE( entry.symbolIndex == 5 );
+    REQUIRE( entry.type == 2 );
+    REQUIRE( entry.addend == 0 );
+  }
+
+  SECTION("64-bit little-endian Rela")
+  {
+    uchar array[24] = {
+      // r_offset
+      0x10,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+      // r_info: type 4, symbol 7
+      0x04,0x00,0x00,0x00,0x07,0x00,0x00,0x00,
+      // r_addend: -4
+      0xFC,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
+    };
+    entry = relocationEntryFromArray( arraySpanFromArray( array, sizeof(array) ), make64BitLittleEndianIdent(), true );
+    REQUIRE( entry.offset == 0x10 );
+    REQUIRE( entry.symbolIndex == 7 );
+    REQUIRE( entry.type == 4 );
+    REQUIRE( entry.addend == -4 );
+  }
+}
+
+TEST_CASE("checkSectionIsInMap")
+{
+  using Mdt::ExecutableFile::Elf::checkSectionIsInMap;
+
+  uchar map[8] = {};
+  const ByteArraySpan mapSpan = arraySpanFromArray( map, sizeof(map) );
+
+  SectionHeader header;
+  header.name = ".text";
+
+  SECTION("section at the end of the map")
+  {
+    header.offset = 4;
+    header.size = 4;
+    REQUIRE_NOTHROW( checkSectionIsInMap(mapSpan, header) );
+  }
+
+  SECTION("section past the end of the map")
+  {
+    header.offset = 4;
+    header.size = 5;
+    REQUIRE_THROWS_AS( checkSectionIsInMap(mapSpan, header), RelocatableObjectReadError );
+  }
+
+  SECTION("offset past the end of the map")
+  {
+    header.offset = 9;
+    header.size = 0;
+    REQUIRE_THROWS_AS( checkSectionIsInMap(mapSpan, header), RelocatableObjectReadError );
+  }
+
+  SECTION("offset plus size overflows")
+  {
+    header.offset = 4;
+    header.size = 0xFFFFFFFFFFFFFFFE;
+    REQUIRE_THROWS_AS( checkSectionIsInMap(mapSpan, header), RelocatableObjectReadError );
+  }
+
+  SECTION("offset does not fit in a int64")
+  {
+    header.offset = 0x8000000000000000;
+    header.size = 4;
+    REQUIRE_THROWS_AS( checkSectionIsInMap(mapSpan, header), RelocatableObjectReadError );
+  }
+}
+
+TEST_CASE("stringViewFromStringTableSection")
+{
+  using Mdt::ExecutableFile::Elf::stringViewFromStringTableSection;
+
+  uchar map[8] = {'\0','f','o','o','\0','b','a','r'};
+  const ByteArraySpan mapSpan = arraySpanFromArray( map, sizeof(map) );
+
+  SectionHeader header;
+  header.name = ".strtab";
+  header.type = static_cast<uint32_t>(SectionType::StringTable);
+  header.offset = 0;
+
+  SECTION("null terminated strings")
+  {
+    header.size = 5;
+    REQUIRE( stringViewFromStringTableSection(mapSpan, header, 0).empty() );
+    REQUIRE( stringViewFromStringTableSection(mapSpan, header, 1) == "foo" );
+    REQUIRE( stringViewFromStringTableSection(mapSpan, header, 2) == "oo" );
+  }
+
+  SECTION("index out of range")
+  {
+    header.size = 5;
+    REQUIRE_THROWS_AS( stringViewFromStringTableSection(mapSpan, header, 5), RelocatableObjectReadError );
+  }
+
+  SECTION("not null terminated")
+  {
+    header.size = 8;
+    REQUIRE_THROWS_AS( stringViewFromStringTableSection(mapSpan, header, 5), RelocatableObjectReadError );
+  }
+}
+
+TEST_CASE("extractSectionGroup")
+{
+  using Mdt::ExecutableFile::Elf::extractSectionGroup;
+  using Mdt::ExecutableFile::Elf::SectionGroup;
+
+  FileHeader fileHeader = make64BitLittleEndianFileHeader();
+  fileHeader.setObjectFileType(ObjectFileType::RelocatableFile);
+
+  uchar map[12] = {
+    // flags: GRP_COMDAT
+    0x01,0x00,0x00,0x00,
+    // members
+    0x05,0x00,0x00,0x00,
+    0x06,0x00,0x00,0x00
+  };
+  const ByteArraySpan mapSpan = arraySpanFromArray( map, sizeof(map) );
+
+  std::vector<RelocatableObjectSymbol> symbols(2);
+  symbols[1].name = "_ZN1AC2Ev";
+
+  SectionHeader header;
+  header.name = ".group";
+  header.type = static_cast<uint32_t>(SectionType::Group);
+  header.offset = 0;
+  header.size = 12;
+  header.entsize = 4;
+
+  SECTION("valid group")
+  {
+    header.info = 1;
+    const SectionGroup group = extractSectionGroup(mapSpan, fileHeader, header, 3, symbols);
+    REQUIRE( group.sectionIndex == 3 );
+    REQUIRE( group.isComdat );
+    REQUIRE( group.signature == "_ZN1AC2Ev" );
+    REQUIRE( group.memberSectionIndexes == std::vector<uint32_t>{5,6} );
+  }
+
+  SECTION("signature symbol does not exist")
+  {
+    header.info = 2;
+    REQUIRE_THROWS_AS( extractSectionGroup(mapSpan, fileHeader, header, 3, symbols), RelocatableObjectReadError );
+  }
+}
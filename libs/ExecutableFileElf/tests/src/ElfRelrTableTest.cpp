@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "ElfFileIoTestUtils.h"
+#include "ByteArraySpanTestUtils.h"
+#include "Mdt/ExecutableFile/Elf/RelrTable.h"
+#include "Mdt/ExecutableFile/Elf/RelocationTableWriter.h"
+#include "Mdt/ExecutableFile/Elf/RelocatableObjectReader.h"
+#include <vector>
+
+using namespace Mdt::ExecutableFile::Elf;
+using Mdt::ExecutableFile::ByteArraySpan;
+
+TEST_CASE("isRelativeRelocationType")
+{
+  REQUIRE( isRelativeRelocationType(Machine::X86_64, 8) );
+  REQUIRE( isRelativeRelocationType(Machine::X86, 8) );
+  REQUIRE( !isRelativeRelocationType(Machine::X86_64, 1) );
+  REQUIRE( !isRelativeRelocationType(Machine::X86_64, 6) );
+  REQUIRE( !isRelativeRelocationType(Machine::Unknown, 8) );
+}
+
+TEST_CASE("makeRelrTable")
+{
+  SECTION("empty")
+  {
+    REQUIRE( makeRelrTable({}, Class::Class64).empty() );
+  }
+
+  SECTION("1 address")
+  {
+    const std::vector<uint64_t> table = makeRelrTable({0x1000}, Class::Class64);
+    REQUIRE( table == std::vector<uint64_t>{0x1000} );
+  }
+
+  SECTION("3 contiguous words (64-bit)")
+  {
+    const std::vector<uint64_t> table = makeRelrTable({0x1000, 0x1008, 0x1010}, Class::Class64);
+    REQUIRE( table == std::vector<uint64_t>{0x1000, 0b111} );
+  }
+
+  SECTION("2 words with a gap (32-bit)")
+  {
+    const std::vector<uint64_t> table = makeRelrTable({0x1000, 0x100c}, Class::Class32);
+    REQUIRE( table == std::vector<uint64_t>{0x1000, 0b1001} );
+  }
+
+  SECTION("a address past the bitmap range starts a new address entry")
+  {
+    const std::vector<uint64_t> table = makeRelrTable({0x1000, 0x1000 + 8 * 64 + 8 * 100}, Class::Class64);
+    REQUIRE( table == std::vector<uint64_t>{0x1000, 0x1000 + 8 * 64 + 8 * 100} );
+  }
+}
+
+TEST_CASE("makeRelrTable_relrTableAddresses")
+{
+  std::vector<uint64_t> addresses;
+
+  SECTION("64-bit")
+  {
+    for(uint64_t i = 0; i < 300; ++i){
+      if( (i % 3) != 0 ){
+        addresses.push_back(0x4000 + 8 * i);
+      }
+    }
+    addresses.push_back(0x9000);
+    addresses.push_back(0x9008);
+
+    const std::vector<uint64_t> table = makeRelrTable(addresses, Class::Class64);
+    REQUIRE( table.size() < addresses.size() );
+    REQUIRE( relrTableAddresses(table, Class::Class64) == addresses );
+  }
+
+  SECTION("32-bit")
+  {
+    for(uint64_t i = 0; i < 100; ++i){
+      addresses.push_back(0x2000 + 4 * i);
+    }
+
+    const std::vector<uint64_t> table = makeRelrTable(addresses, Class::Class32);
+    REQUIRE( table.size() == 5 );
+    REQUIRE( relrTableAddresses(table, Class::Class32) == addresses );
+  }
+}
+
+TEST_CASE("setRelocationTableToArray")
+{
+  const Ident ident = make64BitLittleEndianIdent();
+
+  RelocationEntry entry;
+  entry.offset = 0x3df0;
+  entry.type = 6;
+  entry.symbolIndex = 2;
+  entry.addend = -4;
+
+  uchar arrayData[2 * 24] = {};
+  const ByteArraySpan arraySpan = arraySpanFromArray( arrayData, sizeof(arrayData) );
+
+  setRelocationTableToArray(arraySpan, {entry, entry}, ident, true);
+
+  const RelocationEntry readEntry = relocationEntryFromArray(arraySpan.subSpan(24, 24), ident, true);
+  REQUIRE( readEntry.offset == 0x3df0 );
+  REQUIRE( readEntry.type == 6 );
+  REQUIRE( readEntry.symbolIndex == 2 );
+  REQUIRE( readEntry.addend == -4 );
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "TestUtils.h"
+#include "ElfDynamicSectionTestCommon.h"
+#include "Mdt/ExecutableFile/Elf/RunPathInPlaceEditor.h"
+#include <vector>
+
+using Mdt::ExecutableFile::Elf::RunPathInPlaceEdit;
+using Mdt::ExecutableFile::Elf::RunPathInPlacePlan;
+using Mdt::ExecutableFile::Elf::planRunPathInPlaceEdit;
+using Mdt::ExecutableFile::Elf::referencesContainsAnyInRange;
+
+
+TEST_CASE("referencesContainsAnyInRange")
+{
+  const std::vector<uint64_t> references = {2, 10};
+
+  REQUIRE( !referencesContainsAnyInRange({}, 0, 5) );
+  REQUIRE( referencesContainsAnyInRange(references, 2, 5) );
+  REQUIRE( !referencesContainsAnyInRange(references, 3, 10) );
+  REQUIRE( referencesContainsAnyInRange(references, 3, 11) );
+}
+
+TEST_CASE("planRunPathInPlaceEdit")
+{
+  /*
+   * String table: \0/tmp:/path2\0libA.so\0
+   * Index:         0 1          12 13    20
+   */
+  uchar stringTable[21] = {
+    '\0',
+    '/','t','m','p',':','/','p','a','t','h','2','\0',
+    'l','i','b','A','.','s','o','\0'
+  };
+
+  DynamicSection section;
+  section.addEntry( makeNeededEntry(13) );
+  section.addEntry( makeStringTableSizeEntry(21) );
+  section.setStringTable( stringTableFromCharArray( stringTable, sizeof(stringTable) ) );
+
+  std::vector<uint64_t> otherReferences;
+  RunPathInPlacePlan plan;
+
+  SECTION("file with a DT_RUNPATH")
+  {
+    section.addEntry( makeRunPathEntry(1) );
+    section.addEntry( makeNullEntry() );
+
+    SECTION("same run path")
+    {
+      plan = planRunPathInPlaceEdit(section, 21, "/tmp:/path2", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::Unchanged );
+      REQUIRE( !plan.requiresWrite() );
+    }
+
+    SECTION("shorter run path")
+    {
+      plan = planRunPathInPlaceEdit(section, 21, "/opt", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::OverwriteString );
+      REQUIRE( plan.runPathEntryIndex == 2 );
+      REQUIRE( plan.stringTableSizeEntryIndex == 1 );
+      REQUIRE( plan.stringTableIndex == 1 );
+      REQUIRE( plan.stringTableByteCount == 12 );
+      REQUIRE( plan.stringTableSize == 21 );
+    }
+
+    SECTION("run path of the same length")
+    {
+      plan = planRunPathInPlaceEdit(section, 21, "/opt:/path3", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::OverwriteString );
+    }
+
+    SECTION("a symbol name is merged into the run path tail")
+    {
+      otherReferences.push_back(7);
+      plan = planRunPathInPlaceEdit(section, 21, "/opt", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::NotPossible );
+    }
+
+    SECTION("a reference just after the run path does not prevent overwriting it")
+    {
+      otherReferences.push_back(12);
+      plan = planRunPathInPlaceEdit(section, 21, "/opt", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::OverwriteString );
+    }
+
+    SECTION("longer run path without slack")
+    {
+      plan = planRunPathInPlaceEdit(section, 21, "/tmp:/path2:/path3", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::NotPossible );
+    }
+
+    SECTION("longer run path that fits in the slack")
+    {
+      plan = planRunPathInPlaceEdit(section, 40, "/tmp:/path2:/path3", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::UseStringTableSlack );
+      REQUIRE( plan.runPathEntryIndex == 2 );
+      REQUIRE( plan.stringTableIndex == 21 );
+      REQUIRE( plan.stringTableByteCount == 19 );
+      REQUIRE( plan.stringTableSize == 40 );
+    }
+
+    SECTION("removing the run path is not done in place")
+    {
+      plan = planRunPathInPlaceEdit(section, 21, "", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::NotPossible );
+    }
+  }
+
+  SECTION("file without DT_RUNPATH")
+  {
+    section.addEntry( makeNullEntry() );
+
+    SECTION("empty run path")
+    {
+      plan = planRunPathInPlaceEdit(section, 21, "", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::Unchanged );
+    }
+
+    SECTION("no spare DT_NULL")
+    {
+      plan = planRunPathInPlaceEdit(section, 40, "/opt", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::NotPossible );
+    }
+
+    SECTION("spare DT_NULL and slack")
+    {
+      section.addEntry( makeNullEntry() );
+      plan = planRunPathInPlaceEdit(section, 40, "/opt", otherReferences);
+      REQUIRE( plan.edit == RunPathInPlaceEdit::UseStringTableSlack );
+      REQUIRE( plan.runPathEntryIndex == 2 );
+      REQUIRE( plan.stringTableIndex == 21 );
+      REQUIRE( plan.stringTableSize == 26 );
+    }
+  }
+}
+
+TEST_CASE("planRunPathInPlaceEdit_runPathIsTheTailOfAnOtherString")
+{
+  /*
+   * A symbol named foo/lib and the run path /lib
+   * merged by the linker
+   *
+   * String table: \0foo/lib\0
+   * Index:         0 1  4   8
+   */
+  uchar stringTable[9] = {
+    '\0',
+    'f','o','o','/','l','i','b','\0'
+  };
+
+  DynamicSection section;
+  section.addEntry( makeStringTableSizeEntry(9) );
+  section.addEntry( makeRunPathEntry(4) );
+  section.addEntry( makeNullEntry() );
+  section.setStringTable( stringTableFromCharArray( stringTable, sizeof(stringTable) ) );
+
+  const std::vector<uint64_t> otherReferences = {1};
+  RunPathInPlacePlan plan;
+
+  SECTION("shorter run path without slack")
+  {
+    plan = planRunPathInPlaceEdit(section, 9, "/x", otherReferences);
+    REQUIRE( plan.edit == RunPathInPlaceEdit::NotPossible );
+  }
+
+  SECTION("shorter run path with slack")
+  {
+    plan = planRunPathInPlaceEdit(section, 20, "/x", otherReferences);
+    REQUIRE( plan.edit == RunPathInPlaceEdit::UseStringTableSlack );
+    REQUIRE( plan.stringTableIndex == 9 );
+  }
+}
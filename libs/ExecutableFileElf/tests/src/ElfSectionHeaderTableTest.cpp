@@ -232,6 +232,40 @@ TEST_CASE("sortSectionHeadersByFileOffset")
     REQUIRE( indexChangeMap.indexForOldIndex(2) == 1 );
   }
 
+  SECTION(".dynamic , .dynstr , .interp - .dynstr is swapped twice")
+  {
+    /*
+     * This happens after a edit that moved
+     * the .dynstr to the end of the file
+     */
+    SectionHeader dynStr = makeDynamicStringTableSectionHeader();
+    dynStr.offset = 300;
+    dynStr.link = 0;
+
+    SectionHeader interp = makeProgramInterpreterSectionHeader();
+    interp.offset = 100;
+
+    SectionHeader dynamic = makeDynamicSectionHeader();
+    dynamic.offset = 200;
+    dynamic.link = 1;
+
+    headers.push_back( makeNullSectionHeader() );
+    headers.push_back(dynStr);
+    headers.push_back(interp);
+    headers.push_back(dynamic);
+
+    indexChangeMap = sortSectionHeadersByFileOffset(headers);
+
+    REQUIRE( headers[1].name == ".interp" );
+    REQUIRE( headers[2].name == ".dynamic" );
+    REQUIRE( headers[2].link == 3 );
+    REQUIRE( headers[3].name == ".dynstr" );
+    REQUIRE( indexChangeMap.indexForOldIndex(0) == 0 );
+    REQUIRE( indexChangeMap.indexForOldIndex(1) == 3 );
+    REQUIRE( indexChangeMap.indexForOldIndex(2) == 1 );
+    REQUIRE( indexChangeMap.indexForOldIndex(3) == 2 );
+  }
+
   SECTION(".rela.plt , .got , .dynsym")
   {
     SectionHeader dynsym = makeDynamicLinkerSymbolTableSectionHeader();
@@ -266,6 +300,129 @@ TEST_CASE("sortSectionHeadersByFileOffset")
     REQUIRE( indexChangeMap.indexForOldIndex(2) == 2 );
     REQUIRE( indexChangeMap.indexForOldIndex(3) == 1 );
   }
+
+  SECTION("sections at the same offset keep their order")
+  {
+    SectionHeader note1 = makeNoteSectionHeader(".note.1");
+    note1.offset = 200;
+    note1.size = 0;
+
+    SectionHeader note2 = makeNoteSectionHeader(".note.2");
+    note2.offset = 200;
+
+    SectionHeader got = makeGotSectionHeader();
+    got.offset = 100;
+
+    headers.push_back( makeNullSectionHeader() );
+    headers.push_back(note1);
+    headers.push_back(note2);
+    headers.push_back(got);
+
+    indexChangeMap = sortSectionHeadersByFileOffset(headers);
+
+    REQUIRE( headers[1].name == ".got" );
+    REQUIRE( headers[2].name == ".note.1" );
+    REQUIRE( headers[3].name == ".note.2" );
+    REQUIRE( indexChangeMap.indexForOldIndex(0) == 0 );
+    REQUIRE( indexChangeMap.indexForOldIndex(1) == 2 );
+    REQUIRE( indexChangeMap.indexForOldIndex(2) == 3 );
+    REQUIRE( indexChangeMap.indexForOldIndex(3) == 1 );
+  }
+}
+
+TEST_CASE("removeSectionHeaders")
+{
+  std::vector<SectionHeader> headers;
+  SectionIndexChangeMap indexChangeMap;
+
+  const auto isSymTab = [](uint16_t, const SectionHeader & header){
+    return header.name == ".symtab";
+  };
+
+  SECTION("empty collection")
+  {
+    indexChangeMap = removeSectionHeaders(headers, isSymTab);
+    REQUIRE( indexChangeMap.isEmpty() );
+  }
+
+  SECTION(".dynstr , .symtab , .dynamic")
+  {
+    SectionHeader dynStr = makeDynamicStringTableSectionHeader();
+    dynStr.offset = 50;
+
+    SectionHeader symTab = makeSymbolTableSectionHeader();
+    symTab.offset = 100;
+    symTab.link = 1;
+
+    SectionHeader dynamic = makeDynamicSectionHeader();
+    dynamic.offset = 200;
+    dynamic.link = 1;
+
+    headers.push_back( makeNullSectionHeader() );
+    headers.push_back(dynStr);
+    headers.push_back(symTab);
+    headers.push_back(dynamic);
+
+    SECTION("remove nothing")
+    {
+      const auto removeNothing = [](uint16_t, const SectionHeader &){
+        return false;
+      };
+
+      indexChangeMap = removeSectionHeaders(headers, removeNothing);
+
+      REQUIRE( headers.size() == 4 );
+      REQUIRE( indexChangeMap.indexForOldIndex(2) == 2 );
+      REQUIRE( indexChangeMap.indexForOldIndex(3) == 3 );
+    }
+
+    SECTION("remove .symtab")
+    {
+      indexChangeMap = removeSectionHeaders(headers, isSymTab);
+
+      REQUIRE( headers.size() == 3 );
+      REQUIRE( headers[1].name == ".dynstr" );
+      REQUIRE( headers[2].name == ".dynamic" );
+      REQUIRE( headers[2].link == 1 );
+      REQUIRE( indexChangeMap.indexForOldIndex(0) == 0 );
+      REQUIRE( indexChangeMap.indexForOldIndex(1) == 1 );
+      REQUIRE( indexChangeMap.indexForOldIndex(2) == 0 );
+      REQUIRE( indexChangeMap.indexForOldIndex(3) == 2 );
+    }
+
+    SECTION("remove .dynstr")
+    {
+      const auto isDynStr = [](uint16_t index, const SectionHeader &){
+        return index == 1;
+      };
+
+      indexChangeMap = removeSectionHeaders(headers, isDynStr);
+
+      REQUIRE( headers.size() == 3 );
+      REQUIRE( headers[1].name == ".symtab" );
+      REQUIRE( headers[1].link == 0 );
+      REQUIRE( headers[2].name == ".dynamic" );
+      REQUIRE( headers[2].link == 0 );
+      REQUIRE( indexChangeMap.indexForOldIndex(1) == 0 );
+      REQUIRE( indexChangeMap.indexForOldIndex(2) == 1 );
+      REQUIRE( indexChangeMap.indexForOldIndex(3) == 2 );
+    }
+  }
+
+  SECTION("the null section is never removed")
+  {
+    const auto removeAll = [](uint16_t, const SectionHeader &){
+      return true;
+    };
+
+    headers.push_back( makeNullSectionHeader() );
+    headers.push_back( makeSymbolTableSectionHeader() );
+
+    indexChangeMap = removeSectionHeaders(headers, removeAll);
+
+    REQUIRE( headers.size() == 1 );
+    REQUIRE( headers[0].sectionType() == SectionType::Null );
+  }
 }
 
 TEST_CASE("findCountOfSectionsToMoveToFreeSize")
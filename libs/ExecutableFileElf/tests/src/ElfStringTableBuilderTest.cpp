@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Mdt/ExecutableFile/Elf/StringTableBuilder.h"
+#include <vector>
+
+using Mdt::ExecutableFile::Elf::StringTable;
+using Mdt::ExecutableFile::Elf::StringTableBuilder;
+using Mdt::ExecutableFile::Elf::StringTableIndexMap;
+
+
+TEST_CASE("StringTableIndexMap")
+{
+  StringTableIndexMap map;
+
+  map.addIndex(6, 1);
+  map.addIndex(1, 9);
+  map.addIndex(6, 1);
+  map.sort();
+
+  REQUIRE( map.indexCount() == 2 );
+  REQUIRE( map.containsOldIndex(1) );
+  REQUIRE( map.containsOldIndex(6) );
+  REQUIRE( !map.containsOldIndex(0) );
+  REQUIRE( !map.containsOldIndex(9) );
+  REQUIRE( map.newIndexForOldIndex(1) == 9 );
+  REQUIRE( map.newIndexForOldIndex(6) == 1 );
+}
+
+TEST_CASE("build")
+{
+  StringTableBuilder builder;
+  StringTable table;
+
+  SECTION("no string")
+  {
+    table = builder.build();
+    REQUIRE( table.isEmpty() );
+    REQUIRE( builder.indexOfString("") == 0 );
+  }
+
+  SECTION("empty strings are not added")
+  {
+    builder.addString("");
+    REQUIRE( builder.stringCount() == 0 );
+  }
+
+  SECTION("a string added twice is stored once")
+  {
+    builder.addString("libA.so");
+    builder.addString("libA.so");
+    REQUIRE( builder.stringCount() == 1 );
+    table = builder.build();
+    REQUIRE( table.byteCount() == 9 );
+    REQUIRE( builder.indexOfString("libA.so") == 1 );
+  }
+
+  SECTION("a string that ends a other one shares its bytes")
+  {
+    builder.addString("libfoo.so");
+    builder.addString("liblibfoo.so");
+    builder.addString("foo.so");
+    table = builder.build();
+    // \0liblibfoo.so\0
+    REQUIRE( table.byteCount() == 14 );
+    REQUIRE( builder.indexOfString("liblibfoo.so") == 1 );
+    REQUIRE( builder.indexOfString("libfoo.so") == 4 );
+    REQUIRE( builder.indexOfString("foo.so") == 7 );
+    REQUIRE( table.stringAtIndex(4) == "libfoo.so" );
+    REQUIRE( table.stringAtIndex(7) == "foo.so" );
+  }
+
+  SECTION("strings that do not end a other one")
+  {
+    builder.addString("libA.so");
+    builder.addString("libB.so");
+    table = builder.build();
+    REQUIRE( table.byteCount() == 17 );
+    REQUIRE( table.stringAtIndex( builder.indexOfString("libA.so") ) == "libA.so" );
+    REQUIRE( table.stringAtIndex( builder.indexOfString("libB.so") ) == "libB.so" );
+  }
+}
+
+TEST_CASE("build_doesNotDependOnOrder")
+{
+  StringTableBuilder builderA;
+  builderA.addString("GLIBC_2.2.5");
+  builderA.addString("libc.so.6");
+  builderA.addString("c.so.6");
+  builderA.addString("printf");
+
+  StringTableBuilder builderB;
+  builderB.addString("printf");
+  builderB.addString("c.so.6");
+  builderB.addString("GLIBC_2.2.5");
+  builderB.addString("libc.so.6");
+
+  const StringTable tableA = builderA.build();
+  const StringTable tableB = builderB.build();
+
+  REQUIRE( tableA.byteCount() == tableB.byteCount() );
+  for(const char *str : {"GLIBC_2.2.5", "libc.so.6", "c.so.6", "printf"}){
+    REQUIRE( builderA.indexOfString(str) == builderB.indexOfString(str) );
+  }
+}
+
+TEST_CASE("indexMapForTable")
+{
+  StringTable table;
+  const uint64_t unusedIndex = table.appendString("unused");
+  const uint64_t libAIndex = table.appendString("libA.so");
+  const uint64_t runPathIndex = table.appendString("/tmp/lib");
+  // index to the middle of libA.so
+  const uint64_t aIndex = libAIndex + 3;
+  REQUIRE( unusedIndex == 1 );
+
+  const std::vector<uint64_t> indexes{0, libAIndex, runPathIndex, aIndex};
+
+  StringTableBuilder builder;
+  builder.addStringsAtIndexes(table, indexes);
+  const StringTable compactTable = builder.build();
+  REQUIRE( compactTable.byteCount() == table.byteCount() - 7 );
+
+  const StringTableIndexMap map = builder.indexMapForTable(table, indexes);
+  REQUIRE( map.indexCount() == 4 );
+  REQUIRE( map.newIndexForOldIndex(0) == 0 );
+  REQUIRE( compactTable.stringAtIndex( map.newIndexForOldIndex(libAIndex) ) == "libA.so" );
+  REQUIRE( compactTable.stringAtIndex( map.newIndexForOldIndex(runPathIndex) ) == "/tmp/lib" );
+  REQUIRE( compactTable.stringAtIndex( map.newIndexForOldIndex(aIndex) ) == "A.so" );
+  REQUIRE( !map.containsOldIndex(unusedIndex) );
+}
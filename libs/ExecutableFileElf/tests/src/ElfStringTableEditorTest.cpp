@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Mdt/ExecutableFile/Elf/StringTableEditor.h"
+#include <vector>
+
+using Mdt::ExecutableFile::Elf::StringTable;
+using Mdt::ExecutableFile::Elf::StringTableEditor;
+using Mdt::ExecutableFile::Elf::StringTableIndexMap;
+
+
+TEST_CASE("commit")
+{
+  // \0/tmp\0libA.so\0libB.so\0
+  StringTable table;
+  const uint64_t runPathIndex = table.appendString("/tmp");
+  const uint64_t libAIndex = table.appendString("libA.so");
+  const uint64_t libBIndex = table.appendString("libB.so");
+  REQUIRE( runPathIndex == 1 );
+  REQUIRE( libAIndex == 6 );
+  REQUIRE( libBIndex == 14 );
+
+  StringTableEditor editor(table);
+  StringTable newTable;
+
+  SECTION("no edit")
+  {
+    REQUIRE( !editor.hasEdits() );
+    newTable = editor.commit();
+    REQUIRE( newTable.byteCount() == table.byteCount() );
+    REQUIRE( editor.newIndexForOldIndex(libBIndex) == libBIndex );
+  }
+
+  SECTION("longer string")
+  {
+    editor.setStringAtIndex(runPathIndex, "/path1");
+    REQUIRE( editor.hasEdits() );
+    newTable = editor.commit();
+    REQUIRE( newTable.byteCount() == table.byteCount() + 2 );
+    REQUIRE( newTable.stringAtIndex(1) == "/path1" );
+    REQUIRE( editor.newIndexForOldIndex(runPathIndex) == 1 );
+    REQUIRE( editor.newIndexForOldIndex(libAIndex) == 8 );
+    REQUIRE( newTable.stringAtIndex(8) == "libA.so" );
+    REQUIRE( editor.newIndexForOldIndex(libBIndex) == 16 );
+    REQUIRE( newTable.stringAtIndex(16) == "libB.so" );
+  }
+
+  SECTION("shorter string")
+  {
+    editor.setStringAtIndex(libAIndex, "A");
+    newTable = editor.commit();
+    REQUIRE( newTable.byteCount() == table.byteCount() - 6 );
+    REQUIRE( newTable.stringAtIndex( editor.newIndexForOldIndex(runPathIndex) ) == "/tmp" );
+    REQUIRE( newTable.stringAtIndex( editor.newIndexForOldIndex(libAIndex) ) == "A" );
+    REQUIRE( newTable.stringAtIndex( editor.newIndexForOldIndex(libBIndex) ) == "libB.so" );
+  }
+
+  SECTION("remove a string")
+  {
+    editor.removeStringAtIndex(libAIndex);
+    newTable = editor.commit();
+    REQUIRE( newTable.byteCount() == table.byteCount() - 8 );
+    REQUIRE( !editor.oldIndexIsKept(libAIndex) );
+    REQUIRE( !editor.oldIndexIsKept(libAIndex + 3) );
+    REQUIRE( editor.oldIndexIsKept(libBIndex) );
+    REQUIRE( editor.newIndexForOldIndex(libBIndex) == 6 );
+    REQUIRE( newTable.stringAtIndex(6) == "libB.so" );
+  }
+
+  SECTION("many edits in any order")
+  {
+    editor.setStringAtIndex(libBIndex, "libQt5Core.so");
+    editor.removeStringAtIndex(runPathIndex);
+    editor.setStringAtIndex(libAIndex, "libX.so");
+    editor.setStringAtIndex(libAIndex, "libC.so.1");
+    newTable = editor.commit();
+    // \0libC.so.1\0libQt5Core.so\0
+    REQUIRE( newTable.byteCount() == 25 );
+    REQUIRE( !editor.oldIndexIsKept(runPathIndex) );
+    REQUIRE( editor.newIndexForOldIndex(libAIndex) == 1 );
+    REQUIRE( newTable.stringAtIndex(1) == "libC.so.1" );
+    REQUIRE( editor.newIndexForOldIndex(libBIndex) == 11 );
+    REQUIRE( newTable.stringAtIndex(11) == "libQt5Core.so" );
+  }
+
+  SECTION("index to the middle of a edited string")
+  {
+    editor.setStringAtIndex(libAIndex, "lib.so");
+    newTable = editor.commit();
+    REQUIRE( newTable.stringAtIndex( editor.newIndexForOldIndex(libAIndex + 3) ) == ".so" );
+    REQUIRE( newTable.stringAtIndex( editor.newIndexForOldIndex(libAIndex + 7) ) == "" );
+  }
+}
+
+TEST_CASE("indexMapForIndexes")
+{
+  // \0/tmp\0libA.so\0
+  StringTable table;
+  const uint64_t runPathIndex = table.appendString("/tmp");
+  const uint64_t libAIndex = table.appendString("libA.so");
+
+  StringTableEditor editor(table);
+  editor.removeStringAtIndex(runPathIndex);
+  const StringTable newTable = editor.commit();
+
+  const StringTableIndexMap map = editor.indexMapForIndexes({0, runPathIndex, libAIndex});
+  REQUIRE( map.indexCount() == 2 );
+  REQUIRE( map.newIndexForOldIndex(0) == 0 );
+  REQUIRE( !map.containsOldIndex(runPathIndex) );
+  REQUIRE( newTable.stringAtIndex( map.newIndexForOldIndex(libAIndex) ) == "libA.so" );
+}
@@ -127,6 +127,17 @@ TEST_CASE("stringAtIndex")
   }
 }
 
+TEST_CASE("stringViewAtIndex")
+{
+  StringTable table;
+
+  uchar charArray[9] = {'\0','n','a','m','e','.','\0','A','\0'};
+  table = stringTableFromCharArray( charArray, sizeof(charArray) );
+  REQUIRE( table.stringViewAtIndex(0).empty() );
+  REQUIRE( table.stringViewAtIndex(1) == "name." );
+  REQUIRE( table.stringViewAtIndex(7) == "A" );
+}
+
 TEST_CASE("unicodeStringAtIndex")
 {
   StringTable table;
@@ -188,192 +199,6 @@ TEST_CASE("appendString")
   }
 }
 
-TEST_CASE("removeStringAtIndex")
-{
-  StringTable table;
-  int64_t offset;
-
-  SECTION("remove the only string the table contains")
-  {
-    uchar charArray[6] = {
-      '\0',
-      '/','t','m','p','\0'
-    };
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    offset = table.removeStringAtIndex(1);
-    REQUIRE( offset == -5 );
-    REQUIRE( table.stringAtIndex(0).empty() );
-    REQUIRE( table.byteCount() == 1 );
-  }
-
-  SECTION("remove the second string")
-  {
-    uchar charArray[14] = {
-      '\0',
-      '/','t','m','p','\0',
-      'l','i','b','A','.','s','o','\0'
-    };
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    offset = table.removeStringAtIndex(6);
-    REQUIRE( offset == -8 );
-    REQUIRE( table.stringAtIndex(0).empty() );
-    REQUIRE( table.stringAtIndex(1) == "/tmp" );
-    REQUIRE( table.byteCount() == 1+4+1 );
-  }
-
-  SECTION("remove the first string")
-  {
-    uchar charArray[14] = {
-      '\0',
-      '/','t','m','p','\0',
-      'l','i','b','A','.','s','o','\0'
-    };
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    offset = table.removeStringAtIndex(1);
-    REQUIRE( offset == -5 );
-    REQUIRE( table.stringAtIndex(0).empty() );
-    REQUIRE( table.stringAtIndex(1) == "libA.so" );
-    REQUIRE( table.byteCount() == 1+7+1 );
-  }
-}
-
-TEST_CASE("setStringAtIndex")
-{
-  StringTable table;
-  int64_t offset;
-
-  SECTION("add a string to a empty table")
-  {
-    uchar charArray[1] = {0};
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    offset = table.setStringAtIndex(1, "libA.so");
-    REQUIRE( offset == 7 );
-    REQUIRE( table.stringAtIndex(0).empty() );
-    REQUIRE( table.stringAtIndex(1) == "libA.so" );
-    REQUIRE( table.byteCount() == 1+7+1 );
-  }
-
-  SECTION("replace a string in a table with 1 string")
-  {
-    uchar charArray[6] = {
-      '\0',
-      'n','a','m','e','\0'
-    };
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    SECTION("new string is shorter")
-    {
-      offset = table.setStringAtIndex(1, "abc");
-      REQUIRE( offset == -1 );
-      REQUIRE( table.stringAtIndex(0).empty() );
-      REQUIRE( table.stringAtIndex(1) == "abc" );
-      REQUIRE( table.byteCount() == 1+3+1 );
-    }
-
-    SECTION("new string is same length")
-    {
-      offset = table.setStringAtIndex(1, "abcd");
-      REQUIRE( offset == 0 );
-      REQUIRE( table.stringAtIndex(0).empty() );
-      REQUIRE( table.stringAtIndex(1) == "abcd" );
-      REQUIRE( table.byteCount() == 1+4+1 );
-    }
-
-    SECTION("new string is longer")
-    {
-      offset = table.setStringAtIndex(1, "abcde");
-      REQUIRE( offset == 1 );
-      REQUIRE( table.stringAtIndex(0).empty() );
-      REQUIRE( table.stringAtIndex(1) == "abcde" );
-      REQUIRE( table.byteCount() == 1+5+1 );
-    }
-  }
-
-  SECTION("replace a string in a table with 2 strings")
-  {
-    uchar charArray[14] = {
-      '\0',
-      'n','a','m','e','\0',
-      'l','i','b','A','.','s','o','\0'
-    };
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    SECTION("replace first string")
-    {
-      SECTION("new string is shorter")
-      {
-        offset = table.setStringAtIndex(1, "abc");
-        REQUIRE( offset == -1 );
-        REQUIRE( table.stringAtIndex(0).empty() );
-        REQUIRE( table.stringAtIndex(1) == "abc" );
-        REQUIRE( table.stringAtIndex(6-1) == "libA.so" );
-        REQUIRE( table.byteCount() == 1+3+1+7+1 );
-      }
-
-      SECTION("new string is same length")
-      {
-        offset = table.setStringAtIndex(1, "abcd");
-        REQUIRE( offset == 0 );
-        REQUIRE( table.stringAtIndex(0).empty() );
-        REQUIRE( table.stringAtIndex(1) == "abcd" );
-        REQUIRE( table.stringAtIndex(6) == "libA.so" );
-        REQUIRE( table.byteCount() == 1+4+1+7+1 );
-      }
-
-      SECTION("new string is longer")
-      {
-        offset = table.setStringAtIndex(1, "abcde");
-        REQUIRE( offset == 1 );
-        REQUIRE( table.stringAtIndex(0).empty() );
-        REQUIRE( table.stringAtIndex(1) == "abcde" );
-        REQUIRE( table.stringAtIndex(6+1) == "libA.so" );
-        REQUIRE( table.byteCount() == 1+5+1+7+1 );
-      }
-    }
-
-    SECTION("replace second string")
-    {
-      SECTION("new string is shorter")
-      {
-        offset = table.setStringAtIndex(6, "abc");
-        REQUIRE( offset == -4 );
-        REQUIRE( table.stringAtIndex(0).empty() );
-        REQUIRE( table.stringAtIndex(1) == "name" );
-        REQUIRE( table.stringAtIndex(6) == "abc" );
-        REQUIRE( table.byteCount() == 1+4+1+3+1 );
-      }
-
-      SECTION("new string is same length")
-      {
-        offset = table.setStringAtIndex(6, "abcdefg");
-        REQUIRE( offset == 0 );
-        REQUIRE( table.stringAtIndex(0).empty() );
-        REQUIRE( table.stringAtIndex(1) == "name" );
-        REQUIRE( table.stringAtIndex(6) == "abcdefg" );
-        REQUIRE( table.byteCount() == 1+4+1+7+1 );
-      }
-
-      SECTION("new string is longer")
-      {
-        offset = table.setStringAtIndex(6, "abcdefgh");
-        REQUIRE( offset == 1 );
-        REQUIRE( table.stringAtIndex(0).empty() );
-        REQUIRE( table.stringAtIndex(1) == "name" );
-        REQUIRE( table.stringAtIndex(6) == "abcdefgh" );
-        REQUIRE( table.byteCount() == 1+4+1+8+1 );
-      }
-    }
-  }
-}
-
-/*
- * Current implementation is a call to appendString(),
- * we don't have to do all possible tests here
- */
 TEST_CASE("appendUnicodeString")
 {
   StringTable table;
@@ -388,53 +213,3 @@ TEST_CASE("appendUnicodeString")
     REQUIRE( table.byteCount() == 1+7+1 );
   }
 }
-
-/*
- * Current implementation is a call to setStringAtIndex(),
- * we don't have to do all possible tests here
- */
-TEST_CASE("setUnicodeStringAtIndex")
-{
-  StringTable table;
-  int64_t offset;
-
-  SECTION("replace the first string in a table with 2 strings")
-  {
-    uchar charArray[14] = {
-      '\0',
-      'n','a','m','e','\0',
-      'l','i','b','A','.','s','o','\0'
-    };
-    table = stringTableFromCharArray( charArray, sizeof(charArray) );
-
-    SECTION("new string is shorter")
-    {
-      offset = table.setUnicodeStringAtIndex( 1, QLatin1String("abc") );
-      REQUIRE( offset == -1 );
-      REQUIRE( table.stringAtIndex(0).empty() );
-      REQUIRE( table.stringAtIndex(1) == "abc" );
-      REQUIRE( table.stringAtIndex(6-1) == "libA.so" );
-      REQUIRE( table.byteCount() == 1+3+1+7+1 );
-    }
-
-    SECTION("new string is same length")
-    {
-      offset = table.setUnicodeStringAtIndex( 1, QLatin1String("abcd") );
-      REQUIRE( offset == 0 );
-      REQUIRE( table.stringAtIndex(0).empty() );
-      REQUIRE( table.stringAtIndex(1) == "abcd" );
-      REQUIRE( table.stringAtIndex(6) == "libA.so" );
-      REQUIRE( table.byteCount() == 1+4+1+7+1 );
-    }
-
-    SECTION("new string is longer")
-    {
-      offset = table.setUnicodeStringAtIndex( 1, QLatin1String("abcde") );
-      REQUIRE( offset == 1 );
-      REQUIRE( table.stringAtIndex(0).empty() );
-      REQUIRE( table.stringAtIndex(1) == "abcde" );
-      REQUIRE( table.stringAtIndex(6+1) == "libA.so" );
-      REQUIRE( table.byteCount() == 1+5+1+7+1 );
-    }
-  }
-}
@@ -11,8 +11,10 @@
 #include "Catch2QString.h"
 #include "ElfFileIoTestUtils.h"
 #include "ByteArraySpanTestUtils.h"
+#include "ElfSectionHeaderTestUtils.h"
 #include "Mdt/ExecutableFile/Elf/SymbolTableReader.h"
 #include "Mdt/ExecutableFile/Elf/SymbolTableWriter.h"
+#include <vector>
 
 using namespace Mdt::ExecutableFile::Elf;
 using Mdt::ExecutableFile::ByteArraySpan;
@@ -148,6 +150,69 @@ TEST_CASE("extractPartialSymbolTableEntry")
   }
 }
 
+TEST_CASE("symbolTableDecodeChunkCount")
+{
+  SECTION("single thread")
+  {
+    REQUIRE( symbolTableDecodeChunkCount(0, 1) == 1 );
+    REQUIRE( symbolTableDecodeChunkCount(10000000, 1) == 1 );
+  }
+
+  SECTION("small table")
+  {
+    REQUIRE( symbolTableDecodeChunkCount(0, 8) == 1 );
+    REQUIRE( symbolTableDecodeChunkCount(minimumSymbolTableEntriesPerThread, 8) == 1 );
+  }
+
+  SECTION("big table")
+  {
+    REQUIRE( symbolTableDecodeChunkCount(minimumSymbolTableEntriesPerThread*2, 8) == 2 );
+    REQUIRE( symbolTableDecodeChunkCount(minimumSymbolTableEntriesPerThread*100, 8) == 8 );
+  }
+}
+
+TEST_CASE("extractPartialSymbolTable_parallel")
+{
+  FileHeader fileHeader = make64BitLittleEndianFileHeader();
+  const int64_t entrySize = symbolTableEntrySize(fileHeader.ident._class);
+  const uint64_t entryCount = minimumSymbolTableEntriesPerThread * 3 + 5;
+
+  std::vector<unsigned char> mapData( static_cast<size_t>( static_cast<int64_t>(entryCount) * entrySize ) );
+  ByteArraySpan map = arraySpanFromArray( mapData.data(), static_cast<int64_t>( mapData.size() ) );
+  REQUIRE( map.size >= fileHeader.minimumSizeToReadAllSectionHeaders() );
+
+  for(uint64_t i = 0; i < entryCount; ++i){
+    SymbolTableEntry entry;
+    entry.name = static_cast<uint32_t>(i);
+    entry.info = 3;
+    entry.other = 0;
+    entry.shndx = static_cast<uint16_t>(i % 3);
+    entry.value = 0;
+    entry.size = 0;
+    setSymbolTableEntryToArray(map.subSpan(static_cast<int64_t>(i) * entrySize, entrySize), entry, fileHeader.ident);
+  }
+
+  SectionHeader symTabHeader = makeSymbolTableSectionHeader();
+  symTabHeader.offset = 0;
+  symTabHeader.size = entryCount * static_cast<uint64_t>(entrySize);
+  symTabHeader.entsize = static_cast<uint64_t>(entrySize);
+
+  std::vector<SectionHeader> sectionHeaderTable;
+  sectionHeaderTable.push_back( makeNullSectionHeader() );
+  sectionHeaderTable.push_back(symTabHeader);
+
+  const PartialSymbolTable expectedTable = extractPartialSymbolTableReferringToSection(map, fileHeader, sectionHeaderTable, SectionType::SymbolTable);
+  REQUIRE( expectedTable.entriesCount() == entryCount - (entryCount + 2) / 3 );
+
+  const PartialSymbolTable table = extractPartialSymbolTableReferringToSection(map, fileHeader, sectionHeaderTable, SectionType::SymbolTable, 4);
+  REQUIRE( table.entriesCount() == expectedTable.entriesCount() );
+  for(size_t i = 0; i < table.entriesCount(); ++i){
+    REQUIRE( table.fileMapOffsetAt(i) == expectedTable.fileMapOffsetAt(i) );
+    REQUIRE( table.entryAt(i).name == expectedTable.entryAt(i).name );
+    REQUIRE( table.entryAt(i).shndx == expectedTable.entryAt(i).shndx );
+  }
+}
+
 TEST_CASE("setSymbolTableEntryToArray")
 {
   SymbolTableEntry entry;
@@ -205,6 +205,56 @@ TEST_CASE("updateVirtualAddresses")
   }
 }
 
+TEST_CASE("updateVirtualAddresses_multipleThreads")
+{
+  std::vector<SectionHeader> sectionHeaderTable;
+
+  SectionHeader nullSh = makeNullSectionHeader();
+  nullSh.addr = 0;
+
+  SectionHeader dynamicSh = makeDynamicSectionHeader();
+  dynamicSh.addr = 1000;
+
+  SectionHeader dynstrSh = makeStringTableSectionHeader(".dynstr");
+  dynstrSh.addr = 2000;
+
+  sectionHeaderTable.push_back(nullSh);
+  sectionHeaderTable.push_back(dynamicSh);
+  sectionHeaderTable.push_back(dynstrSh);
+
+  /*
+   * Enough entries to be split in chunks
+   */
+  const size_t entryCount = 3 * minimumSymbolTableEntriesPerThread + 7;
+  PartialSymbolTable symbolTable;
+  for(size_t i = 0; i < entryCount; ++i){
+    PartialSymbolTableEntry entry = makeSectionAssociationSymbolTableEntryWithFileOffset( static_cast<int64_t>(i) );
+    entry.entry.shndx = static_cast<uint16_t>( 1 + (i % 2) );
+    entry.entry.value = 1000 * entry.entry.shndx;
+    symbolTable.addEntryFromFile(entry);
+  }
+
+  sectionHeaderTable[2].addr = 2500;
+  const std::vector<uint16_t> headerIndexes{2};
+
+  PartialSymbolTable expectedSymbolTable = symbolTable;
+  expectedSymbolTable.updateVirtualAddresses(headerIndexes, sectionHeaderTable);
+
+  symbolTable.updateVirtualAddresses(headerIndexes, sectionHeaderTable, 4);
+
+  REQUIRE( symbolTable.entriesCount() == entryCount );
+  size_t differentValueCount = 0;
+  for(size_t i = 0; i < entryCount; ++i){
+    if( symbolTable.entryAt(i).value != expectedSymbolTable.entryAt(i).value ){
+      ++differentValueCount;
+    }
+  }
+  REQUIRE( differentValueCount == 0 );
+  REQUIRE( symbolTable.entryAt(0).value == 1000 );
+  REQUIRE( symbolTable.entryAt(1).value == 2500 );
+  REQUIRE( symbolTable.entryAt(entryCount - 2).value == 2500 );
+}
+
 TEST_CASE("indexAssociationsKnownSections")
 {
   PartialSymbolTableEntry entry;
@@ -17,6 +17,9 @@
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
 #include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
 #include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
+#include <algorithm>
+#include <iterator>
 #include <QCoreApplication>
 #include <QtGlobal>
 #include <QString>
@@ -538,9 +541,11 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
   }
 
   /*! \internal
+   *
+   * \exception ReadLimitExceededError
    */
   inline
-  ImportDirectoryTable importDirectoryTableFromArray(const ByteArraySpan & map) noexcept
+  ImportDirectoryTable importDirectoryTableFromArray(const ByteArraySpan & map, const ReadBudget & budget)
   {
     assert( !map.isNull() );
     assert( map.size >= 20 );
@@ -560,6 +565,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
       if( directory.isNull() ){
         return table;
       }
+      budget.checkEntryCount(table.size() + 1);
       table.push_back(directory);
     }
 
@@ -567,9 +573,12 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
   }
 
   /*! \internal
+   *
+   * \exception ReadLimitExceededError
    */
   inline
-  ImportDirectoryTable extractImportDirectoryTable(const ByteArraySpan & map, const SectionHeader & sectionHeader, const ImageDataDirectory & directory) noexcept
+  ImportDirectoryTable extractImportDirectoryTable(const ByteArraySpan & map, const SectionHeader & sectionHeader,
+                                                   const ImageDataDirectory & directory, ReadBudget & budget)
   {
     assert( !map.isNull() );
     assert( sectionHeader.seemsValid() );
@@ -579,8 +588,9 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
 
     const int64_t offset = sectionHeader.rvaToFileOffset(directory.virtualAddress);
     const int64_t size = directory.size;
+    budget.consumeRegion( static_cast<uint64_t>(offset), directory.size );
 
-    return importDirectoryTableFromArray( map.subSpan(offset, size) );
+    return importDirectoryTableFromArray( map.subSpan(offset, size), budget );
   }
 
   /*! \internal
@@ -605,10 +615,10 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
   /*! \internal
    *
    * \pre \a map must not be null
-   * 
+   * \exception ReadLimitExceededError
    */
   inline
-  DelayLoadTable delayLoadTableFromArray(const ByteArraySpan & map) noexcept
+  DelayLoadTable delayLoadTableFromArray(const ByteArraySpan & map, const ReadBudget & budget)
   {
     assert( !map.isNull() );
     assert( map.size >= 32 );
@@ -628,6 +638,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
       if( directory.isNull() ){
         return table;
       }
+      budget.checkEntryCount(table.size() + 1);
       table.push_back(directory);
     }
 
@@ -635,9 +646,12 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
   }
 
   /*! \internal
+   *
+   * \exception ReadLimitExceededError
    */
   inline
-  DelayLoadTable extractDelayLoadTable(const ByteArraySpan & map, const SectionHeader & sectionHeader, const ImageDataDirectory & directory) noexcept
+  DelayLoadTable extractDelayLoadTable(const ByteArraySpan & map, const SectionHeader & sectionHeader,
+                                       const ImageDataDirectory & directory, ReadBudget & budget)
   {
     assert( !map.isNull() );
     assert( sectionHeader.seemsValid() );
@@ -647,8 +661,9 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
 
     const int64_t offset = sectionHeader.rvaToFileOffset(directory.virtualAddress);
     const int64_t size = directory.size;
+    budget.consumeRegion( static_cast<uint64_t>(offset), directory.size );
 
-    return delayLoadTableFromArray( map.subSpan(offset, size) );
+    return delayLoadTableFromArray( map.subSpan(offset, size), budget );
   }
 
 
@@ -667,6 +682,15 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
       mFileName = name;
     }
 
+    /*! \brief Set the resource limits applied while reading a file
+     *
+     * \sa ReadLimits
+     */
+    void setReadLimits(const ReadLimits & limits) noexcept
+    {
+      mReadBudget.setLimits(limits);
+    }
+
     /*! \brief Clear
      */
     void clear() noexcept
@@ -675,6 +699,14 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
       mDosHeader.clear();
       mCoffHeader.clear();
       mOptionalHeader.clear();
+      mReadBudget.reset();
+    }
+
+    const DosHeader & dosHeader() const noexcept
+    {
+      assert( mDosHeader.seemsValid() );
+
+      return mDosHeader;
     }
 
     const CoffHeader & coffHeader() const noexcept
@@ -684,57 +716,28 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
       return mCoffHeader;
     }
 
+    const OptionalHeader & optionalHeader() const noexcept
+    {
+      assert( mOptionalHeader.seemsValid() );
+
+      return mOptionalHeader;
+    }
+
     QStringList getNeededSharedLibraries(const ByteArraySpan & map)
     {
       assert( !map.isNull() );
 
-      QStringList dlls;
-
       extractDosHeaderIfNull(map);
       extractCoffHeaderIfNull(map);
       extractOptionalHeaderIfNull(map);
 
-      if( mOptionalHeader.containsImportTable() ){
-        const ImageDataDirectory directoryDescriptor = mOptionalHeader.importTableDirectory();
-        const SectionHeader sectionHeader = findSectionHeader(map, directoryDescriptor, mCoffHeader, mDosHeader);
-        if( !sectionHeader.seemsValid() ){
-          const QString message = tr("file '%1' declares to have a import table, but related section could not be found")
-                                  .arg(mFileName);
-          throw ExecutableFileReadError(message);
-        }
-
-        if( !sectionHeader.rvaIsValid(directoryDescriptor.virtualAddress) ){
-          const QString message = tr("file '%1' the import directory descriptor contains a invalid address to its section")
-                                  .arg(mFileName);
-          throw ExecutableFileReadError(message);
-        }
-        const ImportDirectoryTable importTable = extractImportDirectoryTable(map, sectionHeader, directoryDescriptor);
-        for(const auto & directory : importTable){
-          dlls.push_back( extractDllName(map, sectionHeader, directory) );
-        }
-      }
-
-      if( mOptionalHeader.containsDelayImportTable() ){
-        const ImageDataDirectory directoryDescriptor = mOptionalHeader.delayImportTableDirectory();
-        const SectionHeader sectionHeader = findSectionHeader(map, directoryDescriptor, mCoffHeader, mDosHeader);
-        if( !sectionHeader.seemsValid() ){
-          const QString message = tr("file '%1' declares to have delay load table, but related section could not be found")
-                                  .arg(mFileName);
-          throw ExecutableFileReadError(message);
-        }
-        if( !sectionHeader.rvaIsValid(directoryDescriptor.virtualAddress) ){
-          const QString message = tr("file '%1' the delay load directory descriptor contains a invalid address to its section")
-                                  .arg(mFileName);
-          throw ExecutableFileReadError(message);
-        }
-        const DelayLoadTable delayLoadTable = extractDelayLoadTable(map, sectionHeader, directoryDescriptor);
-
-        for(const auto & directory : delayLoadTable){
-          dlls.push_back( extractDllName(map, sectionHeader, directory) );
-        }
+      try{
+        return readNeededSharedLibraries(map);
+      }catch(const ReadLimitExceededError & error){
+        const QString message = tr("file '%1': %2")
+                                .arg( mFileName, error.whatQString() );
+        throw ReadLimitExceededError(message);
       }
-
-      return dlls;
     }
 
     bool tryExtractDosHeader(const ByteArraySpan & map)
@@ -836,6 +839,70 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
 
    private:
 
+    /*! \internal
+     *
+     * \exception ReadLimitExceededError
+     */
+    QStringList readNeededSharedLibraries(const ByteArraySpan & map)
+    {
+      assert( !map.isNull() );
+      assert( mDosHeader.seemsValid() );
+      assert( mCoffHeader.seemsValid() );
+      assert( mOptionalHeader.seemsValid() );
+
+      QStringList dlls;
+
+      /*
+       * Each DLL name lookup can scan the section table,
+       * so bound its size first
+       */
+      mReadBudget.checkSectionCount(mCoffHeader.numberOfSections);
+      mReadBudget.consumeRegion( static_cast<uint64_t>( sectionTableOffset(mCoffHeader, mDosHeader) ),
+                                 static_cast<uint64_t>( sectionTableSize(mCoffHeader) ) );
+
+      if( mOptionalHeader.containsImportTable() ){
+        const ImageDataDirectory directoryDescriptor = mOptionalHeader.importTableDirectory();
+        const SectionHeader sectionHeader = findSectionHeader(map, directoryDescriptor, mCoffHeader, mDosHeader);
+        if( !sectionHeader.seemsValid() ){
+          const QString message = tr("file '%1' declares to have a import table, but related section could not be found")
+                                  .arg(mFileName);
+          throw ExecutableFileReadError(message);
+        }
+
+        if( !sectionHeader.rvaIsValid(directoryDescriptor.virtualAddress) ){
+          const QString message = tr("file '%1' the import directory descriptor contains a invalid address to its section")
+                                  .arg(mFileName);
+          throw ExecutableFileReadError(message);
+        }
+        const ImportDirectoryTable importTable = extractImportDirectoryTable(map, sectionHeader, directoryDescriptor, mReadBudget);
+        for(const auto & directory : importTable){
+          dlls.push_back( extractDllName(map, sectionHeader, directory) );
+        }
+      }
+
+      if( mOptionalHeader.containsDelayImportTable() ){
+        const ImageDataDirectory directoryDescriptor = mOptionalHeader.delayImportTableDirectory();
+        const SectionHeader sectionHeader = findSectionHeader(map, directoryDescriptor, mCoffHeader, mDosHeader);
+        if( !sectionHeader.seemsValid() ){
+          const QString message = tr("file '%1' declares to have delay load table, but related section could not be found")
+                                  .arg(mFileName);
+          throw ExecutableFileReadError(message);
+        }
+        if( !sectionHeader.rvaIsValid(directoryDescriptor.virtualAddress) ){
+          const QString message = tr("file '%1' the delay load directory descriptor contains a invalid address to its section")
+                                  .arg(mFileName);
+          throw ExecutableFileReadError(message);
+        }
+        const DelayLoadTable delayLoadTable = extractDelayLoadTable(map, sectionHeader, directoryDescriptor, mReadBudget);
+
+        for(const auto & directory : delayLoadTable){
+          dlls.push_back( extractDllName(map, sectionHeader, directory) );
+        }
+      }
+
+      return dlls;
+    }
+
     void extractDosHeaderIfNull(const ByteArraySpan & map)
     {
       assert( !map.isNull() );
@@ -925,13 +992,27 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
                                 .arg(mFileName);
         throw ExecutableFileReadError(message);
       }
-      try{
-        return qStringFromUft8ByteArraySpan( map.subSpan(offset) );
-      }catch(const NotNullTerminatedStringError &){
+      /*
+       * Do not scan the rest of the file
+       * when the name is not terminated
+       */
+      const int64_t maxSize = std::min( map.size - offset, mReadBudget.limits().maximumStringTableByteCount );
+      const ByteArraySpan nameSpan = map.subSpan(offset, maxSize);
+      const auto nameEnd = std::find(nameSpan.cbegin(), nameSpan.cend(), 0);
+      if( nameEnd == nameSpan.cend() ){
         const QString message = tr("file '%1' failed to extract a DLL name from import or delay load directory (no end of string found)")
                                 .arg(mFileName);
         throw ExecutableFileReadError(message);
       }
+      const int64_t nameByteCount = static_cast<int64_t>( std::distance(nameSpan.cbegin(), nameEnd) ) + 1;
+
+      /*
+       * Account the name before decoding it.
+       * Re-reading the same name does not charge again
+       */
+      mReadBudget.consumeRegion( static_cast<uint64_t>(offset), static_cast<uint64_t>(nameByteCount) );
+
+      return qStringFromUft8ByteArraySpan( nameSpan.subSpan(0, nameByteCount) );
     }
 
     /*! \internal
@@ -962,6 +1043,7 @@ namespace Mdt{ namespace ExecutableFile{ namespace Pe{
     CoffHeader mCoffHeader;
     OptionalHeader mOptionalHeader;
     QString mFileName;
+    ReadBudget mReadBudget;
   };
 
 }}} // namespace Mdt{ namespace ExecutableFile{ namespace Pe{
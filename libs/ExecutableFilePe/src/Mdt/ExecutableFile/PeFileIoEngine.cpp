@@ -27,6 +27,7 @@ PeFileIoEngine::~PeFileIoEngine() noexcept
 void PeFileIoEngine::newFileOpen(const QString & fileName)
 {
   mImpl->setFileName(fileName);
+  mImpl->setReadLimits( readLimits() );
 }
 
 void PeFileIoEngine::fileClosed()
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "PeFileSnapshot.h"
+#include "Mdt/ExecutableFile/Pe/FileReader.h"
+
+namespace Mdt{ namespace ExecutableFile{
+
+FileScanResult PeFileSnapshot::scan(ScanContext & context) const
+{
+  assert( !isNull() );
+
+  FileScanResult result;
+  result.fileName = context.intern( fileName() );
+  result.format = ExecutableFileFormat::Pe;
+
+  for(const QString & dll : mData->neededSharedLibraries){
+    context.appendToList(dll);
+  }
+  result.neededSharedLibraries = context.takeList();
+
+  return result;
+}
+
+PeFileSnapshot PeFileSnapshot::fromFile(const QFileInfo & fileInfo)
+{
+  assert( !fileInfo.filePath().isEmpty() );
+
+  auto data = std::make_shared<Data>();
+  data->mapping.mapFile(fileInfo);
+
+  const ByteArraySpan map = data->mapping.span();
+  Pe::FileReader reader;
+  reader.setFileName( data->mapping.fileName() );
+
+  /*
+   * Extracts the DOS, COFF and Optional headers first,
+   * and throws if one of them is missing
+   */
+  data->neededSharedLibraries = reader.getNeededSharedLibraries(map);
+  data->dosHeader = reader.dosHeader();
+  data->coffHeader = reader.coffHeader();
+  data->optionalHeader = reader.optionalHeader();
+
+  PeFileSnapshot snapshot;
+  snapshot.mData = std::move(data);
+
+  return snapshot;
+}
+
+}} // namespace Mdt{ namespace ExecutableFile{
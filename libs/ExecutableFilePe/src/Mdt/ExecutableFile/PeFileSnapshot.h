@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_PE_FILE_SNAPSHOT_H
+#define MDT_EXECUTABLE_FILE_PE_FILE_SNAPSHOT_H
+
+#include "Mdt/ExecutableFile/FileOpenError.h"
+#include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "Mdt/ExecutableFile/ReadOnlyFileMapping.h"
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/ScanContext.h"
+#include "Mdt/ExecutableFile/Pe/FileHeader.h"
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Immutable parsed model of a PE image file
+   *
+   * A snapshot is built once from a file.
+   * It keeps the file mapped into memory as long as
+   * at least one copy of the snapshot is alive.
+   *
+   * Copying a snapshot is cheap: all copies share the same data,
+   * which is never modified after construction.
+   * Any number of threads can read the same snapshot without locking.
+   *
+   * \sa ElfFileSnapshot
+   */
+  class PeFileSnapshot
+  {
+   public:
+
+    /*! \brief Construct a null snapshot
+     */
+    PeFileSnapshot() noexcept = default;
+
+    /*! \brief Copy construct a snapshot from \a other
+     *
+     * Both snapshots share the same data.
+     */
+    PeFileSnapshot(const PeFileSnapshot & other) noexcept = default;
+
+    /*! \brief Copy assign \a other to this snapshot
+     */
+    PeFileSnapshot & operator=(const PeFileSnapshot & other) noexcept = default;
+
+    /*! \brief Move construct a snapshot from \a other
+     */
+    PeFileSnapshot(PeFileSnapshot && other) noexcept = default;
+
+    /*! \brief Move assign \a other to this snapshot
+     */
+    PeFileSnapshot & operator=(PeFileSnapshot && other) noexcept = default;
+
+    /*! \brief Check if this snapshot is null
+     */
+    bool isNull() const noexcept
+    {
+      return mData.get() == nullptr;
+    }
+
+    /*! \brief Get the name of the file this snapshot refers to
+     *
+     * \pre this snapshot must not be null
+     */
+    QString fileName() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->mapping.fileName();
+    }
+
+    /*! \brief Access the file mapped into memory
+     *
+     * \warning the returned span must only be used to read the file
+     * \pre this snapshot must not be null
+     */
+    ByteArraySpan map() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->mapping.span();
+    }
+
+    /*! \brief Get the DOS header
+     *
+     * \pre this snapshot must not be null
+     */
+    const Pe::DosHeader & dosHeader() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->dosHeader;
+    }
+
+    /*! \brief Get the COFF header
+     *
+     * \pre this snapshot must not be null
+     */
+    const Pe::CoffHeader & coffHeader() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->coffHeader;
+    }
+
+    /*! \brief Get the optional header
+     *
+     * \pre this snapshot must not be null
+     */
+    const Pe::OptionalHeader & optionalHeader() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->optionalHeader;
+    }
+
+    /*! \brief Get the needed shared libraries
+     *
+     * Contains the DLL's of the import table
+     * followed by the ones of the delay load table.
+     *
+     * \pre this snapshot must not be null
+     */
+    const QStringList & neededSharedLibraries() const noexcept
+    {
+      assert( !isNull() );
+
+      return mData->neededSharedLibraries;
+    }
+
+    /*! \brief Scan this file into \a context
+     *
+     * The needed shared libraries are interned in \a context .
+     * PE files have no SONAME and no run path,
+     * so those are left null and empty in the result.
+     *
+     * The returned result is only valid as long as \a context is alive.
+     *
+     * \pre this snapshot must not be null
+     */
+    FileScanResult scan(ScanContext & context) const;
+
+    /*! \brief Build a snapshot of the PE image file \a fileInfo refers to
+     *
+     * \pre \a fileInfo must have a file path set
+     * \exception FileOpenError
+     * \exception ExecutableFileReadError
+     */
+    static
+    PeFileSnapshot fromFile(const QFileInfo & fileInfo);
+
+   private:
+
+    struct Data
+    {
+      ReadOnlyFileMapping mapping;
+      Pe::DosHeader dosHeader;
+      Pe::CoffHeader coffHeader;
+      Pe::OptionalHeader optionalHeader;
+      QStringList neededSharedLibraries;
+    };
+
+    std::shared_ptr<const Data> mData;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_PE_FILE_SNAPSHOT_H
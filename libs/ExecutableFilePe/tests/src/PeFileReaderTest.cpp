@@ -10,6 +10,14 @@
 #include "catch2/catch.hpp"
 #include "Catch2QString.h"
 #include "Mdt/ExecutableFile/Pe/FileReader.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
+#include "Mdt/ExecutableFile/ReadLimitExceededError.h"
+#include <QLatin1String>
+#include <QStringList>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdint>
 
 using namespace Mdt::ExecutableFile;
 
@@ -841,3 +849,141 @@ TEST_CASE("delayLoadDirectoryFromArray")
   REQUIRE( directory.attributes == 0x34567890 );
   REQUIRE( directory.nameRVA == 0x12345678 );
 }
+
+void setLittleEndianValue(std::vector<unsigned char> & image, size_t offset, uint32_t value, size_t byteCount)
+{
+  assert( offset + byteCount <= image.size() );
+
+  for(size_t i = 0; i < byteCount; ++i){
+    image[offset+i] = static_cast<unsigned char>( (value >> (8*i)) & 0xFF );
+  }
+}
+
+/*
+ * A minimal PE32+ DLL image:
+ * - DOS header, PE signature at 0x40
+ * - COFF header with 2 sections
+ * - Optional header (128 bytes) with 2 data directories: export and import
+ * - The .idata section, at file offset 0x200 and RVA 0x1000,
+ *   with the import directory table (ending with a null directory)
+ *   followed by the DLL names at file offset 0x280
+ */
+std::vector<unsigned char> makePe32PlusDllImage(const std::vector<std::string> & dllNames)
+{
+  std::vector<unsigned char> image(0x400, 0);
+
+  image[0] = 'M';
+  image[1] = 'Z';
+  setLittleEndianValue(image, 0x3C, 0x40, 4);
+  image[0x40] = 'P';
+  image[0x41] = 'E';
+
+  // COFF header
+  setLittleEndianValue(image, 0x44, 0x8664, 2);
+  setLittleEndianValue(image, 0x46, 2, 2);
+  setLittleEndianValue(image, 0x54, 128, 2);
+  setLittleEndianValue(image, 0x56, 0x2002, 2);
+
+  // Optional header
+  const size_t optionalHeaderOffset = 0x58;
+  setLittleEndianValue(image, optionalHeaderOffset, 0x20B, 2);
+  setLittleEndianValue(image, optionalHeaderOffset + 108, 2, 4);
+  const uint32_t importDirectoryTableSize = static_cast<uint32_t>( (dllNames.size() + 1) * 20 );
+  setLittleEndianValue(image, optionalHeaderOffset + 120, 0x1000, 4);
+  setLittleEndianValue(image, optionalHeaderOffset + 124, importDirectoryTableSize, 4);
+
+  // Section table
+  const size_t sectionTableOffset = optionalHeaderOffset + 128;
+  for(size_t i = 0; i < 2; ++i){
+    const size_t offset = sectionTableOffset + i*40;
+    image[offset] = '.';
+    image[offset+1] = 'i';
+    setLittleEndianValue(image, offset + 8, 0x200, 4);
+    setLittleEndianValue(image, offset + 12, static_cast<uint32_t>(0x1000 + i*0x200), 4);
+    setLittleEndianValue(image, offset + 16, 0x200, 4);
+    setLittleEndianValue(image, offset + 20, static_cast<uint32_t>(0x200 + i*0x200), 4);
+  }
+
+  // Import directory table and DLL names
+  size_t nameOffset = 0x280;
+  for(size_t i = 0; i < dllNames.size(); ++i){
+    setLittleEndianValue(image, 0x200 + i*20 + 12, static_cast<uint32_t>(0x1000 + nameOffset - 0x200), 4);
+    std::copy( dllNames[i].cbegin(), dllNames[i].cend(), image.begin() + static_cast<std::ptrdiff_t>(nameOffset) );
+    nameOffset += dllNames[i].size() + 1;
+  }
+  assert( nameOffset <= 0x400 );
+
+  return image;
+}
+
+TEST_CASE("FileReader_readLimits")
+{
+  using Pe::FileReader;
+
+  std::vector<unsigned char> image = makePe32PlusDllImage({"A.dll","Bb.dll","Ccc.dll"});
+  const ByteArraySpan map = arraySpanFromArray( image.data(), static_cast<qint64>( image.size() ) );
+
+  /*
+   * The section table, the import directory table
+   * and the DLL names, including their null terminator
+   */
+  const int64_t byteCountToRead = 2*40 + 4*20 + 6 + 7 + 8;
+
+  FileReader reader;
+  ReadLimits limits;
+
+  SECTION("no limits")
+  {
+    reader.setReadLimits( ReadLimits::unlimited() );
+    const QStringList dlls = reader.getNeededSharedLibraries(map);
+    REQUIRE( dlls.size() == 3 );
+    REQUIRE( dlls[0] == QLatin1String("A.dll") );
+    REQUIRE( dlls[1] == QLatin1String("Bb.dll") );
+    REQUIRE( dlls[2] == QLatin1String("Ccc.dll") );
+  }
+
+  SECTION("section count")
+  {
+    limits.maximumSectionCount = 1;
+    reader.setReadLimits(limits);
+    REQUIRE_THROWS_AS( reader.getNeededSharedLibraries(map), ReadLimitExceededError );
+  }
+
+  SECTION("entry count")
+  {
+    limits.maximumEntryCount = 2;
+    reader.setReadLimits(limits);
+    REQUIRE_THROWS_AS( reader.getNeededSharedLibraries(map), ReadLimitExceededError );
+  }
+
+  SECTION("DLL name longer than the string limit")
+  {
+    limits.maximumStringTableByteCount = 6;
+    reader.setReadLimits(limits);
+    REQUIRE_THROWS_AS( reader.getNeededSharedLibraries(map), ExecutableFileReadError );
+  }
+
+  SECTION("total byte count - reading several times charges once")
+  {
+    limits.maximumTotalByteCount = byteCountToRead;
+    reader.setReadLimits(limits);
+    REQUIRE( reader.getNeededSharedLibraries(map).size() == 3 );
+    REQUIRE( reader.getNeededSharedLibraries(map).size() == 3 );
+  }
+
+  SECTION("total byte count exceeded")
+  {
+    limits.maximumTotalByteCount = byteCountToRead - 1;
+    reader.setReadLimits(limits);
+    REQUIRE_THROWS_AS( reader.getNeededSharedLibraries(map), ReadLimitExceededError );
+  }
+
+  SECTION("the budget is reset by clear")
+  {
+    limits.maximumTotalByteCount = byteCountToRead;
+    reader.setReadLimits(limits);
+    REQUIRE( reader.getNeededSharedLibraries(map).size() == 3 );
+    reader.clear();
+    REQUIRE( reader.getNeededSharedLibraries(map).size() == 3 );
+  }
+}
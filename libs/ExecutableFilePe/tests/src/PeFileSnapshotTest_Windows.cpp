@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "TestBinariesUtils.h"
+#include "Mdt/ExecutableFile/PeFileSnapshot.h"
+#include "Mdt/ExecutableFile/PeFileIoEngine.h"
+#include <QString>
+#include <QStringList>
+#include <thread>
+#include <vector>
+
+using namespace Mdt::ExecutableFile;
+
+
+TEST_CASE("fromFile")
+{
+  PeFileSnapshot snapshot;
+  REQUIRE( snapshot.isNull() );
+
+  SECTION("shared library")
+  {
+    snapshot = PeFileSnapshot::fromFile( testSharedLibraryFilePath() );
+    REQUIRE( !snapshot.isNull() );
+    REQUIRE( snapshot.dosHeader().seemsValid() );
+    REQUIRE( snapshot.coffHeader().seemsValid() );
+    REQUIRE( snapshot.coffHeader().isDll() );
+    REQUIRE( snapshot.optionalHeader().seemsValid() );
+    REQUIRE( containsQt5Core( snapshot.neededSharedLibraries() ) );
+  }
+
+  SECTION("dynamic linked executable")
+  {
+    snapshot = PeFileSnapshot::fromFile( testExecutableFilePath() );
+    REQUIRE( !snapshot.isNull() );
+    REQUIRE( !snapshot.coffHeader().isDll() );
+    REQUIRE( containsTestSharedLibrary( snapshot.neededSharedLibraries() ) );
+  }
+}
+
+TEST_CASE("sameResultAsIoEngine")
+{
+  const PeFileSnapshot snapshot = PeFileSnapshot::fromFile( testSharedLibraryFilePath() );
+
+  PeFileIoEngine engine;
+  engine.openFile( testSharedLibraryFilePath(), ExecutableFileOpenMode::ReadOnly );
+
+  REQUIRE( snapshot.neededSharedLibraries() == engine.getNeededSharedLibraries() );
+
+  engine.close();
+}
+
+TEST_CASE("shareAcrossThreads")
+{
+  PeFileSnapshot snapshot = PeFileSnapshot::fromFile( testSharedLibraryFilePath() );
+  const QStringList expectedLibraries = snapshot.neededSharedLibraries();
+
+  constexpr size_t threadCount = 4;
+  std::vector<QStringList> results(threadCount);
+  std::vector<std::thread> threads;
+
+  for(size_t i = 0; i < threadCount; ++i){
+    const PeFileSnapshot copy = snapshot;
+    threads.emplace_back([copy, &results, i](){
+      results[i] = copy.neededSharedLibraries();
+    });
+  }
+
+  /*
+   * The mapping must stay alive while copies exist
+   */
+  snapshot = PeFileSnapshot();
+
+  for(auto & thread : threads){
+    thread.join();
+  }
+
+  for(const auto & libraries : results){
+    REQUIRE( libraries == expectedLibraries );
+  }
+}
+
+TEST_CASE("scan")
+{
+  ScanContext context;
+
+  const PeFileSnapshot snapshot = PeFileSnapshot::fromFile( testSharedLibraryFilePath() );
+  const FileScanResult result = snapshot.scan(context);
+
+  REQUIRE( result.format == ExecutableFileFormat::Pe );
+  REQUIRE( result.fileName.toQString() == snapshot.fileName() );
+  REQUIRE( result.soName.isNull() );
+  REQUIRE( result.runPath.isEmpty() );
+
+  const QStringList expectedLibraries = snapshot.neededSharedLibraries();
+  REQUIRE( result.neededSharedLibraries.size() == static_cast<size_t>( expectedLibraries.size() ) );
+  for(size_t i = 0; i < result.neededSharedLibraries.size(); ++i){
+    REQUIRE( result.neededSharedLibraries[i].toQString() == expectedLibraries.at( static_cast<int>(i) ) );
+  }
+
+  SECTION("scanning twice gives the same handles")
+  {
+    const std::size_t stringCount = context.stringPool().size();
+    const FileScanResult secondResult = snapshot.scan(context);
+
+    REQUIRE( context.stringPool().size() == stringCount );
+    REQUIRE( secondResult.fileName == result.fileName );
+    REQUIRE( secondResult.neededSharedLibraries.size() == result.neededSharedLibraries.size() );
+    for(size_t i = 0; i < result.neededSharedLibraries.size(); ++i){
+      REQUIRE( secondResult.neededSharedLibraries[i] == result.neededSharedLibraries[i] );
+    }
+  }
+}
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_DEPLOY_STAMP_H
+#define MDT_EXECUTABLE_FILE_DEPLOY_STAMP_H
+
+#include "Mdt/ExecutableFile/RPath.h"
+#include <QString>
+#include <QByteArray>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Record of the deployment of a executable file
+   *
+   * A deployment tool can write a stamp to each file it processed,
+   * with the run path it applied and a fingerprint of the input file
+   * (for example its SHA-256 hash).
+   * Reading the stamp back is much cheaper than reading the whole file,
+   * so a file that is already processed can be detected at once:
+   * \code
+   * ExecutableFileReader reader;
+   * reader.openFile(library);
+   * const DeployStamp stamp = reader.getDeployStamp();
+   * if( (stamp.inputFingerprint() == fingerprint) && (stamp.runPath() == rpath) ){
+   *   // Nothing to do
+   * }
+   * \endcode
+   *
+   * \sa ExecutableFileEditTransaction::setDeployStamp()
+   */
+  class DeployStamp
+  {
+   public:
+
+    /*! \brief Construct a null stamp
+     */
+    DeployStamp() noexcept = default;
+
+    /*! \brief Construct a stamp
+     *
+     * \pre \a toolVersion must not be empty
+     */
+    DeployStamp(const QString & toolVersion, const RPath & runPath, const QByteArray & inputFingerprint)
+     : mToolVersion(toolVersion),
+       mRunPath(runPath),
+       mInputFingerprint(inputFingerprint)
+    {
+      assert( !toolVersion.isEmpty() );
+    }
+
+    /*! \brief Copy construct a stamp from \a other
+     */
+    DeployStamp(const DeployStamp & other) = default;
+
+    /*! \brief Copy assign \a other to this stamp
+     */
+    DeployStamp & operator=(const DeployStamp & other) = default;
+
+    /*! \brief Move construct a stamp from \a other
+     */
+    DeployStamp(DeployStamp && other) noexcept = default;
+
+    /*! \brief Move assign \a other to this stamp
+     */
+    DeployStamp & operator=(DeployStamp && other) noexcept = default;
+
+    /*! \brief Check if this stamp is null
+     *
+     * A file that has no stamp returns a null one.
+     */
+    bool isNull() const noexcept
+    {
+      return mToolVersion.isEmpty();
+    }
+
+    /*! \brief Get the version of the tool that deployed the file
+     */
+    const QString & toolVersion() const noexcept
+    {
+      return mToolVersion;
+    }
+
+    /*! \brief Get the run path applied to the file
+     */
+    const RPath & runPath() const noexcept
+    {
+      return mRunPath;
+    }
+
+    /*! \brief Get the fingerprint of the file before it was deployed
+     */
+    const QByteArray & inputFingerprint() const noexcept
+    {
+      return mInputFingerprint;
+    }
+
+    /*! \brief Check if stamp \a a is equal to \a b
+     */
+    friend
+    bool operator==(const DeployStamp & a, const DeployStamp & b) noexcept
+    {
+      return (a.mToolVersion == b.mToolVersion) && (a.mRunPath == b.mRunPath)
+          && (a.mInputFingerprint == b.mInputFingerprint);
+    }
+
+    /*! \brief Check if stamp \a a is different to \a b
+     */
+    friend
+    bool operator!=(const DeployStamp & a, const DeployStamp & b) noexcept
+    {
+      return !(a == b);
+    }
+
+   private:
+
+    QString mToolVersion;
+    RPath mRunPath;
+    QByteArray mInputFingerprint;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_DEPLOY_STAMP_H
@@ -0,0 +1,557 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_EXECUTABLE_FILE_EDIT_TRANSACTION_H
+#define MDT_EXECUTABLE_FILE_EXECUTABLE_FILE_EDIT_TRANSACTION_H
+
+#include "Mdt/ExecutableFile/RPath.h"
+#include "Mdt/ExecutableFile/DeployStamp.h"
+#include <QString>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Kind of change applied to the needed shared libraries
+   */
+  enum class NeededSharedLibraryEditType
+  {
+    Add,      /*!< Add a library after the existing ones */
+    Remove,   /*!< Remove a library */
+    Replace   /*!< Replace a library with a other one, at the same position */
+  };
+
+  /*! \brief Change applied to the needed shared libraries (DT_NEEDED on ELF)
+   */
+  struct NeededSharedLibraryEdit
+  {
+    NeededSharedLibraryEditType type = NeededSharedLibraryEditType::Add;
+    QString library;
+    QString newLibrary;
+  };
+
+  /*! \brief Flags of the ELF DT_FLAGS entry
+   */
+  enum DynamicFlag : uint64_t
+  {
+    DynamicFlagOrigin = 0x1,      /*!< DF_ORIGIN */
+    DynamicFlagSymbolic = 0x2,    /*!< DF_SYMBOLIC */
+    DynamicFlagTextRel = 0x4,     /*!< DF_TEXTREL */
+    DynamicFlagBindNow = 0x8,     /*!< DF_BIND_NOW */
+    DynamicFlagStaticTls = 0x10   /*!< DF_STATIC_TLS */
+  };
+
+  /*! \brief Some flags of the ELF DT_FLAGS_1 entry
+   */
+  enum DynamicFlag1 : uint64_t
+  {
+    DynamicFlag1Now = 0x1,        /*!< DF_1_NOW */
+    DynamicFlag1Global = 0x2,     /*!< DF_1_GLOBAL */
+    DynamicFlag1NoDelete = 0x8,   /*!< DF_1_NODELETE */
+    DynamicFlag1Origin = 0x80,    /*!< DF_1_ORIGIN */
+    DynamicFlag1Pie = 0x8000000   /*!< DF_1_PIE */
+  };
+
+  /*! \brief Load segments to align for huge pages
+   */
+  enum class HugePageAlignment
+  {
+    None,                           /*!< Keep the alignment of the load segments */
+    ExecutableSegments,             /*!< Align the executable load segments */
+    ExecutableAndReadOnlySegments   /*!< Align the executable and the read only load segments */
+  };
+
+  /*! \brief A set of changes to apply to a executable file at once
+   *
+   * Each change queued in a transaction is only recorded.
+   * They are all applied by ExecutableFileWriter::applyEdits(),
+   * which reads the file once, computes the new layout once
+   * and writes the result once.
+   *
+   * \code
+   * ExecutableFileEditTransaction edits;
+   * edits.setRunPath(rpath);
+   * edits.setSoName( QLatin1String("libA.so.1") );
+   * edits.replaceNeededSharedLibrary( QLatin1String("libB.so"), QLatin1String("libB.so.2") );
+   * edits.addDynamicFlags(DynamicFlagBindNow);
+   * edits.stripNonAllocatedSections();
+   * edits.rebuildGnuHashTable();
+   * edits.alignLoadSegmentsForHugePages();
+   * edits.packRelativeRelocations();
+   * edits.compactDynamicStringTable();
+   * edits.setDeployStamp( DeployStamp(toolVersion, rpath, fingerprint) );
+   * edits.splitDebugInfoTo( QLatin1String("/build/debug/libA.so.1.debug") );
+   *
+   * ExecutableFileWriter writer;
+   * writer.openFile(library);
+   * writer.applyEdits(edits);
+   * writer.close();
+   * \endcode
+   *
+   * Changes that are not supported by the executable file format
+   * are ignored (for example, the run path on a PE image).
+   */
+  class ExecutableFileEditTransaction
+  {
+   public:
+
+    /*! \brief Set the run path (DT_RUNPATH on ELF)
+     *
+     * If \a rPath is empty, the run path will be removed.
+     */
+    void setRunPath(const RPath & rPath)
+    {
+      mRunPath = rPath;
+    }
+
+    /*! \brief Check if this transaction sets the run path
+     */
+    bool changesRunPath() const noexcept
+    {
+      return mRunPath.has_value();
+    }
+
+    /*! \brief Get the run path to set
+     *
+     * \pre this transaction must set the run path
+     * \sa changesRunPath()
+     */
+    const RPath & runPath() const noexcept
+    {
+      assert( changesRunPath() );
+
+      return *mRunPath;
+    }
+
+    /*! \brief Set the SO name (DT_SONAME on ELF)
+     *
+     * If \a soName is empty, the SO name will be removed.
+     */
+    void setSoName(const QString & soName)
+    {
+      mSoName = soName;
+    }
+
+    /*! \brief Check if this transaction sets the SO name
+     */
+    bool changesSoName() const noexcept
+    {
+      return mSoName.has_value();
+    }
+
+    /*! \brief Get the SO name to set
+     *
+     * \pre this transaction must set the SO name
+     * \sa changesSoName()
+     */
+    const QString & soName() const noexcept
+    {
+      assert( changesSoName() );
+
+      return *mSoName;
+    }
+
+    /*! \brief Add \a library to the needed shared libraries
+     *
+     * \pre \a library must not be empty
+     */
+    void addNeededSharedLibrary(const QString & library)
+    {
+      assert( !library.trimmed().isEmpty() );
+
+      mNeededSharedLibraryEdits.push_back({NeededSharedLibraryEditType::Add, library, QString()});
+    }
+
+    /*! \brief Remove \a library from the needed shared libraries
+     *
+     * \pre \a library must not be empty
+     */
+    void removeNeededSharedLibrary(const QString & library)
+    {
+      assert( !library.trimmed().isEmpty() );
+
+      mNeededSharedLibraryEdits.push_back({NeededSharedLibraryEditType::Remove, library, QString()});
+    }
+
+    /*! \brief Replace \a library with \a newLibrary in the needed shared libraries
+     *
+     * \pre \a library and \a newLibrary must not be empty
+     */
+    void replaceNeededSharedLibrary(const QString & library, const QString & newLibrary)
+    {
+      assert( !library.trimmed().isEmpty() );
+      assert( !newLibrary.trimmed().isEmpty() );
+
+      mNeededSharedLibraryEdits.push_back({NeededSharedLibraryEditType::Replace, library, newLibrary});
+    }
+
+    /*! \brief Get the changes to the needed shared libraries, in the order they have been queued
+     */
+    const std::vector<NeededSharedLibraryEdit> & neededSharedLibraryEdits() const noexcept
+    {
+      return mNeededSharedLibraryEdits;
+    }
+
+    /*! \brief Set the program interpreter (PT_INTERP on ELF)
+     *
+     * \pre \a path must not be empty
+     */
+    void setProgramInterpreter(const QString & path)
+    {
+      assert( !path.trimmed().isEmpty() );
+
+      mProgramInterpreter = path;
+    }
+
+    /*! \brief Check if this transaction sets the program interpreter
+     */
+    bool changesProgramInterpreter() const noexcept
+    {
+      return mProgramInterpreter.has_value();
+    }
+
+    /*! \brief Get the program interpreter to set
+     *
+     * \pre this transaction must set the program interpreter
+     * \sa changesProgramInterpreter()
+     */
+    const QString & programInterpreter() const noexcept
+    {
+      assert( changesProgramInterpreter() );
+
+      return *mProgramInterpreter;
+    }
+
+    /*! \brief Add \a flags to the DT_FLAGS entry
+     *
+     * \sa DynamicFlag
+     */
+    void addDynamicFlags(uint64_t flags) noexcept
+    {
+      mDynamicFlagsToAdd |= flags;
+    }
+
+    /*! \brief Get the flags to add to the DT_FLAGS entry
+     */
+    uint64_t dynamicFlagsToAdd() const noexcept
+    {
+      return mDynamicFlagsToAdd;
+    }
+
+    /*! \brief Add \a flags to the DT_FLAGS_1 entry
+     *
+     * \sa DynamicFlag1
+     */
+    void addDynamicFlags1(uint64_t flags) noexcept
+    {
+      mDynamicFlags1ToAdd |= flags;
+    }
+
+    /*! \brief Get the flags to add to the DT_FLAGS_1 entry
+     */
+    uint64_t dynamicFlags1ToAdd() const noexcept
+    {
+      return mDynamicFlags1ToAdd;
+    }
+
+    /*! \brief Request immediate binding of all symbols at load time
+     *
+     * Adds DF_BIND_NOW to DT_FLAGS and DF_1_NOW to DT_FLAGS_1 ,
+     * like the linker does with \c -z \c now .
+     */
+    void setBindNow() noexcept
+    {
+      addDynamicFlags(DynamicFlagBindNow);
+      addDynamicFlags1(DynamicFlag1Now);
+    }
+
+    /*! \brief Remove the sections that are not needed at run time
+     *
+     * Like \c strip , the sections that do not occupy memory
+     * during process execution (.symtab, .strtab, .comment, .debug_* , ...)
+     * are removed and the file is compacted.
+     * Only the section name string table (.shstrtab) is kept.
+     *
+     * \note This is only supported on ELF files
+     */
+    void stripNonAllocatedSections() noexcept
+    {
+      mStripNonAllocatedSections = true;
+    }
+
+    /*! \brief Check if this transaction removes the sections not needed at run time
+     *
+     * \sa stripNonAllocatedSections()
+     */
+    bool stripsNonAllocatedSections() const noexcept
+    {
+      return mStripNonAllocatedSections;
+    }
+
+    /*! \brief Rebuild the GNU hash table (.gnu.hash on ELF)
+     *
+     * The table is rebuilt from the dynamic symbols,
+     * with a bloom filter and a count of buckets sized
+     * for the count of symbols.
+     * Old toolchains often produced tables that are too small,
+     * which makes the symbol lookup slower at load time.
+     *
+     * \note This is only supported on ELF files that already have a .gnu.hash section
+     */
+    void rebuildGnuHashTable() noexcept
+    {
+      mRebuildGnuHashTable = true;
+    }
+
+    /*! \brief Check if this transaction rebuilds the GNU hash table
+     *
+     * \sa rebuildGnuHashTable()
+     */
+    bool rebuildsGnuHashTable() const noexcept
+    {
+      return mRebuildGnuHashTable;
+    }
+
+    /*! \brief Align the load segments for huge pages
+     *
+     * The file content is shifted so that the file offset of each selected PT_LOAD segment
+     * is congruent with its virtual address modulo 2 MiB,
+     * and the segment alignment is raised to 2 MiB.
+     * The dynamic loader then maps the file at a 2 MiB aligned address,
+     * and the kernel can back the code with transparent huge pages
+     * (CONFIG_READ_ONLY_THP_FOR_FS), which reduces the iTLB misses of large binaries.
+     *
+     * The virtual addresses are not changed.
+     * A segment that is smaller than a huge page is left as is.
+     *
+     * \note This is only supported on ELF files
+     */
+    void alignLoadSegmentsForHugePages(HugePageAlignment segments = HugePageAlignment::ExecutableSegments) noexcept
+    {
+      mHugePageAlignment = segments;
+    }
+
+    /*! \brief Get the load segments this transaction aligns for huge pages
+     *
+     * \sa alignLoadSegmentsForHugePages()
+     */
+    HugePageAlignment hugePageAlignment() const noexcept
+    {
+      return mHugePageAlignment;
+    }
+
+    /*! \brief Check if this transaction aligns load segments for huge pages
+     *
+     * \sa alignLoadSegmentsForHugePages()
+     */
+    bool alignsLoadSegmentsForHugePages() const noexcept
+    {
+      return mHugePageAlignment != HugePageAlignment::None;
+    }
+
+    /*! \brief Pack the relative relocations (DT_RELR on ELF)
+     *
+     * The relative relocations of the dynamic relocation table
+     * are encoded as a packed relative relocation table,
+     * which takes a few bits per relocation instead of a full entry.
+     * Large position independent executables carry a lot of those,
+     * so the file gets smaller and the dynamic loader processes them faster.
+     *
+     * A dynamic loader that does not know DT_RELR would silently skip them,
+     * so the file then requires the GLIBC_ABI_DT_RELR version of libc.so.6 (glibc 2.36 or later),
+     * like the GNU linker does with -z pack-relative-relocs .
+     *
+     * \note This is only supported on x86 and x86-64 ELF files linked against glibc
+     */
+    void packRelativeRelocations() noexcept
+    {
+      mPackRelativeRelocations = true;
+    }
+
+    /*! \brief Check if this transaction packs the relative relocations
+     *
+     * \sa packRelativeRelocations()
+     */
+    bool packsRelativeRelocations() const noexcept
+    {
+      return mPackRelativeRelocations;
+    }
+
+    /*! \brief Rebuild the dynamic string table (.dynstr on ELF) with only the strings still in use
+     *
+     * Every string referenced from the dynamic section,
+     * the dynamic symbol table and the symbol version sections
+     * is stored once, and a string that ends a other one
+     * (like libfoo.so in liblibfoo.so) shares its bytes.
+     * The strings left unused by the other edits of this transaction
+     * (like a previous SO name) are removed.
+     */
+    void compactDynamicStringTable() noexcept
+    {
+      mCompactDynamicStringTable = true;
+    }
+
+    /*! \brief Check if this transaction compacts the dynamic string table
+     *
+     * \sa compactDynamicStringTable()
+     */
+    bool compactsDynamicStringTable() const noexcept
+    {
+      return mCompactDynamicStringTable;
+    }
+
+    /*! \brief Write \a stamp to the file
+     *
+     * A existing stamp is replaced.
+     * The stamp can be read back without reading the whole file
+     * (see ExecutableFileReader::getDeployStamp()).
+     *
+     * On ELF, the stamp is a note, in a SHT_NOTE section that is not loaded,
+     * described by its own PT_NOTE program header.
+     *
+     * \pre \a stamp must not be null
+     * \note This is only supported on ELF files
+     */
+    void setDeployStamp(const DeployStamp & stamp)
+    {
+      assert( !stamp.isNull() );
+
+      mDeployStamp = stamp;
+    }
+
+    /*! \brief Check if this transaction writes a deployment stamp
+     *
+     * \sa setDeployStamp()
+     */
+    bool changesDeployStamp() const noexcept
+    {
+      return !mDeployStamp.isNull();
+    }
+
+    /*! \brief Get the deployment stamp to write
+     *
+     * \pre this transaction must write a deployment stamp
+     * \sa changesDeployStamp()
+     */
+    const DeployStamp & deployStamp() const noexcept
+    {
+      assert( changesDeployStamp() );
+
+      return mDeployStamp;
+    }
+
+    /*! \brief Move the debug information to the separate file \a debugFilePath
+     *
+     * The file, as it was before this transaction, is written to \a debugFilePath ,
+     * so it keeps the .symtab and .debug_* sections.
+     * The sections not needed at run time are then removed,
+     * like with stripNonAllocatedSections(),
+     * and a .gnu_debuglink section, with the name and the CRC of the debug file, is added.
+     * The build-id note is loaded, so it is kept.
+     *
+     * A debugger, or a symbolisation service, finds the debug file
+     * by its build-id or by the name in .gnu_debuglink .
+     *
+     * If the file has no debug information, no debug file is written,
+     * but the file is still stripped.
+     *
+     * \pre \a debugFilePath must not be empty
+     * \note This is only supported on ELF files
+     */
+    void splitDebugInfoTo(const QString & debugFilePath)
+    {
+      assert( !debugFilePath.trimmed().isEmpty() );
+
+      mDebugInfoFilePath = debugFilePath;
+    }
+
+    /*! \brief Check if this transaction moves the debug information to a separate file
+     *
+     * \sa splitDebugInfoTo()
+     */
+    bool splitsDebugInfo() const noexcept
+    {
+      return !mDebugInfoFilePath.isEmpty();
+    }
+
+    /*! \brief Get the path of the separate debug file
+     *
+     * \pre this transaction must move the debug information to a separate file
+     * \sa splitsDebugInfo()
+     */
+    const QString & debugInfoFilePath() const noexcept
+    {
+      assert( splitsDebugInfo() );
+
+      return mDebugInfoFilePath;
+    }
+
+    /*! \brief Check if this transaction changes anything
+     */
+    bool isEmpty() const noexcept
+    {
+      return !changesRunPath() && !changesSoName() && mNeededSharedLibraryEdits.empty()
+          && !changesProgramInterpreter() && (mDynamicFlagsToAdd == 0) && (mDynamicFlags1ToAdd == 0)
+          && !mStripNonAllocatedSections && !mRebuildGnuHashTable && !alignsLoadSegmentsForHugePages()
+          && !mPackRelativeRelocations && !mCompactDynamicStringTable && !changesDeployStamp()
+          && !splitsDebugInfo();
+    }
+
+    /*! \brief Check if this transaction changes more than the run path
+     */
+    bool changesMoreThanRunPath() const noexcept
+    {
+      return changesSoName() || !mNeededSharedLibraryEdits.empty()
+          || changesProgramInterpreter() || (mDynamicFlagsToAdd != 0) || (mDynamicFlags1ToAdd != 0)
+          || mStripNonAllocatedSections || mRebuildGnuHashTable || alignsLoadSegmentsForHugePages()
+          || mPackRelativeRelocations || mCompactDynamicStringTable || changesDeployStamp()
+          || splitsDebugInfo();
+    }
+
+    /*! \brief Clear this transaction
+     */
+    void clear() noexcept
+    {
+      mRunPath.reset();
+      mSoName.reset();
+      mNeededSharedLibraryEdits.clear();
+      mProgramInterpreter.reset();
+      mDynamicFlagsToAdd = 0;
+      mDynamicFlags1ToAdd = 0;
+      mStripNonAllocatedSections = false;
+      mRebuildGnuHashTable = false;
+      mHugePageAlignment = HugePageAlignment::None;
+      mPackRelativeRelocations = false;
+      mCompactDynamicStringTable = false;
+      mDeployStamp = DeployStamp();
+      mDebugInfoFilePath.clear();
+    }
+
+   private:
+
+    std::optional<RPath> mRunPath;
+    std::optional<QString> mSoName;
+    std::vector<NeededSharedLibraryEdit> mNeededSharedLibraryEdits;
+    std::optional<QString> mProgramInterpreter;
+    uint64_t mDynamicFlagsToAdd = 0;
+    uint64_t mDynamicFlags1ToAdd = 0;
+    bool mStripNonAllocatedSections = false;
+    bool mRebuildGnuHashTable = false;
+    HugePageAlignment mHugePageAlignment = HugePageAlignment::None;
+    bool mPackRelativeRelocations = false;
+    bool mCompactDynamicStringTable = false;
+    DeployStamp mDeployStamp;
+    QString mDebugInfoFilePath;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_EXECUTABLE_FILE_EDIT_TRANSACTION_H
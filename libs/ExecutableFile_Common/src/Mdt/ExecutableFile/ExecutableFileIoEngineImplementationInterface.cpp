@@ -8,6 +8,7 @@
  **
  *****************************************************************************************/
 #include "ExecutableFileIoEngineImplementationInterface.h"
+#include "Mdt/ExecutableFile/FileCloneUtils.h"
 
 namespace Mdt{ namespace ExecutableFile{
 
@@ -97,6 +98,14 @@ RPath ExecutableFileIoEngineImplementationInterface::getRunPath()
   return doGetRunPath();
 }
 
+DeployStamp ExecutableFileIoEngineImplementationInterface::getDeployStamp()
+{
+  assert( isOpen() );
+  assert( isExecutableOrSharedLibrary() );
+
+  return doGetDeployStamp();
+}
+
 void ExecutableFileIoEngineImplementationInterface::setRunPath(const RPath & rPath)
 {
   assert( isOpen() );
@@ -105,6 +114,18 @@ void ExecutableFileIoEngineImplementationInterface::setRunPath(const RPath & rPa
   doSetRunPath(rPath);
 }
 
+void ExecutableFileIoEngineImplementationInterface::applyEdits(const ExecutableFileEditTransaction & edits)
+{
+  assert( isOpen() );
+  assert( isExecutableOrSharedLibrary() );
+
+  if( edits.isEmpty() ){
+    return;
+  }
+
+  doApplyEdits(edits);
+}
+
 qint64 ExecutableFileIoEngineImplementationInterface::fileSize() const noexcept
 {
   assert( isOpen() );
@@ -117,11 +138,30 @@ void ExecutableFileIoEngineImplementationInterface::resizeFile(qint64 size)
   assert( isOpen() );
   assert( size > 0 );
 
+  const qint64 previousSize = mFile.size();
+
+  /*
+   * Accessing a mapping past the end of the file raises a bus error,
+   * so do not keep one that would be longer than the file.
+   */
+  if(size < previousSize){
+    mFileMapper.unmap(mFile);
+  }
+
   if( !mFile.resize(size) ){
     const QString msg = tr("resize file '%1' failed: %2")
                         .arg( fileName(), mFile.errorString() );
     throw ExecutableFileWriteError(msg);
   }
+
+  /*
+   * The grown part would be sparse.
+   * Reserve it now, so that running out of disk space
+   * is reported here instead of as a bus error while writing to the map.
+   */
+  if(size > previousSize){
+    preallocateFile(mFile, previousSize, size - previousSize);
+  }
 }
 
 
@@ -144,6 +184,13 @@ void ExecutableFileIoEngineImplementationInterface::doSetRunPath(const RPath &)
 {
 }
 
+void ExecutableFileIoEngineImplementationInterface::doApplyEdits(const ExecutableFileEditTransaction & edits)
+{
+  if( edits.changesRunPath() ){
+    doSetRunPath( edits.runPath() );
+  }
+}
+
 QIODevice::OpenMode ExecutableFileIoEngineImplementationInterface::qIoDeviceOpenModeFromOpenMode(ExecutableFileOpenMode mode) noexcept
 {
   switch(mode){
@@ -16,8 +16,11 @@
 #include "Mdt/ExecutableFile/ExecutableFileOpenMode.h"
 #include "Mdt/ExecutableFile/Platform.h"
 #include "Mdt/ExecutableFile/RPath.h"
+#include "Mdt/ExecutableFile/DeployStamp.h"
+#include "Mdt/ExecutableFile/ExecutableFileEditTransaction.h"
 #include "Mdt/ExecutableFile/FileMapper.h"
 #include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
 #include "mdt_executablefile_common_export.h"
 #include <QObject>
 #include <QFile>
@@ -47,6 +50,24 @@ namespace Mdt{ namespace ExecutableFile{
       return doSupportsPlatform(platform);
     }
 
+    /*! \brief Set the resource limits applied while reading files
+     *
+     * The limits are applied to the next opened file.
+     *
+     * \sa ReadLimits
+     */
+    void setReadLimits(const ReadLimits & limits) noexcept
+    {
+      mReadLimits = limits;
+    }
+
+    /*! \brief Get the resource limits applied while reading files
+     */
+    const ReadLimits & readLimits() const noexcept
+    {
+      return mReadLimits;
+    }
+
     /*! \brief Open a file
      *
      * This method does not check if \a fileInfo refers to a executable file of any format.
@@ -136,6 +157,19 @@ namespace Mdt{ namespace ExecutableFile{
      */
     RPath getRunPath();
 
+    /*! \brief Get the deployment stamp of the file this engine refers to
+     *
+     * Returns a null stamp if the file has none,
+     * or for executable formats that do not support it.
+     *
+     * \pre this engine must have a open file which is a executable or a shared library
+     * \sa isOpen()
+     * \sa isExecutableOrSharedLibrary()
+     * \sa ExecutableFileEditTransaction::setDeployStamp()
+     * \exception ExecutableFileReadError
+     */
+    DeployStamp getDeployStamp();
+
     /*! \brief Set the run path this engine refers to to \a rPath
      *
      * For executable formats that do not support rpath,
@@ -148,6 +182,17 @@ namespace Mdt{ namespace ExecutableFile{
      */
     void setRunPath(const RPath & rPath);
 
+    /*! \brief Apply all the changes of \a edits to the file this engine refers to
+     *
+     * Changes not supported by the executable format are ignored.
+     *
+     * \pre this engine must have a open file which is a executable or a shared library
+     * \sa isOpen()
+     * \sa isExecutableOrSharedLibrary()
+     * \exception ExecutableFileWriteError
+     */
+    void applyEdits(const ExecutableFileEditTransaction & edits);
+
    signals:
 
     void message(const QString & message) const;
@@ -163,6 +208,11 @@ namespace Mdt{ namespace ExecutableFile{
     qint64 fileSize() const noexcept;
 
     /*! \brief Resize current file
+     *
+     * When the file grows, the disk space is reserved
+     * (see preallocateFile()).
+     * When it shrinks, the current mapping is released,
+     * so mapIfRequired() must be called again to access the file.
      *
      * \pre this engine must have a open file
      * \sa isOpen()
@@ -218,11 +268,24 @@ namespace Mdt{ namespace ExecutableFile{
 
     virtual void doSetRunPath(const RPath & rPath);
 
+    virtual DeployStamp doGetDeployStamp()
+    {
+      return DeployStamp();
+    }
+
+    /*! \brief Apply \a edits
+     *
+     * The default implementation only applies the run path,
+     * using doSetRunPath().
+     */
+    virtual void doApplyEdits(const ExecutableFileEditTransaction & edits);
+
     static
     QIODevice::OpenMode qIoDeviceOpenModeFromOpenMode(ExecutableFileOpenMode mode) noexcept;
 
     FileMapper mFileMapper;
     QFile mFile;
+    ReadLimits mReadLimits;
   };
 
 }} // namespace Mdt{ namespace ExecutableFile{
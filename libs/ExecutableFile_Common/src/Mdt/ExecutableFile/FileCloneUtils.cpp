@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "FileCloneUtils.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include <QtGlobal>
+#include <QByteArray>
+#include <QFileInfo>
+#include <cassert>
+
+#ifdef Q_OS_UNIX
+ #include <unistd.h>
+ #include <fcntl.h>
+ #include <cstdio>
+ #include <cerrno>
+ #include <cstring>
+#endif
+
+#ifdef Q_OS_LINUX
+ #include <sys/ioctl.h>
+ #include <linux/fs.h>
+#endif
+
+#ifdef Q_OS_WIN
+ #include <windows.h>
+ #include <io.h>
+ #include <string>
+#endif
+
+namespace Mdt{ namespace ExecutableFile{
+
+namespace{
+
+#ifdef Q_OS_UNIX
+QString errnoString(int error)
+{
+  return QString::fromLocal8Bit( std::strerror(error) );
+}
+
+void syncParentDirectory(const QString & filePath)
+{
+  const QString directoryPath = QFileInfo(filePath).absolutePath();
+  const QByteArray directory = QFile::encodeName(directoryPath);
+
+  const int fd = ::open(directory.constData(), O_RDONLY | O_DIRECTORY);
+  if(fd < 0){
+    const int error = errno;
+    const QString msg = tr("could not open directory '%1': %2")
+                        .arg( directoryPath, errnoString(error) );
+    throw ExecutableFileWriteError(msg);
+  }
+  // Some file systems do not support syncing a directory
+  if( (::fsync(fd) != 0) && (errno != EINVAL) ){
+    const int error = errno;
+    ::close(fd);
+    const QString msg = tr("could not flush directory '%1' to the storage device: %2")
+                        .arg( directoryPath, errnoString(error) );
+    throw ExecutableFileWriteError(msg);
+  }
+  ::close(fd);
+}
+#endif
+
+bool tryReflink(QFile & source, QFile & destination) noexcept
+{
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+  return ::ioctl(destination.handle(), FICLONE, source.handle()) == 0;
+#else
+  Q_UNUSED(source)
+  Q_UNUSED(destination)
+  return false;
+#endif
+}
+
+/*
+ * Returns false, without having copied anything,
+ * if copy_file_range() is not supported for those files
+ */
+bool tryCopyFileRange(QFile & source, QFile & destination, qint64 size)
+{
+#if defined(Q_OS_LINUX) && defined(__GLIBC__) && ( (__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27) )
+  loff_t sourceOffset = 0;
+  loff_t destinationOffset = 0;
+  qint64 remaining = size;
+
+  while(remaining > 0){
+    const ssize_t copied = ::copy_file_range( source.handle(), &sourceOffset, destination.handle(), &destinationOffset,
+                                              static_cast<size_t>(remaining), 0 );
+    if(copied < 0){
+      const int error = errno;
+      if( (remaining == size) && ( (error == ENOSYS) || (error == EXDEV) || (error == EINVAL) || (error == EOPNOTSUPP) ) ){
+        return false;
+      }
+      const QString msg = tr("copy of file '%1' to '%2' failed: %3")
+                          .arg( source.fileName(), destination.fileName(), errnoString(error) );
+      throw ExecutableFileWriteError(msg);
+    }
+    if(copied == 0){
+      const QString msg = tr("copy of file '%1' to '%2' failed: source file is shorter than expected")
+                          .arg( source.fileName(), destination.fileName() );
+      throw ExecutableFileWriteError(msg);
+    }
+    remaining -= copied;
+  }
+
+  return true;
+#else
+  Q_UNUSED(source)
+  Q_UNUSED(destination)
+  Q_UNUSED(size)
+  return false;
+#endif
+}
+
+void streamedCopy(QFile & source, QFile & destination)
+{
+  constexpr qint64 chunkSize = 1024*1024;
+  QByteArray buffer( static_cast<int>(chunkSize), '\0' );
+
+  if( !source.seek(0) ){
+    const QString msg = tr("copy of file '%1' to '%2' failed: %3")
+                        .arg( source.fileName(), destination.fileName(), source.errorString() );
+    throw ExecutableFileWriteError(msg);
+  }
+
+  while( true ){
+    const qint64 readSize = source.read(buffer.data(), chunkSize);
+    if(readSize < 0){
+      const QString msg = tr("copy of file '%1' to '%2' failed: %3")
+                          .arg( source.fileName(), destination.fileName(), source.errorString() );
+      throw ExecutableFileWriteError(msg);
+    }
+    if(readSize == 0){
+      break;
+    }
+    if( destination.write(buffer.constData(), readSize) != readSize ){
+      const QString msg = tr("copy of file '%1' to '%2' failed: %3")
+                          .arg( source.fileName(), destination.fileName(), destination.errorString() );
+      throw ExecutableFileWriteError(msg);
+    }
+  }
+
+  if( !destination.flush() ){
+    const QString msg = tr("copy of file '%1' to '%2' failed: %3")
+                        .arg( source.fileName(), destination.fileName(), destination.errorString() );
+    throw ExecutableFileWriteError(msg);
+  }
+}
+
+} // namespace{
+
+FileCloneMethod cloneFileContent(QFile & source, QFile & destination)
+{
+  assert( source.isOpen() );
+  assert( destination.isOpen() );
+  assert( destination.size() == 0 );
+
+  if( tryReflink(source, destination) ){
+    return FileCloneMethod::Reflink;
+  }
+  if( tryCopyFileRange( source, destination, source.size() ) ){
+    return FileCloneMethod::CopyFileRange;
+  }
+  streamedCopy(source, destination);
+
+  return FileCloneMethod::StreamedCopy;
+}
+
+void preallocateFile(QFile & file, qint64 offset, qint64 length)
+{
+  assert( file.isOpen() );
+  assert( offset >= 0 );
+  assert( length >= 0 );
+
+  if(length == 0){
+    return;
+  }
+
+#if defined(Q_OS_LINUX)
+  if( !file.flush() ){
+    const QString msg = tr("could not reserve space for file '%1': %2")
+                        .arg( file.fileName(), file.errorString() );
+    throw ExecutableFileWriteError(msg);
+  }
+  const int error = ::posix_fallocate( file.handle(), static_cast<off_t>(offset), static_cast<off_t>(length) );
+  // Some file systems (for example tmpfs on old kernels) do not support it
+  if( (error != 0) && (error != EOPNOTSUPP) && (error != ENOSYS) && (error != EINVAL) ){
+    const QString msg = tr("could not reserve %1 bytes for file '%2': %3")
+                        .arg( length ).arg( file.fileName(), errnoString(error) );
+    throw ExecutableFileWriteError(msg);
+  }
+#else
+  Q_UNUSED(file)
+  Q_UNUSED(offset)
+  Q_UNUSED(length)
+#endif
+}
+
+void syncFile(QFile & file)
+{
+  assert( file.isOpen() );
+
+  bool ok = file.flush();
+#if defined(Q_OS_UNIX)
+  ok = ok && (::fsync( file.handle() ) == 0);
+#elif defined(Q_OS_WIN)
+  ok = ok && (::_commit( file.handle() ) == 0);
+#endif
+
+  if(!ok){
+    const QString msg = tr("could not flush file '%1' to the storage device")
+                        .arg( file.fileName() );
+    throw ExecutableFileWriteError(msg);
+  }
+}
+
+void replaceFileAtomically(const QString & sourceFilePath, const QString & destinationFilePath)
+{
+  assert( !sourceFilePath.isEmpty() );
+  assert( !destinationFilePath.isEmpty() );
+
+#if defined(Q_OS_UNIX)
+  const QByteArray source = QFile::encodeName(sourceFilePath);
+  const QByteArray destination = QFile::encodeName(destinationFilePath);
+  if( ::rename( source.constData(), destination.constData() ) != 0 ){
+    const int error = errno;
+    const QString msg = tr("could not rename '%1' to '%2': %3")
+                        .arg( sourceFilePath, destinationFilePath, errnoString(error) );
+    throw ExecutableFileWriteError(msg);
+  }
+  /*
+   * The rename is only durable once the directory entry is on the storage device
+   */
+  syncParentDirectory(destinationFilePath);
+#elif defined(Q_OS_WIN)
+  const std::wstring source = sourceFilePath.toStdWString();
+  const std::wstring destination = destinationFilePath.toStdWString();
+  if( !::MoveFileExW( source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) ){
+    const QString msg = tr("could not rename '%1' to '%2'")
+                        .arg( sourceFilePath, destinationFilePath );
+    throw ExecutableFileWriteError(msg);
+  }
+#else
+  QFile::remove(destinationFilePath);
+  if( !QFile::rename(sourceFilePath, destinationFilePath) ){
+    const QString msg = tr("could not rename '%1' to '%2'")
+                        .arg( sourceFilePath, destinationFilePath );
+    throw ExecutableFileWriteError(msg);
+  }
+#endif
+}
+
+}} // namespace Mdt{ namespace ExecutableFile{
@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_FILE_CLONE_UTILS_H
+#define MDT_EXECUTABLE_FILE_FILE_CLONE_UTILS_H
+
+#include "Mdt/ExecutableFile/ExecutableFileWriteError.h"
+#include "mdt_executablefile_common_export.h"
+#include <QFile>
+#include <QString>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \internal How the content of a file has been cloned
+   *
+   * \sa cloneFileContent()
+   */
+  enum class FileCloneMethod
+  {
+    Reflink,        /*!< The destination shares the extents of the source (FICLONE, for example on btrfs or xfs) */
+    CopyFileRange,  /*!< The kernel copied the data (copy_file_range) */
+    StreamedCopy    /*!< The data was read and written back in user space */
+  };
+
+  /*! \internal Copy the whole content of \a source to \a destination
+   *
+   * The cheapest available method is tried first:
+   * a reflink clone, then copy_file_range,
+   * and finally a streamed copy (which is the only method on non Linux systems).
+   *
+   * \pre \a source must be open for reading
+   * \pre \a destination must be open for writing and be empty
+   * \exception ExecutableFileWriteError
+   */
+  MDT_EXECUTABLEFILE_COMMON_EXPORT
+  FileCloneMethod cloneFileContent(QFile & source, QFile & destination);
+
+  /*! \internal Reserve disk space for the \a length bytes of \a file starting at \a offset
+   *
+   * Once the space is reserved, writing to a memory map of \a file
+   * can no longer fail because the disk is full
+   * (which would be reported as a bus error).
+   *
+   * Only the given range is reserved,
+   * so a file that grows only reserves its new part.
+   *
+   * Does nothing on file systems, or systems, that do not support it.
+   *
+   * \pre \a file must be open for writing
+   * \exception ExecutableFileWriteError
+   */
+  MDT_EXECUTABLEFILE_COMMON_EXPORT
+  void preallocateFile(QFile & file, qint64 offset, qint64 length);
+
+  /*! \internal Flush the content of \a file to the storage device
+   *
+   * \pre \a file must be open
+   * \exception ExecutableFileWriteError
+   */
+  MDT_EXECUTABLEFILE_COMMON_EXPORT
+  void syncFile(QFile & file);
+
+  /*! \internal Rename \a sourceFilePath to \a destinationFilePath
+   *
+   * If \a destinationFilePath exists, it is replaced.
+   * On POSIX systems, the replacement is atomic:
+   * a other process sees either the old file or the new one,
+   * never a partially written one.
+   * The directory that contains \a destinationFilePath is then flushed
+   * to the storage device, so the replacement survives a power loss.
+   *
+   * \pre both paths must be on the same file system
+   * \exception ExecutableFileWriteError
+   */
+  MDT_EXECUTABLEFILE_COMMON_EXPORT
+  void replaceFileAtomically(const QString & sourceFilePath, const QString & destinationFilePath);
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_FILE_CLONE_UTILS_H
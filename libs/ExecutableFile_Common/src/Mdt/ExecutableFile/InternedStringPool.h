@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_INTERNED_STRING_POOL_H
+#define MDT_EXECUTABLE_FILE_INTERNED_STRING_POOL_H
+
+#include "Mdt/ExecutableFile/MonotonicArena.h"
+#include <QString>
+#include <QByteArray>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Handle to a string stored in a InternedStringPool
+   *
+   * A interned string is a pointer to the single copy of its content
+   * stored in the pool.
+   * Comparing 2 interned strings from the same pool is a pointer compare.
+   *
+   * The handle is only valid as long as the pool that created it is alive.
+   * A default constructed interned string is null.
+   */
+  class InternedString
+  {
+   public:
+
+    /*! \brief Construct a null interned string
+     */
+    constexpr
+    InternedString() noexcept = default;
+
+    /*! \brief Check if this string is null
+     */
+    constexpr
+    bool isNull() const noexcept
+    {
+      return mEntry == nullptr;
+    }
+
+    /*! \brief Get the id of this string in its pool
+     *
+     * Ids are given in insertion order, starting from 0.
+     *
+     * \pre this string must not be null
+     */
+    uint32_t id() const noexcept
+    {
+      assert( !isNull() );
+
+      return mEntry->id;
+    }
+
+    /*! \brief Get a view to the UTF-8 content of this string
+     *
+     * The view is null terminated.
+     * Returns a empty view for a null string.
+     */
+    std::string_view view() const noexcept
+    {
+      if( isNull() ){
+        return std::string_view();
+      }
+      return std::string_view(mEntry->data, mEntry->size);
+    }
+
+    /*! \brief Get this string as a QString
+     */
+    QString toQString() const
+    {
+      const std::string_view str = view();
+
+      return QString::fromUtf8( str.data(), static_cast<int>( str.size() ) );
+    }
+
+    friend
+    constexpr
+    bool operator==(const InternedString & a, const InternedString & b) noexcept
+    {
+      return a.mEntry == b.mEntry;
+    }
+
+    friend
+    constexpr
+    bool operator!=(const InternedString & a, const InternedString & b) noexcept
+    {
+      return a.mEntry != b.mEntry;
+    }
+
+   private:
+
+    friend class InternedStringPool;
+
+    struct Entry
+    {
+      const char *data;
+      uint32_t size;
+      uint32_t id;
+    };
+
+    constexpr
+    explicit
+    InternedString(const Entry *entry) noexcept
+     : mEntry(entry)
+    {
+    }
+
+    const Entry *mEntry = nullptr;
+  };
+
+  /*! \brief Pool that stores each distinct string only once
+   *
+   * When scanning many files,
+   * the same strings (like libc.so.6 or $ORIGIN/../lib)
+   * are found over and over.
+   * This pool stores a single copy of each of them in a MonotonicArena
+   * and hands out InternedString handles that refer to it.
+   *
+   * \code
+   * InternedStringPool pool;
+   * const InternedString a = pool.intern("libc.so.6");
+   * const InternedString b = pool.intern("libc.so.6");
+   * assert( a == b );
+   * \endcode
+   *
+   * This class is not thread safe.
+   */
+  class InternedStringPool
+  {
+   public:
+
+    InternedStringPool() = default;
+
+    InternedStringPool(const InternedStringPool & other) = delete;
+    InternedStringPool & operator=(const InternedStringPool & other) = delete;
+    InternedStringPool(InternedStringPool && other) = default;
+    InternedStringPool & operator=(InternedStringPool && other) = default;
+
+    /*! \brief Get the handle to \a str , adding it to this pool if required
+     *
+     * \a str is only copied the first time it is seen.
+     *
+     * \pre \a str must be smaller than 4 GiB
+     * \exception std::bad_alloc
+     */
+    InternedString intern(std::string_view str)
+    {
+      assert( str.size() < UINT32_MAX );
+
+      const auto it = mIndex.find(str);
+      if( it != mIndex.end() ){
+        return InternedString(it->second);
+      }
+
+      char *data = mArena.allocateArray<char>( str.size() + 1 );
+      if( !str.empty() ){
+        std::memcpy( data, str.data(), str.size() );
+      }
+      data[str.size()] = '\0';
+
+      auto *entry = static_cast<InternedString::Entry*>( mArena.allocate( sizeof(InternedString::Entry), alignof(InternedString::Entry) ) );
+      entry->data = data;
+      entry->size = static_cast<uint32_t>( str.size() );
+      entry->id = static_cast<uint32_t>( mEntries.size() );
+
+      mEntries.push_back(entry);
+      mIndex.emplace( std::string_view(data, str.size()), entry );
+
+      return InternedString(entry);
+    }
+
+    /*! \brief Get the handle to the null terminated \a str , adding it to this pool if required
+     *
+     * Without this overload, a string literal would be ambiguous
+     * between the std::string_view and the QString ones.
+     *
+     * \pre \a str must not be a nullptr
+     * \exception std::bad_alloc
+     */
+    InternedString intern(const char *str)
+    {
+      assert( str != nullptr );
+
+      return intern( std::string_view(str) );
+    }
+
+    /*! \brief Get the handle to \a str , adding it to this pool if required
+     *
+     * \a str is stored as UTF-8.
+     *
+     * \exception std::bad_alloc
+     */
+    InternedString intern(const QString & str)
+    {
+      const QByteArray utf8 = str.toUtf8();
+
+      return intern( std::string_view( utf8.constData(), static_cast<std::size_t>( utf8.size() ) ) );
+    }
+
+    /*! \brief Find \a str in this pool
+     *
+     * Returns a null handle if \a str was never interned.
+     */
+    InternedString find(std::string_view str) const noexcept
+    {
+      const auto it = mIndex.find(str);
+      if( it == mIndex.end() ){
+        return InternedString();
+      }
+      return InternedString(it->second);
+    }
+
+    /*! \brief Get the string that has \a id
+     *
+     * \pre \a id must be < size()
+     */
+    InternedString fromId(uint32_t id) const noexcept
+    {
+      assert( id < mEntries.size() );
+
+      return InternedString(mEntries[id]);
+    }
+
+    /*! \brief Get the count of distinct strings in this pool
+     */
+    std::size_t size() const noexcept
+    {
+      return mEntries.size();
+    }
+
+    /*! \brief Check if this pool is empty
+     */
+    bool isEmpty() const noexcept
+    {
+      return mEntries.empty();
+    }
+
+    /*! \brief Access the arena used by this pool
+     *
+     * Other trivially destructible objects
+     * that must live as long as the strings can be allocated from it.
+     */
+    MonotonicArena & arena() noexcept
+    {
+      return mArena;
+    }
+
+    /*! \brief Get the count of bytes reserved by this pool's arena
+     */
+    std::size_t reservedByteCount() const noexcept
+    {
+      return mArena.reservedByteCount();
+    }
+
+   private:
+
+    MonotonicArena mArena;
+    std::vector<const InternedString::Entry*> mEntries;
+    std::unordered_map<std::string_view, const InternedString::Entry*> mIndex;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_INTERNED_STRING_POOL_H
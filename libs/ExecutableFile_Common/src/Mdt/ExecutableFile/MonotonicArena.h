@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_MONOTONIC_ARENA_H
+#define MDT_EXECUTABLE_FILE_MONOTONIC_ARENA_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \internal Allocator that hands out memory from big blocks
+   *
+   * Allocated memory is never freed individually.
+   * All the memory is released at once when the arena is destroyed
+   * or when release() is called.
+   *
+   * Memory returned by allocate() stays at the same address
+   * for the whole lifetime of the arena (blocks are never moved).
+   *
+   * Only trivially destructible objects should be placed in the arena,
+   * because no destructor is ever called.
+   *
+   * This class is not thread safe.
+   */
+  class MonotonicArena
+  {
+   public:
+
+    /*! \brief Construct a arena that allocates blocks of \a blockSize bytes
+     *
+     * \pre \a blockSize must be > 0
+     */
+    explicit
+    MonotonicArena(std::size_t blockSize = 64*1024) noexcept
+     : mBlockSize(blockSize)
+    {
+      assert( blockSize > 0 );
+    }
+
+    MonotonicArena(const MonotonicArena & other) = delete;
+    MonotonicArena & operator=(const MonotonicArena & other) = delete;
+    MonotonicArena(MonotonicArena && other) noexcept = default;
+    MonotonicArena & operator=(MonotonicArena && other) noexcept = default;
+
+    /*! \brief Allocate \a size bytes aligned to \a alignment
+     *
+     * A request bigger than the block size gets a dedicated block.
+     *
+     * \pre \a alignment must be a power of 2
+     * \exception std::bad_alloc
+     */
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+      assert( alignment > 0 );
+      assert( (alignment & (alignment - 1)) == 0 );
+
+      std::size_t offset = alignedOffset(alignment);
+      if( mBlocks.empty() || (offset + size) > mCurrentBlockSize ){
+        addBlock( std::max(mBlockSize, size + alignment) );
+        offset = alignedOffset(alignment);
+      }
+      assert( (offset + size) <= mCurrentBlockSize );
+
+      void *ptr = mBlocks.back().get() + offset;
+      mCurrentBlockUsed = offset + size;
+      mAllocatedByteCount += size;
+
+      return ptr;
+    }
+
+    /*! \brief Allocate a uninitialized array of \a count objects of type T
+     *
+     * \exception std::bad_alloc
+     */
+    template<typename T>
+    T *allocateArray(std::size_t count)
+    {
+      return static_cast<T*>( allocate(sizeof(T) * count, alignof(T)) );
+    }
+
+    /*! \brief Get the count of bytes handed out by this arena
+     */
+    std::size_t allocatedByteCount() const noexcept
+    {
+      return mAllocatedByteCount;
+    }
+
+    /*! \brief Get the count of bytes reserved from the system by this arena
+     */
+    std::size_t reservedByteCount() const noexcept
+    {
+      return mReservedByteCount;
+    }
+
+    /*! \brief Release all the memory
+     *
+     * \warning any pointer returned by allocate() becomes dangling
+     */
+    void release() noexcept
+    {
+      mBlocks.clear();
+      mCurrentBlockSize = 0;
+      mCurrentBlockUsed = 0;
+      mAllocatedByteCount = 0;
+      mReservedByteCount = 0;
+    }
+
+   private:
+
+    std::size_t alignedOffset(std::size_t alignment) const noexcept
+    {
+      if( mBlocks.empty() ){
+        return 0;
+      }
+      const auto address = reinterpret_cast<std::uintptr_t>( mBlocks.back().get() ) + mCurrentBlockUsed;
+      const auto alignedAddress = (address + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+
+      return mCurrentBlockUsed + static_cast<std::size_t>(alignedAddress - address);
+    }
+
+    void addBlock(std::size_t size)
+    {
+      mBlocks.emplace_back( new unsigned char[size] );
+      mCurrentBlockSize = size;
+      mCurrentBlockUsed = 0;
+      mReservedByteCount += size;
+    }
+
+    std::size_t mBlockSize;
+    std::size_t mCurrentBlockSize = 0;
+    std::size_t mCurrentBlockUsed = 0;
+    std::size_t mAllocatedByteCount = 0;
+    std::size_t mReservedByteCount = 0;
+    std::vector< std::unique_ptr<unsigned char[]> > mBlocks;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_MONOTONIC_ARENA_H
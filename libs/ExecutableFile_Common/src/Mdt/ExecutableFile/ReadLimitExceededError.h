@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_READ_LIMIT_EXCEEDED_ERROR_H
+#define MDT_EXECUTABLE_FILE_READ_LIMIT_EXCEEDED_ERROR_H
+
+#include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "mdt_executablefile_common_export.h"
+#include <QString>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Error when reading a executable file would exceed a configured limit
+   *
+   * \sa ReadLimits
+   */
+  class MDT_EXECUTABLEFILE_COMMON_EXPORT ReadLimitExceededError : public ExecutableFileReadError
+  {
+   public:
+
+    /*! \brief Constructor
+     */
+    explicit ReadLimitExceededError(const QString & what)
+      : ExecutableFileReadError(what)
+    {
+    }
+
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_READ_LIMIT_EXCEEDED_ERROR_H
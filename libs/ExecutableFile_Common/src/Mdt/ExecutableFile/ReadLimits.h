@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_READ_LIMITS_H
+#define MDT_EXECUTABLE_FILE_READ_LIMITS_H
+
+#include "Mdt/ExecutableFile/ReadLimitExceededError.h"
+#include <QCoreApplication>
+#include <QString>
+#include <QLatin1String>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <cstdint>
+#include <limits>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Resource limits applied while reading a file
+   *
+   * Readers trust the counts and sizes declared in the file headers.
+   * A crafted file can declare huge tables, or tables that are not terminated,
+   * and force the reader to allocate a lot of memory or to scan a lot of data.
+   *
+   * These limits are checked by the readers before such work is done.
+   * When a limit is exceeded, a ReadLimitExceededError is thrown.
+   *
+   * The default limits are generous enough for any sane executable or shared library.
+   * When scanning untrusted files, consider lowering them.
+   *
+   * \sa ReadBudget
+   */
+  struct ReadLimits
+  {
+    /*! \brief Maximum number of sections (ELF section headers, PE section table)
+     */
+    int64_t maximumSectionCount = 65535;
+
+    /*! \brief Maximum number of entries in a table
+     *
+     * Applies, for example, to the ELF .dynamic section
+     * and the PE import and delay load directory tables.
+     */
+    int64_t maximumEntryCount = 1024 * 1024;
+
+    /*! \brief Maximum size, in bytes, of a string table
+     */
+    int64_t maximumStringTableByteCount = 256 * 1024 * 1024;
+
+    /*! \brief Maximum number of bytes read from a file
+     */
+    int64_t maximumTotalByteCount = std::numeric_limits<int64_t>::max();
+
+    /*! \brief Get limits that never trigger
+     */
+    static
+    ReadLimits unlimited() noexcept
+    {
+      ReadLimits limits;
+
+      limits.maximumSectionCount = std::numeric_limits<int64_t>::max();
+      limits.maximumEntryCount = std::numeric_limits<int64_t>::max();
+      limits.maximumStringTableByteCount = std::numeric_limits<int64_t>::max();
+      limits.maximumTotalByteCount = std::numeric_limits<int64_t>::max();
+
+      return limits;
+    }
+  };
+
+  /*! \brief Enforce ReadLimits while reading a file
+   *
+   * A budget is meant to be used for one file:
+   * it accumulates the number of bytes read.
+   *
+   * The counts and sizes come from the file,
+   * so they are checked as unsigned 64-bit values,
+   * before any conversion that could make them negative.
+   */
+  class ReadBudget
+  {
+   public:
+
+    /*! \brief Construct a budget with \a limits
+     */
+    explicit ReadBudget(const ReadLimits & limits = ReadLimits()) noexcept
+     : mLimits(limits)
+    {
+    }
+
+    /*! \brief Get the limits of this budget
+     */
+    const ReadLimits & limits() const noexcept
+    {
+      return mLimits;
+    }
+
+    /*! \brief Set the limits
+     *
+     * \note this will not reset the count of bytes read
+     */
+    void setLimits(const ReadLimits & limits) noexcept
+    {
+      mLimits = limits;
+    }
+
+    /*! \brief Get the number of bytes read so far
+     */
+    int64_t readByteCount() const noexcept
+    {
+      return mReadByteCount;
+    }
+
+    /*! \brief Reset the count of bytes read
+     *
+     * This also forgets the regions accounted with consumeRegion()
+     */
+    void reset() noexcept
+    {
+      mReadByteCount = 0;
+      mConsumedRegions.clear();
+    }
+
+    /*! \brief Check that \a count sections are allowed
+     *
+     * \exception ReadLimitExceededError
+     */
+    void checkSectionCount(uint64_t count) const
+    {
+      if( exceedsLimit(count, mLimits.maximumSectionCount) ){
+        throwLimitExceeded("the file declares %1 sections, which exceeds the limit of %2", count, mLimits.maximumSectionCount);
+      }
+    }
+
+    /*! \brief Check that \a count entries are allowed in a table
+     *
+     * \exception ReadLimitExceededError
+     */
+    void checkEntryCount(uint64_t count) const
+    {
+      if( exceedsLimit(count, mLimits.maximumEntryCount) ){
+        throwLimitExceeded("a table contains %1 entries, which exceeds the limit of %2", count, mLimits.maximumEntryCount);
+      }
+    }
+
+    /*! \brief Check that a string table of \a byteCount bytes is allowed
+     *
+     * \exception ReadLimitExceededError
+     */
+    void checkStringTableByteCount(uint64_t byteCount) const
+    {
+      if( exceedsLimit(byteCount, mLimits.maximumStringTableByteCount) ){
+        throwLimitExceeded("a string table has %1 bytes, which exceeds the limit of %2 bytes", byteCount, mLimits.maximumStringTableByteCount);
+      }
+    }
+
+    /*! \brief Account \a byteCount bytes as read
+     *
+     * \exception ReadLimitExceededError
+     * \sa consumeRegion()
+     */
+    void consumeBytes(uint64_t byteCount)
+    {
+      assert( mReadByteCount >= 0 );
+
+      if( exceedsLimit(byteCount, mLimits.maximumTotalByteCount - mReadByteCount) ){
+        throwLimitExceeded("reading %1 more bytes would exceed the limit of %2 bytes read per file", byteCount, mLimits.maximumTotalByteCount);
+      }
+      mReadByteCount += static_cast<int64_t>(byteCount);
+    }
+
+    /*! \brief Account the \a byteCount bytes at \a offset as read
+     *
+     * A reader can extract the same table several times for one file,
+     * for example the section header table.
+     * Only the bytes of the region that were not already accounted
+     * since the last reset() are accounted,
+     * so overlapping regions are accounted once.
+     *
+     * The accounted regions are kept merged and sorted by offset,
+     * so a call costs O(log n) amortized, n being the count of disjoint regions.
+     *
+     * \note the region should be accounted before it is decoded,
+     *  so that a region that exceeds the limit is never decoded.
+     *
+     * \exception ReadLimitExceededError
+     */
+    void consumeRegion(uint64_t offset, uint64_t byteCount)
+    {
+      if(byteCount == 0){
+        return;
+      }
+
+      uint64_t end = std::numeric_limits<uint64_t>::max();
+      if( byteCount < end - offset ){
+        end = offset + byteCount;
+      }
+
+      // First region that overlaps, or touches, [offset, end)
+      auto first = mConsumedRegions.upper_bound(offset);
+      if( first != mConsumedRegions.begin() ){
+        const auto previous = std::prev(first);
+        if(previous->second >= offset){
+          first = previous;
+        }
+      }
+
+      uint64_t coveredByteCount = 0;
+      uint64_t mergedBegin = offset;
+      uint64_t mergedEnd = end;
+      auto last = first;
+      for( ; (last != mConsumedRegions.end()) && (last->first <= end); ++last ){
+        coveredByteCount += std::min(last->second, end) - std::max(last->first, offset);
+        mergedBegin = std::min(mergedBegin, last->first);
+        mergedEnd = std::max(mergedEnd, last->second);
+      }
+
+      consumeBytes(end - offset - coveredByteCount);
+
+      mConsumedRegions.erase(first, last);
+      mConsumedRegions.emplace(mergedBegin, mergedEnd);
+    }
+
+   private:
+
+    static
+    bool exceedsLimit(uint64_t value, int64_t limit) noexcept
+    {
+      if(limit < 0){
+        return true;
+      }
+
+      return value > static_cast<uint64_t>(limit);
+    }
+
+    [[noreturn]]
+    static
+    void throwLimitExceeded(const char *sourceText, uint64_t value, int64_t limit)
+    {
+      const QString message = QCoreApplication::translate("Mdt::ExecutableFile::ReadBudget", sourceText)
+                              .arg(value).arg(limit);
+      throw ReadLimitExceededError(message);
+    }
+
+    ReadLimits mLimits;
+    int64_t mReadByteCount = 0;
+    // Begin and end offsets of the disjoint accounted regions
+    std::map<uint64_t, uint64_t> mConsumedRegions;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_READ_LIMITS_H
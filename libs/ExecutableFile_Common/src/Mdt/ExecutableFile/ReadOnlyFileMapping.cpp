@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "ReadOnlyFileMapping.h"
+#include "Mdt/ExecutableFile/ExecutableFileReaderUtils.h"
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+ReadOnlyFileMapping::~ReadOnlyFileMapping() noexcept
+{
+  if(mMap != nullptr){
+    mFile.unmap(mMap);
+  }
+  mFile.close();
+}
+
+void ReadOnlyFileMapping::mapFile(const QFileInfo & fileInfo)
+{
+  assert( !fileInfo.filePath().isEmpty() );
+  assert( !isMapped() );
+
+  if( !fileInfo.exists() ){
+    const QString message = tr("file '%1' does not exist")
+                            .arg( fileInfo.absoluteFilePath() );
+    throw FileOpenError(message);
+  }
+
+  mFile.setFileName( fileInfo.absoluteFilePath() );
+  if( !mFile.open(QIODevice::ReadOnly) ){
+    const QString message = tr("could not open file '%1': %2")
+                            .arg( mFile.fileName(), mFile.errorString() );
+    throw FileOpenError(message);
+  }
+
+  const qint64 size = mFile.size();
+  if(size <= 0){
+    mFile.close();
+    const QString message = tr("could not map file '%1': file is empty")
+                            .arg( fileInfo.absoluteFilePath() );
+    throw FileOpenError(message);
+  }
+
+  mMap = mFile.map(0, size);
+  if(mMap == nullptr){
+    const QString message = tr("could not map file '%1': %2")
+                            .arg( mFile.fileName(), mFile.errorString() );
+    mFile.close();
+    throw FileOpenError(message);
+  }
+  mSize = size;
+}
+
+}} // namespace Mdt{ namespace ExecutableFile{
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_READ_ONLY_FILE_MAPPING_H
+#define MDT_EXECUTABLE_FILE_READ_ONLY_FILE_MAPPING_H
+
+#include "Mdt/ExecutableFile/ByteArraySpan.h"
+#include "Mdt/ExecutableFile/FileOpenError.h"
+#include "mdt_executablefile_common_export.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \internal Map a whole file read only into memory
+   *
+   * The file stays open and mapped until this object is destroyed.
+   * Once mapped, the memory can be read from any thread,
+   * as long as this object is alive.
+   *
+   * This class is not copyable.
+   * To share a mapping, hold it in a std::shared_ptr .
+   *
+   * \code
+   * ReadOnlyFileMapping mapping;
+   * mapping.mapFile(fileInfo);
+   * readHeader( mapping.span() );
+   * \endcode
+   */
+  class MDT_EXECUTABLEFILE_COMMON_EXPORT ReadOnlyFileMapping
+  {
+   public:
+
+    /*! \brief Construct a object that has no file mapped
+     */
+    ReadOnlyFileMapping() noexcept = default;
+
+    /*! \brief Unmap and close the file
+     */
+    ~ReadOnlyFileMapping() noexcept;
+
+    ReadOnlyFileMapping(const ReadOnlyFileMapping & other) = delete;
+    ReadOnlyFileMapping & operator=(const ReadOnlyFileMapping & other) = delete;
+    ReadOnlyFileMapping(ReadOnlyFileMapping && other) = delete;
+    ReadOnlyFileMapping & operator=(ReadOnlyFileMapping && other) = delete;
+
+    /*! \brief Open the file \a fileInfo refers to and map it into memory
+     *
+     * \pre \a fileInfo must have a file path set
+     * \pre this object must not already have a file mapped
+     * \sa isMapped()
+     * \exception FileOpenError
+     */
+    void mapFile(const QFileInfo & fileInfo);
+
+    /*! \brief Check if this object has a file mapped
+     */
+    bool isMapped() const noexcept
+    {
+      return mMap != nullptr;
+    }
+
+    /*! \brief Get the mapped memory
+     *
+     * \warning the returned span must only be used to read the file
+     * \pre this object must have a file mapped
+     * \sa isMapped()
+     */
+    ByteArraySpan span() const noexcept
+    {
+      assert( isMapped() );
+
+      ByteArraySpan map;
+      map.data = mMap;
+      map.size = mSize;
+
+      return map;
+    }
+
+    /*! \brief Get the name of the mapped file
+     */
+    QString fileName() const noexcept
+    {
+      return mFile.fileName();
+    }
+
+   private:
+
+    QFile mFile;
+    unsigned char *mMap = nullptr;
+    qint64 mSize = 0;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_READ_ONLY_FILE_MAPPING_H
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_READ_RESULT_H
+#define MDT_EXECUTABLE_FILE_READ_RESULT_H
+
+#include <utility>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Result of a read operation that does not throw
+   *
+   * Holds either a value of type \a T , or a error code of type \a ErrorCode .
+   *
+   * \a ErrorCode is a enumeration that must provide a \a NoError enumerator.
+   * \a T must be default constructible.
+   *
+   * Building a result never allocates a message:
+   * formatting a human readable message is left to the caller,
+   * only when it is required.
+   *
+   * \code
+   * const auto result = readFileHeader(map);
+   * if( !result ){
+   *   // maybe not a ELF file, just skip it
+   *   return;
+   * }
+   * const FileHeader & header = result.value();
+   * \endcode
+   */
+  template<typename T, typename ErrorCode>
+  class ReadResult
+  {
+   public:
+
+    /*! \brief Construct a result that holds \a value
+     */
+    ReadResult(const T & value) noexcept
+     : mValue(value)
+    {
+    }
+
+    /*! \brief Construct a result that holds \a value
+     */
+    ReadResult(T && value) noexcept
+     : mValue( std::move(value) )
+    {
+    }
+
+    /*! \brief Get a result for \a error
+     *
+     * \pre \a error must not be NoError
+     */
+    static
+    ReadResult fromError(ErrorCode error) noexcept
+    {
+      assert( error != ErrorCode::NoError );
+
+      ReadResult result;
+      result.mError = error;
+
+      return result;
+    }
+
+    /*! \brief Check if this result holds a value
+     */
+    bool hasValue() const noexcept
+    {
+      return mError == ErrorCode::NoError;
+    }
+
+    /*! \brief Check if this result holds a value
+     */
+    explicit operator bool() const noexcept
+    {
+      return hasValue();
+    }
+
+    /*! \brief Get the value
+     *
+     * \pre this result must hold a value
+     * \sa hasValue()
+     */
+    const T & value() const noexcept
+    {
+      assert( hasValue() );
+
+      return mValue;
+    }
+
+    /*! \brief Move the value out of this result
+     *
+     * \pre this result must hold a value
+     * \sa hasValue()
+     */
+    T takeValue() noexcept
+    {
+      assert( hasValue() );
+
+      return std::move(mValue);
+    }
+
+    /*! \brief Get the error
+     *
+     * Returns NoError if this result holds a value
+     */
+    ErrorCode error() const noexcept
+    {
+      return mError;
+    }
+
+   private:
+
+    ReadResult() noexcept = default;
+
+    T mValue;
+    ErrorCode mError = ErrorCode::NoError;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_READ_RESULT_H
@@ -0,0 +1,274 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#ifndef MDT_EXECUTABLE_FILE_SCAN_CONTEXT_H
+#define MDT_EXECUTABLE_FILE_SCAN_CONTEXT_H
+
+#include "Mdt/ExecutableFile/InternedStringPool.h"
+#include "Mdt/ExecutableFile/ExecutableFileFormat.h"
+#include <QString>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <cassert>
+
+namespace Mdt{ namespace ExecutableFile{
+
+  /*! \brief Read only list of interned strings
+   *
+   * The storage is owned by the ScanContext that created the list.
+   */
+  class InternedStringList
+  {
+   public:
+
+    using const_iterator = const InternedString*;
+
+    /*! \brief Construct a empty list
+     */
+    constexpr
+    InternedStringList() noexcept = default;
+
+    /*! \internal
+     */
+    constexpr
+    InternedStringList(const InternedString *data, std::size_t size) noexcept
+     : mData(data),
+       mSize(size)
+    {
+    }
+
+    /*! \brief Get the count of strings in this list
+     */
+    constexpr
+    std::size_t size() const noexcept
+    {
+      return mSize;
+    }
+
+    /*! \brief Check if this list is empty
+     */
+    constexpr
+    bool isEmpty() const noexcept
+    {
+      return mSize == 0;
+    }
+
+    /*! \brief Get the string at \a index
+     *
+     * \pre \a index must be in valid range
+     */
+    const InternedString & operator[](std::size_t index) const noexcept
+    {
+      assert( index < mSize );
+
+      return mData[index];
+    }
+
+    /*! \brief Check if \a str is in this list
+     *
+     * This is a linear search with pointer compares.
+     */
+    bool contains(InternedString str) const noexcept
+    {
+      for(const InternedString & s : *this){
+        if(s == str){
+          return true;
+        }
+      }
+      return false;
+    }
+
+    constexpr
+    const_iterator begin() const noexcept
+    {
+      return mData;
+    }
+
+    constexpr
+    const_iterator end() const noexcept
+    {
+      return mData + mSize;
+    }
+
+   private:
+
+    const InternedString *mData = nullptr;
+    std::size_t mSize = 0;
+  };
+
+  /*! \brief Result of scanning a executable file in a ScanContext
+   *
+   * Holds no string itself, only handles to the strings of the context.
+   * Comparing results, or looking for a given library,
+   * is done with pointer compares.
+   */
+  struct FileScanResult
+  {
+    InternedString fileName;
+    ExecutableFileFormat format = ExecutableFileFormat::Unknown;
+    InternedString soName;
+    InternedStringList neededSharedLibraries;
+    InternedStringList runPath;
+  };
+
+  /*! \brief Context to scan many executable files
+   *
+   * When scanning a whole tree of files,
+   * the same library names and run path entries appear in most of them.
+   * A scan context stores each distinct string once
+   * in a InternedStringPool and allocates the result lists
+   * in the same arena.
+   * Results only hold handles, so a result costs a few pointers
+   * instead of a set of QString .
+   *
+   * Example with a ELF snapshot:
+   * \code
+   * ScanContext context;
+   * for(const QFileInfo & file : files){
+   *   const ElfFileSnapshot snapshot = ElfFileSnapshot::fromFile(file);
+   *   results.push_back( snapshot.scan(context) );
+   * }
+   * const InternedString libc = context.find("libc.so.6");
+   * \endcode
+   *
+   * The results are only valid as long as the context is alive.
+   *
+   * This class is not thread safe.
+   * For parallel scans, use a context per thread.
+   */
+  class ScanContext
+  {
+   public:
+
+    ScanContext() = default;
+
+    ScanContext(const ScanContext & other) = delete;
+    ScanContext & operator=(const ScanContext & other) = delete;
+    ScanContext(ScanContext && other) = default;
+    ScanContext & operator=(ScanContext && other) = default;
+
+    /*! \brief Intern \a str
+     *
+     * \exception std::bad_alloc
+     */
+    InternedString intern(std::string_view str)
+    {
+      return mPool.intern(str);
+    }
+
+    /*! \brief Intern the null terminated \a str
+     *
+     * \pre \a str must not be a nullptr
+     * \exception std::bad_alloc
+     */
+    InternedString intern(const char *str)
+    {
+      return mPool.intern(str);
+    }
+
+    /*! \brief Intern \a str
+     *
+     * \exception std::bad_alloc
+     */
+    InternedString intern(const QString & str)
+    {
+      return mPool.intern(str);
+    }
+
+    /*! \brief Find \a str in this context
+     *
+     * Returns a null handle if \a str was never seen.
+     */
+    InternedString find(std::string_view str) const noexcept
+    {
+      return mPool.find(str);
+    }
+
+    /*! \brief Add a string to the list that is currently built
+     *
+     * \a str is interned, then appended to a scratch buffer
+     * that is reused from one list to the next.
+     *
+     * \sa takeList()
+     * \exception std::bad_alloc
+     */
+    void appendToList(std::string_view str)
+    {
+      mListBuffer.push_back( mPool.intern(str) );
+    }
+
+    /*! \brief Add the null terminated \a str to the list that is currently built
+     *
+     * \pre \a str must not be a nullptr
+     * \exception std::bad_alloc
+     */
+    void appendToList(const char *str)
+    {
+      mListBuffer.push_back( mPool.intern(str) );
+    }
+
+    /*! \brief Add a string to the list that is currently built
+     *
+     * \exception std::bad_alloc
+     */
+    void appendToList(const QString & str)
+    {
+      mListBuffer.push_back( mPool.intern(str) );
+    }
+
+    /*! \brief Get the list built with appendToList()
+     *
+     * The list is copied into the arena
+     * and the scratch buffer is cleared.
+     *
+     * \exception std::bad_alloc
+     */
+    InternedStringList takeList()
+    {
+      if( mListBuffer.empty() ){
+        return InternedStringList();
+      }
+
+      const std::size_t size = mListBuffer.size();
+      InternedString *data = mPool.arena().allocateArray<InternedString>(size);
+      for(std::size_t i = 0; i < size; ++i){
+        new (data + i) InternedString(mListBuffer[i]);
+      }
+      mListBuffer.clear();
+
+      return InternedStringList(data, size);
+    }
+
+    /*! \brief Access the string pool of this context
+     */
+    const InternedStringPool & stringPool() const noexcept
+    {
+      return mPool;
+    }
+
+    /*! \brief Get the count of bytes reserved by this context
+     *
+     * Does not account the index of the string pool.
+     */
+    std::size_t reservedByteCount() const noexcept
+    {
+      return mPool.reservedByteCount();
+    }
+
+   private:
+
+    InternedStringPool mPool;
+    std::vector<InternedString> mListBuffer;
+  };
+
+}} // namespace Mdt{ namespace ExecutableFile{
+
+#endif // #ifndef MDT_EXECUTABLE_FILE_SCAN_CONTEXT_H
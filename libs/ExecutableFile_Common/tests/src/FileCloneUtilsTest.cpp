@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "TestUtils.h"
+#include "TestFileUtils.h"
+#include "Mdt/ExecutableFile/FileCloneUtils.h"
+#include <QTemporaryDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QLatin1String>
+#include <QString>
+
+using namespace Mdt::ExecutableFile;
+
+
+TEST_CASE("cloneFileContent")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const QString sourceFilePath = makePath(dir, "source.txt");
+  const QString destinationFilePath = makePath(dir, "destination.txt");
+  const QString content = generateStringWithNChars(3*1024*1024 + 5);
+  REQUIRE( createTextFileUtf8(sourceFilePath, content) );
+
+  QFile source(sourceFilePath);
+  REQUIRE( source.open(QIODevice::ReadOnly) );
+  QFile destination(destinationFilePath);
+  REQUIRE( destination.open(QIODevice::ReadWrite) );
+
+  cloneFileContent(source, destination);
+  destination.close();
+  source.close();
+
+  REQUIRE( QFileInfo(destinationFilePath).size() == QFileInfo(sourceFilePath).size() );
+  REQUIRE( readTextFileUtf8(destinationFilePath) == content );
+}
+
+TEST_CASE("preallocateFile")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const QString filePath = makePath(dir, "file.txt");
+  REQUIRE( createTextFileUtf8( filePath, QLatin1String("abc") ) );
+
+  QFile file(filePath);
+  REQUIRE( file.open(QIODevice::ReadWrite) );
+  REQUIRE( file.resize(4096) );
+  preallocateFile(file, 3, 4096 - 3);
+  file.close();
+
+  REQUIRE( QFileInfo(filePath).size() == 4096 );
+}
+
+TEST_CASE("replaceFileAtomically")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+
+  const QString sourceFilePath = makePath(dir, "new.txt");
+  const QString destinationFilePath = makePath(dir, "old.txt");
+  REQUIRE( createTextFileUtf8( sourceFilePath, QLatin1String("new") ) );
+
+  SECTION("destination does not exist")
+  {
+    replaceFileAtomically(sourceFilePath, destinationFilePath);
+  }
+
+  SECTION("destination exists")
+  {
+    REQUIRE( createTextFileUtf8( destinationFilePath, QLatin1String("old") ) );
+    replaceFileAtomically(sourceFilePath, destinationFilePath);
+  }
+
+  REQUIRE( !fileExists(sourceFilePath) );
+  REQUIRE( readTextFileUtf8(destinationFilePath) == QLatin1String("new") );
+}
@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
+
+using namespace Mdt::ExecutableFile;
+
+
+TEST_CASE("checkCounts")
+{
+  ReadLimits limits;
+  limits.maximumSectionCount = 10;
+  limits.maximumEntryCount = 20;
+  limits.maximumStringTableByteCount = 100;
+
+  const ReadBudget budget(limits);
+
+  SECTION("within limits")
+  {
+    budget.checkSectionCount(10);
+    budget.checkEntryCount(20);
+    budget.checkStringTableByteCount(100);
+  }
+
+  SECTION("limits exceeded")
+  {
+    REQUIRE_THROWS_AS( budget.checkSectionCount(11), ReadLimitExceededError );
+    REQUIRE_THROWS_AS( budget.checkEntryCount(21), ReadLimitExceededError );
+    REQUIRE_THROWS_AS( budget.checkStringTableByteCount(101), ExecutableFileReadError );
+  }
+
+  SECTION("values that do not fit in a int64")
+  {
+    REQUIRE_THROWS_AS( budget.checkEntryCount(0x8000000000000000), ReadLimitExceededError );
+    REQUIRE_THROWS_AS( budget.checkStringTableByteCount(0xFFFFFFFFFFFFFFFF), ReadLimitExceededError );
+  }
+}
+
+TEST_CASE("consumeBytes")
+{
+  ReadLimits limits;
+  limits.maximumTotalByteCount = 100;
+
+  ReadBudget budget(limits);
+
+  budget.consumeBytes(60);
+  REQUIRE( budget.readByteCount() == 60 );
+  budget.consumeBytes(40);
+  REQUIRE( budget.readByteCount() == 100 );
+  REQUIRE_THROWS_AS( budget.consumeBytes(1), ReadLimitExceededError );
+
+  budget.reset();
+  REQUIRE( budget.readByteCount() == 0 );
+  budget.consumeBytes(1);
+}
+
+TEST_CASE("consumeBytes_valueDoesNotFitInInt64")
+{
+  ReadBudget budget( ReadLimits::unlimited() );
+
+  REQUIRE_THROWS_AS( budget.consumeBytes(0x8000000000000000), ReadLimitExceededError );
+  REQUIRE( budget.readByteCount() == 0 );
+}
+
+TEST_CASE("consumeRegion")
+{
+  ReadLimits limits;
+  limits.maximumTotalByteCount = 100;
+
+  ReadBudget budget(limits);
+
+  SECTION("a region is accounted once")
+  {
+    budget.consumeRegion(10, 60);
+    budget.consumeRegion(10, 60);
+    REQUIRE( budget.readByteCount() == 60 );
+    budget.consumeRegion(70, 40);
+    REQUIRE( budget.readByteCount() == 100 );
+    budget.consumeRegion(70, 40);
+    REQUIRE( budget.readByteCount() == 100 );
+    budget.consumeRegion(10, 1);
+    REQUIRE( budget.readByteCount() == 100 );
+    REQUIRE_THROWS_AS( budget.consumeRegion(110, 1), ReadLimitExceededError );
+  }
+
+  SECTION("only the bytes not yet accounted of a overlapping region are accounted")
+  {
+    budget.consumeRegion(10, 20);
+    budget.consumeRegion(50, 20);
+    REQUIRE( budget.readByteCount() == 40 );
+    // Covers [10, 30) and [50, 70)
+    budget.consumeRegion(0, 80);
+    REQUIRE( budget.readByteCount() == 80 );
+    budget.consumeRegion(20, 40);
+    REQUIRE( budget.readByteCount() == 80 );
+    budget.consumeRegion(75, 10);
+    REQUIRE( budget.readByteCount() == 85 );
+  }
+
+  SECTION("a failed region is not recorded")
+  {
+    REQUIRE_THROWS_AS( budget.consumeRegion(0, 101), ReadLimitExceededError );
+    REQUIRE( budget.readByteCount() == 0 );
+    limits.maximumTotalByteCount = 200;
+    budget.setLimits(limits);
+    budget.consumeRegion(0, 101);
+    REQUIRE( budget.readByteCount() == 101 );
+  }
+
+  SECTION("reset")
+  {
+    budget.consumeRegion(0, 100);
+    budget.reset();
+    budget.consumeRegion(0, 100);
+    REQUIRE( budget.readByteCount() == 100 );
+  }
+}
+
+TEST_CASE("unlimited")
+{
+  ReadBudget budget( ReadLimits::unlimited() );
+
+  budget.checkSectionCount(1000000);
+  budget.consumeBytes( std::numeric_limits<int64_t>::max() );
+  REQUIRE( budget.readByteCount() == std::numeric_limits<int64_t>::max() );
+}
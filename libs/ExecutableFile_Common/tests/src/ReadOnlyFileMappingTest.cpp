@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "TestFileUtils.h"
+#include "Mdt/ExecutableFile/ReadOnlyFileMapping.h"
+#include <QTemporaryFile>
+#include <QTemporaryDir>
+#include <QFileInfo>
+#include <QLatin1String>
+#include <QString>
+
+using namespace Mdt::ExecutableFile;
+
+
+TEST_CASE("mapFile")
+{
+  ReadOnlyFileMapping mapping;
+  REQUIRE( !mapping.isMapped() );
+
+  SECTION("file with some content")
+  {
+    QTemporaryFile file;
+    REQUIRE( file.open() );
+    REQUIRE( writeTextFileUtf8( file, QLatin1String("abc") ) );
+    REQUIRE( file.flush() );
+
+    mapping.mapFile( QFileInfo( file.fileName() ) );
+    REQUIRE( mapping.isMapped() );
+    REQUIRE( mapping.fileName() == QFileInfo( file.fileName() ).absoluteFilePath() );
+
+    const ByteArraySpan map = mapping.span();
+    REQUIRE( map.size == 3 );
+    REQUIRE( map.data[0] == 'a' );
+    REQUIRE( map.data[2] == 'c' );
+  }
+
+  SECTION("empty file")
+  {
+    QTemporaryFile file;
+    REQUIRE( file.open() );
+
+    REQUIRE_THROWS_AS( mapping.mapFile( QFileInfo( file.fileName() ) ), FileOpenError );
+    REQUIRE( !mapping.isMapped() );
+  }
+
+  SECTION("non existing file")
+  {
+    QTemporaryDir dir;
+    REQUIRE( dir.isValid() );
+
+    REQUIRE_THROWS_AS( mapping.mapFile( QFileInfo( makePath(dir, "nonExisting") ) ), FileOpenError );
+    REQUIRE( !mapping.isMapped() );
+  }
+}
@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include "catch2/catch.hpp"
+#include "Catch2QString.h"
+#include "Mdt/ExecutableFile/MonotonicArena.h"
+#include "Mdt/ExecutableFile/InternedStringPool.h"
+#include "Mdt/ExecutableFile/ScanContext.h"
+#include <QLatin1String>
+#include <QString>
+#include <string>
+#include <cstdint>
+
+using namespace Mdt::ExecutableFile;
+
+
+TEST_CASE("MonotonicArena")
+{
+  MonotonicArena arena(64);
+
+  SECTION("alignment")
+  {
+    arena.allocate(1, 1);
+    void *ptr = arena.allocate(8, 8);
+    REQUIRE( reinterpret_cast<std::uintptr_t>(ptr) % 8 == 0 );
+  }
+
+  SECTION("request bigger than a block")
+  {
+    void *ptr = arena.allocate(1000, 1);
+    REQUIRE( ptr != nullptr );
+    REQUIRE( arena.allocatedByteCount() == 1000 );
+    REQUIRE( arena.reservedByteCount() >= 1000 );
+  }
+
+  SECTION("release")
+  {
+    arena.allocate(10);
+    arena.release();
+    REQUIRE( arena.allocatedByteCount() == 0 );
+    REQUIRE( arena.reservedByteCount() == 0 );
+  }
+}
+
+TEST_CASE("InternedStringPool")
+{
+  InternedStringPool pool;
+  REQUIRE( pool.isEmpty() );
+
+  const InternedString libc = pool.intern("libc.so.6");
+  const InternedString libm = pool.intern("libm.so.6");
+
+  REQUIRE( pool.size() == 2 );
+  REQUIRE( libc != libm );
+  REQUIRE( libc.id() == 0 );
+  REQUIRE( libm.id() == 1 );
+  REQUIRE( libc.view() == "libc.so.6" );
+  REQUIRE( libc.view().data()[libc.view().size()] == '\0' );
+
+  SECTION("same string gives the same handle")
+  {
+    REQUIRE( pool.intern("libc.so.6") == libc );
+    REQUIRE( pool.intern( QLatin1String("libc.so.6") ) == libc );
+    REQUIRE( pool.size() == 2 );
+  }
+
+  SECTION("find")
+  {
+    REQUIRE( pool.find("libm.so.6") == libm );
+    REQUIRE( pool.find("libQt5Core.so.5").isNull() );
+  }
+
+  SECTION("fromId")
+  {
+    REQUIRE( pool.fromId(1) == libm );
+  }
+
+  SECTION("toQString")
+  {
+    REQUIRE( libc.toQString() == QLatin1String("libc.so.6") );
+    REQUIRE( InternedString().toQString().isEmpty() );
+  }
+
+  SECTION("empty string")
+  {
+    const InternedString empty = pool.intern("");
+    REQUIRE( !empty.isNull() );
+    REQUIRE( empty.view().empty() );
+  }
+
+  SECTION("handles stay valid when the pool grows")
+  {
+    for(int i = 0; i < 10000; ++i){
+      pool.intern( std::to_string(i) );
+    }
+    REQUIRE( pool.size() == 10002 );
+    REQUIRE( libc.view() == "libc.so.6" );
+    REQUIRE( pool.find("libc.so.6") == libc );
+  }
+}
+
+TEST_CASE("ScanContext_lists")
+{
+  ScanContext context;
+
+  REQUIRE( context.takeList().isEmpty() );
+
+  context.appendToList("libQt5Core.so.5");
+  context.appendToList("libc.so.6");
+  const InternedStringList first = context.takeList();
+
+  context.appendToList("libc.so.6");
+  const InternedStringList second = context.takeList();
+
+  REQUIRE( first.size() == 2 );
+  REQUIRE( second.size() == 1 );
+  REQUIRE( first[1] == second[0] );
+  REQUIRE( first.contains( context.find("libQt5Core.so.5") ) );
+  REQUIRE( !second.contains( context.find("libQt5Core.so.5") ) );
+  REQUIRE( context.stringPool().size() == 2 );
+}
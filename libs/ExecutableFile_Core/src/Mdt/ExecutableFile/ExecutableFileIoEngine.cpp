@@ -99,6 +99,14 @@ bool ExecutableFileIoEngine::isOpen() const noexcept
   return mIoEngine->isOpen();
 }
 
+void ExecutableFileIoEngine::setReadLimits(const ReadLimits & limits) noexcept
+{
+  mReadLimits = limits;
+  if(mIoEngine){
+    mIoEngine->setReadLimits(mReadLimits);
+  }
+}
+
 void ExecutableFileIoEngine::close()
 {
   if(mIoEngine){
@@ -131,6 +139,7 @@ void ExecutableFileIoEngine::instanciateEngine(ExecutableFileFormat format) noex
   }
 
   if( mIoEngine.get() != nullptr ){
+    mIoEngine->setReadLimits(mReadLimits);
     connect(mIoEngine.get(), &ExecutableFileIoEngineImplementationInterface::message, this, &ExecutableFileIoEngine::message);
     connect(mIoEngine.get(), &ExecutableFileIoEngineImplementationInterface::verboseMessage, this, &ExecutableFileIoEngine::verboseMessage);
   }
@@ -14,6 +14,7 @@
 #include "Mdt/ExecutableFile/ExecutableFileReadError.h"
 #include "Mdt/ExecutableFile/ExecutableFileOpenMode.h"
 #include "Mdt/ExecutableFile/Platform.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
 #include "mdt_executablefilecore_export.h"
 #include <QObject>
 #include <QFileInfo>
@@ -60,6 +61,12 @@ namespace Mdt{ namespace ExecutableFile{
      */
     void openFile(const QFileInfo & fileInfo, ExecutableFileOpenMode mode, const Platform & platform);
 
+    /*! \brief Set the resource limits applied while reading files
+     *
+     * The limits are applied to the next opened file.
+     */
+    void setReadLimits(const ReadLimits & limits) noexcept;
+
     /*! \brief Check if this engine has a open file
      *
      * \sa openFile()
@@ -101,6 +108,7 @@ namespace Mdt{ namespace ExecutableFile{
     void instanciateEngine(ExecutableFileFormat format) noexcept;
 
     std::unique_ptr<ExecutableFileIoEngineImplementationInterface> mIoEngine;
+    ReadLimits mReadLimits;
   };
 
 }} // namespace Mdt{ namespace ExecutableFile{
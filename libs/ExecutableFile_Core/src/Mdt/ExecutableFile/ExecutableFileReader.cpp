@@ -18,6 +18,11 @@ ExecutableFileReader::ExecutableFileReader(QObject* parent)
 {
 }
 
+void ExecutableFileReader::setReadLimits(const ReadLimits & limits) noexcept
+{
+  mEngine.setReadLimits(limits);
+}
+
 void ExecutableFileReader::openFile(const QFileInfo & fileInfo)
 {
   assert( !fileInfo.filePath().isEmpty() );
@@ -83,4 +88,12 @@ RPath ExecutableFileReader::getRunPath()
   return mEngine.engine()->getRunPath();
 }
 
+DeployStamp ExecutableFileReader::getDeployStamp()
+{
+  assert( isOpen() );
+  assert( isExecutableOrSharedLibrary() );
+
+  return mEngine.engine()->getDeployStamp();
+}
+
 }} // namespace Mdt{ namespace ExecutableFile{
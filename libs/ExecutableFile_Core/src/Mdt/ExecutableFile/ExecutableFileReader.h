@@ -12,8 +12,11 @@
 
 #include "Mdt/ExecutableFile/FileOpenError.h"
 #include "Mdt/ExecutableFile/ExecutableFileReadError.h"
+#include "Mdt/ExecutableFile/ReadLimitExceededError.h"
+#include "Mdt/ExecutableFile/ReadLimits.h"
 #include "Mdt/ExecutableFile/Platform.h"
 #include "Mdt/ExecutableFile/RPath.h"
+#include "Mdt/ExecutableFile/DeployStamp.h"
 #include "Mdt/ExecutableFile/ExecutableFileIoEngine.h"
 #include "mdt_executablefilecore_export.h"
 #include <QObject>
@@ -65,6 +68,18 @@ namespace Mdt{ namespace ExecutableFile{
      */
     ~ExecutableFileReader() noexcept = default;
 
+    /*! \brief Set the resource limits applied while reading files
+     *
+     * When scanning untrusted files,
+     * lower limits make sure that a crafted file
+     * can not force huge allocations or long scans.
+     * A ReadLimitExceededError (which is a ExecutableFileReadError)
+     * is thrown when a limit is exceeded.
+     *
+     * The limits are applied to the next opened file.
+     */
+    void setReadLimits(const ReadLimits & limits) noexcept;
+
     /*! \brief Open a file
      *
      * \pre \a fileInfo must have a file path set
@@ -149,6 +164,20 @@ namespace Mdt{ namespace ExecutableFile{
      */
     RPath getRunPath();
 
+    /*! \brief Get the deployment stamp of the file this reader refers to
+     *
+     * Only the headers at the start of the file and the stamp itself are read,
+     * so this is much cheaper than getting the other informations.
+     * Returns a null stamp if the file has none.
+     *
+     * \pre this reader must have a open file which is a executable or a shared library
+     * \sa isOpen()
+     * \sa isExecutableOrSharedLibrary()
+     * \sa ExecutableFileEditTransaction::setDeployStamp()
+     * \exception ExecutableFileReadError
+     */
+    DeployStamp getDeployStamp();
+
    private:
 
     ExecutableFileIoEngine mEngine;
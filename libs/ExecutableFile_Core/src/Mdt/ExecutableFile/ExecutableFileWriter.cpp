@@ -9,6 +9,10 @@
  *****************************************************************************************/
 #include "ExecutableFileWriter.h"
 #include "Mdt/ExecutableFile/ExecutableFileIoEngineImplementationInterface.h"
+#include "Mdt/ExecutableFile/FileCloneUtils.h"
+#include <QFile>
+#include <QTemporaryFile>
+#include <QLatin1String>
 #include <cassert>
 
 namespace Mdt{ namespace ExecutableFile{
@@ -20,6 +24,13 @@ ExecutableFileWriter::ExecutableFileWriter(QObject *parent)
   connect(&mEngine, &ExecutableFileIoEngine::verboseMessage, this, &ExecutableFileWriter::verboseMessage);
 }
 
+ExecutableFileWriter::~ExecutableFileWriter() noexcept
+{
+  if( isOutOfPlaceEdit() ){
+    discardOutOfPlaceEdit();
+  }
+}
+
 void ExecutableFileWriter::openFile(const QFileInfo & fileInfo)
 {
   assert( !fileInfo.filePath().isEmpty() );
@@ -37,6 +48,37 @@ void ExecutableFileWriter::openFile(const QFileInfo & fileInfo, const Platform &
   mEngine.openFile(fileInfo, ExecutableFileOpenMode::ReadWrite, platform);
 }
 
+void ExecutableFileWriter::openFileForOutOfPlaceEdit(const QFileInfo & fileInfo, const QFileInfo & outputFileInfo)
+{
+  assert( !fileInfo.filePath().isEmpty() );
+  assert( !outputFileInfo.filePath().isEmpty() );
+  assert( !isOpen() );
+
+  cloneToTemporaryFile(fileInfo, outputFileInfo);
+  try{
+    mEngine.openFile(QFileInfo(mTemporaryFilePath), ExecutableFileOpenMode::ReadWrite);
+  }catch(...){
+    discardOutOfPlaceEdit();
+    throw;
+  }
+}
+
+void ExecutableFileWriter::openFileForOutOfPlaceEdit(const QFileInfo & fileInfo, const QFileInfo & outputFileInfo, const Platform & platform)
+{
+  assert( !fileInfo.filePath().isEmpty() );
+  assert( !outputFileInfo.filePath().isEmpty() );
+  assert( !platform.isNull() );
+  assert( !isOpen() );
+
+  cloneToTemporaryFile(fileInfo, outputFileInfo);
+  try{
+    mEngine.openFile(QFileInfo(mTemporaryFilePath), ExecutableFileOpenMode::ReadWrite, platform);
+  }catch(...){
+    discardOutOfPlaceEdit();
+    throw;
+  }
+}
+
 bool ExecutableFileWriter::isOpen() const noexcept
 {
   return mEngine.isOpen();
@@ -44,7 +86,23 @@ bool ExecutableFileWriter::isOpen() const noexcept
 
 void ExecutableFileWriter::close()
 {
-  mEngine.close();
+  if( !isOutOfPlaceEdit() ){
+    mEngine.close();
+    return;
+  }
+
+  if(mOutOfPlaceEditFailed){
+    discardOutOfPlaceEdit();
+    return;
+  }
+
+  try{
+    mEngine.close();
+    commitOutOfPlaceEdit();
+  }catch(...){
+    discardOutOfPlaceEdit();
+    throw;
+  }
 }
 
 bool ExecutableFileWriter::isExecutableOrSharedLibrary()
@@ -67,7 +125,118 @@ void ExecutableFileWriter::setRunPath(const RPath & rPath)
   assert( isOpen() );
   assert( isExecutableOrSharedLibrary() );
 
-  mEngine.engine()->setRunPath(rPath);
+  try{
+    mEngine.engine()->setRunPath(rPath);
+  }catch(...){
+    mOutOfPlaceEditFailed = true;
+    throw;
+  }
+}
+
+void ExecutableFileWriter::applyEdits(const ExecutableFileEditTransaction & edits)
+{
+  assert( isOpen() );
+  assert( isExecutableOrSharedLibrary() );
+
+  try{
+    mEngine.engine()->applyEdits(edits);
+  }catch(...){
+    mOutOfPlaceEditFailed = true;
+    throw;
+  }
+}
+
+void ExecutableFileWriter::cloneToTemporaryFile(const QFileInfo & fileInfo, const QFileInfo & outputFileInfo)
+{
+  assert( !isOutOfPlaceEdit() );
+
+  QFile source( fileInfo.absoluteFilePath() );
+  if( !source.open(QIODevice::ReadOnly) ){
+    const QString message = tr("could not open file '%1': %2")
+                            .arg( source.fileName(), source.errorString() );
+    throw FileOpenError(message);
+  }
+
+  /*
+   * The temporary file must be on the same file system as the output,
+   * so that it can be renamed to it
+   */
+  const QString outputFilePath = outputFileInfo.absoluteFilePath();
+  QTemporaryFile temporaryFile( outputFilePath + QLatin1String(".XXXXXX") );
+  temporaryFile.setAutoRemove(false);
+  if( !temporaryFile.open() ){
+    const QString message = tr("could not create a temporary file beside '%1': %2")
+                            .arg( outputFilePath, temporaryFile.errorString() );
+    throw FileOpenError(message);
+  }
+
+  mTemporaryFilePath = temporaryFile.fileName();
+  mOutputFilePath = outputFilePath;
+  mOutOfPlaceEditFailed = false;
+
+  try{
+    const FileCloneMethod method = cloneFileContent(source, temporaryFile);
+    if( !temporaryFile.setPermissions( source.permissions() ) ){
+      const QString message = tr("could not set the permissions of '%1': %2")
+                              .arg( mTemporaryFilePath, temporaryFile.errorString() );
+      throw ExecutableFileWriteError(message);
+    }
+    temporaryFile.close();
+
+    switch(method){
+      case FileCloneMethod::Reflink:
+        emit verboseMessage( tr("cloned '%1' to '%2' (reflink)").arg(source.fileName(), mTemporaryFilePath) );
+        break;
+      case FileCloneMethod::CopyFileRange:
+        emit verboseMessage( tr("cloned '%1' to '%2' (kernel copy)").arg(source.fileName(), mTemporaryFilePath) );
+        break;
+      case FileCloneMethod::StreamedCopy:
+        emit verboseMessage( tr("cloned '%1' to '%2' (streamed copy)").arg(source.fileName(), mTemporaryFilePath) );
+        break;
+    }
+  }catch(...){
+    temporaryFile.close();
+    discardOutOfPlaceEdit();
+    throw;
+  }
+}
+
+void ExecutableFileWriter::commitOutOfPlaceEdit()
+{
+  assert( isOutOfPlaceEdit() );
+  assert( !isOpen() );
+
+  QFile temporaryFile(mTemporaryFilePath);
+  if( !temporaryFile.open(QIODevice::ReadWrite) ){
+    const QString message = tr("could not open file '%1': %2")
+                            .arg( mTemporaryFilePath, temporaryFile.errorString() );
+    throw ExecutableFileWriteError(message);
+  }
+  syncFile(temporaryFile);
+  temporaryFile.close();
+
+  replaceFileAtomically(mTemporaryFilePath, mOutputFilePath);
+  emit verboseMessage( tr("written '%1'").arg(mOutputFilePath) );
+
+  mTemporaryFilePath.clear();
+  mOutputFilePath.clear();
+}
+
+void ExecutableFileWriter::discardOutOfPlaceEdit() noexcept
+{
+  assert( isOutOfPlaceEdit() );
+
+  try{
+    if( isOpen() ){
+      mEngine.close();
+    }
+  }catch(...){
+  }
+  QFile::remove(mTemporaryFilePath);
+
+  mTemporaryFilePath.clear();
+  mOutputFilePath.clear();
+  mOutOfPlaceEditFailed = false;
 }
 
 }} // namespace Mdt{ namespace ExecutableFile{
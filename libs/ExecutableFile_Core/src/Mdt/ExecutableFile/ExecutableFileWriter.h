@@ -15,9 +15,11 @@
 #include "Mdt/ExecutableFile/ExecutableFileWriteError.h"
 #include "Mdt/ExecutableFile/ExecutableFileIoEngine.h"
 #include "Mdt/ExecutableFile/RPath.h"
+#include "Mdt/ExecutableFile/ExecutableFileEditTransaction.h"
 #include "mdt_executablefilecore_export.h"
 #include <QObject>
 #include <QFileInfo>
+#include <QString>
 #include <QStringList>
 
 namespace Mdt{ namespace ExecutableFile{
@@ -51,8 +53,13 @@ namespace Mdt{ namespace ExecutableFile{
     explicit ExecutableFileWriter(QObject *parent = nullptr);
 
     /*! \brief Close this file writer and free resources
+     *
+     * If a out of place edit is still pending,
+     * it is discarded and the output file is left untouched.
+     *
+     * \sa openFileForOutOfPlaceEdit()
      */
-    ~ExecutableFileWriter() noexcept = default;
+    ~ExecutableFileWriter() noexcept;
 
     /*! \brief Open a file
      *
@@ -75,6 +82,55 @@ namespace Mdt{ namespace ExecutableFile{
      */
     void openFile(const QFileInfo & fileInfo, const Platform & platform);
 
+    /*! \brief Open a file to write the edited result to a other file
+     *
+     * \a fileInfo is never modified.
+     * Its content is first cloned to a temporary file,
+     * in the directory of \a outputFileInfo .
+     * On file systems that support it (for example btrfs or xfs),
+     * the clone shares the data of \a fileInfo and costs almost nothing.
+     * Otherwise, the data is copied by the kernel if possible,
+     * or streamed as a last resort.
+     *
+     * All the edits are done on the temporary file.
+     * close() then flushes it to disk and renames it to \a outputFileInfo .
+     * On POSIX systems, this rename is atomic,
+     * so a crash never leaves a partially written binary at \a outputFileInfo .
+     *
+     * If a edit fails, or if this writer is destroyed before close() is called,
+     * the temporary file is removed and \a outputFileInfo is left untouched.
+     *
+     * \a outputFileInfo can refer to \a fileInfo ,
+     * in which case the file is atomically replaced.
+     *
+     * \code
+     * ExecutableFileWriter writer;
+     *
+     * writer.openFileForOutOfPlaceEdit(library, library);
+     * writer.setRunPath(rpath);
+     * writer.close();
+     * \endcode
+     *
+     * \pre \a fileInfo and \a outputFileInfo must have a file path set
+     * \pre this writer must not allready have a file open
+     * \sa isOpen()
+     * \sa close()
+     * \exception FileOpenError
+     * \exception ExecutableFileWriteError
+     */
+    void openFileForOutOfPlaceEdit(const QFileInfo & fileInfo, const QFileInfo & outputFileInfo);
+
+    /*! \brief Open a file, for a expected platform, to write the edited result to a other file
+     *
+     * \pre \a fileInfo and \a outputFileInfo must have a file path set
+     * \pre \a platform must be valid
+     * \pre this writer must not allready have a file open
+     * \sa openFileForOutOfPlaceEdit(const QFileInfo &, const QFileInfo &)
+     * \exception FileOpenError
+     * \exception ExecutableFileWriteError
+     */
+    void openFileForOutOfPlaceEdit(const QFileInfo & fileInfo, const QFileInfo & outputFileInfo, const Platform & platform);
+
     /*! \brief Check if this writer has a open file
      *
      * \sa openFile()
@@ -83,6 +139,12 @@ namespace Mdt{ namespace ExecutableFile{
     bool isOpen() const noexcept;
 
     /*! \brief Close the file that was maybe open
+     *
+     * For a out of place edit, the result is committed to the output file,
+     * unless a edit has failed.
+     *
+     * \sa openFileForOutOfPlaceEdit()
+     * \exception ExecutableFileWriteError
      */
     void close();
 
@@ -118,6 +180,39 @@ namespace Mdt{ namespace ExecutableFile{
      */
     void setRunPath(const RPath & rPath);
 
+    /*! \brief Apply all the changes of \a edits to the file this writer refers to
+     *
+     * Compared to calling setRunPath() and the like one after the other,
+     * the file is read once, its new layout is computed once
+     * and it is written once.
+     * For example, if both the run path and a needed shared library
+     * make the dynamic section grow,
+     * only one new segment is added to the file.
+     * Likewise, stripping the sections not needed at run time
+     * in the same transaction avoids a second rewrite of the file
+     * by a external \c strip tool.
+     *
+     * Changes not supported by the executable file format are ignored.
+     *
+     * \code
+     * ExecutableFileEditTransaction edits;
+     * edits.setRunPath(rpath);
+     * edits.addNeededSharedLibrary( QLatin1String("libQt5Core.so.5") );
+     * edits.setBindNow();
+     * edits.stripNonAllocatedSections();
+     *
+     * writer.openFile(targetLibrary);
+     * writer.applyEdits(edits);
+     * writer.close();
+     * \endcode
+     *
+     * \pre this writer must have a open file which is a executable or a shared library
+     * \sa isOpen()
+     * \sa isExecutableOrSharedLibrary()
+     * \exception ExecutableFileWriteError
+     */
+    void applyEdits(const ExecutableFileEditTransaction & edits);
+
    signals:
 
     void message(const QString & message) const;
@@ -125,7 +220,19 @@ namespace Mdt{ namespace ExecutableFile{
 
    private:
 
+    bool isOutOfPlaceEdit() const noexcept
+    {
+      return !mTemporaryFilePath.isEmpty();
+    }
+
+    void cloneToTemporaryFile(const QFileInfo & fileInfo, const QFileInfo & outputFileInfo);
+    void commitOutOfPlaceEdit();
+    void discardOutOfPlaceEdit() noexcept;
+
     ExecutableFileIoEngine mEngine;
+    QString mTemporaryFilePath;
+    QString mOutputFilePath;
+    bool mOutOfPlaceEditFailed = false;
   };
 
 }} // namespace Mdt{ namespace ExecutableFile{
@@ -13,12 +13,35 @@
 #include "TestFileUtils.h"
 #include "TestBinariesUtils.h"
 #include "Mdt/ExecutableFile/RPath.h"
+#include "Mdt/ExecutableFile/DeployStamp.h"
 #include "Mdt/ExecutableFile/ExecutableFileWriter.h"
 #include "Mdt/ExecutableFile/ExecutableFileReader.h"
+#include "Mdt/ExecutableFile/ElfFileSnapshot.h"
+#include "Mdt/ExecutableFile/Elf/FileReader.h"
+#include "Mdt/ExecutableFile/Elf/GnuHashTableReader.h"
+#include "Mdt/ExecutableFile/Elf/GnuHashTableBuilder.h"
+#include "Mdt/ExecutableFile/Elf/DynamicStringTableReferences.h"
+#include "Mdt/ExecutableFile/Elf/GnuDebugLinkReader.h"
 #include <QString>
 #include <QStringList>
 #include <QTemporaryFile>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QByteArray>
 #include <QtGlobal>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+#ifdef __GLIBC__
+ #include <gnu/libc-version.h>
+#endif
+
+#ifndef Q_OS_WIN
+ #include <dlfcn.h>
+#endif
 
 // #include "Mdt/DeployUtils/MessageLogger.h"
 // #include <QDebug>
@@ -40,6 +63,210 @@ void appendRPathToRPath(const RPath & source, RPath & destination)
   }
 }
 
+#ifndef Q_OS_WIN
+Elf::DynamicSection getFileDynamicSection(const QString & filePath)
+{
+  return ElfFileSnapshot::fromFile(filePath).dynamicSection();
+}
+
+/*
+ * Read the path the kernel uses,
+ * which is the one in the PT_INTERP segment
+ */
+std::string getFileProgramInterpreter(const QString & filePath)
+{
+  const ElfFileSnapshot file = ElfFileSnapshot::fromFile(filePath);
+
+  for(const Elf::ProgramHeader & header : file.programHeaderTable()){
+    if(header.segmentType() == Elf::SegmentType::Interpreter){
+      REQUIRE( header.fileOffsetEnd() <= static_cast<uint64_t>(file.map().size) );
+      const unsigned char *first = file.map().data + header.offset;
+      const unsigned char *last = first + header.filesz;
+      return std::string( first, std::find(first, last, 0) );
+    }
+  }
+
+  return std::string();
+}
+
+bool containsDynamicEntry(const Elf::DynamicSection & dynamicSection, Elf::DynamicSectionTagType tag)
+{
+  const auto pred = [tag](const Elf::DynamicStruct & entry){
+    return entry.tagType() == tag;
+  };
+
+  return std::any_of(dynamicSection.cbegin(), dynamicSection.cend(), pred);
+}
+
+Elf::GnuDebugLink getFileGnuDebugLink(const QString & filePath)
+{
+  const ElfFileSnapshot file = ElfFileSnapshot::fromFile(filePath);
+  const Elf::SectionHeaderTable & sectionHeaderTable = file.sectionHeaderTable();
+
+  const auto it = std::find_if(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), [](const Elf::SectionHeader & header){
+    return header.isGnuDebugLinkSectionHeader();
+  });
+  if( it == sectionHeaderTable.cend() ){
+    return Elf::GnuDebugLink();
+  }
+  REQUIRE( it->minimumSizeToReadSection() <= file.map().size );
+
+  return Elf::extractGnuDebugLink( file.map(), *it, file.fileHeader().ident.dataFormat );
+}
+
+/*
+ * The CRC a debugger checks before it accepts the debug file
+ */
+uint32_t fileGnuDebugLinkCrc(const QString & filePath)
+{
+  QFile file(filePath);
+  REQUIRE( file.open(QIODevice::ReadOnly) );
+  QByteArray content = file.readAll();
+
+  ByteArraySpan span;
+  span.data = reinterpret_cast<unsigned char*>( content.data() );
+  span.size = content.size();
+
+  return Elf::updateGnuDebugLinkCrc(0, span);
+}
+
+struct GnuHashTableOfFile
+{
+  Elf::Class _class = Elf::Class::ClassNone;
+  Elf::GnuHashTable table;
+  // Hashes of the symbols starting at symoffset in .dynsym
+  std::vector<uint32_t> hashes;
+};
+
+GnuHashTableOfFile getFileGnuHashTable(const QString & filePath)
+{
+  const ElfFileSnapshot file = ElfFileSnapshot::fromFile(filePath);
+  const Elf::SectionHeaderTable & sectionHeaderTable = file.sectionHeaderTable();
+
+  const auto gnuHashIt = std::find_if(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), [](const Elf::SectionHeader & header){
+    return header.isGnuHashTableSectionHeader();
+  });
+  REQUIRE( gnuHashIt != sectionHeaderTable.cend() );
+
+  const auto dynSymIt = std::find_if(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), [](const Elf::SectionHeader & header){
+    return header.sectionType() == Elf::SectionType::DynSym;
+  });
+  REQUIRE( dynSymIt != sectionHeaderTable.cend() );
+  REQUIRE( dynSymIt->link < sectionHeaderTable.size() );
+  const Elf::StringTable dynamicStringTable = Elf::extractStringTable(file.map(), sectionHeaderTable[dynSymIt->link]);
+
+  GnuHashTableOfFile result;
+  result._class = file.fileHeader().ident._class;
+  result.table = Elf::GnuHashTableReader::extractHasTable(file.map(), file.fileHeader(), *gnuHashIt);
+  result.hashes = Elf::GnuHashTableReader::extractHashedSymbolHashes(file.map(), file.fileHeader(), sectionHeaderTable,
+                                                                     result.table.symoffset, dynamicStringTable);
+
+  return result;
+}
+
+/*
+ * Look up the symbol at symbolIndex in .dynsym,
+ * the way the dynamic linker does:
+ * the bloom filter must accept its hash,
+ * then it must be found in the chain of its bucket
+ */
+bool gnuHashTableFindsSymbol(const GnuHashTableOfFile & file, uint32_t symbolIndex)
+{
+  const Elf::GnuHashTable & table = file.table;
+  REQUIRE( symbolIndex >= table.symoffset );
+  const uint32_t hash = file.hashes[symbolIndex - table.symoffset];
+
+  const auto entryBits = static_cast<uint32_t>( Elf::GnuHashTable::bloomEntryByteCount(file._class) * 8 );
+  const uint64_t bloomEntry = table.bloom[(hash / entryBits) & (table.bloomSize() - 1)];
+  const uint64_t bloomMask = ( uint64_t(1) << (hash % entryBits) ) | ( uint64_t(1) << ( (hash >> table.bloomShift) % entryBits ) );
+  if( (bloomEntry & bloomMask) != bloomMask ){
+    return false;
+  }
+
+  uint32_t index = table.buckets[hash % table.bucketCount()];
+  if(index < table.symoffset){
+    return false;
+  }
+  for(; (index - table.symoffset) < table.chain.size(); ++index){
+    const uint32_t chainHash = table.chain[index - table.symoffset];
+    if( ( (chainHash | 1) == (hash | 1) ) && (index == symbolIndex) ){
+      return true;
+    }
+    // The lowest bit marks the end of the chain
+    if(chainHash & 1){
+      return false;
+    }
+  }
+
+  return false;
+}
+
+/*
+ * Get the names of the dynamic symbols
+ * and the names used by .gnu.version_d and .gnu.version_r ,
+ * in the order of their sections
+ */
+std::vector<std::string> getFileDynamicStringTableReferencedNames(const QString & filePath)
+{
+  const ElfFileSnapshot file = ElfFileSnapshot::fromFile(filePath);
+  const Elf::SectionHeaderTable & sectionHeaderTable = file.sectionHeaderTable();
+
+  const auto dynSymIt = std::find_if(sectionHeaderTable.cbegin(), sectionHeaderTable.cend(), [](const Elf::SectionHeader & header){
+    return header.sectionType() == Elf::SectionType::DynSym;
+  });
+  REQUIRE( dynSymIt != sectionHeaderTable.cend() );
+  REQUIRE( dynSymIt->link < sectionHeaderTable.size() );
+  const auto dynamicStringTableIndex = static_cast<uint16_t>(dynSymIt->link);
+  const Elf::StringTable dynamicStringTable = Elf::extractStringTable(file.map(), sectionHeaderTable[dynamicStringTableIndex]);
+
+  const std::vector<Elf::DynamicStringTableReference> references =
+    Elf::extractDynamicStringTableReferenceLocations(file.map(), file.fileHeader(), sectionHeaderTable, dynamicStringTableIndex);
+
+  std::vector<std::string> names;
+  for(const Elf::DynamicStringTableReference & reference : references){
+    REQUIRE( dynamicStringTable.indexIsValid(reference.index) );
+    names.push_back( dynamicStringTable.stringAtIndex(reference.index) );
+  }
+
+  return names;
+}
+
+/*
+ * Get the PT_LOAD segment that holds the code
+ */
+Elf::ProgramHeader getFileExecutableLoadProgramHeader(const QString & filePath)
+{
+  const ElfFileSnapshot file = ElfFileSnapshot::fromFile(filePath);
+
+  for(const Elf::ProgramHeader & header : file.programHeaderTable()){
+    if( (header.segmentType() == Elf::SegmentType::Load) && header.isExecutable() ){
+      return header;
+    }
+  }
+  FAIL("file has no executable PT_LOAD segment");
+
+  return Elf::ProgramHeader();
+}
+
+/*
+ * DT_RELR is supported by the dynamic linker since glibc 2.36
+ */
+bool dynamicLinkerSupportsRelr()
+{
+#ifdef __GLIBC__
+  int major = 0;
+  int minor = 0;
+  if( std::sscanf(gnu_get_libc_version(), "%d.%d", &major, &minor) != 2 ){
+    return false;
+  }
+
+  return (major > 2) || ( (major == 2) && (minor >= 36) );
+#else
+  return false;
+#endif
+}
+#endif
+
 
 TEST_CASE("open_close")
 {
@@ -173,3 +400,769 @@ TEST_CASE("setRunPath")
     }
   }
 }
+
+#ifndef Q_OS_WIN
+TEST_CASE("applyEdits")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  /*
+   * libutil is part of the C library,
+   * so it exists on every Linux system,
+   * but a Qt executable has no reason to link to it
+   */
+  const QString addedLibrary = QLatin1String("libutil.so.1");
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( dir.path() );
+  appendRPathToRPath(getFileRunPath(targetFilePath), expectedRPath);
+
+  QStringList expectedNeededSharedLibraries;
+  {
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    expectedNeededSharedLibraries = reader.getNeededSharedLibraries();
+  }
+  REQUIRE( !expectedNeededSharedLibraries.contains(addedLibrary) );
+  expectedNeededSharedLibraries.append(addedLibrary);
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(expectedRPath);
+  edits.addNeededSharedLibrary(addedLibrary);
+  edits.setBindNow();
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  ExecutableFileReader reader;
+  reader.openFile(targetFilePath);
+  REQUIRE( reader.getRunPath() == expectedRPath );
+  REQUIRE( reader.getNeededSharedLibraries() == expectedNeededSharedLibraries );
+  reader.close();
+
+  const Elf::DynamicSection dynamicSection = getFileDynamicSection(targetFilePath);
+  REQUIRE( (dynamicSection.valueForTag(Elf::DynamicSectionTagType::Flags) & DynamicFlagBindNow) != 0 );
+  REQUIRE( (dynamicSection.valueForTag(Elf::DynamicSectionTagType::Flags1) & DynamicFlag1Now) != 0 );
+
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+
+TEST_CASE("applyEdits_setSoName")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString libraryFilePath = dir.filePath( testSharedLibraryFileName() );
+  const QString executableFilePath = makePath(dir, "executable");
+  REQUIRE( copyFile(testSharedLibraryFilePath(), libraryFilePath) );
+  REQUIRE( copyFile(testExecutableFilePath(), executableFilePath) );
+
+  const QString soName = QLatin1String("libRenamedTestSharedLibrary.so");
+  REQUIRE( getFileDynamicSection(libraryFilePath).getSoName() != soName );
+
+  ExecutableFileEditTransaction edits;
+  edits.setSoName(soName);
+
+  ExecutableFileWriter writer;
+  writer.openFile(libraryFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( getFileDynamicSection(libraryFilePath).getSoName() == soName );
+
+  /*
+   * The executable still finds the library by its file name,
+   * make it load the edited copy
+   */
+  RPath rPath;
+  rPath.appendPath( dir.path() );
+  appendRPathToRPath(getFileRunPath(executableFilePath), rPath);
+  writer.openFile(executableFilePath);
+  writer.setRunPath(rPath);
+  writer.close();
+
+  REQUIRE( runExecutable(executableFilePath, {QLatin1String("25")}) );
+}
+
+TEST_CASE("applyEdits_replaceAndRemoveNeededSharedLibrary")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  // Both are part of the C library and not needed by a Qt executable
+  const QString addedLibrary = QLatin1String("libutil.so.1");
+  const QString newLibrary = QLatin1String("libanl.so.1");
+
+  QStringList originalNeededSharedLibraries;
+  {
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    originalNeededSharedLibraries = reader.getNeededSharedLibraries();
+  }
+  REQUIRE( !originalNeededSharedLibraries.contains(addedLibrary) );
+  REQUIRE( !originalNeededSharedLibraries.contains(newLibrary) );
+
+  ExecutableFileWriter writer;
+
+  ExecutableFileEditTransaction addEdits;
+  addEdits.addNeededSharedLibrary(addedLibrary);
+  writer.openFile(targetFilePath);
+  writer.applyEdits(addEdits);
+  writer.close();
+
+  ExecutableFileEditTransaction replaceEdits;
+  replaceEdits.replaceNeededSharedLibrary(addedLibrary, newLibrary);
+  writer.openFile(targetFilePath);
+  writer.applyEdits(replaceEdits);
+  writer.close();
+
+  QStringList expectedNeededSharedLibraries = originalNeededSharedLibraries;
+  expectedNeededSharedLibraries.append(newLibrary);
+  {
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    REQUIRE( reader.getNeededSharedLibraries() == expectedNeededSharedLibraries );
+  }
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+
+  ExecutableFileEditTransaction removeEdits;
+  removeEdits.removeNeededSharedLibrary(newLibrary);
+  writer.openFile(targetFilePath);
+  writer.applyEdits(removeEdits);
+  writer.close();
+
+  {
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    REQUIRE( reader.getNeededSharedLibraries() == originalNeededSharedLibraries );
+  }
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+
+TEST_CASE("applyEdits_setProgramInterpreter")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  const std::string originalInterpreter = getFileProgramInterpreter(targetFilePath);
+  REQUIRE( !originalInterpreter.empty() );
+  REQUIRE( originalInterpreter[0] == '/' );
+
+  /*
+   * A longer path to the same dynamic linker,
+   * so the .interp section has to be moved
+   */
+  const std::string expectedInterpreter = "/." + originalInterpreter;
+
+  ExecutableFileEditTransaction edits;
+  edits.setProgramInterpreter( QString::fromStdString(expectedInterpreter) );
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( getFileProgramInterpreter(targetFilePath) == expectedInterpreter );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+
+TEST_CASE("applyEdits_stripNonAllocatedSections")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+  const qint64 originalFileSize = QFileInfo(targetFilePath).size();
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( dir.path() );
+  appendRPathToRPath(getFileRunPath(targetFilePath), expectedRPath);
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(expectedRPath);
+  edits.stripNonAllocatedSections();
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( QFileInfo(targetFilePath).size() < originalFileSize );
+  REQUIRE( getFileRunPath(targetFilePath) == expectedRPath );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+
+TEST_CASE("applyEdits_rebuildGnuHashTable")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  const GnuHashTableOfFile originalTable = getFileGnuHashTable(targetFilePath);
+  const Elf::GnuHashTable expectedTable = Elf::makeOptimizedGnuHashTable(originalTable.hashes, originalTable.table, originalTable._class);
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( dir.path() );
+  appendRPathToRPath(getFileRunPath(targetFilePath), expectedRPath);
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(expectedRPath);
+  edits.rebuildGnuHashTable();
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( getFileRunPath(targetFilePath) == expectedRPath );
+
+  const GnuHashTableOfFile table = getFileGnuHashTable(targetFilePath);
+  REQUIRE( table.hashes == originalTable.hashes );
+  REQUIRE( table.table.symoffset == originalTable.table.symoffset );
+  REQUIRE( table.table.bucketCount() >= originalTable.table.bucketCount() );
+  REQUIRE( table.table.bucketCount() == expectedTable.bucketCount() );
+  REQUIRE( table.table.buckets == expectedTable.buckets );
+  REQUIRE( table.table.bloomSize() >= originalTable.table.bloomSize() );
+  REQUIRE( table.table.bloomShift == expectedTable.bloomShift );
+  REQUIRE( table.table.bloom == expectedTable.bloom );
+  REQUIRE( table.table.chain == expectedTable.chain );
+  for(size_t i = 0; i < table.hashes.size(); ++i){
+    REQUIRE( gnuHashTableFindsSymbol( table, table.table.symoffset + static_cast<uint32_t>(i) ) );
+  }
+
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+
+/*
+ * The executable only looks up symbols of the libraries it needs,
+ * so also look up a symbol defined in a edited shared library
+ */
+TEST_CASE("applyEdits_rebuildGnuHashTable_lookupSymbol")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath( dir, testSharedLibraryFileName().toLocal8Bit().constData() );
+  REQUIRE( copyFile(testSharedLibraryFilePath(), targetFilePath) );
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( dir.path() );
+  appendRPathToRPath(getFileRunPath(targetFilePath), expectedRPath);
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(expectedRPath);
+  edits.rebuildGnuHashTable();
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  const GnuHashTableOfFile table = getFileGnuHashTable(targetFilePath);
+  for(size_t i = 0; i < table.hashes.size(); ++i){
+    REQUIRE( gnuHashTableFindsSymbol( table, table.table.symoffset + static_cast<uint32_t>(i) ) );
+  }
+
+  void *handle = dlopen(QFile::encodeName(targetFilePath).constData(), RTLD_NOW | RTLD_LOCAL);
+  INFO( (handle == nullptr ? dlerror() : "") );
+  REQUIRE( handle != nullptr );
+
+  // int process(const char *str)
+  using ProcessFunction = int (*)(const char *);
+  const auto process = reinterpret_cast<ProcessFunction>( dlsym(handle, "_Z7processPKc") );
+  REQUIRE( process != nullptr );
+  REQUIRE( process("gnuHash") == 42 );
+  // A symbol that is not defined is rejected
+  REQUIRE( dlsym(handle, "_Z7processPKcNotDefined") == nullptr );
+
+  REQUIRE( dlclose(handle) == 0 );
+}
+
+TEST_CASE("applyEdits_alignLoadSegmentsForHugePages")
+{
+  const uint64_t hugePageSize = 0x200000;
+
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableLargeTextFilePath(), targetFilePath) );
+
+  // The file content must be shifted
+  const Elf::ProgramHeader originalHeader = getFileExecutableLoadProgramHeader(targetFilePath);
+  REQUIRE( originalHeader.filesz >= 2 * hugePageSize );
+  REQUIRE( (originalHeader.offset % hugePageSize) != (originalHeader.vaddr % hugePageSize) );
+
+  ExecutableFileEditTransaction edits;
+  edits.alignLoadSegmentsForHugePages();
+
+  RPath expectedRPath;
+
+  SECTION("align only")
+  {
+    expectedRPath = getFileRunPath(targetFilePath);
+  }
+
+  SECTION("also set a run path that moves the dynamic string table")
+  {
+    expectedRPath.appendPath( dir.path() );
+    for(int i = 0; i < 20; ++i){
+      expectedRPath.appendPath( QLatin1String("/opt/huge/pages/lib") + QString::number(i) );
+    }
+    edits.setRunPath(expectedRPath);
+  }
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  const Elf::ProgramHeader header = getFileExecutableLoadProgramHeader(targetFilePath);
+  REQUIRE( header.vaddr == originalHeader.vaddr );
+  REQUIRE( header.filesz == originalHeader.filesz );
+  REQUIRE( (header.offset % hugePageSize) == (header.vaddr % hugePageSize) );
+  REQUIRE( header.align == hugePageSize );
+  REQUIRE( getFileRunPath(targetFilePath) == expectedRPath );
+  REQUIRE( runExecutable(targetFilePath) );
+}
+
+TEST_CASE("applyEdits_packRelativeRelocations")
+{
+  using Elf::DynamicSectionTagType;
+
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  const uint64_t originalRelaSize = getFileDynamicSection(targetFilePath).valueForTag(DynamicSectionTagType::RelocationTableSize);
+  REQUIRE( originalRelaSize > 0 );
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( dir.path() );
+  appendRPathToRPath(getFileRunPath(targetFilePath), expectedRPath);
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(expectedRPath);
+  edits.packRelativeRelocations();
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( getFileRunPath(targetFilePath) == expectedRPath );
+
+  const Elf::DynamicSection dynamicSection = getFileDynamicSection(targetFilePath);
+  REQUIRE( containsDynamicEntry(dynamicSection, DynamicSectionTagType::RelrTable) );
+  REQUIRE( containsDynamicEntry(dynamicSection, DynamicSectionTagType::RelrTableSize) );
+  REQUIRE( dynamicSection.valueForTag(DynamicSectionTagType::RelrEntrySize) == 8 );
+  REQUIRE( dynamicSection.valueForTag(DynamicSectionTagType::RelocationTableSize) < originalRelaSize );
+
+  /*
+   * A dynamic linker that does not know DT_RELR
+   * would start the executable without applying those relocations
+   */
+  if( dynamicLinkerSupportsRelr() ){
+    REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+  }
+}
+
+TEST_CASE("applyEdits_compactDynamicStringTable")
+{
+  using Elf::DynamicSectionTagType;
+
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  const uint64_t originalStringTableSize = getFileDynamicSection(targetFilePath).valueForTag(DynamicSectionTagType::StringTableSize);
+  const std::vector<std::string> originalNames = getFileDynamicStringTableReferencedNames(targetFilePath);
+  REQUIRE( !originalNames.empty() );
+  const QStringList originalNeededSharedLibraries = ElfFileSnapshot::fromFile(targetFilePath).getNeededSharedLibraries();
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( QLatin1String("lib") );
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(expectedRPath);
+  edits.compactDynamicStringTable();
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( getFileRunPath(targetFilePath) == expectedRPath );
+  REQUIRE( getFileDynamicSection(targetFilePath).valueForTag(DynamicSectionTagType::StringTableSize) < originalStringTableSize );
+  // Each index that moved must still refer to the same name
+  REQUIRE( getFileDynamicStringTableReferencedNames(targetFilePath) == originalNames );
+  REQUIRE( ElfFileSnapshot::fromFile(targetFilePath).getNeededSharedLibraries() == originalNeededSharedLibraries );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+
+TEST_CASE("applyEdits_setDeployStamp")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  RPath rPath;
+  rPath.appendPath( QLatin1String("lib") );
+  const DeployStamp stamp( QLatin1String("1.0"), rPath, fileSha256(targetFilePath) );
+
+  {
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    REQUIRE( reader.getDeployStamp().isNull() );
+  }
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(rPath);
+  edits.setDeployStamp(stamp);
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  {
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    REQUIRE( reader.getDeployStamp() == stamp );
+    REQUIRE( reader.getRunPath() == rPath );
+  }
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+
+  SECTION("update the stamp in place")
+  {
+    const qint64 fileSize = QFileInfo(targetFilePath).size();
+    const DeployStamp newStamp( QLatin1String("1.1"), rPath, stamp.inputFingerprint() );
+
+    ExecutableFileEditTransaction newEdits;
+    newEdits.setDeployStamp(newStamp);
+
+    writer.openFile(targetFilePath);
+    writer.applyEdits(newEdits);
+    writer.close();
+
+    ExecutableFileReader reader;
+    reader.openFile(targetFilePath);
+    REQUIRE( reader.getDeployStamp() == newStamp );
+    reader.close();
+    REQUIRE( QFileInfo(targetFilePath).size() == fileSize );
+    REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+  }
+}
+
+TEST_CASE("applyEdits_splitDebugInfo")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  const QString debugFilePath = makePath(dir, "targetFile.debug");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+  const qint64 originalFileSize = QFileInfo(targetFilePath).size();
+  const QByteArray originalHash = fileSha256(targetFilePath);
+
+  ExecutableFileEditTransaction edits;
+  edits.splitDebugInfoTo(debugFilePath);
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  REQUIRE( QFileInfo(targetFilePath).size() < originalFileSize );
+  REQUIRE( fileSha256(debugFilePath) == originalHash );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+
+  const Elf::GnuDebugLink debugLink = getFileGnuDebugLink(targetFilePath);
+  REQUIRE( debugLink.fileName == "targetFile.debug" );
+  REQUIRE( debugLink.crc == fileGnuDebugLinkCrc(debugFilePath) );
+
+  SECTION("split again a file that has no debug information")
+  {
+    const QString otherDebugFilePath = makePath(dir, "other.debug");
+    const QByteArray splitHash = fileSha256(targetFilePath);
+
+    ExecutableFileEditTransaction newEdits;
+    newEdits.splitDebugInfoTo(otherDebugFilePath);
+
+    writer.openFile(targetFilePath);
+    writer.applyEdits(newEdits);
+    writer.close();
+
+    REQUIRE( !QFile::exists(otherDebugFilePath) );
+    // The existing .gnu_debuglink is kept
+    REQUIRE( fileSha256(targetFilePath) == splitHash );
+  }
+}
+
+TEST_CASE("applyEdits_splitDebugInfo_failingEdit")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  const QString debugFilePath = makePath(dir, "targetFile.debug");
+  REQUIRE( copyFile(testSharedLibraryFilePath(), targetFilePath) );
+  const QByteArray originalHash = fileSha256(targetFilePath);
+
+  // A shared library has no .interp
+  ExecutableFileEditTransaction edits;
+  edits.splitDebugInfoTo(debugFilePath);
+  edits.setProgramInterpreter( QLatin1String("/lib/ld-linux.so.2") );
+
+  ExecutableFileWriter writer;
+  writer.openFile(targetFilePath);
+  REQUIRE_THROWS_AS( writer.applyEdits(edits), ExecutableFileWriteError );
+  writer.close();
+
+  REQUIRE( !QFile::exists(debugFilePath) );
+  REQUIRE( fileSha256(targetFilePath) == originalHash );
+}
+
+TEST_CASE("applyEdits_isReproducible")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString firstTargetFilePath = makePath(dir, "firstTargetFile");
+  const QString secondTargetFilePath = makePath(dir, "secondTargetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), firstTargetFilePath) );
+  REQUIRE( copyFile(testExecutableFilePath(), secondTargetFilePath) );
+  const qint64 originalFileSize = QFileInfo(firstTargetFilePath).size();
+
+  /*
+   * The run path must not depend on the run (like the path of the temporary directory),
+   * and must be long enough to move the dynamic section and its string table to the end
+   */
+  RPath rPath;
+  for(int i = 0; i < 20; ++i){
+    rPath.appendPath( QLatin1String("/opt/reproducible/build/lib") + QString::number(i) );
+  }
+
+  ExecutableFileEditTransaction edits;
+  edits.setRunPath(rPath);
+  edits.setBindNow();
+  edits.rebuildGnuHashTable();
+  edits.compactDynamicStringTable();
+
+  ExecutableFileWriter writer;
+  writer.openFile(firstTargetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  const qint64 grownByteCount = QFileInfo(firstTargetFilePath).size() - originalFileSize;
+  REQUIRE( grownByteCount > 0 );
+
+  /*
+   * The part the file grows by is not always zeroed
+   * (for example, a file that was truncated and not yet rewritten).
+   * Put some garbage there in the second file,
+   * the writer must overwrite it.
+   */
+  {
+    QFile file(secondTargetFilePath);
+    REQUIRE( file.open(QIODevice::WriteOnly | QIODevice::Append) );
+    const QByteArray garbage( static_cast<int>(grownByteCount), '\xAA' );
+    REQUIRE( file.write(garbage) == grownByteCount );
+    file.close();
+  }
+
+  writer.openFile(secondTargetFilePath);
+  writer.applyEdits(edits);
+  writer.close();
+
+  const QByteArray firstHash = fileSha256(firstTargetFilePath);
+  REQUIRE( !firstHash.isEmpty() );
+  REQUIRE( fileSha256(secondTargetFilePath) == firstHash );
+  REQUIRE( getFileRunPath(firstTargetFilePath) == rPath );
+  REQUIRE( runExecutable(firstTargetFilePath, {QLatin1String("25")}) );
+}
+#endif
+
+TEST_CASE("openFileForOutOfPlaceEdit")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString sourceFilePath = makePath(dir, "sourceFile");
+  const QString outputFilePath = makePath(dir, "outputFile");
+  REQUIRE( copyFile(testSharedLibraryFilePath(), sourceFilePath) );
+  const RPath originalRPath = getFileRunPath(sourceFilePath);
+
+  RPath expectedRPath;
+  expectedRPath.appendPath( dir.path() );
+  REQUIRE(originalRPath != expectedRPath);
+
+  ExecutableFileWriter writer;
+
+  SECTION("edit into a new file")
+  {
+    writer.openFileForOutOfPlaceEdit(sourceFilePath, outputFilePath);
+    REQUIRE( writer.isOpen() );
+    writer.setRunPath(expectedRPath);
+    REQUIRE( !fileExists(outputFilePath) );
+    writer.close();
+    REQUIRE( !writer.isOpen() );
+
+    REQUIRE( getFileRunPath(sourceFilePath) == originalRPath );
+#ifndef Q_OS_WIN
+    REQUIRE( getFileRunPath(outputFilePath) == expectedRPath );
+    REQUIRE( QFileInfo(outputFilePath).permissions() == QFileInfo(sourceFilePath).permissions() );
+#endif
+  }
+
+  SECTION("replace the source file")
+  {
+    writer.openFileForOutOfPlaceEdit(sourceFilePath, sourceFilePath);
+    writer.setRunPath(expectedRPath);
+    writer.close();
+
+#ifndef Q_OS_WIN
+    REQUIRE( getFileRunPath(sourceFilePath) == expectedRPath );
+#endif
+  }
+
+  SECTION("the writer is destroyed before close")
+  {
+    {
+      ExecutableFileWriter otherWriter;
+      otherWriter.openFileForOutOfPlaceEdit(sourceFilePath, outputFilePath);
+      otherWriter.setRunPath(expectedRPath);
+    }
+    REQUIRE( !fileExists(outputFilePath) );
+  }
+
+  // Only the source and the output files, no temporary file left
+  REQUIRE( QDir( dir.path() ).entryList(QDir::Files).size() <= 2 );
+}
+
+#ifndef Q_OS_WIN
+TEST_CASE("setRunPath_inPlace")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+
+  ExecutableFileWriter writer;
+
+  RPath longRPath;
+  longRPath.appendPath( QLatin1String("/some/long/path/that/will/be/shortened") );
+  longRPath.appendPath( dir.path() );
+  writer.openFile(targetFilePath);
+  writer.setRunPath(longRPath);
+  writer.close();
+  REQUIRE( getFileRunPath(targetFilePath) == longRPath );
+
+  const qint64 fileSize = QFileInfo(targetFilePath).size();
+
+  SECTION("shorter RunPath is written in place")
+  {
+    RPath expectedRPath;
+    expectedRPath.appendPath( dir.path() );
+
+    writer.openFile(targetFilePath);
+    writer.setRunPath(expectedRPath);
+    writer.close();
+
+    REQUIRE( getFileRunPath(targetFilePath) == expectedRPath );
+    REQUIRE( QFileInfo(targetFilePath).size() == fileSize );
+    REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+  }
+
+  SECTION("same RunPath does not change the file")
+  {
+    QFile file(targetFilePath);
+    REQUIRE( file.open(QIODevice::ReadOnly) );
+    const QByteArray contentBefore = file.readAll();
+    file.close();
+
+    writer.openFile(targetFilePath);
+    writer.setRunPath(longRPath);
+    writer.close();
+
+    REQUIRE( file.open(QIODevice::ReadOnly) );
+    REQUIRE( file.readAll() == contentBefore );
+    file.close();
+  }
+}
+
+/*
+ * Once the dynamic string table has grown,
+ * it is reused by the next edits,
+ * so the file does not grow again
+ */
+TEST_CASE("setRunPath_longerShorterLonger")
+{
+  QTemporaryDir dir;
+  REQUIRE( dir.isValid() );
+  dir.setAutoRemove(true);
+  const QString targetFilePath = makePath(dir, "targetFile");
+  REQUIRE( copyFile(testExecutableFilePath(), targetFilePath) );
+  const qint64 originalFileSize = QFileInfo(targetFilePath).size();
+
+  const RPath originalRPath = getFileRunPath(targetFilePath);
+
+  RPath longRPath;
+  longRPath.appendPath( QLatin1String("/opt/first/long/run/path/") + QString( 200, QLatin1Char('a') ) );
+  appendRPathToRPath(originalRPath, longRPath);
+
+  RPath shortRPath;
+  appendRPathToRPath(originalRPath, shortRPath);
+
+  // As long as the first one, but different
+  RPath otherLongRPath;
+  otherLongRPath.appendPath( QLatin1String("/opt/third/long/run/path/") + QString( 200, QLatin1Char('c') ) );
+  appendRPathToRPath(originalRPath, otherLongRPath);
+
+  ExecutableFileWriter writer;
+
+  writer.openFile(targetFilePath);
+  writer.setRunPath(longRPath);
+  writer.close();
+  REQUIRE( getFileRunPath(targetFilePath) == longRPath );
+  const qint64 fileSize = QFileInfo(targetFilePath).size();
+  REQUIRE( fileSize > originalFileSize );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+
+  writer.openFile(targetFilePath);
+  writer.setRunPath(shortRPath);
+  writer.close();
+  REQUIRE( getFileRunPath(targetFilePath) == shortRPath );
+  REQUIRE( QFileInfo(targetFilePath).size() == fileSize );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+
+  writer.openFile(targetFilePath);
+  writer.setRunPath(otherLongRPath);
+  writer.close();
+  REQUIRE( getFileRunPath(targetFilePath) == otherLongRPath );
+  REQUIRE( QFileInfo(targetFilePath).size() == fileSize );
+  REQUIRE( runExecutable(targetFilePath, {QLatin1String("25")}) );
+}
+#endif // #ifndef Q_OS_WIN
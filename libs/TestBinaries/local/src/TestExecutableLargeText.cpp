@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+/****************************************************************************************
+ **
+ ** MdtExecutableFile
+ ** C++ library to help reading and partially editing some binary files like ELF and Pe.
+ **
+ ** Copyright (C) 2021-2023 Philippe Steinmann.
+ **
+ *****************************************************************************************/
+#include <cstdio>
+
+/*
+ * 4 MiB of code that is never executed,
+ * so that the executable segment spans whole huge pages (2 MiB)
+ */
+__asm__(
+  ".text\n"
+  ".p2align 4\n"
+  ".fill 0x400000, 1, 0xcc\n"
+);
+
+int main()
+{
+  std::puts("Hello large text");
+
+  return 0;
+}
@@ -65,3 +65,21 @@ QString testStaticLibraryFilePath()
 
   return path;
 }
+
+QString testObjectFilePath()
+{
+  auto path = QString::fromLocal8Bit(TEST_OBJECT_FILE_PATH);
+  assert( QFileInfo(path).isAbsolute() );
+
+  return path;
+}
+
+#ifndef Q_OS_WIN
+QString testExecutableLargeTextFilePath()
+{
+  auto path = QString::fromLocal8Bit(TEST_LARGE_TEXT_EXECUTABLE_FILE_PATH);
+  assert( QFileInfo(path).isAbsolute() );
+
+  return path;
+}
+#endif
@@ -12,6 +12,7 @@
 
 #include <QString>
 #include <QStringList>
+#include <QtGlobal>
 
 /*! \internal Get the absolute path to the Qt5Core library
  */
@@ -47,4 +48,19 @@ QString testExecutableFilePath();
  */
 QString testStaticLibraryFilePath();
 
+/*! \internal Get the absolute path to the test object file
+ *
+ * This is a relocatable object (ET_REL) on ELF platforms.
+ */
+QString testObjectFilePath();
+
+#ifndef Q_OS_WIN
+/*! \internal Get the absolute path to the test executable that has a large text segment
+ *
+ * Its executable PT_LOAD segment is larger than a huge page (2 MiB),
+ * and its file offset is not congruent with its virtual address modulo 2 MiB.
+ */
+QString testExecutableLargeTextFilePath();
+#endif
+
 #endif // #ifndef TEST_BINARIES_UTILS_H
@@ -13,6 +13,7 @@
 #include <QTextStream>
 #include <QDir>
 #include <QProcess>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <iostream>
 #include <cassert>
@@ -114,6 +115,21 @@ bool copyFile(const QString & source, const QString & destination)
   return QFile::copy(source, destination);
 }
 
+QByteArray fileSha256(const QString & filePath)
+{
+  QFile file(filePath);
+  if( !file.open(QIODevice::ReadOnly) ){
+    return QByteArray();
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+  if( !hash.addData(&file) ){
+    return QByteArray();
+  }
+
+  return hash.result();
+}
+
 bool hasExePermissions(QFile::Permissions permissions) noexcept
 {
   return permissions.testFlag(QFile::ExeOwner);
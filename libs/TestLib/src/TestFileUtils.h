@@ -15,6 +15,7 @@
 #include <QTemporaryDir>
 #include <QProcessEnvironment>
 #include <QFile>
+#include <QByteArray>
 
 /*
  * Make a absolute path that retruns the correct result
@@ -44,6 +45,11 @@ QString readTextFileUtf8(const QString & filePath);
 
 bool copyFile(const QString & source, const QString & destination);
 
+/*
+ * Returns a empty array if the file could not be read
+ */
+QByteArray fileSha256(const QString & filePath);
+
 bool hasExePermissions(QFile::Permissions permissions) noexcept;
 
 void setExePermissions(QFile::Permissions & permissions) noexcept;